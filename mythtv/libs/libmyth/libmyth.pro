@@ -52,6 +52,7 @@ HEADERS += mythterminal.h
 HEADERS += remoteutil.h
 HEADERS += rawsettingseditor.h
 HEADERS += programinfo.h          programinfoupdater.h
+HEADERS += recordedlistcache.h     seekindex.h
 HEADERS += programtypes.h         recordingtypes.h
 HEADERS += rssparse.h
 
@@ -76,6 +77,7 @@ SOURCES += mythterminal.cpp
 SOURCES += remoteutil.cpp
 SOURCES += rawsettingseditor.cpp
 SOURCES += programinfo.cpp        programinfoupdater.cpp
+SOURCES += recordedlistcache.cpp   seekindex.cpp
 SOURCES += programtypes.cpp       recordingtypes.cpp
 SOURCES += rssparse.cpp
 
@@ -20,6 +20,7 @@ using std::min;
 
 // MythTV headers
 #include "programinfoupdater.h"
+#include "seekindex.h"
 #include "mythcorecontext.h"
 #include "mythscheduler.h"
 #include "mythmiscutil.h"
@@ -3740,6 +3741,11 @@ void ProgramInfo::ClearPositionMap(MarkTypes type) const
                       " AND type = :TYPE ;");
         query.bindValue(":CHANID", chanid);
         query.bindValue(":STARTTIME", recstartts);
+
+        // Everything that rebuilds the seek table clears the durations,
+        // the index would be stale after that.
+        if (type == MARK_DURATION_MS)
+            SeekIndex::Remove(GetPlaybackURL(false, true));
     }
     else
     {
@@ -3828,6 +3834,9 @@ void ProgramInfo::SavePositionMap(
                       + comp + ';');
         query.bindValue(":CHANID", chanid);
         query.bindValue(":STARTTIME", recstartts);
+
+        if (type == MARK_DURATION_MS && comp.isEmpty())
+            SeekIndex::Remove(GetPlaybackURL(false, true));
     }
     else
     {
@@ -5813,6 +5822,214 @@ bool LoadFromOldRecorded(
     return true;
 }
 
+/// Makes a ProgramInfo from a row of ProgramInfo::kFromRecordedQuery with
+/// only the state stored in the database, see ApplyRecordedState().
+static ProgramInfo *recorded_from_query(const MSqlQuery &query)
+{
+    const uint chanid = query.value(6).toUInt();
+    QString channum  = QString("#%1").arg(chanid);
+    QString chansign = channum;
+    QString channame = channum;
+    QString chanfilt;
+    if (!query.value(7).toString().isEmpty())
+    {
+        channum  = query.value(7).toString();
+        chansign = query.value(8).toString();
+        channame = query.value(9).toString();
+        chanfilt = query.value(10).toString();
+    }
+
+    QString hostname = query.value(15).toString();
+    if (hostname.isEmpty())
+        hostname = gCoreContext->GetHostName();
+
+    RecStatus::Type recstatus = RecStatus::Recorded;
+
+    uint flags = 0;
+
+    set_flag(flags, FL_CHANCOMMFREE,
+             query.value(30).toInt() == COMM_DETECT_COMMFREE);
+    set_flag(flags, FL_COMMFLAG,
+             query.value(31).toInt() == COMM_FLAG_DONE);
+    set_flag(flags, FL_COMMPROCESSING ,
+             query.value(31).toInt() == COMM_FLAG_PROCESSING);
+    set_flag(flags, FL_REPEAT,        query.value(32).toBool());
+    set_flag(flags, FL_TRANSCODED,
+             query.value(34).toInt() == TRANSCODING_COMPLETE);
+    set_flag(flags, FL_DELETEPENDING, query.value(35).toBool());
+    set_flag(flags, FL_PRESERVED,     query.value(36).toBool());
+    set_flag(flags, FL_CUTLIST,       query.value(37).toBool());
+    set_flag(flags, FL_AUTOEXP,       query.value(38).toBool());
+    set_flag(flags, FL_REALLYEDITING, query.value(39).toBool());
+    set_flag(flags, FL_BOOKMARK,      query.value(40).toBool());
+    set_flag(flags, FL_WATCHED,       query.value(41).toBool());
+
+    // User/metadata defined season from recorded
+    uint season = query.value(3).toUInt();
+    if (season == 0)
+        season = query.value(51).toUInt(); // Guide defined season from recordedprogram
+
+    // User/metadata defined episode from recorded
+    uint episode = query.value(4).toUInt();
+    if (episode == 0)
+        episode  = query.value(52).toUInt();  // Guide defined episode from recordedprogram
+
+    // Guide defined total episodes from recordedprogram
+    uint totalepisodes = query.value(53).toUInt();
+
+    return new ProgramInfo(
+        query.value(55).toUInt(),
+        query.value(0).toString(),
+        query.value(1).toString(),
+        query.value(2).toString(),
+        season,
+        episode,
+        totalepisodes,
+        query.value(48).toString(), // syndicatedepisode
+        query.value(5).toString(), // category
+
+        chanid, channum, chansign, channame, chanfilt,
+
+        query.value(11).toString(), query.value(12).toString(),
+
+        query.value(14).toString(), // pathname
+
+        hostname, query.value(13).toString(),
+
+        query.value(17).toString(), query.value(18).toString(),
+        query.value(19).toString(), // inetref
+        string_to_myth_category_type(query.value(54).toString()), // category_type
+
+        query.value(16).toInt(),  // recpriority
+
+        query.value(20).toULongLong(),  // filesize
+
+        MythDate::as_utc(query.value(21).toDateTime()), //startts
+        MythDate::as_utc(query.value(22).toDateTime()), // endts
+        MythDate::as_utc(query.value(24).toDateTime()), // recstartts
+        MythDate::as_utc(query.value(25).toDateTime()), // recendts
+
+        query.value(23).toDouble(), // stars
+
+        query.value(26).toUInt(), // year
+        query.value(49).toUInt(), // partnumber
+        query.value(50).toUInt(), // parttotal
+        query.value(27).toDate(), // originalAirdate
+        MythDate::as_utc(query.value(28).toDateTime()), // lastmodified
+
+        recstatus,
+
+        query.value(29).toUInt(), // recordid
+
+        RecordingDupInType(query.value(46).toInt()),
+        RecordingDupMethodType(query.value(47).toInt()),
+
+        query.value(45).toUInt(), // findid
+
+        flags,
+        query.value(42).toUInt(), // audioproperties
+        query.value(43).toUInt(), // videoproperties
+        query.value(44).toUInt(), // subtitleType
+        query.value(56).toString(), // inputname
+        MythDate::as_utc(query.value(57)
+                         .toDateTime())); // bookmarkupdate
+
+}
+
+/** \brief Adds the state that doesn't come from the recorded table to
+ *         a recording loaded from it.
+ *
+ *  Sets the in-use flags, the recording status of recordings still in
+ *  progress, and clears the commercial flagging flag when no flagging
+ *  job is running any more.
+ *
+ *  \param pginfo          recording loaded by LoadRecordedEntries()
+ *  \param rectime         recordings ending after this may be in progress
+ *  \param inUseMap        in-use programs map
+ *  \param isJobRunning    job map
+ *  \param recMap          recording map
+ *  \return true if the commercial flagging flag was cleared, in which
+ *          case the caller should save that.
+ */
+bool ApplyRecordedState(
+    ProgramInfo &pginfo,
+    const QDateTime &rectime,
+    const QMap<QString,uint32_t> &inUseMap,
+    const QMap<QString,bool> &isJobRunning,
+    const QMap<QString, ProgramInfo*> &recMap)
+{
+    QString key = pginfo.MakeUniqueKey();
+    if (pginfo.recendts > rectime && recMap.contains(key))
+        pginfo.recstatus = RecStatus::Recording;
+
+    bool save_not_commflagged = false;
+    uint32_t flags = pginfo.programflags;
+
+    QMap<QString,uint32_t>::const_iterator it = inUseMap.find(key);
+    if (it != inUseMap.end())
+        flags |= *it;
+
+    if (flags & FL_COMMPROCESSING &&
+        (isJobRunning.find(key) == isJobRunning.end()))
+    {
+        flags &= ~FL_COMMPROCESSING;
+        save_not_commflagged = true;
+    }
+
+    set_flag(flags, FL_EDITING,
+             (flags & FL_REALLYEDITING) ||
+             (flags & COMM_FLAG_PROCESSING));
+
+    pginfo.programflags = flags;
+
+    return save_not_commflagged;
+}
+
+/** \brief Load recordings from the recorded table as they are stored there.
+ *
+ *  Unlike LoadFromRecorded() this leaves out the state kept outside
+ *  the recorded table, ApplyRecordedState() adds it. This is meant for
+ *  callers that keep recordings around, such as RecordedListCache.
+ *
+ *  \param destination     ProgramList to fill
+ *  \param recordedids     recordings to load, or NULL for all of them
+ *  \return true if it succeeds, false if it fails.
+ */
+bool LoadRecordedEntries(
+    ProgramList &destination,
+    const QList<uint> *recordedids)
+{
+    destination.clear();
+
+    QString thequery = ProgramInfo::kFromRecordedQuery;
+    if (recordedids)
+    {
+        if (recordedids->empty())
+            return true;
+
+        QStringList ids;
+        QList<uint>::const_iterator it = recordedids->begin();
+        for (; it != recordedids->end(); ++it)
+            ids.push_back(QString::number(*it));
+        thequery += QString("WHERE r.recordedid IN (%1) ")
+            .arg(ids.join(","));
+    }
+
+    MSqlQuery query(MSqlQuery::InitCon());
+    query.prepare(thequery);
+
+    if (!query.exec())
+    {
+        MythDB::DBError("LoadRecordedEntries", query);
+        return false;
+    }
+
+    while (query.next())
+        destination.push_back(recorded_from_query(query));
+
+    return true;
+}
+
 /** \fn ProgramInfo::LoadFromRecorded(void)
  *  \brief Load a ProgramList from the recorded table.
  *  \param destination     ProgramList to fill
@@ -5838,7 +6055,6 @@ bool LoadFromRecorded(
 {
     destination.clear();
 
-    QString     fs_db_name = "";
     QDateTime   rectime    = MythDate::current().addSecs(
         -gCoreContext->GetNumSetting("RecordOverTime"));
 
@@ -5864,140 +6080,14 @@ bool LoadFromRecorded(
 
     while (query.next())
     {
-        const uint chanid = query.value(6).toUInt();
-        QString channum  = QString("#%1").arg(chanid);
-        QString chansign = channum;
-        QString channame = channum;
-        QString chanfilt;
-        if (!query.value(7).toString().isEmpty())
-        {
-            channum  = query.value(7).toString();
-            chansign = query.value(8).toString();
-            channame = query.value(9).toString();
-            chanfilt = query.value(10).toString();
-        }
-
-        QString hostname = query.value(15).toString();
-        if (hostname.isEmpty())
-            hostname = gCoreContext->GetHostName();
-
-        RecStatus::Type recstatus = RecStatus::Recorded;
-        QDateTime recstartts = MythDate::as_utc(query.value(24).toDateTime());
-
-        QString key = ProgramInfo::MakeUniqueKey(chanid, recstartts);
-        if (MythDate::as_utc(query.value(25).toDateTime()) > rectime &&
-            recMap.contains(key))
-        {
-            recstatus = RecStatus::Recording;
-        }
+        ProgramInfo *pginfo = recorded_from_query(query);
+        destination.push_back(pginfo);
 
-        bool save_not_commflagged = false;
-        uint flags = 0;
-
-        set_flag(flags, FL_CHANCOMMFREE,
-                 query.value(30).toInt() == COMM_DETECT_COMMFREE);
-        set_flag(flags, FL_COMMFLAG,
-                 query.value(31).toInt() == COMM_FLAG_DONE);
-        set_flag(flags, FL_COMMPROCESSING ,
-                 query.value(31).toInt() == COMM_FLAG_PROCESSING);
-        set_flag(flags, FL_REPEAT,        query.value(32).toBool());
-        set_flag(flags, FL_TRANSCODED,
-                 query.value(34).toInt() == TRANSCODING_COMPLETE);
-        set_flag(flags, FL_DELETEPENDING, query.value(35).toBool());
-        set_flag(flags, FL_PRESERVED,     query.value(36).toBool());
-        set_flag(flags, FL_CUTLIST,       query.value(37).toBool());
-        set_flag(flags, FL_AUTOEXP,       query.value(38).toBool());
-        set_flag(flags, FL_REALLYEDITING, query.value(39).toBool());
-        set_flag(flags, FL_BOOKMARK,      query.value(40).toBool());
-        set_flag(flags, FL_WATCHED,       query.value(41).toBool());
-
-        if (inUseMap.contains(key))
-            flags |= inUseMap[key];
-
-        if (flags & FL_COMMPROCESSING &&
-            (isJobRunning.find(key) == isJobRunning.end()))
+        if (ApplyRecordedState(*pginfo, rectime, inUseMap, isJobRunning,
+                               recMap))
         {
-            flags &= ~FL_COMMPROCESSING;
-            save_not_commflagged = true;
+            pginfo->SaveCommFlagged(COMM_FLAG_NOT_FLAGGED);
         }
-
-        set_flag(flags, FL_EDITING,
-                 (flags & FL_REALLYEDITING) ||
-                 (flags & COMM_FLAG_PROCESSING));
-
-        // User/metadata defined season from recorded
-        uint season = query.value(3).toUInt();
-        if (season == 0)
-            season = query.value(51).toUInt(); // Guide defined season from recordedprogram
-
-        // User/metadata defined episode from recorded
-        uint episode = query.value(4).toUInt();
-        if (episode == 0)
-            episode  = query.value(52).toUInt();  // Guide defined episode from recordedprogram
-
-        // Guide defined total episodes from recordedprogram
-        uint totalepisodes = query.value(53).toUInt();
-
-        destination.push_back(
-            new ProgramInfo(
-                query.value(55).toUInt(),
-                query.value(0).toString(),
-                query.value(1).toString(),
-                query.value(2).toString(),
-                season,
-                episode,
-                totalepisodes,
-                query.value(48).toString(), // syndicatedepisode
-                query.value(5).toString(), // category
-
-                chanid, channum, chansign, channame, chanfilt,
-
-                query.value(11).toString(), query.value(12).toString(),
-
-                query.value(14).toString(), // pathname
-
-                hostname, query.value(13).toString(),
-
-                query.value(17).toString(), query.value(18).toString(),
-                query.value(19).toString(), // inetref
-                string_to_myth_category_type(query.value(54).toString()), // category_type
-
-                query.value(16).toInt(),  // recpriority
-
-                query.value(20).toULongLong(),  // filesize
-
-                MythDate::as_utc(query.value(21).toDateTime()), //startts
-                MythDate::as_utc(query.value(22).toDateTime()), // endts
-                MythDate::as_utc(query.value(24).toDateTime()), // recstartts
-                MythDate::as_utc(query.value(25).toDateTime()), // recendts
-
-                query.value(23).toDouble(), // stars
-
-                query.value(26).toUInt(), // year
-                query.value(49).toUInt(), // partnumber
-                query.value(50).toUInt(), // parttotal
-                query.value(27).toDate(), // originalAirdate
-                MythDate::as_utc(query.value(28).toDateTime()), // lastmodified
-
-                recstatus,
-
-                query.value(29).toUInt(), // recordid
-
-                RecordingDupInType(query.value(46).toInt()),
-                RecordingDupMethodType(query.value(47).toInt()),
-
-                query.value(45).toUInt(), // findid
-
-                flags,
-                query.value(42).toUInt(), // audioproperties
-                query.value(43).toUInt(), // videoproperties
-                query.value(44).toUInt(), // subtitleType
-                query.value(56).toString(), // inputname
-                MythDate::as_utc(query.value(57)
-                                 .toDateTime()))); // bookmarkupdate
-
-        if (save_not_commflagged)
-            destination.back()->SaveCommFlagged(COMM_FLAG_NOT_FLAGGED);
     }
 
     return true;
@@ -65,6 +65,9 @@ class PMapDBReplacement;
 class MPUBLIC ProgramInfo
 {
     friend int pginfo_init_statics(void);
+    friend bool ApplyRecordedState(
+        ProgramInfo&, const QDateTime&, const QMap<QString,uint32_t>&,
+        const QMap<QString,bool>&, const QMap<QString, ProgramInfo*>&);
   public:
     enum CategoryType { kCategoryNone, kCategoryMovie, kCategorySeries,
                         kCategorySports, kCategoryTVShow };
@@ -827,6 +830,17 @@ MPUBLIC bool LoadFromRecorded(
     const QMap<QString, ProgramInfo*> &recMap,
     int                 sort = 0);
 
+MPUBLIC bool LoadRecordedEntries(
+    ProgramList        &destination,
+    const QList<uint>  *recordedids = NULL);
+
+MPUBLIC bool ApplyRecordedState(
+    ProgramInfo        &pginfo,
+    const QDateTime    &rectime,
+    const QMap<QString,uint32_t> &inUseMap,
+    const QMap<QString,bool> &isJobRunning,
+    const QMap<QString, ProgramInfo*> &recMap);
+
 template<typename TYPE>
 bool LoadFromScheduler(
     AutoDeleteDeque<TYPE*> &destination,
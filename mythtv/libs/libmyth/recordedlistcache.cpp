@@ -0,0 +1,298 @@
+// -*- Mode: c++ -*-
+// vim:set sw=4 ts=4 expandtab:
+
+#include "recordedlistcache.h"
+#include "mythcorecontext.h"
+#include "mythlogging.h"
+#include "mythevent.h"
+#include "mythdate.h"
+
+#include <algorithm>
+
+#define LOC QString("RecordedListCache: ")
+
+const int RecordedListCache::kMaxAge           = 5 * 60 * 1000;
+const int RecordedListCache::kMaxPartialReload = 500;
+
+namespace {
+    /// Order of QUERY_RECORDINGS "Ascending", the same as the old
+    /// "ORDER BY r.starttime" with ties in recordedid order.
+    bool recstart_less(const ProgramInfo *a, const ProgramInfo *b)
+    {
+        if (a->GetRecordingStartTime() == b->GetRecordingStartTime())
+            return a->GetRecordingID() < b->GetRecordingID();
+        return a->GetRecordingStartTime() < b->GetRecordingStartTime();
+    }
+}
+
+RecordedListCache::RecordedListCache() :
+    m_loaded(false), m_invalid(false)
+{
+}
+
+RecordedListCache::~RecordedListCache()
+{
+    QMutexLocker locker(&m_lock);
+    Clear();
+}
+
+/** \brief Notes the recordings a backend event says have changed.
+ *
+ *  This is cheap and safe to call for every event the backend sees.
+ */
+void RecordedListCache::HandleEvent(const MythEvent &event)
+{
+    const QString &message = event.Message();
+
+    if (message.startsWith("RECORDING_LIST_CHANGE"))
+    {
+        QStringList tokens = message.simplified().split(" ");
+        if (tokens.size() >= 3 &&
+            (tokens[1] == "ADD" || tokens[1] == "DELETE"))
+        {
+            Invalidate(tokens[2].toUInt());
+        }
+        else if (tokens.size() >= 2 && tokens[1] == "UPDATE")
+        {
+            ProgramInfo evinfo(event.ExtraDataList());
+            Invalidate(evinfo.GetRecordingID());
+        }
+        else
+        {
+            Invalidate();
+        }
+    }
+    else if (message.startsWith("MASTER_UPDATE_REC_INFO"))
+    {
+        QStringList tokens = message.simplified().split(" ");
+        if (tokens.size() >= 2)
+            Invalidate(tokens[1].toUInt());
+    }
+    else if (message.startsWith("UPDATE_FILE_SIZE"))
+    {
+        QStringList tokens = message.simplified().split(" ");
+        if (tokens.size() >= 3)
+            UpdateFileSize(tokens[1].toUInt(), tokens[2].toULongLong());
+    }
+}
+
+/// Reload all recordings on the next Get()
+void RecordedListCache::Invalidate(void)
+{
+    QMutexLocker locker(&m_pendingLock);
+    m_invalid = true;
+}
+
+/// Reload this recording, or remove it if it is gone, on the next Get()
+void RecordedListCache::Invalidate(uint recordedid)
+{
+    if (!recordedid)
+    {
+        Invalidate();
+        return;
+    }
+
+    QMutexLocker locker(&m_pendingLock);
+    m_dirty.insert(recordedid);
+}
+
+void RecordedListCache::UpdateFileSize(uint recordedid, uint64_t filesize)
+{
+    QMutexLocker locker(&m_pendingLock);
+    m_fileSizes[recordedid] = filesize;
+}
+
+/** \brief Fills destination like LoadFromRecorded() would.
+ *
+ *  The caller owns the ProgramInfo copies in destination, the in-use,
+ *  job and recording state is added to them with ApplyRecordedState().
+ *
+ *  \return false if the recordings couldn't be loaded from the database
+ */
+bool RecordedListCache::Get(
+    ProgramList &destination,
+    bool possiblyInProgressRecordingsOnly,
+    const QMap<QString,uint32_t> &inUseMap,
+    const QMap<QString,bool> &isJobRunning,
+    const QMap<QString, ProgramInfo*> &recMap,
+    int sort)
+{
+    destination.clear();
+
+    QDateTime now     = MythDate::current();
+    QDateTime rectime = now.addSecs(
+        -gCoreContext->GetNumSetting("RecordOverTime"));
+
+    vector<ProgramInfo*> not_flagged;
+
+    QMutexLocker locker(&m_lock);
+
+    if (!Refresh())
+        return false;
+
+    size_t count = m_sorted.size();
+    Cache::const_iterator cit = m_cache.begin();
+    for (size_t i = 0; i < count; i++, ++cit)
+    {
+        const ProgramInfo *entry;
+        if (sort > 0)
+            entry = m_sorted[i];
+        else if (sort < 0)
+            entry = m_sorted[count - i - 1];
+        else
+            entry = *cit;
+
+        if (possiblyInProgressRecordingsOnly &&
+            (entry->GetRecordingEndTime() < now ||
+             entry->GetRecordingStartTime() > now))
+        {
+            continue;
+        }
+
+        ProgramInfo *pginfo = new ProgramInfo(*entry);
+        destination.push_back(pginfo);
+
+        if (ApplyRecordedState(*pginfo, rectime, inUseMap, isJobRunning,
+                               recMap))
+        {
+            not_flagged.push_back(pginfo);
+        }
+    }
+
+    locker.unlock();
+
+    // The update events these send will refresh the cached copies
+    vector<ProgramInfo*>::iterator it = not_flagged.begin();
+    for (; it != not_flagged.end(); ++it)
+        (*it)->SaveCommFlagged(COMM_FLAG_NOT_FLAGGED);
+
+    return true;
+}
+
+/// Number of recordings currently in the cache
+uint RecordedListCache::size(void) const
+{
+    QMutexLocker locker(&m_lock);
+    return m_cache.size();
+}
+
+/** \brief Loads recordings from the database.
+ *
+ *  This is only virtual so tests can supply recordings without one.
+ */
+bool RecordedListCache::LoadEntries(
+    ProgramList &destination, const QList<uint> *recordedids)
+{
+    return LoadRecordedEntries(destination, recordedids);
+}
+
+/// Applies the changes noted since the last call, m_lock must be held.
+bool RecordedListCache::Refresh(void)
+{
+    m_pendingLock.lock();
+    bool reload = m_invalid || !m_loaded || m_age.elapsed() > kMaxAge ||
+        m_dirty.size() > kMaxPartialReload;
+    QSet<uint> dirty;
+    QMap<uint,uint64_t> sizes;
+    dirty.swap(m_dirty);
+    sizes.swap(m_fileSizes);
+    m_invalid = false;
+    m_pendingLock.unlock();
+
+    bool changed = reload || !dirty.empty();
+
+    if (reload)
+    {
+        ProgramList list;
+        list.setAutoDelete(false);
+        if (!LoadEntries(list, NULL))
+        {
+            for (ProgramList::iterator it = list.begin();
+                 it != list.end(); ++it)
+            {
+                delete *it;
+            }
+            Invalidate();
+            return false;
+        }
+
+        Clear();
+        for (ProgramList::iterator it = list.begin(); it != list.end(); ++it)
+            m_cache[(*it)->GetRecordingID()] = *it;
+
+        m_loaded = true;
+        m_age.start();
+
+        LOG(VB_GENERAL, LOG_DEBUG, LOC +
+            QString("Loaded %1 recordings").arg(m_cache.size()));
+    }
+    else if (!dirty.empty())
+    {
+        QList<uint> ids = dirty.toList();
+
+        ProgramList list;
+        list.setAutoDelete(false);
+        if (!LoadEntries(list, &ids))
+        {
+            for (ProgramList::iterator it = list.begin();
+                 it != list.end(); ++it)
+            {
+                delete *it;
+            }
+            QMutexLocker locker(&m_pendingLock);
+            m_dirty.unite(dirty);
+            return false;
+        }
+
+        // Anything not found again has been deleted
+        QList<uint>::const_iterator iit = ids.begin();
+        for (; iit != ids.end(); ++iit)
+        {
+            Cache::iterator cit = m_cache.find(*iit);
+            if (cit != m_cache.end())
+            {
+                delete *cit;
+                m_cache.erase(cit);
+            }
+        }
+
+        for (ProgramList::iterator it = list.begin(); it != list.end(); ++it)
+            m_cache[(*it)->GetRecordingID()] = *it;
+
+        LOG(VB_GENERAL, LOG_DEBUG, LOC +
+            QString("Reloaded %1 of %2 recordings")
+                .arg(ids.size()).arg(m_cache.size()));
+    }
+
+    QMap<uint,uint64_t>::const_iterator sit = sizes.begin();
+    for (; sit != sizes.end(); ++sit)
+    {
+        Cache::iterator cit = m_cache.find(sit.key());
+        if (cit != m_cache.end())
+            (*cit)->SetFilesize(*sit);
+    }
+
+    if (changed)
+    {
+        m_sorted.clear();
+        m_sorted.reserve(m_cache.size());
+        for (Cache::const_iterator cit = m_cache.begin();
+             cit != m_cache.end(); ++cit)
+        {
+            m_sorted.push_back(*cit);
+        }
+        std::stable_sort(m_sorted.begin(), m_sorted.end(), recstart_less);
+    }
+
+    return true;
+}
+
+/// Clears the cache, m_lock must be held when this is called.
+void RecordedListCache::Clear(void)
+{
+    for (Cache::iterator it = m_cache.begin(); it != m_cache.end(); ++it)
+        delete *it;
+    m_cache.clear();
+    m_sorted.clear();
+    m_loaded = false;
+}
@@ -0,0 +1,86 @@
+// -*- Mode: c++ -*-
+// vim:set sw=4 ts=4 expandtab:
+#ifndef _RECORDED_LIST_CACHE_H_
+#define _RECORDED_LIST_CACHE_H_
+
+// ANSI C headers
+#include <stdint.h>
+
+// C++ headers
+#include <vector>
+using namespace std;
+
+// Qt headers
+#include <QMutex>
+#include <QMap>
+#include <QSet>
+
+// MythTV headers
+#include "programinfo.h"
+#include "mythtimer.h"
+#include "mythexp.h"
+
+class MythEvent;
+
+/** \brief Copy of the recorded table for answering recordings list requests.
+ *
+ *  The backend gets asked for the full recordings list whenever a
+ *  frontend opens the recordings screen. Rather than reading the whole
+ *  recorded table each time, this keeps the recordings in memory and
+ *  only reloads the ones the RECORDING_LIST_CHANGE, MASTER_UPDATE_REC_INFO
+ *  and UPDATE_FILE_SIZE events say have changed. Everything is reloaded
+ *  when an event doesn't say which recording changed, and at least every
+ *  kMaxAge ms in case the database was changed without sending an event.
+ *
+ *  Events are only noted when they arrive, the database is read by the
+ *  next Get() call so the event thread is never held up by it.
+ */
+class MPUBLIC RecordedListCache
+{
+  public:
+    RecordedListCache();
+    virtual ~RecordedListCache();
+
+    void HandleEvent(const MythEvent &event);
+
+    void Invalidate(void);
+    void Invalidate(uint recordedid);
+    void UpdateFileSize(uint recordedid, uint64_t filesize);
+
+    bool Get(ProgramList &destination,
+             bool possiblyInProgressRecordingsOnly,
+             const QMap<QString,uint32_t> &inUseMap,
+             const QMap<QString,bool> &isJobRunning,
+             const QMap<QString, ProgramInfo*> &recMap,
+             int sort = 0);
+
+    uint size(void) const;
+
+    static const int kMaxAge;
+
+  protected:
+    virtual bool LoadEntries(ProgramList &destination,
+                             const QList<uint> *recordedids);
+
+  private:
+    bool Refresh(void);
+    void Clear(void);
+
+  private:
+    typedef QMap<uint,ProgramInfo*> Cache;
+
+    mutable QMutex          m_lock;
+    Cache                   m_cache;   // protected by m_lock
+    vector<ProgramInfo*>    m_sorted;  // protected by m_lock
+    bool                    m_loaded;  // protected by m_lock
+    MythTimer               m_age;     // protected by m_lock
+
+    QMutex                  m_pendingLock;
+    bool                    m_invalid;   // protected by m_pendingLock
+    QSet<uint>              m_dirty;     // protected by m_pendingLock
+    QMap<uint,uint64_t>     m_fileSizes; // protected by m_pendingLock
+
+    static const int kMaxPartialReload;
+};
+
+#endif // _RECORDED_LIST_CACHE_H_
@@ -0,0 +1,350 @@
+// -*- Mode: c++ -*-
+// vim:set sw=4 ts=4 expandtab:
+
+// ANSI C headers
+#include <cstring>
+
+// Qt headers
+#include <QSaveFile>
+#include <QtEndian>
+
+// MythTV headers
+#include "seekindex.h"
+#include "mythlogging.h"
+#include "remotefile.h"
+
+#define LOC QString("SeekIndex(%1): ").arg(m_filename)
+
+// File layout, all integers little endian:
+//   header:  "MYTHSEEK", u32 version, u32 mark type, s64 recording size,
+//            u32 checkpoint interval, u32 reserved
+//   then for the positions and the durations:
+//            u32 entries, u32 bytes of delta data,
+//            checkpoints: s64 key, s64 value, u32 delta data offset,
+//                         u32 reserved
+//            delta data: zigzag varint key delta, zigzag varint value delta
+//                        for each entry that isn't a checkpoint
+static const char     kMagic[8]        = { 'M','Y','T','H','S','E','E','K' };
+static const uint     kVersion         = 1;
+static const uint     kHeaderSize      = 32;
+static const uint     kSectionSize     = 8;
+static const uint     kCheckpointSize  = 24;
+static const long long kMaxRemoteSize  = 64 * 1024 * 1024;
+
+const uint SeekIndex::kCheckpointInterval = 64;
+
+static void put_varint(QByteArray &buf, int64_t value)
+{
+    uint64_t u = ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+    while (u >= 0x80)
+    {
+        buf += (char)((u & 0x7f) | 0x80);
+        u >>= 7;
+    }
+    buf += (char)u;
+}
+
+static bool get_varint(const uchar *&p, const uchar *end, int64_t &value)
+{
+    uint64_t u = 0;
+    for (int shift = 0; p < end && shift < 64; shift += 7)
+    {
+        uchar b = *p++;
+        u |= (uint64_t)(b & 0x7f) << shift;
+        if (!(b & 0x80))
+        {
+            value = (int64_t)(u >> 1) ^ -(int64_t)(u & 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+static void write_section(QByteArray &out, const frm_pos_map_t &map)
+{
+    QByteArray checkpoints;
+    QByteArray data;
+    int64_t last_key   = 0;
+    int64_t last_value = 0;
+
+    uint i = 0;
+    frm_pos_map_t::const_iterator it = map.begin();
+    for (; it != map.end(); ++it, ++i)
+    {
+        if (i % SeekIndex::kCheckpointInterval == 0)
+        {
+            uchar cp[kCheckpointSize];
+            qToLittleEndian<qint64>(it.key(), &cp[0]);
+            qToLittleEndian<qint64>(*it, &cp[8]);
+            qToLittleEndian<quint32>(data.size(), &cp[16]);
+            qToLittleEndian<quint32>(0, &cp[20]);
+            checkpoints.append((const char*)cp, sizeof(cp));
+        }
+        else
+        {
+            put_varint(data, it.key() - last_key);
+            put_varint(data, *it - last_value);
+        }
+        last_key   = it.key();
+        last_value = *it;
+    }
+
+    uchar section[kSectionSize];
+    qToLittleEndian<quint32>(map.size(), &section[0]);
+    qToLittleEndian<quint32>(data.size(), &section[4]);
+    out.append((const char*)section, sizeof(section));
+    out += checkpoints;
+    out += data;
+}
+
+SeekIndex::Cursor::Cursor(const uchar *checkpoints, uint count,
+                          const uchar *data, const uchar *end) :
+    m_checkpoints(checkpoints), m_count(count), m_index(0),
+    m_data(data), m_end(end), m_ptr(data), m_key(0), m_value(0)
+{
+}
+
+/// Returns the next entry, false at the end or if the index is corrupt
+bool SeekIndex::Cursor::Next(int64_t &key, int64_t &value)
+{
+    if (m_index >= m_count)
+        return false;
+
+    if (m_index % kCheckpointInterval == 0)
+    {
+        const uchar *cp = m_checkpoints +
+            (m_index / kCheckpointInterval) * kCheckpointSize;
+        m_key   = qFromLittleEndian<qint64>(cp);
+        m_value = qFromLittleEndian<qint64>(cp + 8);
+        uint offset = qFromLittleEndian<quint32>(cp + 16);
+        if (offset > (uint)(m_end - m_data))
+        {
+            m_index = m_count;
+            return false;
+        }
+        m_ptr = m_data + offset;
+    }
+    else
+    {
+        int64_t dkey, dvalue;
+        if (!get_varint(m_ptr, m_end, dkey) ||
+            !get_varint(m_ptr, m_end, dvalue))
+        {
+            m_index = m_count;
+            return false;
+        }
+        m_key   += dkey;
+        m_value += dvalue;
+    }
+
+    m_index++;
+    key   = m_key;
+    value = m_value;
+    return true;
+}
+
+SeekIndex::SeekIndex() :
+    m_data(NULL), m_size(0), m_type(MARK_UNSET)
+{
+    memset(m_sections, 0, sizeof(m_sections));
+}
+
+SeekIndex::~SeekIndex()
+{
+    Close();
+}
+
+/** \brief Opens the index of a recording.
+ *  \param recording     local path or myth:// URL of the recording
+ *  \param recordingSize current size of the recording, the index is
+ *                       only used if it was written for this size
+ *  \return true if there is a usable index with at least one position
+ */
+bool SeekIndex::Open(const QString &recording, int64_t recordingSize)
+{
+    Close();
+
+    m_filename = GetIndexName(recording);
+
+    if (RemoteFile::isLocal(m_filename))
+    {
+        m_file.setFileName(m_filename);
+        if (!m_file.exists() || !m_file.open(QIODevice::ReadOnly))
+            return false;
+
+        m_size = m_file.size();
+        m_data = m_file.map(0, m_size);
+        if (!m_data)
+        {
+            m_buffer = m_file.readAll();
+            m_data = (const uchar*) m_buffer.constData();
+            m_size = m_buffer.size();
+        }
+    }
+    else if (m_filename.startsWith("myth://"))
+    {
+        if (!RemoteFile::Exists(m_filename))
+            return false;
+
+        RemoteFile rf(m_filename, false, false);
+        long long size = rf.GetFileSize();
+        if (!rf.isOpen() || size <= 0 || size > kMaxRemoteSize)
+            return false;
+
+        m_buffer.resize(size);
+        long long got = 0;
+        while (got < size)
+        {
+            int ret = rf.Read(m_buffer.data() + got, size - got);
+            if (ret <= 0)
+                break;
+            got += ret;
+        }
+        if (got != size)
+        {
+            m_buffer.clear();
+            return false;
+        }
+        m_data = (const uchar*) m_buffer.constData();
+        m_size = size;
+    }
+    else
+    {
+        return false;
+    }
+
+    if (!Parse(recordingSize))
+    {
+        LOG(VB_FILE, LOG_INFO, LOC + "Ignoring stale or invalid index");
+        Close();
+        return false;
+    }
+
+    LOG(VB_FILE, LOG_INFO, LOC + QString("Opened, %1 positions, %2 bytes")
+        .arg(m_sections[kPositions].count).arg(m_size));
+
+    return true;
+}
+
+void SeekIndex::Close(void)
+{
+    m_file.close();
+    m_buffer.clear();
+    m_data = NULL;
+    m_size = 0;
+    m_type = MARK_UNSET;
+    memset(m_sections, 0, sizeof(m_sections));
+}
+
+SeekIndex::Cursor SeekIndex::GetCursor(Map map) const
+{
+    const Section &s = m_sections[map];
+    return Cursor(s.checkpoints, s.count, s.data, s.end);
+}
+
+bool SeekIndex::Parse(int64_t recordingSize)
+{
+    const uchar *p   = m_data;
+    const uchar *end = m_data + m_size;
+
+    if (m_size < kHeaderSize || memcmp(p, kMagic, sizeof(kMagic)) != 0)
+        return false;
+
+    if (qFromLittleEndian<quint32>(p + 8) != kVersion ||
+        qFromLittleEndian<quint32>(p + 24) != kCheckpointInterval)
+    {
+        return false;
+    }
+
+    int64_t size = qFromLittleEndian<qint64>(p + 16);
+    if (recordingSize > 0 && size != recordingSize)
+        return false;
+
+    m_type = (MarkTypes) qFromLittleEndian<quint32>(p + 12);
+    p += kHeaderSize;
+
+    for (uint i = 0; i < 2; i++)
+    {
+        if ((uint64_t)(end - p) < kSectionSize)
+            return false;
+
+        uint count = qFromLittleEndian<quint32>(p);
+        uint bytes = qFromLittleEndian<quint32>(p + 4);
+        p += kSectionSize;
+
+        uint64_t checkpoints =
+            (count + kCheckpointInterval - 1) / kCheckpointInterval;
+        if ((uint64_t)(end - p) < checkpoints * kCheckpointSize + bytes)
+            return false;
+
+        m_sections[i].count       = count;
+        m_sections[i].checkpoints = p;
+        p += checkpoints * kCheckpointSize;
+        m_sections[i].data        = p;
+        p += bytes;
+        m_sections[i].end         = p;
+    }
+
+    return m_sections[kPositions].count > 0;
+}
+
+/** \brief Writes the index for a local recording.
+ *
+ *  The index is written to a temporary file and renamed into place so
+ *  readers never see a partial index.
+ */
+bool SeekIndex::Write(const QString &recording, int64_t recordingSize,
+                      MarkTypes type, const frm_pos_map_t &posMap,
+                      const frm_pos_map_t &durMap)
+{
+    if (posMap.empty())
+        return false;
+
+    QByteArray out;
+    out.reserve(kHeaderSize + (posMap.size() + durMap.size()) * 5);
+
+    uchar header[kHeaderSize];
+    memcpy(&header[0], kMagic, sizeof(kMagic));
+    qToLittleEndian<quint32>(kVersion, &header[8]);
+    qToLittleEndian<quint32>(type, &header[12]);
+    qToLittleEndian<qint64>(recordingSize, &header[16]);
+    qToLittleEndian<quint32>(kCheckpointInterval, &header[24]);
+    qToLittleEndian<quint32>(0, &header[28]);
+    out.append((const char*)header, sizeof(header));
+
+    write_section(out, posMap);
+    write_section(out, durMap);
+
+    QString filename = GetIndexName(recording);
+    QSaveFile file(filename);
+    if (!file.open(QIODevice::WriteOnly) ||
+        file.write(out) != out.size() || !file.commit())
+    {
+        LOG(VB_GENERAL, LOG_ERR, QString("SeekIndex(%1): Unable to write: %2")
+            .arg(filename).arg(file.errorString()));
+        return false;
+    }
+
+    LOG(VB_FILE, LOG_INFO, QString("SeekIndex(%1): Wrote %2 positions, "
+                                   "%3 durations in %4 bytes")
+        .arg(filename).arg(posMap.size()).arg(durMap.size())
+        .arg(out.size()));
+
+    return true;
+}
+
+/// Deletes the index of a recording, if there is one
+void SeekIndex::Remove(const QString &recording)
+{
+    QString filename = GetIndexName(recording);
+
+    if (RemoteFile::isLocal(filename))
+    {
+        if (QFile::exists(filename))
+            QFile::remove(filename);
+    }
+    else if (filename.startsWith("myth://") && RemoteFile::Exists(filename))
+    {
+        RemoteFile::DeleteFile(filename);
+    }
+}
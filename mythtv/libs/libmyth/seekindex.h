@@ -0,0 +1,102 @@
+// -*- Mode: c++ -*-
+// vim:set sw=4 ts=4 expandtab:
+#ifndef _SEEK_INDEX_H_
+#define _SEEK_INDEX_H_
+
+// ANSI C headers
+#include <stdint.h>
+
+// Qt headers
+#include <QByteArray>
+#include <QString>
+#include <QFile>
+
+// MythTV headers
+#include "programtypes.h"
+#include "mythexp.h"
+
+/** \brief Compact copy of a recording's seek table stored next to it.
+ *
+ *  The recordedseek table holds one row per keyframe, which makes
+ *  loading the seek table of a long recording slow. The recorder also
+ *  writes the keyframe positions and durations to "<recording>.seek"
+ *  when it finishes. Entries are delta encoded as variable length
+ *  integers, with an absolute checkpoint every kCheckpointInterval
+ *  entries so a reader can start decoding in the middle.
+ *
+ *  Local index files are memory mapped, remote ones are read in one
+ *  request. An index is ignored if the recording size no longer matches
+ *  the size it was written for, and callers always fall back to the
+ *  database when there is no usable index.
+ */
+class MPUBLIC SeekIndex
+{
+  public:
+    enum Map
+    {
+        kPositions = 0, ///< keyframe number to byte offset
+        kDurations = 1, ///< keyframe number to duration in ms
+    };
+
+    /// Reads the entries of one of the maps in key order
+    class MPUBLIC Cursor
+    {
+        friend class SeekIndex;
+      public:
+        bool Next(int64_t &key, int64_t &value);
+
+      private:
+        Cursor(const uchar *checkpoints, uint count,
+               const uchar *data, const uchar *end);
+
+        const uchar *m_checkpoints;
+        uint         m_count;
+        uint         m_index;
+        const uchar *m_data;
+        const uchar *m_end;
+        const uchar *m_ptr;
+        int64_t      m_key;
+        int64_t      m_value;
+    };
+
+    SeekIndex();
+    ~SeekIndex();
+
+    bool Open(const QString &recording, int64_t recordingSize);
+    void Close(void);
+    bool IsOpen(void) const { return m_data; }
+
+    MarkTypes GetType(void) const { return m_type; }
+    uint GetCount(Map map) const { return m_sections[map].count; }
+    Cursor GetCursor(Map map) const;
+
+    static QString GetIndexName(const QString &recording)
+        { return recording + ".seek"; }
+    static bool Write(const QString &recording, int64_t recordingSize,
+                      MarkTypes type, const frm_pos_map_t &posMap,
+                      const frm_pos_map_t &durMap);
+    static void Remove(const QString &recording);
+
+    static const uint kCheckpointInterval;
+
+  private:
+    bool Parse(int64_t recordingSize);
+
+    struct Section
+    {
+        uint         count;
+        const uchar *checkpoints;
+        const uchar *data;
+        const uchar *end;
+    };
+
+    QString      m_filename;
+    QFile        m_file;
+    QByteArray   m_buffer;
+    const uchar *m_data;
+    qint64       m_size;
+    MarkTypes    m_type;
+    Section      m_sections[2];
+};
+
+#endif // _SEEK_INDEX_H_
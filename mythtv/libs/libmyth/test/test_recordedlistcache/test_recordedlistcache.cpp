@@ -0,0 +1,3 @@
+#include "test_recordedlistcache.h"
+
+QTEST_GUILESS_MAIN(TestRecordedListCache)
@@ -0,0 +1,248 @@
+/*
+ *  Class TestRecordedListCache
+ *
+ *  Copyright (C) MythTV Developers 2016
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <QtTest/QtTest>
+
+#include "recordedlistcache.h"
+#include "mythcorecontext.h"
+#include "programinfo.h"
+#include "programtypes.h"
+#include "mythevent.h"
+
+/// Serves recordings from a map instead of the recorded table
+class MockRecordedListCache : public RecordedListCache
+{
+  public:
+    MockRecordedListCache() : m_loads(0) { }
+    ~MockRecordedListCache()
+    {
+        QMap<uint,ProgramInfo*>::iterator it = m_table.begin();
+        for (; it != m_table.end(); ++it)
+            delete *it;
+    }
+
+    void Insert(uint recordedid, const QDateTime &recstartts)
+    {
+        ProgramInfo *pginfo = new ProgramInfo(
+            QString("Title %1").arg(recordedid % 100), /* title */
+            QString("Episode %1").arg(recordedid), /* subtitle */
+            "Its a recording.", /* description */
+            "", /* syndicated episode */
+            "", /* category */
+            1000 + recordedid % 50, /* chanid */
+            "", /* channum */
+            "", /* chansign */
+            "", /* channame */
+            "", /* chan playback filters */
+            recstartts, /* start ts */
+            recstartts.addSecs(1800), /* end ts */
+            recstartts, /* rec start ts */
+            recstartts.addSecs(1800), /* rec end ts */
+            "", /* series id */
+            "", /* program id */
+            ProgramInfo::kCategorySeries, /* cat type */
+            0.0f, /* stars */
+            (uint) 0, /* year */
+            (uint) 0, /* part number */
+            (uint) 0, /* part total */
+            QDate(), /* original air date */
+            RecStatus::Recorded, /* rec status */
+            (uint) 0, /* record id */
+            kNotRecording, /* rec type */
+            (uint) 0, /* find id */
+            false, /* comm free */
+            false, /* repeat */
+            (uint) 0, /* video props */
+            (uint) 0, /* audio props */
+            (uint) 0, /* subtitle type */
+            (uint) 0, /* season */
+            (uint) 0, /* episode */
+            (uint) 0, /* total episodes */
+            ProgramList() /* sched List */
+        );
+        pginfo->SetRecordingID(recordedid);
+        Remove(recordedid);
+        m_table[recordedid] = pginfo;
+    }
+
+    void Remove(uint recordedid)
+    {
+        delete m_table.take(recordedid);
+    }
+
+    int         m_loads;
+    QList<uint> m_lastIDs;
+
+  protected:
+    bool LoadEntries(ProgramList &destination, const QList<uint> *recordedids)
+    {
+        m_loads++;
+        m_lastIDs = (recordedids) ? *recordedids : QList<uint>();
+
+        QMap<uint,ProgramInfo*>::const_iterator it = m_table.begin();
+        for (; it != m_table.end(); ++it)
+        {
+            if (!recordedids || recordedids->contains(it.key()))
+                destination.push_back(new ProgramInfo(**it));
+        }
+        return true;
+    }
+
+  private:
+    QMap<uint,ProgramInfo*> m_table;
+};
+
+class TestRecordedListCache : public QObject
+{
+    Q_OBJECT
+
+    QMap<QString,uint32_t>       m_inUseMap;
+    QMap<QString,bool>           m_isJobRunning;
+    QMap<QString, ProgramInfo*>  m_recMap;
+
+    static QDateTime Start(int hours)
+    {
+        return MythDate::fromString("2016-01-01 00:00:00").addSecs(hours * 3600);
+    }
+
+  private slots:
+    // called at the beginning of these sets of tests
+    void initTestCase(void)
+    {
+        gCoreContext = new MythCoreContext("bin_version_unknown", NULL);
+    }
+
+    // called at the end of these sets of tests
+    void cleanupTestCase(void)
+    {
+        delete gCoreContext;
+        gCoreContext = NULL;
+    }
+
+    void Get_test(void)
+    {
+        MockRecordedListCache cache;
+        cache.Insert(1, Start(2));
+        cache.Insert(2, Start(0));
+        cache.Insert(3, Start(1));
+
+        ProgramInfo *inuse = new ProgramInfo();
+        inuse->SetChanID(1003);
+        inuse->SetRecordingStartTime(Start(1));
+        m_inUseMap[inuse->MakeUniqueKey()] = FL_INUSEPLAYING;
+        delete inuse;
+
+        ProgramList list;
+        QVERIFY(cache.Get(list, false, m_inUseMap, m_isJobRunning,
+                          m_recMap, 1));
+        QCOMPARE((int)list.size(), 3);
+        QCOMPARE(list[0]->GetRecordingID(), 2U);
+        QCOMPARE(list[1]->GetRecordingID(), 3U);
+        QCOMPARE(list[2]->GetRecordingID(), 1U);
+        QVERIFY(list[1]->IsInUsePlaying());
+        QVERIFY(!list[0]->IsInUsePlaying());
+
+        QVERIFY(cache.Get(list, false, m_inUseMap, m_isJobRunning,
+                          m_recMap, -1));
+        QCOMPARE(list[0]->GetRecordingID(), 1U);
+        QCOMPARE(list[2]->GetRecordingID(), 2U);
+
+        // nothing recorded in 2016 is still in progress
+        QVERIFY(cache.Get(list, true, m_inUseMap, m_isJobRunning,
+                          m_recMap, 0));
+        QVERIFY(list.empty());
+
+        QCOMPARE(cache.m_loads, 1);
+        m_inUseMap.clear();
+    }
+
+    void Events_test(void)
+    {
+        MockRecordedListCache cache;
+        cache.Insert(1, Start(0));
+        cache.Insert(2, Start(1));
+
+        ProgramList list;
+        QVERIFY(cache.Get(list, false, m_inUseMap, m_isJobRunning, m_recMap));
+        QCOMPARE(cache.m_loads, 1);
+
+        // only the recordings named in events are reloaded
+        cache.Insert(3, Start(2));
+        cache.Remove(1);
+        cache.HandleEvent(MythEvent("RECORDING_LIST_CHANGE ADD 3"));
+        cache.HandleEvent(MythEvent("RECORDING_LIST_CHANGE DELETE 1"));
+        cache.HandleEvent(MythEvent("UPDATE_FILE_SIZE 2 123456"));
+        QVERIFY(cache.Get(list, false, m_inUseMap, m_isJobRunning,
+                          m_recMap, 1));
+        QCOMPARE(cache.m_loads, 2);
+        QCOMPARE(cache.m_lastIDs.size(), 2);
+        QCOMPARE((int)list.size(), 2);
+        QCOMPARE(list[0]->GetRecordingID(), 2U);
+        QCOMPARE(list[0]->GetFilesize(), (uint64_t)123456);
+        QCOMPARE(list[1]->GetRecordingID(), 3U);
+
+        // file sizes don't need the database
+        cache.HandleEvent(MythEvent("UPDATE_FILE_SIZE 3 42"));
+        QVERIFY(cache.Get(list, false, m_inUseMap, m_isJobRunning,
+                          m_recMap, 1));
+        QCOMPARE(cache.m_loads, 2);
+        QCOMPARE(list[1]->GetFilesize(), (uint64_t)42);
+
+        // an event that doesn't say what changed reloads everything
+        cache.HandleEvent(MythEvent("RECORDING_LIST_CHANGE"));
+        QVERIFY(cache.Get(list, false, m_inUseMap, m_isJobRunning, m_recMap));
+        QCOMPARE(cache.m_loads, 3);
+        QVERIFY(cache.m_lastIDs.isEmpty());
+        QCOMPARE(cache.size(), 2U);
+    }
+
+    void Get_benchmark_data(void)
+    {
+        QTest::addColumn<int>("recordings");
+        QTest::newRow("10000 recordings") << 10000;
+        QTest::newRow("25000 recordings") << 25000;
+    }
+
+    /// Time to build a QUERY_RECORDINGS response once the cache is loaded
+    void Get_benchmark(void)
+    {
+        QFETCH(int, recordings);
+
+        MockRecordedListCache cache;
+        for (int i = 1; i <= recordings; i++)
+            cache.Insert(i, Start(i));
+
+        ProgramList list;
+        QVERIFY(cache.Get(list, false, m_inUseMap, m_isJobRunning, m_recMap));
+
+        QBENCHMARK
+        {
+            QVERIFY(cache.Get(list, false, m_inUseMap, m_isJobRunning,
+                              m_recMap, -1));
+            QStringList strlist(QString::number(list.size()));
+            ProgramList::iterator it = list.begin();
+            for (; it != list.end(); ++it)
+                (*it)->ToStringList(strlist);
+        }
+
+        QCOMPARE((int)list.size(), recordings);
+        QCOMPARE(cache.m_loads, 1);
+    }
+};
@@ -0,0 +1,3 @@
+#include "test_seekindex.h"
+
+QTEST_GUILESS_MAIN(TestSeekIndex)
@@ -0,0 +1,160 @@
+/*
+ *  Class TestSeekIndex
+ *
+ *  Copyright (C) MythTV Developers 2016
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+#include <QFile>
+
+#include "seekindex.h"
+#include "mythcorecontext.h"
+#include "programtypes.h"
+
+class TestSeekIndex : public QObject
+{
+    Q_OBJECT
+
+    QTemporaryDir m_dir;
+
+    QString Recording(const QString &name) const
+    {
+        return m_dir.path() + "/" + name;
+    }
+
+    static void Compare(SeekIndex &index, SeekIndex::Map map,
+                        const frm_pos_map_t &expected)
+    {
+        QCOMPARE(index.GetCount(map), (uint)expected.size());
+
+        SeekIndex::Cursor cursor = index.GetCursor(map);
+        frm_pos_map_t::const_iterator it = expected.begin();
+        int64_t key, value;
+        for (; it != expected.end(); ++it)
+        {
+            QVERIFY(cursor.Next(key, value));
+            QCOMPARE(key, (int64_t)it.key());
+            QCOMPARE(value, (int64_t)*it);
+        }
+        QVERIFY(!cursor.Next(key, value));
+    }
+
+    /// A GOP_BYFRAME style seek table of about an hour of 1080i
+    static void MakeMaps(frm_pos_map_t &posMap, frm_pos_map_t &durMap)
+    {
+        long long pos = 376;
+        for (long long frame = 0; frame < 108000; frame += 15)
+        {
+            posMap[frame] = pos;
+            durMap[frame] = frame * 1001 / 30;
+            pos += 500000 + (frame * 7919) % 40000;
+        }
+        // the durations aren't always increasing after a discontinuity
+        durMap[54000] = 12345;
+        // and a recording can start with a negative offset
+        posMap[-15] = 0;
+    }
+
+  private slots:
+    // called at the beginning of these sets of tests
+    void initTestCase(void)
+    {
+        gCoreContext = new MythCoreContext("bin_version_unknown", NULL);
+        QVERIFY(m_dir.isValid());
+    }
+
+    // called at the end of these sets of tests
+    void cleanupTestCase(void)
+    {
+        delete gCoreContext;
+        gCoreContext = NULL;
+    }
+
+    void RoundTrip_test(void)
+    {
+        frm_pos_map_t posMap, durMap;
+        MakeMaps(posMap, durMap);
+
+        QString recording = Recording("1000_20160101000000.ts");
+        QVERIFY(SeekIndex::Write(recording, 4000000000LL, MARK_GOP_BYFRAME,
+                                 posMap, durMap));
+
+        SeekIndex index;
+        QVERIFY(index.Open(recording, 4000000000LL));
+        QVERIFY(index.IsOpen());
+        QCOMPARE(index.GetType(), MARK_GOP_BYFRAME);
+        Compare(index, SeekIndex::kPositions, posMap);
+        Compare(index, SeekIndex::kDurations, durMap);
+
+        // an index without durations is still usable
+        QVERIFY(SeekIndex::Write(recording, 4000000000LL, MARK_GOP_START,
+                                 posMap, frm_pos_map_t()));
+        QVERIFY(index.Open(recording, 4000000000LL));
+        QCOMPARE(index.GetType(), MARK_GOP_START);
+        Compare(index, SeekIndex::kPositions, posMap);
+        QCOMPARE(index.GetCount(SeekIndex::kDurations), 0U);
+
+        SeekIndex::Remove(recording);
+        QVERIFY(!QFile::exists(SeekIndex::GetIndexName(recording)));
+        QVERIFY(!index.Open(recording, 4000000000LL));
+    }
+
+    void Invalid_test(void)
+    {
+        frm_pos_map_t posMap, durMap;
+        MakeMaps(posMap, durMap);
+
+        QString recording = Recording("1001_20160101000000.ts");
+        QVERIFY(!SeekIndex::Write(recording, 1000, MARK_GOP_BYFRAME,
+                                  frm_pos_map_t(), durMap));
+        QVERIFY(SeekIndex::Write(recording, 1000, MARK_GOP_BYFRAME,
+                                 posMap, durMap));
+
+        // the recording was changed after the index was written
+        SeekIndex index;
+        QVERIFY(!index.Open(recording, 2000));
+        QVERIFY(!index.IsOpen());
+
+        // a truncated index is never used
+        QString name = SeekIndex::GetIndexName(recording);
+        QFile file(name);
+        QVERIFY(file.resize(file.size() / 2));
+        QVERIFY(!index.Open(recording, 1000));
+
+        QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        file.write("not a seek index at all, just some text");
+        file.close();
+        QVERIFY(!index.Open(recording, 1000));
+    }
+
+    void Size_test(void)
+    {
+        frm_pos_map_t posMap, durMap;
+        MakeMaps(posMap, durMap);
+
+        QString recording = Recording("1002_20160101000000.ts");
+        QVERIFY(SeekIndex::Write(recording, 1000, MARK_GOP_BYFRAME,
+                                 posMap, durMap));
+
+        // the database stores each entry as a row with a 64 bit key
+        // and value, the index should need well under a quarter of that
+        QFileInfo info(SeekIndex::GetIndexName(recording));
+        qint64 raw = (posMap.size() + durMap.size()) * 16;
+        QVERIFY(info.size() < raw / 4);
+    }
+};
@@ -11,7 +11,9 @@
 #include <QMap>
 #include <QRegExp>
 #include <QVariantMap>
+#include <QThreadStorage>
 #include <iostream>
+#include <algorithm>
 
 using namespace std;
 
@@ -70,7 +72,9 @@ extern "C" {
 
 static QMutex                  logQueueMutex;
 static QQueue<LoggingItem *>   logQueue;
-static QRegExp                 logRegExp = QRegExp("[%]{1,2}");
+static QAtomicInt              logSeq;
+static QAtomicInt              logSleeping; // logger waits for messages,
+                                            // only set with logQueueMutex
 
 static LoggerThread           *logThread = NULL;
 static QMutex                  logThreadMutex;
@@ -98,6 +102,59 @@ QStringList             logPropagateArgList;
 #define TIMESTAMP_MAX 30
 #define MAX_STRING_LENGTH (LOGLINE_MAX+120)
 
+/// Number of records in each thread's LogRing, must be a power of two
+#define LOGRING_SIZE 32
+
+/// \brief A log message as LOG() leaves it in the calling thread's LogRing.
+///        This is plain data so logging never allocates in the caller, the
+///        logging thread turns it into a LoggingItem.
+struct LogRecord
+{
+    uint        seq;
+    int         type;
+    LogLevel_t  level;
+    int         line;
+    const char *file;       ///< from __FILE__, so never freed
+    const char *function;   ///< from __FUNCTION__, so never freed
+    uint64_t    threadId;
+    int64_t     tid;
+    qlonglong   epoch;
+    uint        usec;
+    char        message[LOGLINE_MAX+1];
+};
+
+/// \brief Single producer, single consumer ring of LogRecords.  The owning
+///        thread fills records at m_head and the logging thread empties
+///        them at m_tail, so neither side takes a lock.
+class LogRing
+{
+  public:
+    LogRing() : m_threadId(0), m_tid(0) {}
+
+    uint64_t    m_threadId;
+    int64_t     m_tid;
+    QAtomicInt  m_head;     ///< Next record to fill, written by the owner
+    QAtomicInt  m_tail;     ///< Next record to empty, written by the logger
+    QAtomicInt  m_orphaned; ///< Set once the owning thread has exited
+    LogRecord   m_records[LOGRING_SIZE];
+};
+
+/// \brief Thread local handle on a LogRing.  When the thread exits this
+///        hands the ring over to the logging thread, which frees it once
+///        it has been emptied.
+class LogRingRef
+{
+  public:
+    explicit LogRingRef(LogRing *ring) : m_ring(ring) {}
+    ~LogRingRef() { m_ring->m_orphaned.storeRelease(1); }
+
+    LogRing *m_ring;
+};
+
+static QMutex                       logRingMutex;
+static QList<LogRing *>             logRings;   // protected by logRingMutex
+static QThreadStorage<LogRingRef *> logRingStorage;
+
 LogLevel_t logLevel = (LogLevel_t)LOG_INFO;
 
 bool verboseInitialized = false;
@@ -148,7 +205,7 @@ LoggingItem::LoggingItem() :
         m_pid(-1), m_tid(-1), m_threadId(-1), m_usec(0), m_line(0),
         m_type(kMessage), m_level((LogLevel_t)LOG_INFO), m_facility(0), m_epoch(0),
         m_file(NULL), m_function(NULL), m_threadName(NULL), m_appName(NULL),
-        m_table(NULL), m_logFile(NULL)
+        m_table(NULL), m_logFile(NULL), m_seq(0)
 {
     m_message[0]='\0';
     m_message[LOGLINE_MAX]='\0';
@@ -160,7 +217,8 @@ LoggingItem::LoggingItem(const char *_file, const char *_function,
         m_threadId((uint64_t)(QThread::currentThreadId())),
         m_line(_line), m_type(_type), m_level(_level), m_facility(0),
         m_file(strdup(_file)), m_function(strdup(_function)),
-        m_threadName(NULL), m_appName(NULL), m_table(NULL), m_logFile(NULL)
+        m_threadName(NULL), m_appName(NULL), m_table(NULL), m_logFile(NULL),
+        m_seq(0)
 {
     loggingGetTimeStamp(&m_epoch, &m_usec);
 
@@ -226,28 +284,189 @@ int64_t LoggingItem::getThreadTid(void)
 ///        The intention is to get a thread ID that will map well to what is
 ///        shown in gdb.
 void LoggingItem::setThreadTid(void)
+{
+    m_tid = loggingCurrentTid(m_threadId);
+}
+
+/// \brief Look up, or work out and remember, the thread ID of the calling
+///        thread.
+/// \param threadId    Qt's handle of the calling thread
+int64_t loggingCurrentTid(uint64_t threadId)
 {
     QMutexLocker locker(&logThreadTidMutex);
 
-    m_tid = logThreadTidHash.value(m_threadId, -1);
-    if (m_tid == -1)
+    int64_t tid = logThreadTidHash.value(threadId, -1);
+    if (tid == -1)
     {
-        m_tid = 0;
+        tid = 0;
 
 #if defined(Q_OS_ANDROID)
-        m_tid = (int64_t)gettid();
+        tid = (int64_t)gettid();
 #elif defined(linux)
-        m_tid = (int64_t)syscall(SYS_gettid);
+        tid = (int64_t)syscall(SYS_gettid);
 #elif defined(__FreeBSD__)
         long lwpid;
         int dummy = thr_self( &lwpid );
         (void)dummy;
-        m_tid = (int64_t)lwpid;
+        tid = (int64_t)lwpid;
 #elif CONFIG_DARWIN
-        m_tid = (int64_t)mach_thread_self();
+        tid = (int64_t)mach_thread_self();
 #endif
-        logThreadTidHash[m_threadId] = m_tid;
+        logThreadTidHash[threadId] = tid;
+    }
+    return tid;
+}
+
+/// \brief Get the calling thread's LogRing, creating it on first use.
+static LogRing *logRingGet(void)
+{
+    LogRingRef *ref = logRingStorage.localData();
+    if (ref)
+        return ref->m_ring;
+
+    LogRing *ring = new LogRing;
+    ring->m_threadId = (uint64_t)(QThread::currentThreadId());
+    ring->m_tid      = loggingCurrentTid(ring->m_threadId);
+    logRingStorage.setLocalData(new LogRingRef(ring));
+
+    QMutexLocker locker(&logRingMutex);
+    logRings.append(ring);
+    return ring;
+}
+
+/// \brief Claim the next free record in the calling thread's LogRing and
+///        fill in everything but the message.
+/// \return The record to write the message into, or NULL if the ring is
+///         full and the message has to go onto logQueue instead.
+static LogRecord *logRingClaim(LogRing *ring, int type, LogLevel_t level,
+                               const char *file, int line,
+                               const char *function)
+{
+    uint head = ring->m_head.load();
+    if (head - (uint)ring->m_tail.loadAcquire() >= LOGRING_SIZE)
+        return NULL;
+
+    LogRecord *rec = &ring->m_records[head % LOGRING_SIZE];
+    rec->type     = type;
+    rec->level    = level;
+    rec->line     = line;
+    rec->file     = file;
+    rec->function = function;
+    rec->threadId = ring->m_threadId;
+    rec->tid      = ring->m_tid;
+    loggingGetTimeStamp(&rec->epoch, &rec->usec);
+    return rec;
+}
+
+/// \brief Wake the logging thread if it is waiting for messages.
+static void logWake(void)
+{
+    QMutexLocker qLock(&logQueueMutex);
+    if (logSleeping.loadAcquire() && logThread)
+        logThread->wake();
+}
+
+/// \brief Make the record claimed by logRingClaim() visible to the logging
+///        thread.  The logging thread is woken for the first record after
+///        it emptied the ring and again once the ring is half full, so
+///        bursts are handed over in batches without taking a lock per
+///        message.
+static void logRingPublish(LogRing *ring, LogRecord *rec)
+{
+    rec->seq = logSeq.fetchAndAddOrdered(1);
+    uint head = ring->m_head.load() + 1;
+    ring->m_head.fetchAndStoreOrdered(head);
+
+    uint fill = head - (uint)ring->m_tail.loadAcquire();
+    if ((fill == 1 || fill == LOGRING_SIZE / 2) && logSleeping.loadAcquire())
+        logWake();
+}
+
+/// \brief Copy a message that has already been formatted into the fixed
+///        size buffer of a log message.  Like printf, "%%" is copied as "%"
+///        as some callers escape their QString messages.
+static void logCopyMessage(char *dst, const char *message)
+{
+    char *end = dst + LOGLINE_MAX;
+    while (*message && dst < end)
+    {
+        if (message[0] == '%' && message[1] == '%')
+            message++;
+        *dst++ = *message++;
     }
+    *dst = '\0';
+}
+
+/// \brief Orders LoggingItems by when they were logged.
+static bool logItemBefore(const LoggingItem *a, const LoggingItem *b)
+{
+    return (int)(a->seq() - b->seq()) < 0;
+}
+
+/// \brief Move all waiting messages out of the thread LogRings and logQueue,
+///        in the order they were logged.  Rings of threads that have exited
+///        are freed once empty.  Must be called with logQueueMutex held.
+/// \param items   Receives the messages, the caller must DecrRef() them
+static void logTakeAll(QList<LoggingItem *> &items)
+{
+    {
+        QMutexLocker locker(&logRingMutex);
+
+        QList<LogRing *>::iterator it = logRings.begin();
+        while (it != logRings.end())
+        {
+            LogRing *ring = *it;
+            // read before emptying, nothing is added once this is set
+            bool orphaned = ring->m_orphaned.loadAcquire();
+
+            uint head = ring->m_head.loadAcquire();
+            uint tail = ring->m_tail.load();
+            for (; tail != head; ++tail)
+            {
+                items.append(LoggingItem::create(
+                                 ring->m_records[tail % LOGRING_SIZE]));
+            }
+            ring->m_tail.storeRelease(tail);
+
+            if (orphaned)
+            {
+                delete ring;
+                it = logRings.erase(it);
+                continue;
+            }
+            ++it;
+        }
+    }
+
+    while (!logQueue.isEmpty())
+        items.append(logQueue.dequeue());
+
+    if (items.size() > 1)
+        std::stable_sort(items.begin(), items.end(), logItemBefore);
+}
+
+/// \brief Check for messages that have not been taken by logTakeAll() yet.
+///        Must be called with logQueueMutex held.
+static bool logPending(void)
+{
+    if (!logQueue.isEmpty())
+        return true;
+
+    QMutexLocker locker(&logRingMutex);
+    foreach (LogRing *ring, logRings)
+    {
+        if (ring->m_head.loadAcquire() != ring->m_tail.loadAcquire())
+            return true;
+    }
+    return false;
+}
+
+/// \brief Put a message onto logQueue, used when the calling thread's
+///        LogRing is full.  Must be called with logQueueMutex held.
+static void logEnqueue(LoggingItem *item)
+{
+    item->setSeq(logSeq.fetchAndAddOrdered(1));
+    logQueue.enqueue(item);
 }
 
 /// \brief LoggerThread constructor.  Enables debugging of thread registration
@@ -386,27 +605,36 @@ void LoggerThread::run(void)
 
     QMutexLocker qLock(&logQueueMutex);
 
-    while (!m_aborted || !logQueue.isEmpty())
+    while (!m_aborted || logPending())
     {
         qLock.unlock();
         qApp->processEvents(QEventLoop::AllEvents, 10);
         qApp->sendPostedEvents(NULL, QEvent::DeferredDelete);
 
         qLock.relock();
-        if (logQueue.isEmpty())
+        QList<LoggingItem *> items;
+        logTakeAll(items);
+        if (items.isEmpty())
         {
             m_waitEmpty->wakeAll();
-            m_waitNotEmpty->wait(qLock.mutex(), 100);
+            // Producers wake us once logSleeping is set, check again for
+            // a message that was published before they could see it.  The
+            // timeout only keeps the event processing above going.
+            logSleeping.fetchAndStoreOrdered(1);
+            if (!logPending())
+                m_waitNotEmpty->wait(qLock.mutex(), 100);
+            logSleeping.fetchAndStoreOrdered(0);
             continue;
         }
-
-        LoggingItem *item = logQueue.dequeue();
         qLock.unlock();
 
-        fillItem(item);
-        handleItem(item);
-        logConsole(item);
-        item->DecrRef();
+        foreach (LoggingItem *item, items)
+        {
+            fillItem(item);
+            handleItem(item);
+            logConsole(item);
+            item->DecrRef();
+        }
 
         qLock.relock();
     }
@@ -705,14 +933,14 @@ bool LoggerThread::flush(int timeoutMS)
 {
     QTime t;
     t.start();
-    while (!m_aborted && !logQueue.isEmpty() && t.elapsed() < timeoutMS)
+    while (!m_aborted && logPending() && t.elapsed() < timeoutMS)
     {
         m_waitNotEmpty->wakeAll();
         int left = timeoutMS - t.elapsed();
         if (left > 0)
             m_waitEmpty->wait(&logQueueMutex, left);
     }
-    return logQueue.isEmpty();
+    return !logPending();
 }
 
 void LoggerThread::fillItem(LoggingItem *item)
@@ -746,6 +974,33 @@ LoggingItem *LoggingItem::create(const char *_file,
     return item;
 }
 
+/// \brief  Create a new LoggingItem from a message left in a LogRing
+/// \param  rec     the message
+/// \return LoggingItem that was created
+LoggingItem *LoggingItem::create(const LogRecord &rec)
+{
+    LoggingItem *item = new LoggingItem;
+
+    item->m_seq      = rec.seq;
+    item->m_type     = (LoggingType)rec.type;
+    item->m_level    = rec.level;
+    item->m_line     = rec.line;
+    item->m_file     = strdup(rec.file);
+    item->m_function = strdup(rec.function);
+    item->m_threadId = rec.threadId;
+    item->m_tid      = rec.tid;
+    item->m_epoch    = rec.epoch;
+    item->m_usec     = rec.usec;
+
+    // registrations carry the thread name in place of a message
+    if (rec.type & kRegistering)
+        item->m_threadName = strdup(rec.message);
+    else
+        strcpy(item->m_message, rec.message);
+
+    return item;
+}
+
 LoggingItem *LoggingItem::create(QByteArray &buf)
 {
     // Deserialize buffer
@@ -778,27 +1033,48 @@ void LogPrintLine( uint64_t mask, LogLevel_t level, const char *file, int line,
     int type = kMessage;
     type |= (mask & VB_FLUSH) ? kFlush : 0;
     type |= (mask & VB_STDIO) ? kStandardIO : 0;
+
+    // Flushes need the logging thread to see the message straight away,
+    // and once it has finished messages are handled right here.
+    if (!logThreadFinished && !(type & kFlush))
+    {
+        LogRing *ring = logRingGet();
+        LogRecord *rec = logRingClaim(ring, type, level, file, line, function);
+        if (rec)
+        {
+            if (fromQString)
+                logCopyMessage(rec->message, format);
+            else
+            {
+                va_start(arguments, format);
+                vsnprintf(rec->message, LOGLINE_MAX, format, arguments);
+                va_end(arguments);
+            }
+
+#if defined( _MSC_VER ) && defined( _DEBUG )
+            OutputDebugStringA( rec->message );
+            OutputDebugStringA( "\n" );
+#endif
+
+            logRingPublish(ring, rec);
+            return;
+        }
+    }
+
     LoggingItem *item = LoggingItem::create(file, function, line, level,
                                             (LoggingType)type);
     if (!item)
         return;
 
-    char *formatcopy = NULL;
-    if( fromQString && strchr(format, '%') )
+    if (fromQString)
+        logCopyMessage(item->m_message, format);
+    else
     {
-        QString string(format);
-        format = strdup(string.replace(logRegExp, "%%").toLocal8Bit()
-                              .constData());
-        formatcopy = (char *)format;
+        va_start(arguments, format);
+        vsnprintf(item->m_message, LOGLINE_MAX, format, arguments);
+        va_end(arguments);
     }
 
-    va_start(arguments, format);
-    vsnprintf(item->m_message, LOGLINE_MAX, format, arguments);
-    va_end(arguments);
-
-    if (formatcopy)
-        free(formatcopy);
-
     QMutexLocker qLock(&logQueueMutex);
 
 #if defined( _MSC_VER ) && defined( _DEBUG )
@@ -806,18 +1082,19 @@ void LogPrintLine( uint64_t mask, LogLevel_t level, const char *file, int line,
         OutputDebugStringA( "\n" );
 #endif
 
-    logQueue.enqueue(item);
+    logEnqueue(item);
 
     if (logThread && logThreadFinished && !logThread->isRunning())
     {
-        while (!logQueue.isEmpty())
+        QList<LoggingItem *> items;
+        logTakeAll(items);
+        qLock.unlock();
+
+        foreach (item, items)
         {
-            item = logQueue.dequeue();
-            qLock.unlock();
             logThread->handleItem(item);
             logThread->logConsole(item);
             item->DecrRef();
-            qLock.relock();
         }
     }
     else if (logThread && !logThreadFinished && (type & kFlush))
@@ -963,6 +1240,18 @@ void loggingRegisterThread(const QString &name)
     if (logThreadFinished)
         return;
 
+    QByteArray threadName = name.toLocal8Bit();
+
+    LogRing *ring = logRingGet();
+    LogRecord *rec = logRingClaim(ring, kRegistering, (LogLevel_t)LOG_DEBUG,
+                                  __FILE__, __LINE__, __FUNCTION__);
+    if (rec)
+    {
+        logCopyMessage(rec->message, threadName.constData());
+        logRingPublish(ring, rec);
+        return;
+    }
+
     QMutexLocker qLock(&logQueueMutex);
 
     LoggingItem *item = LoggingItem::create(__FILE__, __FUNCTION__,
@@ -970,8 +1259,8 @@ void loggingRegisterThread(const QString &name)
                                             kRegistering);
     if (item)
     {
-        item->setThreadName((char *)name.toLocal8Bit().constData());
-        logQueue.enqueue(item);
+        item->setThreadName((char *)threadName.constData());
+        logEnqueue(item);
     }
 }
 
@@ -982,13 +1271,23 @@ void loggingDeregisterThread(void)
     if (logThreadFinished)
         return;
 
+    LogRing *ring = logRingGet();
+    LogRecord *rec = logRingClaim(ring, kDeregistering, (LogLevel_t)LOG_DEBUG,
+                                  __FILE__, __LINE__, __FUNCTION__);
+    if (rec)
+    {
+        rec->message[0] = '\0';
+        logRingPublish(ring, rec);
+        return;
+    }
+
     QMutexLocker qLock(&logQueueMutex);
 
     LoggingItem *item = LoggingItem::create(__FILE__, __FUNCTION__, __LINE__,
                                             (LogLevel_t)LOG_DEBUG,
                                             kDeregistering);
     if (item)
-        logQueue.enqueue(item);
+        logEnqueue(item);
 }
 
 
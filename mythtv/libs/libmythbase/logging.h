@@ -38,10 +38,12 @@ namespace nzmqt {
 class QString;
 class MSqlQuery;
 class LoggingItem;
+struct LogRecord;
 
 void loggingRegisterThread(const QString &name);
 void loggingDeregisterThread(void);
 void loggingGetTimeStamp(qlonglong *epoch, uint *usec);
+int64_t loggingCurrentTid(uint64_t threadId);
 
 class QWaitCondition;
 
@@ -97,8 +99,13 @@ class LoggingItem: public QObject, public ReferenceCounter
     static LoggingItem *create(const char *, const char *, int, LogLevel_t,
                                LoggingType);
     static LoggingItem *create(QByteArray &buf);
+    static LoggingItem *create(const LogRecord &rec);
     QByteArray toByteArray(void);
 
+    /// Order in which the message was logged, not sent to mythlogserver
+    uint                seq() const         { return m_seq; };
+    void setSeq(const uint val)             { m_seq = val; };
+
     int                 pid() const         { return m_pid; };
     qlonglong           tid() const         { return m_tid; };
     qulonglong          threadId() const    { return m_threadId; };
@@ -162,6 +169,7 @@ class LoggingItem: public QObject, public ReferenceCounter
     char               *m_table;
     char               *m_logFile;
     char                m_message[LOGLINE_MAX+1];
+    uint                m_seq;
 
   private:
     LoggingItem();
@@ -185,6 +193,8 @@ class LoggerThread : public QObject, public MThread
     void run(void);
     void stop(void);
     bool flush(int timeoutMS = 200000);
+    /// Wake the thread waiting for messages, logQueueMutex must be held
+    void wake(void) { m_waitNotEmpty->wakeAll(); }
     void handleItem(LoggingItem *item);
     void fillItem(LoggingItem *item);
   private:
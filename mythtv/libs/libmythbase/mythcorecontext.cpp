@@ -1536,9 +1536,10 @@ bool MythCoreContext::CheckProtoVersion(MythSocket *socket, uint timeout_ms,
     if (!socket)
         return false;
 
-    QStringList strlist(QString("MYTH_PROTO_VERSION %1 %2")
+    QStringList strlist(QString("MYTH_PROTO_VERSION %1 %2 %3")
                         .arg(MYTH_PROTO_VERSION)
-                        .arg(QString::fromUtf8(MYTH_PROTO_TOKEN)));
+                        .arg(QString::fromUtf8(MYTH_PROTO_TOKEN))
+                        .arg(MythSocket::kBinaryStringListsToken));
     socket->WriteStringList(strlist);
 
     if (!socket->ReadStringList(strlist, timeout_ms) || strlist.empty())
@@ -1578,6 +1579,11 @@ bool MythCoreContext::CheckProtoVersion(MythSocket *socket, uint timeout_ms,
                                 .arg(QString::fromUtf8(MYTH_PROTO_TOKEN)));
         }
 
+        // Backends that don't know the binary encoding just don't echo it
+        if (strlist.size() >= 3 &&
+            strlist[2] == MythSocket::kBinaryStringListsToken)
+            socket->SetBinaryStringLists(true);
+
         return true;
     }
 
@@ -18,8 +18,10 @@ extern "C" {
 // Helper for checking verbose mask & level outside of LOG macro
 #define VERBOSE_LEVEL_NONE        (verboseMask == 0)
 #ifdef __cplusplus
+// Component levels are rarely used, so test for them with an inline size
+// check before doing a map lookup on every disabled message.
 #define VERBOSE_LEVEL_CHECK(_MASK_, _LEVEL_) \
-    (componentLogLevel.contains(_MASK_) ?                               \
+    ((!componentLogLevel.isEmpty() && componentLogLevel.contains(_MASK_)) ? \
      (*(componentLogLevel.find(_MASK_)) >= _LEVEL_) :                   \
      (((verboseMask & (_MASK_)) == (_MASK_)) && logLevel >= (_LEVEL_)))
 #else
@@ -32,8 +34,10 @@ extern "C" {
 // There are two LOG macros now.  One for use with Qt/C++, one for use
 // without Qt.
 //
-// Neither of them will lock the calling thread other than momentarily to put
-// the log message onto a queue.
+// Neither of them will lock the calling thread.  The log message is copied
+// into a ring owned by the calling thread and formatted for output by the
+// logging thread.  Only if that ring is full is the message put onto a
+// shared queue, which locks momentarily.
 #ifdef __cplusplus
 #define LOG(_MASK_, _LEVEL_, _STRING_)                                  \
     do {                                                                \
@@ -8,6 +8,7 @@
 #include <QHostInfo>
 #include <QThread>
 #include <QMetaType>
+#include <QtEndian>
 
 // setsockopt -- has to be after Qt includes for Q_OS_WIN definition
 #if defined(Q_OS_WIN)
@@ -17,6 +18,11 @@
 #else
 #include <sys/socket.h>
 #endif
+#ifdef __linux__
+#include <sys/sendfile.h>
+#include <poll.h>
+#endif
+#include <cerrno>
 #include <unistd.h> // for usleep (and socket code on Q_OS_WIN)
 #include <algorithm> // for min/max
 using std::max;
@@ -39,6 +45,7 @@ using std::vector;
 
 const uint MythSocket::kShortTimeout = kMythSocketShortTimeout;
 const uint MythSocket::kLongTimeout  = kMythSocketLongTimeout;
+const char *MythSocket::kBinaryStringListsToken = "BINARY";
 
 const int MythSocket::kSocketReceiveBufferSize = 128 * 1024;
 
@@ -88,6 +95,7 @@ MythSocket::MythSocket(
     m_callback(cb),
     m_useSharedThread(use_shared_thread),
     m_disableReadyReadCallback(false),
+    m_binaryStringLists(0),
     m_connected(false),
     m_dataAvailable(0),
     m_isValidated(false),
@@ -181,6 +189,25 @@ MythSocket::~MythSocket()
     m_tcpSocket = NULL;
 }
 
+/** \brief Runs one of the *Real() methods on the socket's thread.
+ *
+ *  Calls from other threads block until the method has run.
+ */
+void MythSocket::Invoke(const char *method,
+                        QGenericArgument val0, QGenericArgument val1,
+                        QGenericArgument val2, QGenericArgument val3)
+{
+    if (QThread::currentThread() == m_thread->qthread())
+    {
+        QMetaObject::invokeMethod(this, method, Qt::DirectConnection,
+                                  val0, val1, val2, val3);
+        return;
+    }
+
+    QMetaObject::invokeMethod(this, method, Qt::BlockingQueuedConnection,
+                              val0, val1, val2, val3);
+}
+
 void MythSocket::ConnectHandler(void)
 {
     {
@@ -297,24 +324,28 @@ bool MythSocket::ConnectToHost(
     const QHostAddress &hadr, quint16 port)
 {
     bool ret = false;
-    QMetaObject::invokeMethod(
-        this, "ConnectToHostReal",
-        (QThread::currentThread() != m_thread->qthread()) ?
-        Qt::BlockingQueuedConnection : Qt::DirectConnection,
+    Invoke(
+        "ConnectToHostReal",
         Q_ARG(QHostAddress, hadr),
         Q_ARG(quint16, port),
         Q_ARG(bool*, &ret));
     return ret;
 }
 
-bool MythSocket::WriteStringList(const QStringList &list)
+/** \brief Writes a string list to the peer.
+ *
+ *  If binaryAfterWrite is set the list is written in the current encoding
+ *  and the socket then switches to binary string lists, on the socket's
+ *  thread and before any other read or write on it is handled.
+ */
+bool MythSocket::WriteStringList(const QStringList &list,
+                                 bool binaryAfterWrite)
 {
     bool ret = false;
-    QMetaObject::invokeMethod(
-        this, "WriteStringListReal",
-        (QThread::currentThread() != m_thread->qthread()) ?
-        Qt::BlockingQueuedConnection : Qt::DirectConnection,
+    Invoke(
+        "WriteStringListReal",
         Q_ARG(const QStringList*, &list),
+        Q_ARG(bool, binaryAfterWrite),
         Q_ARG(bool*, &ret));
     return ret;
 }
@@ -322,10 +353,8 @@ bool MythSocket::WriteStringList(const QStringList &list)
 bool MythSocket::ReadStringList(QStringList &list, uint timeoutMS)
 {
     bool ret = false;
-    QMetaObject::invokeMethod(
-        this, "ReadStringListReal",
-        (QThread::currentThread() != m_thread->qthread()) ?
-        Qt::BlockingQueuedConnection : Qt::DirectConnection,
+    Invoke(
+        "ReadStringListReal",
         Q_ARG(QStringList*, &list),
         Q_ARG(uint, timeoutMS),
         Q_ARG(bool*, &ret));
@@ -414,9 +443,10 @@ bool MythSocket::Validate(uint timeout_ms, bool error_dialog_desired)
     if (m_isValidated)
         return true;
 
-    QStringList strlist(QString("MYTH_PROTO_VERSION %1 %2")
+    QStringList strlist(QString("MYTH_PROTO_VERSION %1 %2 %3")
                         .arg(MYTH_PROTO_VERSION)
-                        .arg(QString::fromUtf8(MYTH_PROTO_TOKEN)));
+                        .arg(QString::fromUtf8(MYTH_PROTO_TOKEN))
+                        .arg(kBinaryStringListsToken));
 
     WriteStringList(strlist);
 
@@ -450,6 +480,9 @@ bool MythSocket::Validate(uint timeout_ms, bool error_dialog_desired)
     {
         LOG(VB_GENERAL, LOG_NOTICE, QString("Using protocol version %1 %2")
             .arg(MYTH_PROTO_VERSION).arg(QString::fromUtf8(MYTH_PROTO_TOKEN)));
+        // Backends that don't know the binary encoding just don't echo it
+        if (strlist.size() >= 3 && strlist[2] == kBinaryStringListsToken)
+            SetBinaryStringLists(true);
         m_isValidated = true;
     }
     else
@@ -514,19 +547,14 @@ void MythSocket::DisconnectFromHost(void)
                     "MythSocket(0x%1)").arg(reinterpret_cast<intptr_t>(this),0,16));
         return;
     }
-    QMetaObject::invokeMethod(
-        this, "DisconnectFromHostReal",
-        (QThread::currentThread() != m_thread->qthread()) ?
-        Qt::BlockingQueuedConnection : Qt::DirectConnection);
+    Invoke("DisconnectFromHostReal");
 }
 
 int MythSocket::Write(const char *data, int size)
 {
     int ret = -1;
-    QMetaObject::invokeMethod(
-        this, "WriteReal",
-        (QThread::currentThread() != m_thread->qthread()) ?
-        Qt::BlockingQueuedConnection : Qt::DirectConnection,
+    Invoke(
+        "WriteReal",
         Q_ARG(const char*, data),
         Q_ARG(int, size),
         Q_ARG(int*, &ret));
@@ -536,10 +564,8 @@ int MythSocket::Write(const char *data, int size)
 int MythSocket::Read(char *data, int size, int max_wait_ms)
 {
     int ret = -1;
-    QMetaObject::invokeMethod(
-        this, "ReadReal",
-        (QThread::currentThread() != m_thread->qthread()) ?
-        Qt::BlockingQueuedConnection : Qt::DirectConnection,
+    Invoke(
+        "ReadReal",
         Q_ARG(char*, data),
         Q_ARG(int, size),
         Q_ARG(int, max_wait_ms),
@@ -547,12 +573,29 @@ int MythSocket::Read(char *data, int size, int max_wait_ms)
     return ret;
 }
 
+/** \brief Sends size bytes of the open file fd, starting at offset,
+ *         directly from the page cache to the socket.
+ *
+ *  \return number of bytes sent, which is less than size at EOF,
+ *          or -1 if the zero-copy path is not available or failed
+ *          before sending anything; the caller must then fall back
+ *          to Write().
+ */
+int MythSocket::SendFile(int fd, long long offset, int size)
+{
+    int ret = -1;
+    Invoke(
+        "SendFileReal",
+        Q_ARG(int, fd),
+        Q_ARG(long long, offset),
+        Q_ARG(int, size),
+        Q_ARG(int*, &ret));
+    return ret;
+}
+
 void MythSocket::Reset(void)
 {
-    QMetaObject::invokeMethod(
-        this, "ResetReal",
-        (QThread::currentThread() != m_thread->qthread()) ?
-        Qt::BlockingQueuedConnection : Qt::DirectConnection);
+    Invoke("ResetReal");
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -573,10 +616,8 @@ bool MythSocket::IsDataAvailable(void) const
 
     bool ret = false;
 
-    QMetaObject::invokeMethod(
-        const_cast<MythSocket*>(this), "IsDataAvailableReal",
-        Qt::BlockingQueuedConnection,
-        Q_ARG(bool*, &ret));
+    const_cast<MythSocket*>(this)->Invoke(
+        "IsDataAvailableReal", Q_ARG(bool*, &ret));
 
     return ret;
 }
@@ -737,7 +778,115 @@ void MythSocket::DisconnectFromHostReal(void)
     m_tcpSocket->disconnectFromHost();
 }
 
-void MythSocket::WriteStringListReal(const QStringList *list, bool *ret)
+/// Field tags of the binary string list encoding
+enum
+{
+    kWireEmpty   = 0, ///< Empty string, no data follows
+    kWireInteger = 1, ///< 8 byte big endian signed integer
+    kWireString  = 2, ///< 4 byte big endian length followed by UTF-8
+};
+
+/// Returns true if str is an integer that QString::number() gives back as is
+static bool is_wire_integer(const QString &str)
+{
+    int len = str.length();
+    int i = (len > 1 && str[0] == QChar('-')) ? 1 : 0;
+    if (len - i < 1 || len - i > 18)
+        return false;
+    if (str[i] == QChar('0'))
+        return len == 1;
+    for (; i < len; i++)
+    {
+        ushort c = str[i].unicode();
+        if (c < '0' || c > '9')
+            return false;
+    }
+    return true;
+}
+
+/** \brief Encodes a string list for a connection using binary string lists.
+ *
+ *  Every item is a one byte tag followed by its data. Integers, which
+ *  includes the timestamps in ProgramInfo lists, are sent as fixed width
+ *  binary, other strings as length prefixed UTF-8, so items may contain
+ *  any text including the "[]:[]" separator of the text encoding.
+ */
+QByteArray MythSocket::EncodeStringList(const QStringList &list)
+{
+    QByteArray payload;
+    payload.reserve(list.size() * 9);
+
+    QStringList::const_iterator it = list.begin();
+    for (; it != list.end(); ++it)
+    {
+        if (it->isEmpty())
+        {
+            payload += (char) kWireEmpty;
+        }
+        else if (is_wire_integer(*it))
+        {
+            uchar buf[9];
+            buf[0] = kWireInteger;
+            qToBigEndian((qint64) it->toLongLong(), &buf[1]);
+            payload.append((const char*) buf, sizeof(buf));
+        }
+        else
+        {
+            QByteArray utf8 = it->toUtf8();
+            uchar buf[5];
+            buf[0] = kWireString;
+            qToBigEndian((quint32) utf8.size(), &buf[1]);
+            payload.append((const char*) buf, sizeof(buf));
+            payload += utf8;
+        }
+    }
+
+    return payload;
+}
+
+/// Decodes a payload made by EncodeStringList(), returns false if malformed
+bool MythSocket::DecodeStringList(const QByteArray &payload, QStringList &list)
+{
+    list.clear();
+
+    const uchar *p   = (const uchar*) payload.constData();
+    const uchar *end = p + payload.size();
+    while (p < end)
+    {
+        uchar tag = *p++;
+        if (tag == kWireEmpty)
+        {
+            list.push_back(QString(""));
+        }
+        else if (tag == kWireInteger)
+        {
+            if (end - p < 8)
+                return false;
+            list.push_back(QString::number(qFromBigEndian<qint64>(p)));
+            p += 8;
+        }
+        else if (tag == kWireString)
+        {
+            if (end - p < 4)
+                return false;
+            quint32 len = qFromBigEndian<quint32>(p);
+            p += 4;
+            if ((quint32)(end - p) < len)
+                return false;
+            list.push_back(QString::fromUtf8((const char*) p, len));
+            p += len;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    return !list.empty();
+}
+
+void MythSocket::WriteStringListReal(
+    const QStringList *list, bool binaryAfterWrite, bool *ret)
 {
     if (list->empty())
     {
@@ -755,16 +904,25 @@ void MythSocket::WriteStringListReal(const QStringList *list, bool *ret)
         return;
     }
 
-    QString str = list->join("[]:[]");
-    if (str.isEmpty())
+    bool binary = m_binaryStringLists.loadAcquire();
+    QByteArray utf8;
+    if (binary)
     {
-        LOG(VB_GENERAL, LOG_ERR, LOC +
-            "WriteStringList: Error, joined null string.");
-        *ret = false;
-        return;
+        utf8 = EncodeStringList(*list);
+    }
+    else
+    {
+        QString str = list->join("[]:[]");
+        if (str.isEmpty())
+        {
+            LOG(VB_GENERAL, LOG_ERR, LOC +
+                "WriteStringList: Error, joined null string.");
+            *ret = false;
+            return;
+        }
+        utf8 = str.toUtf8();
     }
 
-    QByteArray utf8 = str.toUtf8();
     int size = utf8.length();
     int written = 0;
     int written_since_timer_restart = 0;
@@ -779,7 +937,9 @@ void MythSocket::WriteStringListReal(const QStringList *list, bool *ret)
     if (VERBOSE_LEVEL_CHECK(VB_NETWORK, LOG_INFO))
     {
         QString msg = QString("write -> %1 %2")
-            .arg(m_tcpSocket->socketDescriptor(), 2).arg(payload.data());
+            .arg(m_tcpSocket->socketDescriptor(), 2)
+            .arg((binary) ? QString(payload.left(8)) + list->join("[]:[]") :
+                 QString(payload.data()));
 
         if (logLevel < LOG_DEBUG && msg.length() > 88)
         {
@@ -835,6 +995,9 @@ void MythSocket::WriteStringListReal(const QStringList *list, bool *ret)
 
     m_tcpSocket->flush();
 
+    if (binaryAfterWrite)
+        SetBinaryStringLists(true);
+
     *ret = true;
     return;
 }
@@ -968,16 +1131,33 @@ void MythSocket::ReadStringListReal(
         }
     }
 
-    QString str = QString::fromUtf8(utf8.data());
-
-    QByteArray payload;
-    payload = payload.setNum(str.length());
-    payload += "        ";
-    payload.truncate(8);
-    payload += str;
+    if (m_binaryStringLists.loadAcquire())
+    {
+        utf8.truncate(readoffset);
+        if (!DecodeStringList(utf8, *list))
+        {
+            LOG(VB_GENERAL, LOG_ERR, LOC +
+                QString("Protocol error: malformed binary string list "
+                        "of %1 bytes.").arg(readoffset));
+            ResetReal();
+            return;
+        }
+    }
+    else
+    {
+        *list = QString::fromUtf8(utf8.data()).split("[]:[]");
+    }
 
     if (VERBOSE_LEVEL_CHECK(VB_NETWORK, LOG_INFO))
     {
+        QString str = list->join("[]:[]");
+
+        QByteArray payload;
+        payload = payload.setNum(str.length());
+        payload += "        ";
+        payload.truncate(8);
+        payload += str;
+
         QString msg = QString("read  <- %1 %2")
             .arg(m_tcpSocket->socketDescriptor(), 2)
             .arg(payload.data());
@@ -990,8 +1170,6 @@ void MythSocket::ReadStringListReal(
         LOG(VB_NETWORK, LOG_INFO, LOC + msg);
     }
 
-    *list = str.split("[]:[]");
-
     m_dataAvailable.fetchAndStoreOrdered(
         (m_tcpSocket->bytesAvailable() > 0) ? 1 : 0);
 
@@ -1026,6 +1204,70 @@ void MythSocket::ReadReal(char *data, int size, int max_wait_ms, int *ret)
         (m_tcpSocket->bytesAvailable() > 0) ? 1 : 0);
 }
 
+void MythSocket::SendFileReal(int fd, long long offset, int size, int *ret)
+{
+#ifdef __linux__
+    // Anything already queued by QTcpSocket must go out first
+    while (m_tcpSocket->bytesToWrite() > 0)
+    {
+        if (!m_tcpSocket->waitForBytesWritten(kLongTimeout))
+        {
+            *ret = -1;
+            return;
+        }
+    }
+
+    int sock = m_tcpSocket->socketDescriptor();
+    off_t off = offset;
+    int sent = 0;
+    MythTimer t; t.start();
+
+    while (sent < size)
+    {
+        ssize_t n = sendfile(sock, fd, &off, size - sent);
+        if (n > 0)
+        {
+            sent += n;
+            continue;
+        }
+        if (n == 0)
+            break; // EOF
+
+        if (errno == EINTR)
+            continue;
+        if (errno != EAGAIN)
+        {
+            LOG(VB_SOCKET, LOG_ERR, LOC + "SendFile() failed" + ENO);
+            break;
+        }
+
+        // QTcpSocket uses non-blocking sockets, wait for buffer space
+        struct pollfd pfd;
+        pfd.fd = sock;
+        pfd.events = POLLOUT;
+        pfd.revents = 0;
+        int left = (int)kLongTimeout - t.elapsed();
+        if (left <= 0 || poll(&pfd, 1, left) <= 0)
+        {
+            LOG(VB_SOCKET, LOG_ERR, LOC + "SendFile() timed out");
+            break;
+        }
+    }
+
+    if (t.elapsed() > 50)
+    {
+        LOG(VB_NETWORK, LOG_INFO,
+            QString("SendFileReal(%1, %2, %3) -> %4 took %5 ms")
+            .arg(fd).arg(offset).arg(size).arg(sent).arg(t.elapsed()));
+    }
+
+    *ret = (sent > 0 || size == 0) ? sent : -1;
+#else
+    (void) fd; (void) offset; (void) size;
+    *ret = -1;
+#endif
+}
+
 void MythSocket::ResetReal(void)
 {
     vector<char> trash;
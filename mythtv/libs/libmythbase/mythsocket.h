@@ -54,7 +54,18 @@ class MBASE_PUBLIC MythSocket : public QObject, public ReferenceCounter
         uint timeoutMS = kLongTimeout);
 
     bool ReadStringList(QStringList &list, uint timeoutMS = kShortTimeout);
-    bool WriteStringList(const QStringList &list);
+    bool WriteStringList(const QStringList &list,
+                         bool binaryAfterWrite = false);
+
+    /// Switches string lists to the binary encoding, both ends of the
+    /// connection must agree on this in MYTH_PROTO_VERSION.
+    /// A server answering MYTH_PROTO_VERSION must use
+    /// WriteStringList(reply, true) instead, so the switch happens on
+    /// the socket thread before the client's next request can be read.
+    void SetBinaryStringLists(bool enabled)
+        { m_binaryStringLists.fetchAndStoreOrdered((enabled) ? 1 : 0); }
+    bool IsUsingBinaryStringLists(void) const
+        { return m_binaryStringLists.loadAcquire() != 0; }
 
     bool IsConnected(void) const;
     bool IsDataAvailable(void) const;
@@ -66,10 +77,15 @@ class MBASE_PUBLIC MythSocket : public QObject, public ReferenceCounter
     // RemoteFile stuff
     int Write(const char*, int size);
     int Read(char*, int size, int max_wait_ms);
+    int SendFile(int fd, long long offset, int size);
     void Reset(void);
 
     static const uint kShortTimeout;
     static const uint kLongTimeout;
+    static const char *kBinaryStringListsToken;
+
+    static QByteArray EncodeStringList(const QStringList &list);
+    static bool DecodeStringList(const QByteArray &payload, QStringList &list);
 
   signals:
     void CallReadyRead(void);
@@ -83,12 +99,14 @@ class MBASE_PUBLIC MythSocket : public QObject, public ReferenceCounter
     void CallReadyReadHandler(void);
 
     void ReadStringListReal(QStringList *list, uint timeoutMS, bool *ret);
-    void WriteStringListReal(const QStringList *list, bool *ret);
+    void WriteStringListReal(const QStringList *list, bool binaryAfterWrite,
+                             bool *ret);
     void ConnectToHostReal(QHostAddress address, quint16 port, bool *ret);
     void DisconnectFromHostReal(void);
 
     void WriteReal(const char*, int size, int *ret);
     void ReadReal(char*, int size, int max_wait_ms, int *ret);
+    void SendFileReal(int fd, long long offset, int size, int *ret);
     void ResetReal(void);
 
     void IsDataAvailableReal(bool *ret) const;
@@ -96,6 +114,12 @@ class MBASE_PUBLIC MythSocket : public QObject, public ReferenceCounter
   protected:
     ~MythSocket(); // force reference counting
 
+    void Invoke(const char *method,
+                QGenericArgument val0 = QGenericArgument(),
+                QGenericArgument val1 = QGenericArgument(),
+                QGenericArgument val2 = QGenericArgument(),
+                QGenericArgument val3 = QGenericArgument());
+
     QTcpSocket     *m_tcpSocket; // only set in ctor
     MThread        *m_thread; // only set in ctor
     mutable QMutex  m_lock;
@@ -105,6 +129,7 @@ class MBASE_PUBLIC MythSocket : public QObject, public ReferenceCounter
     MythSocketCBs  *m_callback; // only set in ctor
     bool            m_useSharedThread; // only set in ctor
     QAtomicInt      m_disableReadyReadCallback;
+    QAtomicInt      m_binaryStringLists;
     bool            m_connected; // protected by m_lock
     /// This is used internally as a hint that there might be
     /// data available for reading.
@@ -0,0 +1,238 @@
+/*
+ *  Class TestLogging
+ *
+ *  Copyright (C) MythTV Developers 2016
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <QtTest/QtTest>
+#include <QTemporaryFile>
+#include <QSemaphore>
+#include <QThread>
+
+#include "mythlogging.h"
+
+/// Logs like a recorder thread with VB_RECORD debugging turned on
+class LoggingThread : public QThread
+{
+  public:
+    explicit LoggingThread(int count) : m_count(count) { }
+
+    void run(void)
+    {
+        for (int i = 0; i < m_count; i++)
+            LOG(VB_RECORD, LOG_INFO, "DTVRec: Wrote a block of packets");
+    }
+
+    int m_count;
+};
+
+/// Takes turns with a partner thread, each logging every other message
+class PingPongThread : public QThread
+{
+  public:
+    PingPongThread(int first, int count, QSemaphore *mine, QSemaphore *theirs) :
+        m_first(first), m_count(count), m_mine(mine), m_theirs(theirs) { }
+
+    void run(void)
+    {
+        for (int i = m_first; i < m_count; i += 2)
+        {
+            m_mine->acquire();
+            LOG(VB_GENERAL, LOG_INFO, QString("Order %1").arg(i));
+            m_theirs->release();
+        }
+    }
+
+    int         m_first;
+    int         m_count;
+    QSemaphore *m_mine;
+    QSemaphore *m_theirs;
+};
+
+class TestLogging: public QObject
+{
+    Q_OBJECT
+
+    static const int kMessages = 10000;
+
+    /// Logs kMessages messages from each of threads threads at once
+    void LogFromThreads(int threads)
+    {
+        QList<LoggingThread*> list;
+        for (int i = 0; i < threads; i++)
+            list.push_back(new LoggingThread(kMessages));
+
+        foreach (LoggingThread *thread, list)
+            thread->start();
+
+        foreach (LoggingThread *thread, list)
+        {
+            thread->wait();
+            delete thread;
+        }
+    }
+
+    QTemporaryFile *m_console;
+    int             m_stdout;
+
+    /// Starts logging to the console, with the console sent to a file
+    void StartCapture(void)
+    {
+        delete m_console;
+        m_console = new QTemporaryFile();
+        QVERIFY(m_console->open());
+        fflush(stdout);
+        m_stdout = dup(1);
+        QVERIFY(dup2(m_console->handle(), 1) >= 0);
+        logStart("", 0, 0, -1, LOG_INFO, false, false, true);
+    }
+
+    /// Stops logging, once everything queued has been written, and
+    /// returns the messages that were logged containing marker
+    QStringList StopCapture(const QString &marker)
+    {
+        logStop();
+        dup2(m_stdout, 1);
+        close(m_stdout);
+
+        QStringList messages;
+        QFile file(m_console->fileName());
+        if (!file.open(QIODevice::ReadOnly))
+            return messages;
+        while (!file.atEnd())
+        {
+            // "<date> <time> <level>  <message>"
+            QString line = QString::fromUtf8(file.readLine()).trimmed();
+            int start = line.indexOf("  ");
+            if (start >= 0 && line.contains(marker))
+                messages.push_back(line.mid(start + 2));
+        }
+        return messages;
+    }
+
+    static void StartQuiet(void)
+    {
+        // quiet console, no mythlogserver, so only the queuing is measured
+        logStart("", 0, 1, -1, LOG_INFO, false, false, true);
+    }
+
+  private slots:
+    // called at the beginning of these sets of tests
+    void initTestCase(void)
+    {
+        m_console = NULL;
+        verboseMask = VB_GENERAL | VB_RECORD;
+    }
+
+    // called at the end of these sets of tests
+    void cleanupTestCase(void)
+    {
+        logStop();
+        delete m_console;
+    }
+
+    void VerboseLevelCheck_test(void)
+    {
+        QVERIFY(VERBOSE_LEVEL_CHECK(VB_RECORD, LOG_INFO));
+        QVERIFY(!VERBOSE_LEVEL_CHECK(VB_RECORD, LOG_DEBUG));
+        QVERIFY(!VERBOSE_LEVEL_CHECK(VB_PLAYBACK, LOG_INFO));
+    }
+
+    /// Must run before anything has started the logging thread,
+    /// so nothing empties this thread's LogRing while it is filled.
+    void RingFull_test(void)
+    {
+        const int kCount = 100; // the ring holds 32
+        for (int i = 0; i < kCount; i++)
+            LOG(VB_GENERAL, LOG_INFO, QString("Backlog %1").arg(i));
+
+        StartCapture();
+        QStringList messages = StopCapture("Backlog");
+        QCOMPARE(messages.size(), kCount);
+        for (int i = 0; i < kCount; i++)
+            QCOMPARE(messages[i], QString("Backlog %1").arg(i));
+    }
+
+    void ThreadOrder_test(void)
+    {
+        const int kCount = 200;
+        QSemaphore even(1), odd(0);
+        PingPongThread a(0, kCount, &even, &odd);
+        PingPongThread b(1, kCount, &odd, &even);
+
+        StartCapture();
+        a.start();
+        b.start();
+        a.wait();
+        b.wait();
+        QStringList messages = StopCapture("Order");
+
+        // each thread has its own ring, the output follows the order
+        // the messages were logged in rather than the ring they were in
+        QCOMPARE(messages.size(), kCount);
+        for (int i = 0; i < kCount; i++)
+            QCOMPARE(messages[i], QString("Order %1").arg(i));
+    }
+
+    void Percent_test(void)
+    {
+        StartCapture();
+        LOG(VB_GENERAL, LOG_INFO, QString("Percent: %1%% done").arg(50));
+        LOG(VB_GENERAL, LOG_INFO, "Percent: 100% done");
+        LOG(VB_GENERAL, LOG_INFO, "Percent: %%%% stays %%");
+        LOG(VB_GENERAL, LOG_INFO, "Percent: trailing %");
+        QStringList messages = StopCapture("Percent:");
+
+        QCOMPARE(messages.size(), 4);
+        QCOMPARE(messages[0], QString("Percent: 50% done"));
+        QCOMPARE(messages[1], QString("Percent: 100% done"));
+        QCOMPARE(messages[2], QString("Percent: %% stays %"));
+        QCOMPARE(messages[3], QString("Percent: trailing %"));
+    }
+
+    void Disabled_benchmark(void)
+    {
+        StartQuiet();
+        QBENCHMARK
+        {
+            for (int i = 0; i < kMessages; i++)
+                LOG(VB_PLAYBACK, LOG_DEBUG, "Player: Decoded a frame");
+        }
+    }
+
+    void Enabled_benchmark_data(void)
+    {
+        QTest::addColumn<int>("threads");
+        QTest::newRow("1 thread")  << 1;
+        QTest::newRow("4 threads") << 4;
+        QTest::newRow("8 threads") << 8;
+    }
+
+    void Enabled_benchmark(void)
+    {
+        QFETCH(int, threads);
+
+        StartQuiet();
+        QBENCHMARK
+        {
+            LogFromThreads(threads);
+        }
+    }
+};
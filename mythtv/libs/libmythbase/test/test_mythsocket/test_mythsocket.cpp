@@ -0,0 +1,7 @@
+#include "test_mythsocket.h"
+
+#if QT_VERSION < QT_VERSION_CHECK(5, 0, 0)
+QTEST_MAIN(TestMythSocket)
+#else
+QTEST_GUILESS_MAIN(TestMythSocket)
+#endif
@@ -0,0 +1,242 @@
+/*
+ *  Class TestMythSocket
+ *
+ *  Copyright (C) MythTV Developers 2016
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+#include <vector>
+using std::vector;
+
+#include <QtTest/QtTest>
+#include <QTemporaryFile>
+#include <QTcpServer>
+#include <QThread>
+
+#include "mythsocket.h"
+#include "mythqtcompat.h"
+
+#if QT_VERSION < QT_VERSION_CHECK(5, 0, 0)
+#define MSKIP(MSG) QSKIP(MSG, SkipSingle)
+#else
+#define MSKIP(MSG) QSKIP(MSG)
+#endif
+
+/// Accepts one connection and keeps the raw descriptor for MythSocket
+class RawTcpServer : public QTcpServer
+{
+  public:
+    RawTcpServer() : m_fd(-1) { }
+    qt_socket_fd_t m_fd;
+
+  protected:
+    void incomingConnection(qt_socket_fd_t fd) { m_fd = fd; }
+};
+
+/// Reads and discards everything until the peer closes the connection
+class SocketDrain : public QThread
+{
+  public:
+    explicit SocketDrain(int fd) : m_fd(fd), m_total(0) { }
+
+    void run(void)
+    {
+        vector<char> buf(256 * 1024);
+        ssize_t n;
+        while ((n = read(m_fd, &buf[0], buf.size())) > 0)
+            m_total += n;
+    }
+
+    int    m_fd;
+    qint64 m_total;
+};
+
+class TestMythSocket: public QObject
+{
+    Q_OBJECT
+
+    static const int kFileSize  = 32 * 1024 * 1024;
+    static const int kBlockSize = 256 * 1024; // typical RemoteFile request
+
+    QTemporaryFile  m_file;
+    RawTcpServer    m_server;
+    MythSocket     *m_sock;
+    int             m_client;
+    SocketDrain    *m_drain;
+
+    /// Streams the whole file like FileTransfer::RequestBlock() does
+    qint64 TransferFile(bool zerocopy)
+    {
+        vector<char> buf(kBlockSize);
+        qint64 pos = 0;
+        while (true)
+        {
+            int ret;
+            if (zerocopy)
+                ret = m_sock->SendFile(m_file.handle(), pos, kBlockSize);
+            else
+            {
+                ret = pread(m_file.handle(), &buf[0], kBlockSize, pos);
+                if (ret > 0)
+                    ret = m_sock->Write(&buf[0], ret);
+            }
+            if (ret <= 0)
+                break;
+            pos += ret;
+        }
+        return pos;
+    }
+
+  private slots:
+    // called at the beginning of these sets of tests
+    void initTestCase(void)
+    {
+        m_sock = NULL;
+        m_drain = NULL;
+        m_client = -1;
+
+        QVERIFY(m_file.open());
+        QByteArray block(kBlockSize, 'm');
+        for (int i = 0; i < kFileSize / kBlockSize; i++)
+            QCOMPARE(m_file.write(block), (qint64)kBlockSize);
+        QVERIFY(m_file.flush());
+
+        QVERIFY(m_server.listen(QHostAddress::LocalHost));
+
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(m_server.serverPort());
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        m_client = socket(AF_INET, SOCK_STREAM, 0);
+        QVERIFY(m_client >= 0);
+        QCOMPARE(::connect(m_client, (struct sockaddr*)&addr, sizeof(addr)), 0);
+
+        QVERIFY(m_server.waitForNewConnection(5000));
+        QVERIFY(m_server.m_fd >= 0);
+
+        m_sock = new MythSocket(m_server.m_fd, NULL, false);
+        m_drain = new SocketDrain(m_client);
+        m_drain->start();
+    }
+
+    // called at the end of these sets of tests
+    void cleanupTestCase(void)
+    {
+        if (m_sock)
+            m_sock->DecrRef();
+        if (m_drain)
+        {
+            m_drain->wait();
+            delete m_drain;
+        }
+        if (m_client >= 0)
+            close(m_client);
+    }
+
+    void SendFile_test(void)
+    {
+#ifndef __linux__
+        MSKIP("sendfile() zero-copy transfers are only implemented on Linux");
+#endif
+        QCOMPARE(TransferFile(true), (qint64)kFileSize);
+        QCOMPARE(m_sock->SendFile(m_file.handle(), kFileSize, kBlockSize), 0);
+    }
+
+    void BinaryStringList_test(void)
+    {
+        QStringList list;
+        list << "QUERY_RECORDINGS Play" << "" << "0" << "-1" << "42"
+             << "1461168000" << "007" << "-0" << "1e3" << "+5"
+             << "1234567890123456789" << "Title[]:[]with separator"
+             << QString::fromUtf8("Sch\xc3\xb6ne Gr\xc3\xbc\xc3\x9f""e");
+
+        QByteArray payload = MythSocket::EncodeStringList(list);
+        QStringList decoded;
+        QVERIFY(MythSocket::DecodeStringList(payload, decoded));
+        QCOMPARE(decoded, list);
+
+        // truncated items are rejected
+        QVERIFY(!MythSocket::DecodeStringList(payload.left(payload.size() - 1),
+                                              decoded));
+        QVERIFY(!MythSocket::DecodeStringList(QByteArray(), decoded));
+    }
+
+    /// A request sent as soon as the client reads the ACCEPT reply must
+    /// already be decoded in the binary encoding by the server.
+    void BinaryHandshake_test(void)
+    {
+        RawTcpServer server;
+        QVERIFY(server.listen(QHostAddress::LocalHost));
+
+        MythSocket *client = new MythSocket();
+        QVERIFY(client->ConnectToHost(QHostAddress(QHostAddress::LocalHost),
+                                      server.serverPort()));
+        QVERIFY(server.waitForNewConnection(5000));
+        QVERIFY(server.m_fd >= 0);
+        MythSocket *backend = new MythSocket(server.m_fd, NULL);
+
+        QStringList strlist(QString("MYTH_PROTO_VERSION 88 XmasGift %1")
+                            .arg(MythSocket::kBinaryStringListsToken));
+        QVERIFY(client->WriteStringList(strlist));
+        QVERIFY(backend->ReadStringList(strlist));
+        QCOMPARE(strlist.size(), 1);
+
+        QStringList accept;
+        accept << "ACCEPT" << "88" << MythSocket::kBinaryStringListsToken;
+        QVERIFY(backend->WriteStringList(accept, true));
+        QVERIFY(backend->IsUsingBinaryStringLists());
+
+        QVERIFY(client->ReadStringList(strlist));
+        QCOMPARE(strlist, accept);
+        QVERIFY(!client->IsUsingBinaryStringLists());
+        client->SetBinaryStringLists(true);
+
+        QStringList request;
+        request << "QUERY_RECORDINGS Play" << "" << "1461168000"
+                << "Title[]:[]with separator";
+        QVERIFY(client->WriteStringList(request));
+        QVERIFY(backend->ReadStringList(strlist));
+        QCOMPARE(strlist, request);
+
+        backend->DecrRef();
+        client->DecrRef();
+    }
+
+    void Write_benchmark(void)
+    {
+        QBENCHMARK
+        {
+            TransferFile(false);
+        }
+    }
+
+    void SendFile_benchmark(void)
+    {
+#ifndef __linux__
+        MSKIP("sendfile() zero-copy transfers are only implemented on Linux");
+#endif
+        QBENCHMARK
+        {
+            TransferFile(true);
+        }
+    }
+};
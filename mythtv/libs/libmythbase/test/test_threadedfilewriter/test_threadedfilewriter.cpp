@@ -0,0 +1,7 @@
+#include "test_threadedfilewriter.h"
+
+#if QT_VERSION < QT_VERSION_CHECK(5, 0, 0)
+QTEST_MAIN(TestThreadedFileWriter)
+#else
+QTEST_GUILESS_MAIN(TestThreadedFileWriter)
+#endif
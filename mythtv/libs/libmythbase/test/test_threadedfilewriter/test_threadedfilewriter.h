@@ -0,0 +1,138 @@
+/*
+ *  Class TestThreadedFileWriter
+ *
+ *  Copyright (C) MythTV Developers 2016
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <sys/stat.h>
+#include <fcntl.h>
+
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QFileInfo>
+
+#include "threadedfilewriter.h"
+#include "mythcorecontext.h"
+
+/// Feeds one ThreadedFileWriter the way a DTV recorder does, a few
+/// TS packets at a time.
+class RecordingWriter : public QThread
+{
+  public:
+    static const uint kPacketSize = 188 * 7;
+
+    RecordingWriter(const QString &fn, qint64 total) :
+        m_tfw(fn, O_WRONLY | O_TRUNC | O_CREAT, 0644), m_total(total) { }
+
+    void run(void)
+    {
+        char packet[kPacketSize];
+        memset(packet, 0x47, sizeof(packet));
+        for (qint64 done = 0; done < m_total; done += kPacketSize)
+            m_tfw.Write(packet, kPacketSize);
+        m_tfw.Flush();
+    }
+
+    ThreadedFileWriter m_tfw;
+    qint64             m_total;
+};
+
+class TestThreadedFileWriter: public QObject
+{
+    Q_OBJECT
+
+    /// Roughly 10 seconds of an HD recording per writer
+    static const qint64 kRecordingSize = 24 * 1024 * 1024;
+
+    QTemporaryDir m_dir;
+
+    /// Writes kRecordingSize bytes to each of writers files concurrently
+    void WriteRecordings(int writers, uint kbps)
+    {
+        QList<RecordingWriter*> threads;
+        for (int i = 0; i < writers; i++)
+        {
+            QString fn = m_dir.path() + QString("/rec%1.ts").arg(i);
+            RecordingWriter *writer = new RecordingWriter(fn, kRecordingSize);
+            QVERIFY(writer->m_tfw.Open());
+            writer->m_tfw.SetBlocking(true);
+            if (kbps)
+                writer->m_tfw.SetExpectedBitrate(kbps);
+            threads.push_back(writer);
+        }
+
+        foreach (RecordingWriter *writer, threads)
+            writer->start();
+
+        foreach (RecordingWriter *writer, threads)
+        {
+            writer->wait();
+            delete writer;
+        }
+    }
+
+  private slots:
+    // called at the beginning of these sets of tests
+    void initTestCase(void)
+    {
+        QVERIFY(m_dir.isValid());
+        gCoreContext = new MythCoreContext("bin_version_unknown", NULL);
+    }
+
+    // called at the end of these sets of tests
+    void cleanupTestCase(void)
+    {
+        delete gCoreContext;
+        gCoreContext = NULL;
+    }
+
+    void Write_test(void)
+    {
+        WriteRecordings(2, 0);
+
+        for (int i = 0; i < 2; i++)
+        {
+            QFileInfo info(m_dir.path() + QString("/rec%1.ts").arg(i));
+            qint64 packet  = RecordingWriter::kPacketSize;
+            qint64 packets = (kRecordingSize + packet - 1) / packet;
+            // preallocated space must not show up in the file size
+            QCOMPARE(info.size(), packets * packet);
+        }
+    }
+
+    void MultiWriter_benchmark_data(void)
+    {
+        QTest::addColumn<int>("writers");
+        QTest::addColumn<uint>("kbps");
+        QTest::newRow("1 writer")               << 1 << 0U;
+        QTest::newRow("4 writers")              << 4 << 0U;
+        QTest::newRow("8 writers")              << 8 << 0U;
+        QTest::newRow("8 writers, HD bitrate")  << 8 << 19400U;
+    }
+
+    void MultiWriter_benchmark(void)
+    {
+        QFETCH(int, writers);
+        QFETCH(uint, kbps);
+
+        QBENCHMARK
+        {
+            WriteRecordings(writers, kbps);
+        }
+    }
+};
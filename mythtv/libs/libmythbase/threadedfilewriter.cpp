@@ -3,6 +3,9 @@
 #include <cstdlib>
 #include <cerrno>
 
+// C++ headers
+#include <algorithm>
+
 // Unix C headers
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -15,6 +18,7 @@
 #include <QString>
 
 // MythTV headers
+#include "mythconfig.h"
 #include "threadedfilewriter.h"
 #include "mythlogging.h"
 #include "mythcorecontext.h"
@@ -44,6 +48,28 @@ void TFWSyncThread::run(void)
 const uint ThreadedFileWriter::kMaxBufferSize   = 8 * 1024 * 1024;
 const uint ThreadedFileWriter::kMinWriteSize    = 64 * 1024;
 const uint ThreadedFileWriter::kMaxBlockSize    = 1 * 1024 * 1024;
+const uint ThreadedFileWriter::kMinPreallocSize = 64 * 1024 * 1024;
+const uint ThreadedFileWriter::kPreallocSeconds = 60;
+
+/// Buffers are aligned to the page size so the kernel can copy them
+/// a page at a time.
+static const size_t kBufferAlign = 4096;
+
+ThreadedFileWriter::TFWBuffer::TFWBuffer() : data(NULL), size(0)
+{
+#if HAVE_POSIX_MEMALIGN
+    void *ptr = NULL;
+    if (posix_memalign(&ptr, kBufferAlign, kMaxBlockSize) == 0)
+        data = (char*) ptr;
+#endif
+    if (!data)
+        data = (char*) malloc(kMaxBlockSize);
+}
+
+ThreadedFileWriter::TFWBuffer::~TFWBuffer()
+{
+    free(data);
+}
 
 /** \class ThreadedFileWriter
  *  \brief This class supports the writing of recordings to disk.
@@ -68,6 +94,9 @@ ThreadedFileWriter::ThreadedFileWriter(const QString &fname,
     flush(false),                        in_dtor(false),
     ignore_writes(false),                tfw_min_write_size(kMinWriteSize),
     totalBufferUse(0),
+    // preallocation
+    m_preallocate(false),                m_preallocEnd(0),
+    m_writePos(0),                       m_expectedRate(0),
     // threads
     writeThread(NULL),                   syncThread(NULL),
     m_warned(false),                     m_blocking(false),
@@ -90,6 +119,7 @@ bool ThreadedFileWriter::ReOpen(QString newFilename)
 
     if (fd >= 0)
     {
+        ReleasePreallocation();
         close(fd);
         fd = -1;
     }
@@ -133,6 +163,16 @@ bool ThreadedFileWriter::Open(void)
     gCoreContext->RegisterFileForWrite(filename);
     m_registered = true;
 
+    {
+        QMutexLocker locker(&buflock);
+        struct stat st;
+        m_preallocate = (fstat(fd, &st) == 0) && S_ISREG(st.st_mode);
+        m_preallocEnd = 0;
+        m_writePos    = lseek(fd, 0, SEEK_CUR);
+        if (m_writePos < 0)
+            m_writePos = 0;
+    }
+
     LOG(VB_FILE, LOG_INFO, LOC + "Open() successful");
 
 #ifdef _WIN32
@@ -195,6 +235,7 @@ ThreadedFileWriter::~ThreadedFileWriter()
 
     if (fd >= 0)
     {
+        ReleasePreallocation();
         close(fd);
         fd = -1;
     }
@@ -224,7 +265,14 @@ uint ThreadedFileWriter::Write(const void *data, uint count)
 
     while (written < count)
     {
-        uint towrite = (left > kMaxBlockSize) ? kMaxBlockSize : left;
+        // Fill the last queued buffer before starting a new one
+        uint room = kMaxBlockSize;
+        if (!writeBuffers.empty() &&
+            writeBuffers.back()->size < kMaxBlockSize)
+        {
+            room = kMaxBlockSize - writeBuffers.back()->size;
+        }
+        uint towrite = (left > room) ? room : left;
 
         if ((totalBufferUse + towrite) > (kMaxBufferSize * (m_blocking ? 1 : 8)))
         {
@@ -262,11 +310,9 @@ uint ThreadedFileWriter::Write(const void *data, uint count)
 
         TFWBuffer *buf = NULL;
 
-        if (!writeBuffers.empty() &&
-            (writeBuffers.back()->data.size() + towrite) < kMinWriteSize)
+        if (room < kMaxBlockSize)
         {
             buf = writeBuffers.back();
-            writeBuffers.pop_back();
         }
         else
         {
@@ -274,23 +320,22 @@ uint ThreadedFileWriter::Write(const void *data, uint count)
             {
                 buf = emptyBuffers.front();
                 emptyBuffers.pop_front();
-                buf->data.clear();
+                buf->size = 0;
             }
             else
             {
                 buf = new TFWBuffer();
             }
+            writeBuffers.push_back(buf);
         }
 
         totalBufferUse += towrite;
 
-        const char *cdata = (const char*) data + written;
-        buf->data.insert(buf->data.end(), cdata, cdata+towrite);
+        memcpy(buf->data + buf->size, (const char*) data + written, towrite);
+        buf->size += towrite;
         buf->lastUsed = MythDate::current();
 
-        writeBuffers.push_back(buf);
-
-        if ((writeBuffers.size() > 1) || (buf->data.size() >= kMinWriteSize))
+        if ((writeBuffers.size() > 1) || (buf->size >= kMinWriteSize))
         {
             bufferHasData.wakeAll();
         }
@@ -331,7 +376,10 @@ long long ThreadedFileWriter::Seek(long long pos, int whence)
         }
     }
     flush = false;
-    return lseek(fd, pos, whence);
+    long long ret = lseek(fd, pos, whence);
+    if (ret >= 0)
+        m_writePos = ret;
+    return ret;
 }
 
 /** \fn ThreadedFileWriter::Flush(void)
@@ -364,10 +412,9 @@ void ThreadedFileWriter::Flush(void)
  *  written anytime soon so other processes time-slices will
  *  not be used to deal with our excess dirty pages.
  *
- *  \note We used to also use sync_file_range on Linux, however
- *  this is incompatible with newer filesystems such as BRTFS and
- *  does not actually sync any blocks that have not been allocated
- *  yet so it was never really appropriate for ThreadedFileWriter.
+ *  \note sync_file_range does not sync blocks that have not been
+ *  allocated yet, so it is only used by SyncLoop() once the file
+ *  space has been preallocated, see SyncWritten().
  *
  *  \note We use standard posix calls for this, so any operating
  *  system supporting the calls will benefit, but this has been
@@ -389,6 +436,102 @@ void ThreadedFileWriter::Sync(void)
     }
 }
 
+/** \brief Start writeback of the data written so far without waiting
+ *         for the metadata of the file to be committed.
+ *
+ *  This is only safe when the blocks being written were allocated
+ *  by Preallocate(), otherwise it degrades to a no-op on several
+ *  filesystems.
+ *
+ *  \return true if the data was handed to the disk.
+ */
+bool ThreadedFileWriter::SyncWritten(void)
+{
+#if HAVE_SYNC_FILE_RANGE
+    if (fd >= 0)
+    {
+        return sync_file_range(fd, 0, 0, SYNC_FILE_RANGE_WAIT_BEFORE |
+                               SYNC_FILE_RANGE_WRITE |
+                               SYNC_FILE_RANGE_WAIT_AFTER) == 0;
+    }
+#endif
+    return false;
+}
+
+/** \brief Tells the writer the bitrate of the stream, so that it can
+ *         preallocate file space in extents of a suitable size.
+ *
+ *  Without this the bitrate is estimated from what has been written.
+ */
+void ThreadedFileWriter::SetExpectedBitrate(uint kbps)
+{
+    QMutexLocker locker(&buflock);
+    m_expectedRate = (uint64_t) kbps * 1000 / 8;
+}
+
+/** \brief Reserves file space ahead of the write position.
+ *
+ *  Growing the file a write at a time lets concurrent recordings on
+ *  the same filesystem interleave their blocks, so we reserve
+ *  kPreallocSeconds worth of data at once. The file size is kept as
+ *  is so readers never see the reserved space.
+ *
+ *  Must be called with buflock held, it is released during the call.
+ */
+void ThreadedFileWriter::Preallocate(uint64_t rate)
+{
+#if HAVE_FALLOCATE && defined(FALLOC_FL_KEEP_SIZE)
+    uint64_t extent = max((uint64_t) kMinPreallocSize, rate * kPreallocSeconds);
+    extent = (extent + kMaxBlockSize - 1) / kMaxBlockSize * kMaxBlockSize;
+
+    long long start = max(m_writePos, m_preallocEnd);
+
+    buflock.unlock();
+    int ret = fallocate(fd, FALLOC_FL_KEEP_SIZE, start, extent);
+    int err = errno;
+    buflock.lock();
+
+    if (ret == 0)
+    {
+        m_preallocEnd = start + extent;
+        LOG(VB_FILE, LOG_DEBUG, LOC + QString("Preallocated %1 bytes at %2")
+                .arg(extent).arg(start));
+        return;
+    }
+
+    // Not supported by the filesystem, or we are low on space in which
+    // case the regular writes will report the error.
+    LOG(VB_FILE, LOG_INFO, LOC + "Preallocation disabled: " +
+        QString(strerror(err)));
+#else
+    Q_UNUSED(rate);
+#endif
+    m_preallocate = false;
+}
+
+/** \brief Returns the space reserved by Preallocate() beyond the end
+ *         of the file to the filesystem.
+ */
+void ThreadedFileWriter::ReleasePreallocation(void)
+{
+#if HAVE_FALLOCATE && defined(FALLOC_FL_PUNCH_HOLE)
+    struct stat st;
+    if (m_preallocEnd > 0 && fstat(fd, &st) == 0 &&
+        m_preallocEnd > st.st_size)
+    {
+        if (fallocate(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+                      st.st_size, m_preallocEnd - st.st_size) < 0)
+        {
+            // most filesystems free the blocks past EOF on truncate
+            if (ftruncate(fd, st.st_size) < 0)
+                LOG(VB_FILE, LOG_WARNING, LOC +
+                    "Failed to release preallocated space" + ENO);
+        }
+    }
+#endif
+    m_preallocEnd = 0;
+}
+
 /** \fn ThreadedFileWriter::SetWriteBufferMinWriteSize(uint)
  *  \brief Sets the minumum number of bytes to write to disk in a single write.
  *         This is ignored during a Flush(void)
@@ -409,9 +552,12 @@ void ThreadedFileWriter::SyncLoop(void)
     QMutexLocker locker(&buflock);
     while (!in_dtor)
     {
+        bool prealloc = m_preallocate && (m_preallocEnd > 0);
+
         locker.unlock();
 
-        Sync();
+        if (!prealloc || !SyncWritten())
+            Sync();
 
         locker.relock();
 
@@ -440,9 +586,10 @@ void ThreadedFileWriter::DiskLoop(void)
     // Even if the bytes buffered is less than the minimum write
     // size we do want to write to the OS buffers periodically.
     // This timer makes sure we do.
-    MythTimer minWriteTimer, lastRegisterTimer;
+    MythTimer minWriteTimer, lastRegisterTimer, rateTimer;
     minWriteTimer.start();
     lastRegisterTimer.start();
+    rateTimer.start();
 
     uint64_t total_written = 0LL;
 
@@ -490,14 +637,25 @@ void ThreadedFileWriter::DiskLoop(void)
 
         TFWBuffer *buf = writeBuffers.front();
         writeBuffers.pop_front();
-        totalBufferUse -= buf->data.size();
+        totalBufferUse -= buf->size;
         bufferWasFreed.wakeAll();
         minWriteTimer.start();
 
         //////////////////////////////////////////
 
-        const void *data = &(buf->data[0]);
-        uint sz = buf->data.size();
+        const void *data = buf->data;
+        uint sz = buf->size;
+
+        // Reserve more space before the write catches up with the end
+        // of the preallocated extent
+        if (m_preallocate &&
+            (m_writePos + sz + kMinPreallocSize / 2 > m_preallocEnd))
+        {
+            uint64_t rate = m_expectedRate;
+            if (!rate && rateTimer.elapsed() > 1000)
+                rate = total_written * 1000 / rateTimer.elapsed();
+            Preallocate(rate);
+        }
 
         bool write_ok = true;
         uint tot = 0;
@@ -551,6 +709,8 @@ void ThreadedFileWriter::DiskLoop(void)
                 bufferHasData.wait(locker.mutex(), 50);
         }
 
+        m_writePos += tot;
+
         //////////////////////////////////////////
 
         if (lastRegisterTimer.elapsed() >= 10000)
@@ -612,9 +772,7 @@ void ThreadedFileWriter::TrimEmptyBuffers(void)
     QList<TFWBuffer*>::iterator it = emptyBuffers.begin();
     while (it != emptyBuffers.end())
     {
-        if (((*it)->lastUsed < cur_m_60) ||
-            ((*it)->data.capacity() > 3 * (*it)->data.size() &&
-             (*it)->data.capacity() > 64 * 1024))
+        if ((*it)->lastUsed < cur_m_60)
         {
             delete *it;
             it = emptyBuffers.erase(it);
@@ -53,6 +53,7 @@ class MBASE_PUBLIC ThreadedFileWriter
     uint Write(const void *data, uint count);
 
     void SetWriteBufferMinWriteSize(uint newMinSize = kMinWriteSize);
+    void SetExpectedBitrate(uint kbps);
 
     void Sync(void);
     void Flush(void);
@@ -62,6 +63,9 @@ class MBASE_PUBLIC ThreadedFileWriter
     void DiskLoop(void);
     void SyncLoop(void);
     void TrimEmptyBuffers(void);
+    void Preallocate(uint64_t rate);
+    void ReleasePreallocation(void);
+    bool SyncWritten(void);
 
   private:
     // file info
@@ -77,11 +81,20 @@ class MBASE_PUBLIC ThreadedFileWriter
     uint            tfw_min_write_size; // protected by buflock
     uint            totalBufferUse;     // protected by buflock
 
-    // buffers
+    // preallocation
+    bool            m_preallocate;      // protected by buflock
+    long long       m_preallocEnd;      // protected by buflock
+    long long       m_writePos;         // protected by buflock
+    uint64_t        m_expectedRate;     // protected by buflock
+
+    // buffers, fixed size and page aligned so they can be reused
     class TFWBuffer
     {
       public:
-        vector<char> data;
+        TFWBuffer();
+        ~TFWBuffer();
+        char        *data;
+        uint         size;
         QDateTime    lastUsed;
     };
     mutable QMutex    buflock;
@@ -102,8 +115,12 @@ class MBASE_PUBLIC ThreadedFileWriter
     static const uint kMaxBufferSize;
     /// Minimum to write to disk in a single write, when not flushing buffer.
     static const uint kMinWriteSize;
-    /// Maximum block size to write at a time
+    /// Maximum block size to write at a time, and capacity of each buffer
     static const uint kMaxBlockSize;
+    /// Smallest extent to preallocate ahead of the write position
+    static const uint kMinPreallocSize;
+    /// Seconds of data at the expected bitrate to preallocate at a time
+    static const uint kPreallocSeconds;
 
     bool m_warned;
     bool m_blocking;
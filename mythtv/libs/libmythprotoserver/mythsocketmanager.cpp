@@ -375,7 +375,13 @@ void MythSocketManager::HandleVersion(MythSocket *socket,
 
     LOG(VB_SOCKET, LOG_DEBUG, LOC + "Client validated");
     retlist << "ACCEPT" << MYTH_PROTO_VERSION;
-    socket->WriteStringList(retlist);
+
+    // Older clients don't send the 4th token and keep the text encoding
+    bool binary = slist.size() > 3 &&
+        slist[3] == MythSocket::kBinaryStringListsToken;
+    if (binary)
+        retlist << MythSocket::kBinaryStringListsToken;
+    socket->WriteStringList(retlist, binary);
     socket->m_isValidated = true;
 }
 
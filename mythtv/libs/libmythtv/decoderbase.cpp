@@ -8,6 +8,7 @@ using namespace std;
 #include "mythlogging.h"
 #include "decoderbase.h"
 #include "programinfo.h"
+#include "seekindex.h"
 #include "iso639.h"
 #include "DVD/dvdringbuffer.h"
 #include "Bluray/bdringbuffer.h"
@@ -145,6 +146,10 @@ bool DecoderBase::PosMapFromDb(void)
                 .arg(ringBuffer->BD()->GetTotalReadPosition()).arg(fps));
 #endif
     }
+    else if (PosMapFromIndex())
+    {
+        return true;
+    }
     else if ((positionMapType == MARK_UNSET) ||
         (keyframedist == -1))
     {
@@ -231,6 +236,103 @@ bool DecoderBase::PosMapFromDb(void)
     return true;
 }
 
+/** \brief Fills the position and duration maps from the recording's
+ *         seek index instead of the database.
+ *
+ *  The index is read straight into the maps, so a long recording doesn't
+ *  need a recordedseek query or a temporary frm_pos_map_t copy.
+ *
+ *  \return false if there is no usable index, the caller should then
+ *          load the maps from the database.
+ */
+bool DecoderBase::PosMapFromIndex(void)
+{
+    if (!ringBuffer || ringBuffer->IsDisc() || !m_playbackinfo->IsRecording())
+        return false;
+
+    SeekIndex index;
+    if (!index.Open(ringBuffer->GetFilename(), ringBuffer->GetRealFileSize()))
+        return false;
+
+    bool detect = (positionMapType == MARK_UNSET) || (keyframedist == -1);
+    if (!detect && positionMapType != index.GetType())
+        return false;
+
+    MarkTypes oldMapType = positionMapType;
+    int oldKeyframeDist = keyframedist;
+
+    if (detect)
+    {
+        positionMapType = index.GetType();
+        if (keyframedist == -1 && positionMapType == MARK_GOP_BYFRAME)
+        {
+            keyframedist = 1;
+        }
+        else if (keyframedist == -1 && positionMapType == MARK_GOP_START)
+        {
+            keyframedist = 15;
+            if (fps < 26 && fps > 24)
+                keyframedist = 12;
+        }
+    }
+
+    QMutexLocker locker(&m_positionMapLock);
+    m_positionMap.clear();
+    m_positionMap.reserve(index.GetCount(SeekIndex::kPositions));
+    m_frameToDurMap.clear();
+    m_durToFrameMap.clear();
+
+    int64_t key, value;
+    SeekIndex::Cursor pos = index.GetCursor(SeekIndex::kPositions);
+    while (pos.Next(key, value))
+    {
+        PosMapEntry e = {key, key * keyframedist, value};
+        m_positionMap.push_back(e);
+    }
+
+    uint durations = 0;
+    SeekIndex::Cursor dur = index.GetCursor(SeekIndex::kDurations);
+    while (dur.Next(key, value))
+    {
+        m_frameToDurMap[key] = value;
+        m_durToFrameMap[value] = key;
+        durations++;
+    }
+
+    // A corrupt entry ends a cursor early, a truncated map would send
+    // seeks past that point to the wrong place.
+    bool complete =
+        (m_positionMap.size() == index.GetCount(SeekIndex::kPositions)) &&
+        (durations == index.GetCount(SeekIndex::kDurations));
+    if (!complete)
+    {
+        LOG(VB_GENERAL, LOG_WARNING, LOC +
+            QString("Seek index is damaged, read %1 of %2 positions and "
+                    "%3 of %4 durations, using the database")
+                .arg(m_positionMap.size())
+                .arg(index.GetCount(SeekIndex::kPositions))
+                .arg(durations).arg(index.GetCount(SeekIndex::kDurations)));
+    }
+
+    if (!complete || m_positionMap.empty())
+    {
+        m_positionMap.clear();
+        m_frameToDurMap.clear();
+        m_durToFrameMap.clear();
+        positionMapType = oldMapType;
+        keyframedist = oldKeyframeDist;
+        return false;
+    }
+
+    indexOffset = m_positionMap[0].index;
+
+    LOG(VB_PLAYBACK, LOG_INFO, LOC +
+        QString("Position map filled from index to: %1, %2 durations")
+            .arg(m_positionMap.back().index).arg(m_durToFrameMap.size()));
+
+    return true;
+}
+
 /** \fn DecoderBase::PosMapFromEnc(void)
  *  \brief Queries encoder for position map data
  *         that has not been committed to the DB yet.
@@ -5,7 +5,13 @@
  * License: GPL v2
  */
 
+// C++ headers
+#include <algorithm>
+
+// Qt headers
 #include <QDateTime>
+#include <QStringList>
+#include <QMap>
 
 #include "eitcache.h"
 #include "mythcontext.h"
@@ -19,8 +25,9 @@
 const uint EITCache::kVersionMax = 31;
 
 EITCache::EITCache()
-    : accessCnt(0), hitCnt(0), tblChgCnt(0), verChgCnt(0), endChgCnt(0),
-      entryCnt(0), pruneCnt(0), prunedHitCnt(0), futureHitCnt(0), wrongChannelHitCnt(0)
+    : accessCnt(0), hitCnt(0), missCnt(0), contentionCnt(0),
+      tblChgCnt(0), verChgCnt(0), endChgCnt(0), entryCnt(0), pruneCnt(0),
+      prunedHitCnt(0), futureHitCnt(0), wrongChannelHitCnt(0)
 {
     // 24 hours ago
     lastPruneTime = MythDate::current().toUTC().toTime_t() - 86400;
@@ -33,30 +40,47 @@ EITCache::~EITCache()
 
 void EITCache::ResetStatistics(void)
 {
-    accessCnt = 0;
-    hitCnt    = 0;
-    tblChgCnt = 0;
-    verChgCnt = 0;
-    endChgCnt = 0;
-    entryCnt  = 0;
-    pruneCnt  = 0;
-    prunedHitCnt = 0;
-    futureHitCnt = 0;
-    wrongChannelHitCnt = 0;
+    accessCnt.fetchAndStoreRelaxed(0);
+    hitCnt.fetchAndStoreRelaxed(0);
+    missCnt.fetchAndStoreRelaxed(0);
+    contentionCnt.fetchAndStoreRelaxed(0);
+    tblChgCnt.fetchAndStoreRelaxed(0);
+    verChgCnt.fetchAndStoreRelaxed(0);
+    endChgCnt.fetchAndStoreRelaxed(0);
+    entryCnt.fetchAndStoreRelaxed(0);
+    pruneCnt.fetchAndStoreRelaxed(0);
+    prunedHitCnt.fetchAndStoreRelaxed(0);
+    futureHitCnt.fetchAndStoreRelaxed(0);
+    wrongChannelHitCnt.fetchAndStoreRelaxed(0);
 }
 
 QString EITCache::GetStatistics(void) const
 {
-    QMutexLocker locker(&eventMapLock);
+    uint access   = accessCnt.load();
+    uint hits     = hitCnt.load();
+    uint pruned   = prunedHitCnt.load();
+    uint future   = futureHitCnt.load();
+    uint wrongchn = wrongChannelHitCnt.load();
+
+    uint cached = 0;
+    for (uint i = 0; i < kShardCount; ++i)
+    {
+        QMutexLocker locker(&shards[i].lock);
+        cached += shards[i].Size();
+    }
+
     return QString(
-        "EITCache::statistics: Accesses: %1, Hits: %2, "
-        "Table Upgrades %3, New Versions: %4, New Endtimes: %5, Entries: %6, "
-        "Pruned Entries: %7, Pruned Hits: %8, Future Hits: %9, Wrong Channel Hits %10, "
-        "Hit Ratio %11.")
-        .arg(accessCnt).arg(hitCnt).arg(tblChgCnt).arg(verChgCnt).arg(endChgCnt)
-        .arg(entryCnt).arg(pruneCnt).arg(prunedHitCnt).arg(futureHitCnt)
-        .arg(wrongChannelHitCnt)
-        .arg((hitCnt+prunedHitCnt+futureHitCnt+wrongChannelHitCnt)/(double)accessCnt);
+        "EITCache::statistics: Accesses: %1, Hits: %2, Misses: %3, "
+        "Table Upgrades %4, New Versions: %5, New Endtimes: %6, Entries: %7, "
+        "Pruned Entries: %8, Pruned Hits: %9, Future Hits: %10, "
+        "Wrong Channel Hits %11, Lock Contention: %12, Cached Entries: %13, "
+        "Hit Ratio %14.")
+        .arg(access).arg(hits).arg(missCnt.load())
+        .arg(tblChgCnt.load()).arg(verChgCnt.load()).arg(endChgCnt.load())
+        .arg(entryCnt.load()).arg(pruneCnt.load())
+        .arg(pruned).arg(future).arg(wrongchn)
+        .arg(contentionCnt.load()).arg(cached)
+        .arg((hits+pruned+future+wrongchn)/(double)access);
 }
 
 static inline uint64_t construct_sig(uint tableid, uint version,
@@ -86,12 +110,112 @@ static inline bool modified(uint64_t sig)
     return sig >> 63;
 }
 
-static void replace_in_db(QStringList &value_clauses,
-                          uint chanid, uint eventid, uint64_t sig)
+static inline uint64_t make_key(uint chanid, uint eventid)
+{
+    return ((uint64_t) chanid << 32) | eventid;
+}
+
+static inline uint extract_chanid(uint64_t key)
+{
+    return key >> 32;
+}
+
+static inline uint extract_eventid(uint64_t key)
+{
+    return key & 0xffffffff;
+}
+
+// 64 bit finalizer from MurmurHash3, spreads sequential ids over all bits
+static inline uint64_t hash_key(uint64_t key)
+{
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ULL;
+    key ^= key >> 33;
+    return key;
+}
+
+// chanid 0xffffffff is never assigned, so this key is never looked up
+static const uint64_t kEmptyKey = ~(uint64_t)0;
+static const uint kInitialShardSize = 1024;
+
+EITCacheShard::EITCacheShard() : used(0)
+{
+    Resize(kInitialShardSize);
+}
+
+void EITCacheShard::Resize(uint size)
+{
+    vector<uint64_t> oldkeys(size, kEmptyKey);
+    vector<uint64_t> oldsigs(size, 0);
+    keys.swap(oldkeys);
+    sigs.swap(oldsigs);
+    used = 0;
+
+    for (uint i = 0; i < oldkeys.size(); ++i)
+    {
+        if (oldkeys[i] != kEmptyKey)
+            Insert(oldkeys[i], oldsigs[i]);
+    }
+}
+
+uint64_t *EITCacheShard::Find(uint64_t key)
+{
+    uint mask = keys.size() - 1;
+    uint i = hash_key(key) & mask;
+    while (keys[i] != kEmptyKey)
+    {
+        if (keys[i] == key)
+            return &sigs[i];
+        i = (i + 1) & mask;
+    }
+    return NULL;
+}
+
+uint64_t *EITCacheShard::Insert(uint64_t key, uint64_t sig)
 {
-    value_clauses << QString("(%1,%2,%3,%4,%5)")
-        .arg(chanid).arg(eventid).arg(extract_table_id(sig))
-        .arg(extract_version(sig)).arg(extract_endtime(sig));
+    // keep the load factor below 3/4 so probe sequences stay short
+    if ((used + 1) * 4 > keys.size() * 3)
+        Resize(keys.size() * 2);
+
+    uint mask = keys.size() - 1;
+    uint i = hash_key(key) & mask;
+    while (keys[i] != kEmptyKey && keys[i] != key)
+        i = (i + 1) & mask;
+
+    if (keys[i] == kEmptyKey)
+    {
+        keys[i] = key;
+        used++;
+    }
+    sigs[i] = sig;
+    return &sigs[i];
+}
+
+/** \fn EITCacheShard::Prune(uint)
+ *  \brief Removes all entries for events that ended before endtime.
+ *  \return number of entries removed
+ */
+uint EITCacheShard::Prune(uint endtime)
+{
+    uint before = used;
+
+    // Rebuilding is simpler than deleting in place with linear probing,
+    // and pruning only happens once a day.
+    vector<uint64_t> oldkeys(keys.size(), kEmptyKey);
+    vector<uint64_t> oldsigs(keys.size(), 0);
+    keys.swap(oldkeys);
+    sigs.swap(oldsigs);
+    used = 0;
+
+    for (uint i = 0; i < oldkeys.size(); ++i)
+    {
+        if (oldkeys[i] != kEmptyKey && extract_endtime(oldsigs[i]) > endtime)
+            Insert(oldkeys[i], oldsigs[i]);
+    }
+
+    return before - used;
 }
 
 static void delete_in_db(uint endtime)
@@ -204,10 +328,51 @@ static void unlock_channel(uint chanid, uint updated)
 }
 
 
-event_map_t * EITCache::LoadChannel(uint chanid)
+EITCacheShard &EITCache::GetShard(uint64_t key)
 {
+    // the low bits pick the slot within the shard, use the high ones here
+    return shards[(hash_key(key) >> 32) % kShardCount];
+}
+
+void EITCache::LockShard(EITCacheShard &shard)
+{
+    if (!shard.lock.tryLock())
+    {
+        contentionCnt.fetchAndAddRelaxed(1);
+        shard.lock.lock();
+    }
+}
+
+int EITCache::GetChannelState(uint chanid)
+{
+    EITCacheShard &shard = GetShard(chanid);
+    LockShard(shard);
+    int state = shard.channels.value(chanid, kChannelUnknown);
+    shard.lock.unlock();
+    return state;
+}
+
+void EITCache::SetChannelState(uint chanid, int state)
+{
+    EITCacheShard &shard = GetShard(chanid);
+    QMutexLocker locker(&shard.lock);
+    shard.channels[chanid] = state;
+}
+
+int EITCache::LoadChannel(uint chanid)
+{
+    QMutexLocker locker(&channelLock);
+
+    // another thread may have loaded it while we waited for the lock
+    int state = GetChannelState(chanid);
+    if (state != kChannelUnknown)
+        return state;
+
     if (!lock_channel(chanid, lastPruneTime))
-        return NULL;
+    {
+        SetChannelState(chanid, kChannelUnavailable);
+        return kChannelUnavailable;
+    }
 
     MSqlQuery query(MSqlQuery::InitCon());
 
@@ -226,11 +391,11 @@ event_map_t * EITCache::LoadChannel(uint chanid)
     if (!query.exec() || !query.isActive())
     {
         MythDB::DBError("Error loading eitcache", query);
-        return NULL;
+        SetChannelState(chanid, kChannelUnavailable);
+        return kChannelUnavailable;
     }
 
-    event_map_t * eventMap = new event_map_t();
-
+    uint loaded = 0;
     while (query.next())
     {
         uint eventid = query.value(0).toUInt();
@@ -238,98 +403,145 @@ event_map_t * EITCache::LoadChannel(uint chanid)
         uint version = query.value(2).toUInt();
         uint endtime = query.value(3).toUInt();
 
-        (*eventMap)[eventid] = construct_sig(tableid, version, endtime, false);
+        uint64_t key = make_key(chanid, eventid);
+        EITCacheShard &shard = GetShard(key);
+        LockShard(shard);
+        shard.Insert(key, construct_sig(tableid, version, endtime, false));
+        shard.lock.unlock();
+        loaded++;
     }
 
-    if (eventMap->size())
+    if (loaded)
         LOG(VB_EIT, LOG_INFO, LOC + QString("Loaded %1 entries for channel %2")
-                .arg(eventMap->size()).arg(chanid));
+                .arg(loaded).arg(chanid));
 
-    entryCnt += eventMap->size();
-    return eventMap;
+    entryCnt.fetchAndAddRelaxed(loaded);
+    SetChannelState(chanid, kChannelLocked);
+    return kChannelLocked;
 }
 
-bool EITCache::WriteChannelToDB(QStringList &value_clauses, uint chanid)
+// rows per REPLACE statement, each row has its own placeholders
+static const uint kWriteRows = 100;
+
+static bool write_entries(const vector<pair<uint64_t, uint64_t> > &entries)
 {
-    event_map_t * eventMap = channelMap[chanid];
+    MSqlQuery query(MSqlQuery::InitCon());
 
-    if (!eventMap)
-        return false;
+    for (uint i = 0; i < entries.size(); i += kWriteRows)
+    {
+        uint n = min(kWriteRows, (uint) entries.size() - i);
+        QStringList rows;
+        for (uint j = 0; j < n; ++j)
+        {
+            rows << QString("(:CHANID%1, :EVENTID%1, :TABLEID%1, "
+                            ":VERSION%1, :ENDTIME%1)").arg(j);
+        }
 
-    uint size    = eventMap->size();
-    uint updated = 0;
-    uint removed = 0;
+        query.prepare(QString("REPLACE INTO eit_cache "
+                              "(chanid, eventid, tableid, version, endtime) "
+                              "VALUES %1").arg(rows.join(",")));
 
-    event_map_t::iterator it = eventMap->begin();
-    while (it != eventMap->end())
-    {
-        if (extract_endtime(*it) > lastPruneTime)
+        for (uint j = 0; j < n; ++j)
         {
-            if (modified(*it))
-            {
-                replace_in_db(value_clauses, chanid, it.key(), *it);
-                updated++;
-                *it &= ~(uint64_t)0 >> 1; // mark as synced
-            }
-            ++it;
+            uint64_t key = entries[i + j].first;
+            uint64_t sig = entries[i + j].second;
+            query.bindValue(QString(":CHANID%1").arg(j), extract_chanid(key));
+            query.bindValue(QString(":EVENTID%1").arg(j), extract_eventid(key));
+            query.bindValue(QString(":TABLEID%1").arg(j), extract_table_id(sig));
+            query.bindValue(QString(":VERSION%1").arg(j), extract_version(sig));
+            query.bindValue(QString(":ENDTIME%1").arg(j), extract_endtime(sig));
         }
-        else
+
+        if (!query.exec())
         {
-            // Event is too old; remove from eit cache in memory
-            it = eventMap->erase(it);
-            removed++;
+            MythDB::DBError("Error updating eitcache", query);
+            return false;
         }
     }
-    unlock_channel(chanid, updated);
-
-    if (updated)
-        LOG(VB_EIT, LOG_INFO, LOC + QString("Writing %1 modified entries of %2 "
-                                      "for channel %3 to database.")
-                .arg(updated).arg(size).arg(chanid));
-    if (removed)
-        LOG(VB_EIT, LOG_INFO, LOC + QString("Removed %1 old entries of %2 "
-                                      "for channel %3 from cache.")
-                .arg(removed).arg(size).arg(chanid));
-    pruneCnt += removed;
 
     return true;
 }
 
+/** \fn EITCache::WriteToDB(void)
+ *  \brief Writes the entries modified since the last call to the database.
+ *
+ *  Only the keys in each shard's dirty list are visited, unmodified
+ *  entries are never rewritten.
+ */
 void EITCache::WriteToDB(void)
 {
-    QMutexLocker locker(&eventMapLock);
+    QMutexLocker locker(&channelLock);
 
-    QStringList value_clauses;
-    key_map_t::iterator it = channelMap.begin();
-    while (it != channelMap.end())
+    vector<pair<uint64_t, uint64_t> > entries;
+    QMap<uint, uint> updated; // chanid -> modified entries
+    QList<uint> unlock;       // channels whose db lock we still hold
+
+    for (uint i = 0; i < kShardCount; ++i)
     {
-        if (!WriteChannelToDB(value_clauses, it.key()))
-            it = channelMap.erase(it);
-        else
+        EITCacheShard &shard = shards[i];
+        LockShard(shard);
+
+        for (uint j = 0; j < shard.dirty.size(); ++j)
+        {
+            uint64_t *sig = shard.Find(shard.dirty[j]);
+            if (!sig || !modified(*sig))
+                continue;
+
+            *sig &= ~(uint64_t)0 >> 1; // mark as synced
+
+            // events too old are dropped by the next prune
+            if (extract_endtime(*sig) > lastPruneTime)
+            {
+                entries.push_back(make_pair(shard.dirty[j], *sig));
+                updated[extract_chanid(shard.dirty[j])]++;
+            }
+        }
+        shard.dirty.clear();
+
+        QHash<uint, int>::iterator it = shard.channels.begin();
+        while (it != shard.channels.end())
+        {
+            if (*it == kChannelUnavailable)
+            {
+                // retry loading channels locked by another backend
+                it = shard.channels.erase(it);
+                continue;
+            }
+            if (*it == kChannelLocked)
+            {
+                unlock.push_back(it.key());
+                *it = kChannelLoaded;
+            }
             ++it;
+        }
+
+        shard.lock.unlock();
     }
 
-    if(value_clauses.isEmpty())
+    if (!entries.empty())
     {
-        return;
+        LOG(VB_EIT, LOG_INFO, LOC + QString("Writing %1 modified entries "
+                                            "for %2 channels to database.")
+                .arg(entries.size()).arg(updated.size()));
+        write_entries(entries);
     }
 
-    MSqlQuery query(MSqlQuery::InitCon());
-    query.prepare(QString("REPLACE INTO eit_cache "
-                          "(chanid, eventid, tableid, version, endtime) "
-                          "VALUES %1").arg(value_clauses.join(",")));
-    if (!query.exec())
+    QMap<uint, uint>::const_iterator uit = updated.begin();
+    for (; uit != updated.end(); ++uit)
     {
-        MythDB::DBError("Error updating eitcache", query);
+        unlock_channel(uit.key(), *uit);
+        unlock.removeAll(uit.key());
     }
+    for (int i = 0; i < unlock.size(); ++i)
+        unlock_channel(unlock[i], 0);
 }
 
 bool EITCache::IsNewEIT(uint chanid,  uint tableid,   uint version,
                         uint eventid, uint endtime)
 {
-    accessCnt++;
+    uint access = accessCnt.fetchAndAddRelaxed(1) + 1;
 
-    if (accessCnt % 500000 == 50000)
+    if (access % 500000 == 50000)
     {
         LOG(VB_EIT, LOG_INFO, GetStatistics());
         WriteToDB();
@@ -338,61 +550,73 @@ bool EITCache::IsNewEIT(uint chanid,  uint tableid,   uint version,
     // don't re-add pruned entries
     if (endtime < lastPruneTime)
     {
-        prunedHitCnt++;
+        prunedHitCnt.fetchAndAddRelaxed(1);
         return false;
     }
 
     // validity check, reject events with endtime over 7 weeks in the future
     if (endtime > lastPruneTime + 50 * 86400)
     {
-        futureHitCnt++;
+        futureHitCnt.fetchAndAddRelaxed(1);
         return false;
     }
 
-    QMutexLocker locker(&eventMapLock);
-    if (!channelMap.contains(chanid))
-    {
-        channelMap[chanid] = LoadChannel(chanid);
-    }
+    int state = GetChannelState(chanid);
+    if (state == kChannelUnknown)
+        state = LoadChannel(chanid);
 
-    if (!channelMap[chanid])
+    if (state == kChannelUnavailable)
     {
-        wrongChannelHitCnt++;
+        wrongChannelHitCnt.fetchAndAddRelaxed(1);
         return false;
     }
 
-    event_map_t * eventMap = channelMap[chanid];
-    event_map_t::iterator it = eventMap->find(eventid);
-    if (it != eventMap->end())
+    uint64_t key = make_key(chanid, eventid);
+    EITCacheShard &shard = GetShard(key);
+    LockShard(shard);
+
+    uint64_t *sig = shard.Find(key);
+    if (sig)
     {
-        if (extract_table_id(*it) > tableid)
+        if (extract_table_id(*sig) > tableid)
         {
             // EIT from lower (ie. better) table number
-            tblChgCnt++;
+            tblChgCnt.fetchAndAddRelaxed(1);
         }
-        else if ((extract_table_id(*it) == tableid) &&
-                 ((extract_version(*it) < version) ||
-                  ((extract_version(*it) == kVersionMax) &&
+        else if ((extract_table_id(*sig) == tableid) &&
+                 ((extract_version(*sig) < version) ||
+                  ((extract_version(*sig) == kVersionMax) &&
                    version < kVersionMax)))
         {
             // EIT updated version on current table
-            verChgCnt++;
+            verChgCnt.fetchAndAddRelaxed(1);
         }
-        else if (extract_endtime(*it) != endtime)
+        else if (extract_endtime(*sig) != endtime)
         {
             // Endtime (starttime + duration) changed
-            endChgCnt++;
+            endChgCnt.fetchAndAddRelaxed(1);
         }
         else
         {
             // EIT data previously seen
-            hitCnt++;
+            shard.lock.unlock();
+            hitCnt.fetchAndAddRelaxed(1);
             return false;
         }
     }
 
-    eventMap->insert(eventid, construct_sig(tableid, version, endtime, true));
-    entryCnt++;
+    // queue the key for the next write unless it is already queued
+    if (!sig || !modified(*sig))
+        shard.dirty.push_back(key);
+
+    if (sig)
+        *sig = construct_sig(tableid, version, endtime, true);
+    else
+        shard.Insert(key, construct_sig(tableid, version, endtime, true));
+    shard.lock.unlock();
+
+    entryCnt.fetchAndAddRelaxed(1);
+    missCnt.fetchAndAddRelaxed(1);
 
     return true;
 }
@@ -413,13 +637,27 @@ uint EITCache::PruneOldEntries(uint timestamp)
 
     lastPruneTime  = timestamp;
 
-    // Write all modified entries to DB and start with a clean cache
+    // Write all modified entries to DB
     WriteToDB();
 
+    // Drop the old entries from the cache
+    uint pruned = 0;
+    for (uint i = 0; i < kShardCount; ++i)
+    {
+        LockShard(shards[i]);
+        pruned += shards[i].Prune(timestamp);
+        shards[i].lock.unlock();
+    }
+    pruneCnt.fetchAndAddRelaxed(pruned);
+
+    if (pruned)
+        LOG(VB_EIT, LOG_INFO, LOC + QString("Removed %1 old entries from cache.")
+                .arg(pruned));
+
     // Prune old entries in the DB
     delete_in_db(timestamp);
 
-    return 0;
+    return pruned;
 }
 
 
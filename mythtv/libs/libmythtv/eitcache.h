@@ -8,16 +8,49 @@
 
 #include <stdint.h>
 
+// C++ headers
+#include <vector>
+using namespace std;
+
 // Qt headers
 #include <QString>
 #include <QMutex>
-#include <QMap>
+#include <QAtomicInt>
+#include <QHash>
 
 // MythTV headers
 #include "mythtvexp.h"
 
-typedef QMap<uint, uint64_t> event_map_t;
-typedef QMap<uint, event_map_t*> key_map_t;
+/** \class EITCacheShard
+ *  \brief One slice of the EIT cache.
+ *
+ *  An open-addressing hash from a (chanid, eventid) key to the packed
+ *  event signature, plus the keys modified since the last write to the
+ *  database. Callers must hold lock.
+ */
+class EITCacheShard
+{
+  public:
+    EITCacheShard();
+
+    uint64_t *Find(uint64_t key);
+    uint64_t *Insert(uint64_t key, uint64_t sig);
+    uint Prune(uint endtime);
+    uint Size(void) const { return used; }
+
+    mutable QMutex    lock;
+    /// State of the channels whose chanid hashes to this shard
+    QHash<uint, int>  channels;
+    /// Keys modified since the last WriteToDB()
+    vector<uint64_t>  dirty;
+
+  private:
+    void Resize(uint size);
+
+    vector<uint64_t>  keys;
+    vector<uint64_t>  sigs;
+    uint              used;
+};
 
 class EITCache
 {
@@ -35,26 +68,40 @@ class EITCache
     QString GetStatistics(void) const;
 
   private:
-    event_map_t * LoadChannel(uint chanid);
-    bool WriteChannelToDB(QStringList &value_clauses, uint chanid);
-
-    // event key cache
-    key_map_t   channelMap;
-
-    mutable QMutex eventMapLock;
+    enum ChannelState
+    {
+        kChannelUnknown = 0, ///< not loaded from the database yet
+        kChannelLocked,      ///< loaded, we hold the channel lock in the db
+        kChannelLoaded,      ///< loaded, channel lock has been released
+        kChannelUnavailable, ///< locked by another backend, retried on write
+    };
+
+    EITCacheShard &GetShard(uint64_t key);
+    void LockShard(EITCacheShard &shard);
+    int  GetChannelState(uint chanid);
+    void SetChannelState(uint chanid, int state);
+    int  LoadChannel(uint chanid);
+
+    static const uint kShardCount = 16;
+    EITCacheShard   shards[kShardCount];
+
+    /// Serializes channel loads against writes to the database
+    QMutex          channelLock;
     uint            lastPruneTime;
 
     // statistics
-    uint        accessCnt;
-    uint        hitCnt;
-    uint        tblChgCnt;
-    uint        verChgCnt;
-    uint        endChgCnt;
-    uint        entryCnt;
-    uint        pruneCnt;
-    uint        prunedHitCnt;
-    uint        futureHitCnt;
-    uint        wrongChannelHitCnt;
+    QAtomicInt  accessCnt;
+    QAtomicInt  hitCnt;
+    QAtomicInt  missCnt;
+    QAtomicInt  contentionCnt;
+    QAtomicInt  tblChgCnt;
+    QAtomicInt  verChgCnt;
+    QAtomicInt  endChgCnt;
+    QAtomicInt  entryCnt;
+    QAtomicInt  pruneCnt;
+    QAtomicInt  prunedHitCnt;
+    QAtomicInt  futureHitCnt;
+    QAtomicInt  wrongChannelHitCnt;
 
     static const uint kVersionMax;
 
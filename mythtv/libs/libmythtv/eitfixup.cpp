@@ -63,37 +63,48 @@ EITFixUp::EITFixUp()
       m_dishDescriptionFinale2("\\s*Finale\\.\\s*"),
       m_dishDescriptionPremiere("\\s*(Series|Season)\\s(Premier|Premiere)\\.\\s*"),
       m_dishDescriptionPremiere2("\\s*(Premier|Premiere)\\.\\s*"),
-      m_dishPPVCode("\\s*\\(([A-Z]|[0-9]){5}\\)\\s*$"),
-      m_ukThen("\\s*(Then|Followed by) 60 Seconds\\.", Qt::CaseInsensitive),
-      m_ukNew("(New\\.|\\s*(Brand New|New)\\s*(Series|Episode)\\s*[:\\.\\-])",Qt::CaseInsensitive),
-      m_ukNewTitle("^(Brand New|New:)\\s*",Qt::CaseInsensitive),
-      m_ukAlsoInHD("\\s*Also in HD\\.",Qt::CaseInsensitive),
+      m_dishPPVCode("\\s*\\(([A-Z]|[0-9]){5}\\)\\s*$",
+                    QRegularExpression::CaseInsensitiveOption),
+      m_ukThen("\\s*(Then|Followed by) 60 Seconds\\.",
+               QRegularExpression::CaseInsensitiveOption),
+      m_ukNew("(New\\.|\\s*(Brand New|New)\\s*(Series|Episode)\\s*[:\\.\\-])",
+              QRegularExpression::CaseInsensitiveOption),
+      m_ukNewTitle("^(Brand New|New:)\\s*",
+                   QRegularExpression::CaseInsensitiveOption),
+      m_ukAlsoInHD("\\s*Also in HD\\.",
+                   QRegularExpression::CaseInsensitiveOption),
       m_ukCEPQ("[:\\!\\.\\?]"),
       m_ukColonPeriod("[:\\.]"),
       m_ukDotSpaceStart("^\\. "),
       m_ukDotEnd("\\.$"),
       m_ukSpaceColonStart("^[ |:]*"),
       m_ukSpaceStart("^ "),
-      m_ukPart("[-(\\:,.]\\s*(?:Part|Pt)\\s*(\\d+)\\s*(?:(?:of|/)\\s*(\\d+))?\\s*[-):,.]", Qt::CaseInsensitive),
+      m_ukPart("[-(\\:,.]\\s*(?:Part|Pt)\\s*(\\d+)\\s*(?:(?:of|/)\\s*(\\d+))?\\s*[-):,.]",
+               QRegularExpression::CaseInsensitiveOption),
       // Prefer long format resorting to short format
       // cap0 = long match to remove, cap1 = long season, cap2 = long ep, cap3 = long total,
       // cap4 = short match to remove, cap5 = short ep, cap6 = short total
-      m_ukSeries("(?:" + longContext + "|" + shortContext + ")", Qt::CaseInsensitive),
+      m_ukSeries("(?:" + longContext + "|" + shortContext + ")",
+                 QRegularExpression::CaseInsensitiveOption),
       m_ukCC("\\[(?:(AD|SL|S|W|HD),?)+\\]"),
       m_ukYear("[\\[\\(]([\\d]{4})[\\)\\]]"),
       m_uk24ep("^\\d{1,2}:00[ap]m to \\d{1,2}:00[ap]m: "),
-      m_ukStarring("(?:Western\\s)?[Ss]tarring ([\\w\\s\\-']+)[Aa]nd\\s([\\w\\s\\-']+)[\\.|,](?:\\s)*(\\d{4})?(?:\\.\\s)?"),
+      m_ukStarring("(?:Western\\s)?[Ss]tarring ([\\w\\s\\-']+)[Aa]nd\\s([\\w\\s\\-']+)[\\.|,](?:\\s)*(\\d{4})?(?:\\.\\s)?",
+                   QRegularExpression::UseUnicodePropertiesOption),
       m_ukBBC7rpt("\\[Rptd?[^]]+\\d{1,2}\\.\\d{1,2}[ap]m\\]\\."),
       m_ukDescriptionRemove("^(?:CBBC\\s*\\.|CBeebies\\s*\\.|Class TV\\s*:|BBC Switch\\.)"),
       m_ukTitleRemove("^(?:[tT]4:|Schools\\s*:)"),
       m_ukDoubleDotEnd("\\.\\.+$"),
       m_ukDoubleDotStart("^\\.\\.+"),
       m_ukTime("\\d{1,2}[\\.:]\\d{1,2}\\s*(am|pm|)"),
-      m_ukBBC34("BBC (?:THREE|FOUR) on BBC (?:ONE|TWO)\\.",Qt::CaseInsensitive),
+      m_ukBBC34("BBC (?:THREE|FOUR) on BBC (?:ONE|TWO)\\.",
+                QRegularExpression::CaseInsensitiveOption),
       m_ukYearColon("^[\\d]{4}:"),
-      m_ukExclusionFromSubtitle("(starring|stars\\s|drama|series|sitcom)",Qt::CaseInsensitive),
+      m_ukExclusionFromSubtitle("(starring|stars\\s|drama|series|sitcom)",
+                                QRegularExpression::CaseInsensitiveOption),
       m_ukCompleteDots("^\\.\\.+$"),
-      m_ukQuotedSubtitle("(?:^')([\\w\\s\\-,]+)(?:\\.' )"),
+      m_ukQuotedSubtitle("(?:^')([\\w\\s\\-,]+)(?:\\.' )",
+                         QRegularExpression::UseUnicodePropertiesOption),
       m_ukAllNew("All New To 4Music!\\s?"),
       m_ukLaONoSplit("^Law & Order: (?:Criminal Intent|LA|Special Victims Unit|Trial by Jury|UK|You the Jury)"),
       m_comHemCountry("^(\\(.+\\))?\\s?([^ ]+)\\s([^\\.0-9]+)"
@@ -128,15 +139,19 @@ EITFixUp::EITFixUp()
       m_RTLrepeat("(\\(|\\s)?Wiederholung.+vo[m|n].+((?:\\d{2}\\.\\d{2}\\.\\d{4})|(?:\\d{2}[:\\.]\\d{2}\\sUhr))\\)?"),
       m_RTLSubtitle("^([^\\.]{3,})\\.\\s+(.+)"),
       /* should be (?:\x{8a}|\\.\\s*|$) but 0x8A gets replaced with 0x20 */
-      m_RTLSubtitle1("^Folge\\s(\\d{1,4})\\s*:\\s+'(.*)'(?:\\s|\\.\\s*|$)"),
-      m_RTLSubtitle2("^Folge\\s(\\d{1,4})\\s+(.{,5}[^\\.]{,120})[\\?!\\.]\\s*"),
-      m_RTLSubtitle3("^(?:Folge\\s)?(\\d{1,4}(?:\\/[IVX]+)?)\\s+(.{,5}[^\\.]{,120})[\\?!\\.]\\s*"),
+      m_RTLSubtitle1("^Folge\\s(\\d{1,4})\\s*:\\s+'(.*)'(?:\\s|\\.\\s*|$)",
+                     QRegularExpression::InvertedGreedinessOption),
+      m_RTLSubtitle2("^Folge\\s(\\d{1,4})\\s+(.{0,5}[^\\.]{0,120})[\\?!\\.]\\s*"),
+      m_RTLSubtitle3("^(?:Folge\\s)?(\\d{1,4}(?:\\/[IVX]+)?)\\s+(.{0,5}[^\\.]{0,120})[\\?!\\.]\\s*"),
       m_RTLSubtitle4("^Thema.{0,5}:\\s([^\\.]+)\\.\\s*"),
-      m_RTLSubtitle5("^'(.+)'\\.\\s*"),
+      m_RTLSubtitle5("^'(.+)'\\.\\s*",
+                     QRegularExpression::InvertedGreedinessOption),
       m_PRO7Subtitle(",{0,1}([^,]*),([^,]+)\\s{0,1}(\\d{4})$"),
-      m_PRO7Crew("\n\n(Regie:.*)$"),
+      m_PRO7Crew("\n\n(Regie:.*)$",
+                 QRegularExpression::DotMatchesEverythingOption),
       m_PRO7CrewOne("^(.*):\\s+(.*)$"),
-      m_PRO7Cast("\n\nDarsteller:\n(.*)$"),
+      m_PRO7Cast("\n\nDarsteller:\n(.*)$",
+                 QRegularExpression::DotMatchesEverythingOption),
       m_PRO7CastOne("^([^\\(]*)\\((.*)\\)$"),
       m_RTLEpisodeNo1("^(Folge\\s\\d{1,4})\\.*\\s*"),
       m_RTLEpisodeNo2("^(\\d{1,2}\\/[IVX]+)\\.*\\s*"),
@@ -155,7 +170,8 @@ EITFixUp::EITFixUp()
       m_nlActors("\\sMet:\\s.+e\\.a\\."),
       m_nlPres("\\sPresentatie:\\s([^\\.]+)\\."),
       m_nlPersSeparator("(, |\\sen\\s)"),
-      m_nlRub("\\s?\\({1}\\W+\\){1}\\s?"),
+      m_nlRub("\\s?\\({1}\\W+\\){1}\\s?",
+              QRegularExpression::UseUnicodePropertiesOption),
       m_nlYear1("(?=\\suit\\s)([1-2]{2}[0-9]{2})"),
       m_nlYear2("([\\s]{1}[\\(]{1}[A-Z]{0,3}/?)([1-2]{2}[0-9]{2})([\\)]{1})"),
       m_nlDirector("(?=\\svan\\s)(([A-Z]{1}[a-z]+\\s)|([A-Z]{1}\\.\\s))"),
@@ -169,7 +185,9 @@ EITFixUp::EITFixUp()
                         "NRK2s historiekveld|Detektimen|Nattkino|Filmklassiker|Film|Kortfilm|P.skemorg[eo]n|"
                         "Radioteatret|Opera|P2-Akademiet|Nyhetsmorg[eo]n i P2 og Alltid Nyheter:): (.+)"),
       m_noPremiere("\\s+-\\s+(Sesongpremiere|Premiere|premiere)!?$"),
-      m_Stereo("\\b\\(?[sS]tereo\\)?\\b"),
+      m_Stereo("\\b\\(?[sS]tereo\\)?\\b",
+               QRegularExpression::UseUnicodePropertiesOption),
+      m_DotEnd("\\.$"),
       m_dkEpisode("\\(([0-9]+)\\)"),
       m_dkPart("\\(([0-9]+):([0-9]+)\\)"),
       m_dkSubtitle1("^([^:]+): (.+)"),
@@ -192,51 +210,124 @@ EITFixUp::EITFixUp()
       m_AUFreeviewY("(.*) \\(([12][0-9][0-9][0-9])\\)$"),
       m_AUFreeviewYC("(.*) \\(([12][0-9][0-9][0-9])\\) \\((.+)\\)$"),
       m_AUFreeviewSYC("(.*) \\((.+)\\) \\(([12][0-9][0-9][0-9])\\) \\((.+)\\)$"),
-      m_HTML("</?EM>", Qt::CaseInsensitive),
-      m_grReplay("\\([ΕE]\\)"),
-      m_grDescriptionFinale("\\s*Τελευταίο\\sΕπεισόδιο\\.\\s*"),
-      m_grActors("(?:[Ππ]α[ιί]ζουν:|[Μμ]ε τους:|Πρωταγωνιστο[υύ]ν:|Πρωταγωνιστε[ιί]:?)(?:\\s+στο ρόλο(?: του| της)?\\s(?:\\w+\\s[οη]\\s))?([-\\w\\s']+(?:,[-\\w\\s']+)*)(?:κ\\.[αά])?(?:\\W?)"),
+      m_AUNineRating("^\\((G|PG|M|MA)\\)"),
+      m_AUSevenYear("(\\d{4})$"),
+      m_AUSevenAdvisories("(\\([A-Z,]+\\))$"),
+      m_AUSevenRating("(C|G|PG|M|MA)$"),
+      m_HTML("</?EM>",
+             QRegularExpression::CaseInsensitiveOption),
+      m_grReplay("\\([ΕE]\\)",
+                 QRegularExpression::UseUnicodePropertiesOption),
+      m_grDescriptionFinale("\\s*Τελευταίο\\sΕπεισόδιο\\.\\s*",
+                            QRegularExpression::UseUnicodePropertiesOption),
+      m_grActors("(?:[Ππ]α[ιί]ζουν:|[Μμ]ε τους:|Πρωταγωνιστο[υύ]ν:|Πρωταγωνιστε[ιί]:?)(?:\\s+στο ρόλο(?: του| της)?\\s(?:\\w+\\s[οη]\\s))?([-\\w\\s']+(?:,[-\\w\\s']+)*)(?:κ\\.[αά])?(?:\\W?)",
+                 QRegularExpression::UseUnicodePropertiesOption),
       // cap(1) actors, just names
-      m_grFixnofullstopActors("(\\w\\s(Παίζουν:|Πρωταγων))"),
-      m_grFixnofullstopDirectors("((\\w\\s(Σκηνοθ[εέ]))"),
-      m_grPeopleSeparator("(,\\s+)"),
-      m_grDirector("(?:Σκηνοθεσία: |Σκηνοθέτης: )(\\w+\\s\\w+\\s?)(?:\\W?)"),
-      m_grPres("(?:Παρουσ[ιί]αση:(?:\\b)*|Παρουσι[αά]ζ(?:ουν|ει)(?::|\\sο|\\sη)|Με τ(?:ον |ην )(?:[\\s|:|ο|η])*(?:\\b)*)([-\\w\\s]+(?:,[-\\w\\s]+)*)(?:\\W?)"),
-      m_grYear("(?:\\W?)(?:\\s?παραγωγ[ηή]ς|\\s?-|,)\\s*([1-2]{1}[0-9]{3})(?:-\\d{1,4})?",Qt::CaseInsensitive),
-      m_grCountry("(?:\\W|\\b)(?:(ελλην|τουρκ|αμερικ[αά]ν|γαλλ|αγγλ|βρεττ?αν|γερμαν|ρωσσ?|ιταλ|ελβετ|σουηδ|ισπαν|πορτογαλ|μεξικ[αά]ν|κιν[εέ]ζικ|ιαπων|καναδ|βραζιλι[αά]ν)(ικ[ηή][ςσ]))",Qt::CaseInsensitive),
-      m_grlongEp("\\b(?:Επ.|επεισ[οό]διο:?)\\s*(\\d+)(?:\\W?)",Qt::CaseInsensitive),
-      m_grSeason("(?:-\\s)?\\b((\\D{1,2})(?:')?|(\\d{1,2})(?:ος|ου)?)(?:\\sκ[υύ]κλο(?:[σς]|υ)){1}\\s?",Qt::CaseInsensitive),
-      m_grRealTitleinDescription("(?:^\\()([\\w\\s\\d\\D-]+)(?:\\))(?:\\s*)"),
+      m_grFixnofullstopActors("(\\w\\s(Παίζουν:|Πρωταγων))",
+                              QRegularExpression::UseUnicodePropertiesOption),
+      m_grFixnofullstopDirectors("(\\w\\s(Σκηνοθ[εέ]))",
+                                 QRegularExpression::UseUnicodePropertiesOption),
+      m_grPeopleSeparator("(,\\s+)",
+                          QRegularExpression::UseUnicodePropertiesOption),
+      m_grDirector("(?:Σκηνοθεσία: |Σκηνοθέτης: )(\\w+\\s\\w+\\s?)(?:\\W?)",
+                   QRegularExpression::UseUnicodePropertiesOption),
+      m_grPres("(?:Παρουσ[ιί]αση:(?:\\b)*|Παρουσι[αά]ζ(?:ουν|ει)(?::|\\sο|\\sη)|Με τ(?:ον |ην )(?:[\\s|:|ο|η])*(?:\\b)*)([-\\w\\s]+(?:,[-\\w\\s]+)*)(?:\\W?)",
+               QRegularExpression::UseUnicodePropertiesOption),
+      m_grYear("(?:\\W?)(?:\\s?παραγωγ[ηή]ς|\\s?-|,)\\s*([1-2]{1}[0-9]{3})(?:-\\d{1,4})?",
+               QRegularExpression::CaseInsensitiveOption |
+               QRegularExpression::UseUnicodePropertiesOption),
+      m_grCountry("(?:\\W|\\b)(?:(ελλην|τουρκ|αμερικ[αά]ν|γαλλ|αγγλ|βρεττ?αν|γερμαν|ρωσσ?|ιταλ|ελβετ|σουηδ|ισπαν|πορτογαλ|μεξικ[αά]ν|κιν[εέ]ζικ|ιαπων|καναδ|βραζιλι[αά]ν)(ικ[ηή][ςσ]))",
+                  QRegularExpression::CaseInsensitiveOption |
+                  QRegularExpression::UseUnicodePropertiesOption),
+      m_grlongEp("\\b(?:Επ.|επεισ[οό]διο:?)\\s*(\\d+)(?:\\W?)",
+                 QRegularExpression::CaseInsensitiveOption |
+                 QRegularExpression::UseUnicodePropertiesOption),
+      m_grSeason("(?:-\\s)?\\b((\\D{1,2})(?:')?|(\\d{1,2})(?:ος|ου)?)(?:\\sκ[υύ]κλο(?:[σς]|υ)){1}\\s?",
+                 QRegularExpression::CaseInsensitiveOption |
+                 QRegularExpression::UseUnicodePropertiesOption),
+      m_grRealTitleinDescription("(?:^\\()([\\w\\s\\d\\D-]+)(?:\\))(?:\\s*)",
+                                 QRegularExpression::UseUnicodePropertiesOption |
+                                 QRegularExpression::InvertedGreedinessOption),
       // cap1 = real title
       // cap0 = real title in parentheses.
-      m_grRealTitleinTitle("(?:\\()([\\w\\s\\d\\D-]+)(?:\\))(?:\\s*$)*"),
+      m_grRealTitleinTitle("(?:\\()([\\w\\s\\d\\D-]+)(?:\\))(?:\\s*$)*",
+                           QRegularExpression::UseUnicodePropertiesOption),
       // cap1 = real title
       // cap0 = real title in parentheses.
-      m_grNotPreviouslyShown("(?:\\b[Α1]['η]?\\s*(?:τηλεοπτικ[ηή]\\s*)?(?:μετ[αά]δοση|προβολ[ηή]))(?:\\W?)"),
+      m_grNotPreviouslyShown("(?:\\b[Α1]['η]?\\s*(?:τηλεοπτικ[ηή]\\s*)?(?:μετ[αά]δοση|προβολ[ηή]))(?:\\W?)",
+                             QRegularExpression::UseUnicodePropertiesOption),
       // Try to exctract Greek categories from keywords in description.
-      m_grEpisodeAsSubtitle("(?:^Επεισ[οό]διο:\\s?)([\\w\\s-,']+)\\.(?:\\s)?"),
-      m_grCategFood("(?:\\W)?(?:εκπομπ[ηή]\\W)?(Γαστρονομ[ιί]α[σς]?|μαγειρικ[ηή][σς]?|chef|συνταγ[εέηή]|διατροφ|wine|μ[αά]γειρα[σς]?)(?:\\W)?",Qt::CaseInsensitive),
-      m_grCategDrama("(?:\\W)?(κοινωνικ[ηήό]|δραματικ[ηή]|δρ[αά]μα)(?:\\W)(?:(?:εκπομπ[ηή]|σειρ[αά]|ταιν[ιί]α)\\W)?",Qt::CaseInsensitive),
-      m_grCategComedy("(?:\\W)?(κωμικ[ηήοό]|χιουμοριστικ[ηήοό]|κωμωδ[ιί]α)(?:\\W)(?:(?:εκπομπ[ηή]|σειρ[αά]|ταιν[ιί]α)\\W)?",Qt::CaseInsensitive),
-      m_grCategChildren("(?:\\W)?(παιδικ[ηήοό]|κινο[υύ]μ[εέ]ν(ων|α)\\sσχ[εέ]δ[ιί](ων|α))(?:\\W)(?:(?:εκπομπ[ηή]|σειρ[αά]|ταιν[ιί]α)\\W)?",Qt::CaseInsensitive),
-      m_grCategMystery("(?:(?:εκπομπ[ηή]|σειρ[αά]|ταιν[ιί]α)\\W)?(?:\\W)?(μυστηρ[ιί]ου)(?:\\W)?",Qt::CaseInsensitive),
-      m_grCategFantasy("(?:(?:εκπομπ[ηή]|σειρ[αά]|ταιν[ιί]α)\\W)?(?:\\W)?(φαντασ[ιί]ας)(?:\\W)?",Qt::CaseInsensitive),
-      m_grCategHistory("(?:\\W)?(ιστορικ[ηήοό])(?:\\W)?(?:(?:εκπομπ[ηή]|σειρ[αά]|ταιν[ιί]α)\\W)?",Qt::CaseInsensitive),
-      m_grCategTeleMag("(?:\\W)?(ενημερωτικ[ηή]|ψυχαγωγικ[ηή]|τηλεπεριοδικ[οό]|μαγκαζ[ιί]νο)(?:\\W)?(?:(?:εκπομπ[ηή]|σειρ[αά]|ταιν[ιί]α)\\W)?",Qt::CaseInsensitive),
-      m_grCategTeleShop("(?:\\W)?(οδηγ[οό][σς]?\\sαγορ[ωώ]ν|τηλεπ[ωώ]λ[ηή]σ|τηλεαγορ|τηλεμ[αά]ρκετ|telemarket)(?:\\W)?(?:(?:εκπομπ[ηή]|σειρ[αά]|ταιν[ιί]α)\\W)?",Qt::CaseInsensitive),
-      m_grCategGameShow("(?:\\W)?(τηλεπαιχν[ιί]δι|quiz)(?:\\W)?",Qt::CaseInsensitive),
-      m_grCategDocumentary("(?:\\W)?(ντοκ[ιυ]μαντ[εέ]ρ)(?:\\W)?",Qt::CaseInsensitive),
-      m_grCategBiography("(?:\\W)?(βιογραφ[ιί]α|βιογραφικ[οό][σς]?)(?:\\W)?",Qt::CaseInsensitive),
-      m_grCategNews("(?:\\W)?(δελτ[ιί]ο\\W?|ειδ[ηή]σε(ι[σς]|ων))(?:\\W)?",Qt::CaseInsensitive),
-      m_grCategSports("(?:\\W)?(champion|αθλητικ[αάοόηή]|πρωτ[αά]θλημα|ποδ[οό]σφαιρο(ου)?|κολ[υύ]μβηση|πατιν[αά]ζ|formula|μπ[αά]σκετ|β[οό]λε[ιϊ])(?:\\W)?",Qt::CaseInsensitive),
-      m_grCategMusic("(?:\\W)?(μουσικ[οόηή]|eurovision|τραγο[υύ]δι)(?:\\W)?",Qt::CaseInsensitive),
-      m_grCategReality("(?:\\W)?(ρι[αά]λιτι|reality)(?:\\W)?",Qt::CaseInsensitive),
-      m_grCategReligion("(?:\\W)?(θρησκε[ιί]α|θρησκευτικ|να[οό][σς]?|θε[ιί]α λειτουργ[ιί]α)(?:\\W)?",Qt::CaseInsensitive),
-      m_grCategCulture("(?:\\W)?(τ[εέ]χν(η|ε[σς])|πολιτισμ)(?:\\W)?",Qt::CaseInsensitive),
-      m_grCategNature("(?:\\W)?(φ[υύ]ση|περιβ[αά]λλο|κατασκευ|επιστ[ηή]μ(?!ονικ[ηή]ς φαντασ[ιί]ας))(?:\\W)?",Qt::CaseInsensitive),
-      m_grCategSciFi("(?:\\W)?(επιστ(.|ημονικ[ηή]ς)\\s?φαντασ[ιί]ας)(?:\\W)?",Qt::CaseInsensitive),
-      m_grCategHealth("(?:\\W)?(υγε[ιί]α|υγειιν|ιατρικ|διατροφ)(?:\\W)?",Qt::CaseInsensitive),
-      m_grCategSpecial("(?:\\W)?(αφι[εέ]ρωμα)(?:\\W)?",Qt::CaseInsensitive),
+      m_grEpisodeAsSubtitle("(?:^Επεισ[οό]διο:\\s?)([\\w\\s\\-,']+)\\.(?:\\s)?",
+                            QRegularExpression::UseUnicodePropertiesOption),
+      m_grMovie("\\bταιν[ιί]α\\b",
+                QRegularExpression::CaseInsensitiveOption |
+                QRegularExpression::UseUnicodePropertiesOption),
+      m_grCategFood("(?:\\W)?(?:εκπομπ[ηή]\\W)?(Γαστρονομ[ιί]α[σς]?|μαγειρικ[ηή][σς]?|chef|συνταγ[εέηή]|διατροφ|wine|μ[αά]γειρα[σς]?)(?:\\W)?",
+                    QRegularExpression::CaseInsensitiveOption |
+                    QRegularExpression::UseUnicodePropertiesOption),
+      m_grCategDrama("(?:\\W)?(κοινωνικ[ηήό]|δραματικ[ηή]|δρ[αά]μα)(?:\\W)(?:(?:εκπομπ[ηή]|σειρ[αά]|ταιν[ιί]α)\\W)?",
+                     QRegularExpression::CaseInsensitiveOption |
+                     QRegularExpression::UseUnicodePropertiesOption),
+      m_grCategComedy("(?:\\W)?(κωμικ[ηήοό]|χιουμοριστικ[ηήοό]|κωμωδ[ιί]α)(?:\\W)(?:(?:εκπομπ[ηή]|σειρ[αά]|ταιν[ιί]α)\\W)?",
+                      QRegularExpression::CaseInsensitiveOption |
+                      QRegularExpression::UseUnicodePropertiesOption),
+      m_grCategChildren("(?:\\W)?(παιδικ[ηήοό]|κινο[υύ]μ[εέ]ν(ων|α)\\sσχ[εέ]δ[ιί](ων|α))(?:\\W)(?:(?:εκπομπ[ηή]|σειρ[αά]|ταιν[ιί]α)\\W)?",
+                        QRegularExpression::CaseInsensitiveOption |
+                        QRegularExpression::UseUnicodePropertiesOption),
+      m_grCategMystery("(?:(?:εκπομπ[ηή]|σειρ[αά]|ταιν[ιί]α)\\W)?(?:\\W)?(μυστηρ[ιί]ου)(?:\\W)?",
+                       QRegularExpression::CaseInsensitiveOption |
+                       QRegularExpression::UseUnicodePropertiesOption),
+      m_grCategFantasy("(?:(?:εκπομπ[ηή]|σειρ[αά]|ταιν[ιί]α)\\W)?(?:\\W)?(φαντασ[ιί]ας)(?:\\W)?",
+                       QRegularExpression::CaseInsensitiveOption |
+                       QRegularExpression::UseUnicodePropertiesOption),
+      m_grCategHistory("(?:\\W)?(ιστορικ[ηήοό])(?:\\W)?(?:(?:εκπομπ[ηή]|σειρ[αά]|ταιν[ιί]α)\\W)?",
+                       QRegularExpression::CaseInsensitiveOption |
+                       QRegularExpression::UseUnicodePropertiesOption),
+      m_grCategTeleMag("(?:\\W)?(ενημερωτικ[ηή]|ψυχαγωγικ[ηή]|τηλεπεριοδικ[οό]|μαγκαζ[ιί]νο)(?:\\W)?(?:(?:εκπομπ[ηή]|σειρ[αά]|ταιν[ιί]α)\\W)?",
+                       QRegularExpression::CaseInsensitiveOption |
+                       QRegularExpression::UseUnicodePropertiesOption),
+      m_grCategTeleShop("(?:\\W)?(οδηγ[οό][σς]?\\sαγορ[ωώ]ν|τηλεπ[ωώ]λ[ηή]σ|τηλεαγορ|τηλεμ[αά]ρκετ|telemarket)(?:\\W)?(?:(?:εκπομπ[ηή]|σειρ[αά]|ταιν[ιί]α)\\W)?",
+                        QRegularExpression::CaseInsensitiveOption |
+                        QRegularExpression::UseUnicodePropertiesOption),
+      m_grCategGameShow("(?:\\W)?(τηλεπαιχν[ιί]δι|quiz)(?:\\W)?",
+                        QRegularExpression::CaseInsensitiveOption |
+                        QRegularExpression::UseUnicodePropertiesOption),
+      m_grCategDocumentary("(?:\\W)?(ντοκ[ιυ]μαντ[εέ]ρ)(?:\\W)?",
+                           QRegularExpression::CaseInsensitiveOption |
+                           QRegularExpression::UseUnicodePropertiesOption),
+      m_grCategBiography("(?:\\W)?(βιογραφ[ιί]α|βιογραφικ[οό][σς]?)(?:\\W)?",
+                         QRegularExpression::CaseInsensitiveOption |
+                         QRegularExpression::UseUnicodePropertiesOption),
+      m_grCategNews("(?:\\W)?(δελτ[ιί]ο\\W?|ειδ[ηή]σε(ι[σς]|ων))(?:\\W)?",
+                    QRegularExpression::CaseInsensitiveOption |
+                    QRegularExpression::UseUnicodePropertiesOption),
+      m_grCategSports("(?:\\W)?(champion|αθλητικ[αάοόηή]|πρωτ[αά]θλημα|ποδ[οό]σφαιρο(ου)?|κολ[υύ]μβηση|πατιν[αά]ζ|formula|μπ[αά]σκετ|β[οό]λε[ιϊ])(?:\\W)?",
+                      QRegularExpression::CaseInsensitiveOption |
+                      QRegularExpression::UseUnicodePropertiesOption),
+      m_grCategMusic("(?:\\W)?(μουσικ[οόηή]|eurovision|τραγο[υύ]δι)(?:\\W)?",
+                     QRegularExpression::CaseInsensitiveOption |
+                     QRegularExpression::UseUnicodePropertiesOption),
+      m_grCategReality("(?:\\W)?(ρι[αά]λιτι|reality)(?:\\W)?",
+                       QRegularExpression::CaseInsensitiveOption |
+                       QRegularExpression::UseUnicodePropertiesOption),
+      m_grCategReligion("(?:\\W)?(θρησκε[ιί]α|θρησκευτικ|να[οό][σς]?|θε[ιί]α λειτουργ[ιί]α)(?:\\W)?",
+                        QRegularExpression::CaseInsensitiveOption |
+                        QRegularExpression::UseUnicodePropertiesOption),
+      m_grCategCulture("(?:\\W)?(τ[εέ]χν(η|ε[σς])|πολιτισμ)(?:\\W)?",
+                       QRegularExpression::CaseInsensitiveOption |
+                       QRegularExpression::UseUnicodePropertiesOption),
+      m_grCategNature("(?:\\W)?(φ[υύ]ση|περιβ[αά]λλο|κατασκευ|επιστ[ηή]μ(?!ονικ[ηή]ς φαντασ[ιί]ας))(?:\\W)?",
+                      QRegularExpression::CaseInsensitiveOption |
+                      QRegularExpression::UseUnicodePropertiesOption),
+      m_grCategSciFi("(?:\\W)?(επιστ(.|ημονικ[ηή]ς)\\s?φαντασ[ιί]ας)(?:\\W)?",
+                     QRegularExpression::CaseInsensitiveOption |
+                     QRegularExpression::UseUnicodePropertiesOption),
+      m_grCategHealth("(?:\\W)?(υγε[ιί]α|υγειιν|ιατρικ|διατροφ)(?:\\W)?",
+                      QRegularExpression::CaseInsensitiveOption |
+                      QRegularExpression::UseUnicodePropertiesOption),
+      m_grCategSpecial("(?:\\W)?(αφι[εέ]ρωμα)(?:\\W)?",
+                       QRegularExpression::CaseInsensitiveOption |
+                       QRegularExpression::UseUnicodePropertiesOption),
       m_unitymediaImdbrating("\\s*IMDb Rating: (\\d\\.\\d) /10$")
 {
 }
@@ -651,12 +742,10 @@ void EITFixUp::FixBellExpressVu(DBEventEIT &event) const
     }
 
     // Remove Dish's PPV code at the end of the description
-    QRegExp ppvcode = m_dishPPVCode;
-    ppvcode.setCaseSensitivity(Qt::CaseInsensitive);
-    position = event.description.indexOf(ppvcode);
+    position = event.description.indexOf(m_dishPPVCode);
     if (position != -1)
     {
-        event.description = event.description.replace(ppvcode, "");
+        event.description = event.description.replace(m_dishPPVCode, "");
     }
 
     // Remove trailing garbage
@@ -766,11 +855,13 @@ void EITFixUp::SetUKSubtitle(DBEventEIT &event) const
              fColon = true;
          }
     }
-    QRegExp tmpQuotedSubtitle = m_ukQuotedSubtitle;
-    if (tmpQuotedSubtitle.indexIn(event.description) != -1)
+    QRegularExpressionMatch match;
+    if (event.description.startsWith('\'') &&
+        (match = m_ukQuotedSubtitle.match(event.description)).hasMatch())
     {
-        event.subtitle = tmpQuotedSubtitle.cap(1);
-        event.description.remove(m_ukQuotedSubtitle);
+        event.subtitle = match.captured(1);
+        event.description.remove(match.capturedStart(),
+                                 match.capturedLength());
         fQuotedSubtitle = true;
     }
     QStringList strListPeriod;
@@ -825,6 +916,18 @@ void EITFixUp::SetUKSubtitle(DBEventEIT &event) const
 }
 
 
+/// Literal pre-filter for the UK patterns that cannot match without a digit
+static bool containsDigit(const QString &str)
+{
+    const QChar *c = str.constData();
+    for (int i = 0; i < str.length(); ++i)
+    {
+        if (c[i].isDigit())
+            return true;
+    }
+    return false;
+}
+
 /** \fn EITFixUp::FixUK(DBEventEIT&) const
  *  \brief Use this in the United Kingdom to standardize DVB-T guide.
  */
@@ -836,37 +939,55 @@ void EITFixUp::FixUK(DBEventEIT &event) const
 
     bool isMovie = event.category.startsWith("Movie",Qt::CaseInsensitive) ||
                    event.category.startsWith("Film",Qt::CaseInsensitive);
+    QRegularExpressionMatch match;
+
+    // Each pattern below is guarded by a cheap literal test for text the
+    // pattern cannot match without; most events skip most of the patterns.
+
     // BBC three case (could add another record here ?)
-    event.description = event.description.remove(m_ukThen);
-    event.description = event.description.remove(m_ukNew);
-    event.title = event.title.remove(m_ukNewTitle);
+    if (event.description.contains("60 Seconds", Qt::CaseInsensitive))
+        event.description = event.description.remove(m_ukThen);
+    if (event.description.contains("New", Qt::CaseInsensitive))
+        event.description = event.description.remove(m_ukNew);
+    if (event.title.startsWith("Brand New", Qt::CaseInsensitive) ||
+        event.title.startsWith("New:", Qt::CaseInsensitive))
+        event.title = event.title.remove(m_ukNewTitle);
 
     // Removal of Class TV, CBBC and CBeebies etc..
-    event.title = event.title.remove(m_ukTitleRemove);
-    event.description = event.description.remove(m_ukDescriptionRemove);
+    if (event.title.startsWith("T4:", Qt::CaseInsensitive) ||
+        event.title.startsWith("Schools"))
+        event.title = event.title.remove(m_ukTitleRemove);
+    if (event.description.startsWith('C') ||
+        event.description.startsWith("BBC Switch."))
+        event.description = event.description.remove(m_ukDescriptionRemove);
 
     // Removal of BBC FOUR and BBC THREE
-    event.description = event.description.remove(m_ukBBC34);
+    if (event.description.contains("on BBC ", Qt::CaseInsensitive))
+        event.description = event.description.remove(m_ukBBC34);
 
     // BBC 7 [Rpt of ...] case.
-    event.description = event.description.remove(m_ukBBC7rpt);
+    if (event.description.contains("[Rpt"))
+        event.description = event.description.remove(m_ukBBC7rpt);
 
     // "All New To 4Music!
-    event.description = event.description.remove(m_ukAllNew);
+    if (event.description.contains("All New To 4Music!"))
+        event.description = event.description.remove(m_ukAllNew);
 
     // Removal of 'Also in HD' text
- 	event.description = event.description.remove(m_ukAlsoInHD);
+    if (event.description.contains("Also in HD", Qt::CaseInsensitive))
+        event.description = event.description.remove(m_ukAlsoInHD);
 
     // Remove [AD,S] etc.
-    bool    ccMatched = false;
-    QRegExp tmpCC = m_ukCC;
-    position1 = 0;
-    while ((position1 = tmpCC.indexIn(event.description, position1)) != -1)
+    bool ccMatched = false;
+    QRegularExpressionMatchIterator ccIt;
+    if (event.description.contains('['))
+        ccIt = m_ukCC.globalMatch(event.description);
+    while (ccIt.hasNext())
     {
         ccMatched = true;
-        position1 += tmpCC.matchedLength();
 
-        QStringList tmpCCitems = tmpCC.cap(0).remove("[").remove("]").split(",");
+        QStringList tmpCCitems = ccIt.next().captured(0)
+            .remove("[").remove("]").split(",");
         if (tmpCCitems.contains("AD"))
             event.audioProps |= AUD_VISUALIMPAIR;
         if (tmpCCitems.contains("HD"))
@@ -887,41 +1008,47 @@ void EITFixUp::FixUK(DBEventEIT &event) const
 
     // Work out the season and episode numbers (if any)
     // Matching pattern "Season 2 Episode|Ep 3 of 14|3/14" etc
-    bool    series  = false;
-    QRegExp tmpSeries = m_ukSeries;
-    if ((position1 = tmpSeries.indexIn(event.title)) != -1
-            || (position2 = tmpSeries.indexIn(event.description)) != -1)
+    bool series = false;
+    position1 = -1;
+    if (containsDigit(event.title) &&
+        (match = m_ukSeries.match(event.title)).hasMatch())
+        position1 = match.capturedStart();
+    else if (containsDigit(event.description))
+        match = m_ukSeries.match(event.description);
+    if (match.hasMatch())
     {
-        if (!tmpSeries.cap(1).isEmpty())
+        position2 = match.capturedStart();
+
+        if (!match.captured(1).isEmpty())
         {
-            event.season = tmpSeries.cap(1).toUInt();
+            event.season = match.captured(1).toUInt();
             series = true;
         }
 
-        if (!tmpSeries.cap(2).isEmpty())
+        if (!match.captured(2).isEmpty())
         {
-            event.episode = tmpSeries.cap(2).toUInt();
+            event.episode = match.captured(2).toUInt();
             series = true;
         }
-        else if (!tmpSeries.cap(5).isEmpty())
+        else if (!match.captured(5).isEmpty())
         {
-            event.episode = tmpSeries.cap(5).toUInt();
+            event.episode = match.captured(5).toUInt();
             series = true;
         }
 
-        if (!tmpSeries.cap(3).isEmpty())
+        if (!match.captured(3).isEmpty())
         {
-            event.totalepisodes = tmpSeries.cap(3).toUInt();
+            event.totalepisodes = match.captured(3).toUInt();
             series = true;
         }
-        else if (!tmpSeries.cap(6).isEmpty())
+        else if (!match.captured(6).isEmpty())
         {
-            event.totalepisodes = tmpSeries.cap(6).toUInt();
+            event.totalepisodes = match.captured(6).toUInt();
             series = true;
         }
 
         // Remove long or short match. Short text doesn't start at position2
-        int form = tmpSeries.cap(4).isEmpty() ? 0 : 4;
+        int form = match.captured(4).isEmpty() ? 0 : 4;
 
         if (position1 != -1)
         {
@@ -929,7 +1056,7 @@ void EITFixUp::FixUK(DBEventEIT &event) const
                 .arg(event.season).arg(event.episode).arg(event.totalepisodes)
                 .arg(event.title, event.description));
 
-            event.title.remove(tmpSeries.cap(form));
+            event.title.remove(match.captured(form));
         }
         else
         {
@@ -940,7 +1067,7 @@ void EITFixUp::FixUK(DBEventEIT &event) const
             if (position2 == 0)
      		    // Remove from the start of the description.
 		        // Otherwise it ends up in the subtitle.
-                event.description.remove(tmpSeries.cap(form));
+                event.description.remove(match.captured(form));
         }
     }
 
@@ -951,22 +1078,24 @@ void EITFixUp::FixUK(DBEventEIT &event) const
 
     // Multi-part episodes, or films (e.g. ITV film split by news)
     // Matches Part 1, Pt 1/2, Part 1 of 2 etc.
-    QRegExp tmpPart = m_ukPart;
-    if ((position1 = tmpPart.indexIn(event.title)) != -1)
+    if (containsDigit(event.title) &&
+        (match = m_ukPart.match(event.title)).hasMatch())
     {
-        event.partnumber = tmpPart.cap(1).toUInt();
-        event.parttotal  = tmpPart.cap(2).toUInt();
+        event.partnumber = match.captured(1).toUInt();
+        event.parttotal  = match.captured(2).toUInt();
 
         LOG(VB_EIT, LOG_DEBUG, QString("Extracted Part %1/%2 from title (%3)")
             .arg(event.partnumber).arg(event.parttotal).arg(event.title));
 
         // Remove from the title
-        event.title = event.title.remove(tmpPart.cap(0));
+        event.title = event.title.remove(match.captured(0));
     }
-    else if ((position1 = tmpPart.indexIn(event.description)) != -1)
+    else if (containsDigit(event.description) &&
+             (match = m_ukPart.match(event.description)).hasMatch())
     {
-        event.partnumber = tmpPart.cap(1).toUInt();
-        event.parttotal  = tmpPart.cap(2).toUInt();
+        position1 = match.capturedStart();
+        event.partnumber = match.captured(1).toUInt();
+        event.parttotal  = match.captured(2).toUInt();
 
         LOG(VB_EIT, LOG_DEBUG, QString("Extracted Part %1/%2 from description (%3) \"%4\"")
             .arg(event.partnumber).arg(event.parttotal)
@@ -977,21 +1106,21 @@ void EITFixUp::FixUK(DBEventEIT &event) const
         if (position1 == 0)
         {
             // Retain a single colon (subtitle separator) if we remove any
-            QString sub = tmpPart.cap(0).contains(":") ? ":" : "";
-            event.description = event.description.replace(tmpPart.cap(0), sub);
+            QString sub = match.captured(0).contains(":") ? ":" : "";
+            event.description = event.description.replace(match.captured(0), sub);
         }
     }
 
-    QRegExp tmpStarring = m_ukStarring;
-    if (tmpStarring.indexIn(event.description) != -1)
+    if (event.description.contains("tarring ") &&
+        (match = m_ukStarring.match(event.description)).hasMatch())
     {
         // if we match this we've captured 2 actors and an (optional) airdate
-        event.AddPerson(DBPerson::kActor, tmpStarring.cap(1));
-        event.AddPerson(DBPerson::kActor, tmpStarring.cap(2));
-        if (tmpStarring.cap(3).length() > 0)
+        event.AddPerson(DBPerson::kActor, match.captured(1));
+        event.AddPerson(DBPerson::kActor, match.captured(2));
+        if (match.captured(3).length() > 0)
         {
             bool ok;
-            uint y = tmpStarring.cap(3).toUInt(&ok);
+            uint y = match.captured(3).toUInt(&ok);
             if (ok)
             {
                 event.airdate = y;
@@ -1000,7 +1129,6 @@ void EITFixUp::FixUK(DBEventEIT &event) const
         }
     }
 
-    QRegExp tmp24ep = m_uk24ep;
     if (!event.title.startsWith("CSI:") && !event.title.startsWith("CD:") &&
         !event.title.contains(m_ukLaONoSplit) &&
         !event.title.startsWith("Mission: Impossible"))
@@ -1038,13 +1166,14 @@ void EITFixUp::FixUK(DBEventEIT &event) const
                 }
             }
         }
-        else if ((position1 = tmp24ep.indexIn(event.description)) != -1)
+        else if (event.description.contains(":00") &&
+                 (match = m_uk24ep.match(event.description)).hasMatch())
         {
             // Special case for episodes of 24.
             // -2 from the length cause we don't want ": " on the end
-            event.subtitle = event.description.mid(position1,
-                                tmp24ep.cap(0).length() - 2);
-            event.description = event.description.remove(tmp24ep.cap(0));
+            event.subtitle = event.description.mid(match.capturedStart(),
+                                match.capturedLength() - 2);
+            event.description = event.description.remove(match.captured(0));
         }
         else if ((position1 = event.description.indexOf(m_ukTime)) == -1)
         {
@@ -1095,14 +1224,12 @@ void EITFixUp::FixUK(DBEventEIT &event) const
     }
 
     // Work out the year (if any)
-    QRegExp tmpUKYear = m_ukYear;
-    if ((position1 = tmpUKYear.indexIn(event.description)) != -1)
+    if (containsDigit(event.description) &&
+        (match = m_ukYear.match(event.description)).hasMatch())
     {
-        QString stmp = event.description;
-        int     itmp = position1 + tmpUKYear.cap(0).length();
-        event.description = stmp.left(position1) + stmp.mid(itmp);
+        event.description.remove(match.capturedStart(), match.capturedLength());
         bool ok;
-        uint y = tmpUKYear.cap(1).toUInt(&ok);
+        uint y = match.captured(1).toUInt(&ok);
         if (ok)
         {
             event.airdate = y;
@@ -1155,31 +1282,27 @@ void EITFixUp::FixComHem(DBEventEIT &event, bool process_subtitle) const
 
     bool isSeries = false;
     // Try to find episode numbers
-    int pos;
-    QRegExp tmpSeries1 = m_comHemSeries1;
-    QRegExp tmpSeries2 = m_comHemSeries2;
-    if ((pos = tmpSeries2.indexIn(event.title)) != -1)
+    QRegularExpressionMatch match;
+    if ((match = m_comHemSeries2.match(event.title)).hasMatch())
     {
-        QStringList list = tmpSeries2.capturedTexts();
-        event.partnumber = list[2].toUInt();
-        event.title = event.title.replace(list[0],"");
+        event.partnumber = match.captured(2).toUInt();
+        event.title = event.title.replace(match.captured(0),"");
     }
-    else if ((pos = tmpSeries1.indexIn(event.description)) != -1)
+    else if ((match = m_comHemSeries1.match(event.description)).hasMatch())
     {
-        QStringList list = tmpSeries1.capturedTexts();
-        if (!list[1].isEmpty())
+        if (!match.captured(1).isEmpty())
         {
-            event.partnumber = list[1].toUInt();
+            event.partnumber = match.captured(1).toUInt();
         }
-        if (!list[2].isEmpty())
+        if (!match.captured(2).isEmpty())
         {
-            event.parttotal = list[2].toUInt();
+            event.parttotal = match.captured(2).toUInt();
         }
 
         // Remove the episode numbers, but only if it's not at the begining
         // of the description (subtitle code might use it)
-        if(pos > 0)
-            event.description = event.description.replace(list[0],"");
+        if (match.capturedStart() > 0)
+            event.description = event.description.replace(match.captured(0),"");
         isSeries = true;
     }
 
@@ -1195,11 +1318,11 @@ void EITFixUp::FixComHem(DBEventEIT &event, bool process_subtitle) const
     }
 
     // Move subtitle info from title to subtitle
-    QRegExp tmpTSub = m_comHemTSub;
-    if (tmpTSub.indexIn(event.title) != -1)
+    match = m_comHemTSub.match(event.title);
+    if (match.hasMatch())
     {
-        event.subtitle = tmpTSub.cap(1);
-        event.title = event.title.replace(tmpTSub.cap(0),"");
+        event.subtitle = match.captured(1);
+        event.title = event.title.replace(match.captured(0),"");
     }
 
     // No need to continue without a description.
@@ -1208,11 +1331,13 @@ void EITFixUp::FixComHem(DBEventEIT &event, bool process_subtitle) const
 
     // Try to find country category, year and possibly other information
     // from the begining of the description
-    QRegExp tmpCountry = m_comHemCountry;
-    pos = tmpCountry.indexIn(event.description);
-    if (pos != -1)
+    match = m_comHemCountry.match(event.description);
+    if (match.hasMatch())
     {
-        QStringList list = tmpCountry.capturedTexts();
+        // Unmatched trailing groups are left out of capturedTexts()
+        QStringList list;
+        for (int i = 0; i <= 5; i++)
+            list << match.captured(i);
         QString replacement;
 
         // Original title, usually english title
@@ -1274,41 +1399,37 @@ void EITFixUp::FixComHem(DBEventEIT &event, bool process_subtitle) const
         event.categoryType = ProgramInfo::kCategorySeries;
 
     // Look for additional persons in the description
-    QRegExp tmpPersons = m_comHemPersons;
-    while(pos = tmpPersons.indexIn(event.description),pos!=-1)
+    while ((match = m_comHemPersons.match(event.description)).hasMatch())
     {
         DBPerson::Role role;
-        QStringList list = tmpPersons.capturedTexts();
+        const QString roleText = match.captured(1);
 
-        QRegExp tmpDirector = m_comHemDirector;
-        QRegExp tmpActor = m_comHemActor;
-        QRegExp tmpHost = m_comHemHost;
-        if (tmpDirector.indexIn(list[1])!=-1)
+        if (roleText.contains(m_comHemDirector))
         {
             role = DBPerson::kDirector;
         }
-        else if(tmpActor.indexIn(list[1])!=-1)
+        else if (roleText.contains(m_comHemActor))
         {
             role = DBPerson::kActor;
         }
-        else if(tmpHost.indexIn(list[1])!=-1)
+        else if (roleText.contains(m_comHemHost))
         {
             role = DBPerson::kHost;
         }
         else
         {
-            event.description=event.description.replace(list[0],"");
+            event.description=event.description.replace(match.captured(0),"");
             continue;
         }
 
-        const QStringList actors =
-            list[2].split(m_comHemPersSeparator, QString::SkipEmptyParts);
+        const QStringList actors = match.captured(2).split(
+            m_comHemPersSeparator, QString::SkipEmptyParts);
         QStringList::const_iterator it = actors.begin();
         for (; it != actors.end(); ++it)
             event.AddPerson(role, *it);
 
         // Remove it
-        event.description=event.description.replace(list[0],"");
+        event.description=event.description.replace(match.captured(0),"");
     }
 
     // Is this event on a channel we shoud look for a subtitle?
@@ -1335,36 +1456,35 @@ void EITFixUp::FixComHem(DBEventEIT &event, bool process_subtitle) const
     }
 
     // Try to findout if this is a rerun and if so the date.
-    QRegExp tmpRerun1 = m_comHemRerun1;
-    if (tmpRerun1.indexIn(event.description) == -1)
+    match = m_comHemRerun1.match(event.description);
+    if (!match.hasMatch())
         return;
 
     // Rerun from today
-    QStringList list = tmpRerun1.capturedTexts();
-    if (list[1] == "i dag")
+    const QString rerun = match.captured(1);
+    if (rerun == "i dag")
     {
         event.originalairdate = event.starttime.date();
         return;
     }
 
     // Rerun from yesterday afternoon
-    if (list[1] == "eftermiddagen")
+    if (rerun == "eftermiddagen")
     {
         event.originalairdate = event.starttime.date().addDays(-1);
         return;
     }
 
     // Rerun with day, month and possibly year specified
-    QRegExp tmpRerun2 = m_comHemRerun2;
-    if (tmpRerun2.indexIn(list[1]) != -1)
+    QRegularExpressionMatch datematch = m_comHemRerun2.match(rerun);
+    if (datematch.hasMatch())
     {
-        QStringList datelist = tmpRerun2.capturedTexts();
-        int day   = datelist[1].toInt();
-        int month = datelist[2].toInt();
+        int day   = datematch.captured(1).toInt();
+        int month = datematch.captured(2).toInt();
         //int year;
 
-        //if (datelist[3].length() > 0)
-        //    year = datelist[3].toInt();
+        //if (datematch.captured(3).length() > 0)
+        //    year = datematch.captured(3).toInt();
         //else
         //    year = event.starttime.date().year();
 
@@ -1426,13 +1546,13 @@ void EITFixUp::FixAUDescription(DBEventEIT &event) const
  */
 void EITFixUp::FixAUNine(DBEventEIT &event) const
 {
-    QRegExp rating("\\((G|PG|M|MA)\\)");
-    if (rating.indexIn(event.description) == 0)
+    QRegularExpressionMatch match = m_AUNineRating.match(event.description);
+    if (match.hasMatch())
     {
       EventRating prograting;
-      prograting.system="AU"; prograting.rating = rating.cap(1);
+      prograting.system="AU"; prograting.rating = match.captured(1);
       event.ratings.push_back(prograting);
-      event.description.remove(0,rating.matchedLength()+1);
+      event.description.remove(0,match.capturedLength()+1);
     }
     if (event.description.startsWith("[HD]"))
     {
@@ -1462,10 +1582,10 @@ void EITFixUp::FixAUSeven(DBEventEIT &event) const
         event.previouslyshown = true;
         event.description.resize(event.description.size()-4);
     }
-    QRegExp year("(\\d{4})$");
-    if (year.indexIn(event.description) != -1)
+    QRegularExpressionMatch match = m_AUSevenYear.match(event.description);
+    if (match.hasMatch())
     {
-        event.airdate = year.cap(3).toUInt();
+        event.airdate = match.captured(1).toUInt();
         event.description.resize(event.description.size()-5);
     }
     if (event.description.endsWith(" CC"))
@@ -1474,21 +1594,21 @@ void EITFixUp::FixAUSeven(DBEventEIT &event) const
       event.description.resize(event.description.size()-3);
     }
     QString advisories;//store the advisories to append later
-    QRegExp adv("(\\([A-Z,]+\\))$");
-    if (adv.indexIn(event.description) != -1)
+    match = m_AUSevenAdvisories.match(event.description);
+    if (match.hasMatch())
     {
-        advisories = adv.cap(1);
-        event.description.resize(event.description.size()-(adv.matchedLength()+1));
+        advisories = match.captured(1);
+        event.description.resize(event.description.size()-(match.capturedLength()+1));
     }
-    QRegExp rating("(C|G|PG|M|MA)$");
-    if (rating.indexIn(event.description) != -1)
+    match = m_AUSevenRating.match(event.description);
+    if (match.hasMatch())
     {
         EventRating prograting;
-        prograting.system=""; prograting.rating = rating.cap(1);
+        prograting.system=""; prograting.rating = match.captured(1);
         if (!advisories.isEmpty())
             prograting.rating.append(" ").append(advisories);
         event.ratings.push_back(prograting);
-        event.description.resize(event.description.size()-(rating.matchedLength()+1));
+        event.description.resize(event.description.size()-(match.capturedLength()+1));
     }
 }
 /** \fn EITFixUp::FixAUFreeview(DBEventEIT&) const
@@ -1499,35 +1619,37 @@ void EITFixUp::FixAUFreeview(DBEventEIT &event) const
     if (event.description.endsWith(".."))//has been truncated to fit within the 'subtitle' eit field, so none of the following will work (ABC)
         return;
 
-    if (m_AUFreeviewSY.indexIn(event.description.trimmed(), 0) != -1)
+    const QString description = event.description.trimmed();
+    QRegularExpressionMatch match;
+    if ((match = m_AUFreeviewSY.match(description)).hasMatch())
     {
         if (event.subtitle.isEmpty())//nine sometimes has an actual subtitle field and the brackets thingo)
-            event.subtitle = m_AUFreeviewSY.cap(2);
-        event.airdate = m_AUFreeviewSY.cap(3).toUInt();
-        event.description = m_AUFreeviewSY.cap(1);
+            event.subtitle = match.captured(2);
+        event.airdate = match.captured(3).toUInt();
+        event.description = match.captured(1);
     }
-    else if (m_AUFreeviewY.indexIn(event.description.trimmed(), 0) != -1)
+    else if ((match = m_AUFreeviewY.match(description)).hasMatch())
     {
-        event.airdate = m_AUFreeviewY.cap(2).toUInt();
-        event.description = m_AUFreeviewY.cap(1);
+        event.airdate = match.captured(2).toUInt();
+        event.description = match.captured(1);
     }
-    else if (m_AUFreeviewSYC.indexIn(event.description.trimmed(), 0) != -1)
+    else if ((match = m_AUFreeviewSYC.match(description)).hasMatch())
     {
         if (event.subtitle.isEmpty())
-            event.subtitle = m_AUFreeviewSYC.cap(2);
-        event.airdate = m_AUFreeviewSYC.cap(3).toUInt();
-        QStringList actors = m_AUFreeviewSYC.cap(4).split("/");
+            event.subtitle = match.captured(2);
+        event.airdate = match.captured(3).toUInt();
+        QStringList actors = match.captured(4).split("/");
         for (int i = 0; i < actors.size(); ++i)
             event.AddPerson(DBPerson::kActor, actors.at(i));
-        event.description = m_AUFreeviewSYC.cap(1);
+        event.description = match.captured(1);
     }
-    else if (m_AUFreeviewYC.indexIn(event.description.trimmed(), 0) != -1)
+    else if ((match = m_AUFreeviewYC.match(description)).hasMatch())
     {
-        event.airdate = m_AUFreeviewYC.cap(2).toUInt();
-        QStringList actors = m_AUFreeviewYC.cap(3).split("/");
+        event.airdate = match.captured(2).toUInt();
+        QStringList actors = match.captured(3).split("/");
         for (int i = 0; i < actors.size(); ++i)
             event.AddPerson(DBPerson::kActor, actors.at(i));
-        event.description = m_AUFreeviewYC.cap(1);
+        event.description = match.captured(1);
     }
 }
 
@@ -1539,7 +1661,7 @@ void EITFixUp::FixMCA(DBEventEIT &event) const
     const uint SUBTITLE_PCT     = 60; // % of description to allow subtitle to
     const uint SUBTITLE_MAX_LEN = 128;// max length of subtitle field in db.
     int        position;
-    QRegExp    tmpExp1;
+    QRegularExpressionMatch match;
 
     // Remove subtitle, it contains category information too specific to use
     event.subtitle = QString("");
@@ -1549,42 +1671,44 @@ void EITFixUp::FixMCA(DBEventEIT &event) const
         return;
 
     // Replace incomplete title if the full one is in the description
-    tmpExp1 = m_mcaIncompleteTitle;
-    if (tmpExp1.indexIn(event.title) != -1)
+    match = m_mcaIncompleteTitle.match(event.title);
+    if (match.hasMatch())
     {
-        tmpExp1 = QRegExp( QString(m_mcaCompleteTitlea.pattern() + tmpExp1.cap(1) +
-                                   m_mcaCompleteTitleb.pattern()));
-        tmpExp1.setCaseSensitivity(Qt::CaseInsensitive);
-        if (tmpExp1.indexIn(event.description) != -1)
+        // Only truncated titles pay for building this pattern
+        QRegularExpression completeTitle(
+            m_mcaCompleteTitlea.pattern() + match.captured(1) +
+            m_mcaCompleteTitleb.pattern(),
+            QRegularExpression::CaseInsensitiveOption);
+        match = completeTitle.match(event.description);
+        if (match.hasMatch())
         {
-            event.title       = tmpExp1.cap(1).trimmed();
-            event.description = tmpExp1.cap(2).trimmed();
+            event.title       = match.captured(1).trimmed();
+            event.description = match.captured(2).trimmed();
         }
-        tmpExp1.setCaseSensitivity(Qt::CaseSensitive);
     }
 
     // Try to find subtitle in description
-    tmpExp1 = m_mcaSubtitle;
-    if ((position = tmpExp1.indexIn(event.description)) != -1)
+    match = m_mcaSubtitle.match(event.description);
+    if (match.hasMatch())
     {
-        uint tmpExp1Len = tmpExp1.cap(1).length();
+        uint tmpExp1Len = match.captured(1).length();
         uint evDescLen = max(event.description.length(), 1);
 
         if ((tmpExp1Len < SUBTITLE_MAX_LEN) &&
             ((tmpExp1Len * 100 / evDescLen) < SUBTITLE_PCT))
         {
-            event.subtitle    = tmpExp1.cap(1);
-            event.description = tmpExp1.cap(2);
+            event.subtitle    = match.captured(1);
+            event.description = match.captured(2);
         }
     }
 
     // Try to find episode numbers in subtitle
-    tmpExp1 = m_mcaSeries;
-    if ((position = tmpExp1.indexIn(event.subtitle)) != -1)
+    match = m_mcaSeries.match(event.subtitle);
+    if (match.hasMatch())
     {
-        uint season    = tmpExp1.cap(1).toUInt();
-        uint episode   = tmpExp1.cap(2).toUInt();
-        event.subtitle = tmpExp1.cap(3).trimmed();
+        uint season    = match.captured(1).toUInt();
+        uint episode   = match.captured(2).toUInt();
+        event.subtitle = match.captured(3).trimmed();
         event.syndicatedepisodenumber =
                 QString("S%1E%2").arg(season).arg(episode);
         event.season = season;
@@ -1613,29 +1737,27 @@ void EITFixUp::FixMCA(DBEventEIT &event) const
 
     // Try to find year and director from the end of the description
     bool isMovie = false;
-    tmpExp1  = m_mcaCredits;
-    position = tmpExp1.indexIn(event.description);
-    if (position != -1)
+    match = m_mcaCredits.match(event.description);
+    if (match.hasMatch())
     {
         isMovie = true;
-        event.description = tmpExp1.cap(1).trimmed();
+        event.description = match.captured(1).trimmed();
         bool ok;
-        uint y = tmpExp1.cap(2).trimmed().toUInt(&ok);
+        uint y = match.captured(2).trimmed().toUInt(&ok);
         if (ok)
             event.airdate = y;
-        event.AddPerson(DBPerson::kDirector, tmpExp1.cap(3).trimmed());
+        event.AddPerson(DBPerson::kDirector, match.captured(3).trimmed());
     }
     else
     {
         // Try to find year only from the end of the description
-        tmpExp1  = m_mcaYear;
-        position = tmpExp1.indexIn(event.description);
-        if (position != -1)
+        match = m_mcaYear.match(event.description);
+        if (match.hasMatch())
         {
             isMovie = true;
-            event.description = tmpExp1.cap(1).trimmed();
+            event.description = match.captured(1).trimmed();
             bool ok;
-            uint y = tmpExp1.cap(2).trimmed().toUInt(&ok);
+            uint y = match.captured(2).trimmed().toUInt(&ok);
             if (ok)
                 event.airdate = y;
         }
@@ -1643,16 +1765,15 @@ void EITFixUp::FixMCA(DBEventEIT &event) const
 
     if (isMovie)
     {
-        tmpExp1  = m_mcaActors;
-        position = tmpExp1.indexIn(event.description);
-        if (position != -1)
+        match = m_mcaActors.match(event.description);
+        if (match.hasMatch())
         {
-            const QStringList actors = tmpExp1.cap(2).split(
+            const QStringList actors = match.captured(2).split(
                 m_mcaActorsSeparator, QString::SkipEmptyParts);
             QStringList::const_iterator it = actors.begin();
             for (; it != actors.end(); ++it)
                 event.AddPerson(DBPerson::kActor, (*it).trimmed());
-            event.description = tmpExp1.cap(1).trimmed();
+            event.description = match.captured(1).trimmed();
         }
         event.categoryType = ProgramInfo::kCategoryMovie;
     }
@@ -1664,85 +1785,73 @@ void EITFixUp::FixMCA(DBEventEIT &event) const
  */
 void EITFixUp::FixRTL(DBEventEIT &event) const
 {
-    int        pos;
-
     // No need to continue without a description or with an subtitle.
     if (event.description.length() <= 0 || event.subtitle.length() > 0)
         return;
 
     // Repeat
-    QRegExp tmpExpRepeat = m_RTLrepeat;
-    if ((pos = tmpExpRepeat.indexIn(event.description)) != -1)
+    QRegularExpressionMatch match = m_RTLrepeat.match(event.description);
+    if (match.hasMatch())
     {
         // remove '.' if it matches at the beginning of the description
-        int length = tmpExpRepeat.cap(0).length() + (pos ? 0 : 1);
+        int pos = match.capturedStart();
+        int length = match.capturedLength() + (pos ? 0 : 1);
         event.description = event.description.remove(pos, length).trimmed();
     }
 
-    QRegExp tmpExp1 = m_RTLSubtitle;
-    QRegExp tmpExpSubtitle1 = m_RTLSubtitle1;
-    tmpExpSubtitle1.setMinimal(true);
-    QRegExp tmpExpSubtitle2 = m_RTLSubtitle2;
-    QRegExp tmpExpSubtitle3 = m_RTLSubtitle3;
-    QRegExp tmpExpSubtitle4 = m_RTLSubtitle4;
-    QRegExp tmpExpSubtitle5 = m_RTLSubtitle5;
-    tmpExpSubtitle5.setMinimal(true);
-    QRegExp tmpExpEpisodeNo1 = m_RTLEpisodeNo1;
-    QRegExp tmpExpEpisodeNo2 = m_RTLEpisodeNo2;
-
     // subtitle with episode number: "Folge *: 'subtitle'. description
-    if (tmpExpSubtitle1.indexIn(event.description) != -1)
+    if ((match = m_RTLSubtitle1.match(event.description)).hasMatch())
     {
-        event.syndicatedepisodenumber = tmpExpSubtitle1.cap(1);
-        event.subtitle    = tmpExpSubtitle1.cap(2);
+        event.syndicatedepisodenumber = match.captured(1);
+        event.subtitle    = match.captured(2);
         event.description =
-            event.description.remove(0, tmpExpSubtitle1.matchedLength());
+            event.description.remove(0, match.capturedLength());
     }
     // episode number subtitle
-    else if (tmpExpSubtitle2.indexIn(event.description) != -1)
+    else if ((match = m_RTLSubtitle2.match(event.description)).hasMatch())
     {
-        event.syndicatedepisodenumber = tmpExpSubtitle2.cap(1);
-        event.subtitle    = tmpExpSubtitle2.cap(2);
+        event.syndicatedepisodenumber = match.captured(1);
+        event.subtitle    = match.captured(2);
         event.description =
-            event.description.remove(0, tmpExpSubtitle2.matchedLength());
+            event.description.remove(0, match.capturedLength());
     }
     // episode number subtitle
-    else if (tmpExpSubtitle3.indexIn(event.description) != -1)
+    else if ((match = m_RTLSubtitle3.match(event.description)).hasMatch())
     {
-        event.syndicatedepisodenumber = tmpExpSubtitle3.cap(1);
-        event.subtitle    = tmpExpSubtitle3.cap(2);
+        event.syndicatedepisodenumber = match.captured(1);
+        event.subtitle    = match.captured(2);
         event.description =
-            event.description.remove(0, tmpExpSubtitle3.matchedLength());
+            event.description.remove(0, match.capturedLength());
     }
     // "Thema..."
-    else if (tmpExpSubtitle4.indexIn(event.description) != -1)
+    else if ((match = m_RTLSubtitle4.match(event.description)).hasMatch())
     {
-        event.subtitle    = tmpExpSubtitle4.cap(1);
+        event.subtitle    = match.captured(1);
         event.description =
-            event.description.remove(0, tmpExpSubtitle4.matchedLength());
+            event.description.remove(0, match.capturedLength());
     }
     // "'...'"
-    else if (tmpExpSubtitle5.indexIn(event.description) != -1)
+    else if ((match = m_RTLSubtitle5.match(event.description)).hasMatch())
     {
-        event.subtitle    = tmpExpSubtitle5.cap(1);
+        event.subtitle    = match.captured(1);
         event.description =
-            event.description.remove(0, tmpExpSubtitle5.matchedLength());
+            event.description.remove(0, match.capturedLength());
     }
     // episode number
-    else if (tmpExpEpisodeNo1.indexIn(event.description) != -1)
+    else if ((match = m_RTLEpisodeNo1.match(event.description)).hasMatch())
     {
-        event.syndicatedepisodenumber = tmpExpEpisodeNo1.cap(2);
-        event.subtitle    = tmpExpEpisodeNo1.cap(1);
+        event.syndicatedepisodenumber = match.captured(2);
+        event.subtitle    = match.captured(1);
         event.description =
-            event.description.remove(0, tmpExpEpisodeNo1.matchedLength());
+            event.description.remove(0, match.capturedLength());
     }
     // episode number
-    else if (tmpExpEpisodeNo2.indexIn(event.description) != -1)
+    else if ((match = m_RTLEpisodeNo2.match(event.description)).hasMatch())
     {
-        event.syndicatedepisodenumber = tmpExpEpisodeNo2.cap(2);
-        event.subtitle    = tmpExpEpisodeNo2.cap(1);
+        event.syndicatedepisodenumber = match.captured(2);
+        event.subtitle    = match.captured(1);
         event.description =
-            event.description.remove(0, tmpExpEpisodeNo2.matchedLength());
+            event.description.remove(0, match.capturedLength());
     }
 
     /* got an episode title now? (we did not have one at the start of this function) */
@@ -1757,16 +1866,17 @@ void EITFixUp::FixRTL(DBEventEIT &event) const
         const uint SUBTITLE_PCT = 35; // % of description to allow subtitle up to
         const uint SUBTITLE_MAX_LEN = 50; // max length of subtitle field in db
 
-        if (tmpExp1.indexIn(event.description) != -1)
+        match = m_RTLSubtitle.match(event.description);
+        if (match.hasMatch())
         {
-            uint tmpExp1Len = tmpExp1.cap(1).length();
+            uint tmpExp1Len = match.captured(1).length();
             uint evDescLen = max(event.description.length(), 1);
 
             if ((tmpExp1Len < SUBTITLE_MAX_LEN) &&
                 (tmpExp1Len * 100 / evDescLen < SUBTITLE_PCT))
             {
-                event.subtitle    = tmpExp1.cap(1);
-                event.description = tmpExp1.cap(2);
+                event.subtitle    = match.captured(1);
+                event.description = match.captured(2);
             }
         }
     }
@@ -1777,68 +1887,62 @@ void EITFixUp::FixRTL(DBEventEIT &event) const
  */
 void EITFixUp::FixPRO7(DBEventEIT &event) const
 {
-    QRegExp tmp = m_PRO7Subtitle;
-
-    int pos = tmp.indexIn(event.subtitle);
-    if (pos != -1)
+    QRegularExpressionMatch match = m_PRO7Subtitle.match(event.subtitle);
+    if (match.hasMatch())
     {
         if (event.airdate == 0)
         {
-            event.airdate = tmp.cap(3).toUInt();
+            event.airdate = match.captured(3).toUInt();
         }
-        event.subtitle.replace(tmp, "");
+        event.subtitle.replace(m_PRO7Subtitle, "");
     }
 
     /* handle cast, the very last in description */
-    tmp = m_PRO7Cast;
-    pos = tmp.indexIn(event.description);
-    if (pos != -1)
+    match = m_PRO7Cast.match(event.description);
+    if (match.hasMatch())
     {
-        QStringList cast = tmp.cap(1).split("\n");
-        QRegExp tmpOne = m_PRO7CastOne;
+        QStringList cast = match.captured(1).split("\n");
         QStringListIterator i(cast);
         while (i.hasNext())
         {
-            pos = tmpOne.indexIn (i.next());
-            if (pos != -1)
+            QRegularExpressionMatch one = m_PRO7CastOne.match(i.next());
+            if (one.hasMatch())
             {
-                event.AddPerson (DBPerson::kActor, tmpOne.cap(1).simplified());
+                event.AddPerson (DBPerson::kActor, one.captured(1).simplified());
             }
         }
-        event.description.replace(tmp, "");
+        event.description.replace(m_PRO7Cast, "");
     }
 
     /* handle crew, the new very last in description
      * format: "Role: Name" or "Role: Name1, Name2"
      */
-    tmp = m_PRO7Crew;
-    pos = tmp.indexIn(event.description);
-    if (pos != -1)
+    match = m_PRO7Crew.match(event.description);
+    if (match.hasMatch())
     {
-        QStringList crew = tmp.cap(1).split("\n");
-        QRegExp tmpOne = m_PRO7CrewOne;
+        QStringList crew = match.captured(1).split("\n");
         QStringListIterator i(crew);
         while (i.hasNext())
         {
-            pos = tmpOne.indexIn (i.next());
-            if (pos != -1)
+            QRegularExpressionMatch one = m_PRO7CrewOne.match(i.next());
+            if (one.hasMatch())
             {
                 DBPerson::Role role = DBPerson::kUnknown;
-                if (QString::compare (tmpOne.cap(1), "Regie") == 0)
+                if (QString::compare (one.captured(1), "Regie") == 0)
                 {
                     role = DBPerson::kDirector;
                 }
-                else if (QString::compare (tmpOne.cap(1), "Drehbuch") == 0)
+                else if (QString::compare (one.captured(1), "Drehbuch") == 0)
                 {
                     role = DBPerson::kWriter;
                 }
-                else if (QString::compare (tmpOne.cap(1), "Autor") == 0)
+                else if (QString::compare (one.captured(1), "Autor") == 0)
                 {
                     role = DBPerson::kWriter;
                 }
                 // FIXME add more jobs
 
-                QStringList names = tmpOne.cap(2).simplified().split("\\s*,\\s*");
+                QStringList names = one.captured(2).simplified().split("\\s*,\\s*");
                 QStringListIterator j(names);
                 while (j.hasNext())
                 {
@@ -1846,7 +1950,7 @@ void EITFixUp::FixPRO7(DBEventEIT &event) const
                 }
             }
         }
-        event.description.replace(tmp, "");
+        event.description.replace(m_PRO7Crew, "");
     }
 
     /* FIXME unless its Jamie Oliver, then there is neither Crew nor Cast only
@@ -1891,38 +1995,37 @@ void EITFixUp::FixPremiere(DBEventEIT &event) const
     QString country = "";
 
     // Find infos about country and year, regisseur and actors
-    QRegExp tmpInfos =  m_dePremiereInfos;
-    if (tmpInfos.indexIn(event.description) != -1)
+    QRegularExpressionMatch match;
+    if ((match = m_dePremiereInfos.match(event.description)).hasMatch())
     {
-        country = tmpInfos.cap(2).trimmed();
+        country = match.captured(2).trimmed();
         bool ok;
-        uint y = tmpInfos.cap(1).toUInt(&ok);
+        uint y = match.captured(1).toUInt(&ok);
         if (ok)
             event.airdate = y;
-        event.AddPerson(DBPerson::kDirector, tmpInfos.cap(3));
-        const QStringList actors = tmpInfos.cap(4).split(
+        event.AddPerson(DBPerson::kDirector, match.captured(3));
+        const QStringList actors = match.captured(4).split(
             ", ", QString::SkipEmptyParts);
         QStringList::const_iterator it = actors.begin();
         for (; it != actors.end(); ++it)
             event.AddPerson(DBPerson::kActor, *it);
-        event.description = event.description.replace(tmpInfos, "");
+        event.description = event.description.replace(m_dePremiereInfos, "");
     }
 
     // move the original titel from the title to subtitle
-    QRegExp tmpOTitle = m_dePremiereOTitle;
-    if (tmpOTitle.indexIn(event.title) != -1)
+    if ((match = m_dePremiereOTitle.match(event.title)).hasMatch())
     {
-        event.subtitle = QString("%1, %2").arg(tmpOTitle.cap(1)).arg(country);
-        event.title = event.title.replace(tmpOTitle, "");
+        event.subtitle = QString("%1, %2").arg(match.captured(1)).arg(country);
+        event.title = event.title.replace(m_dePremiereOTitle, "");
     }
 
     // Find infos about season and episode number
-    QRegExp tmpSeasonEpisode =  m_deSkyDescriptionSeasonEpisode;
-    if (tmpSeasonEpisode.indexIn(event.description) != -1)
+    if ((match = m_deSkyDescriptionSeasonEpisode.match(event.description))
+        .hasMatch())
     {
-        event.season = tmpSeasonEpisode.cap(1).trimmed().toUInt();
-        event.episode = tmpSeasonEpisode.cap(2).trimmed().toUInt();
-        event.description.replace(tmpSeasonEpisode, "");
+        event.season = match.captured(1).trimmed().toUInt();
+        event.episode = match.captured(2).trimmed().toUInt();
+        event.description.replace(m_deSkyDescriptionSeasonEpisode, "");
     }
 }
 
@@ -2060,25 +2163,24 @@ void EITFixUp::FixNL(DBEventEIT &event) const
     }
 
     // Try to make subtitle from Afl.:
-    QRegExp tmpSub = m_nlSub;
+    QRegularExpressionMatch match;
     QString tmpSubString;
-    if (tmpSub.indexIn(fullinfo) != -1)
+    if ((match = m_nlSub.match(fullinfo)).hasMatch())
     {
-        tmpSubString = tmpSub.cap(0);
+        tmpSubString = match.captured(0);
         tmpSubString = tmpSubString.right(tmpSubString.length() - 7);
         event.subtitle = tmpSubString.left(tmpSubString.length() -1);
-        fullinfo = fullinfo.replace(tmpSub.cap(0), "");
+        fullinfo = fullinfo.replace(match.captured(0), "");
     }
 
     // Try to make subtitle from " "
-    QRegExp tmpSub2 = m_nlSub2;
     //QString tmpSubString2;
-    if (tmpSub2.indexIn(fullinfo) != -1)
+    if ((match = m_nlSub2.match(fullinfo)).hasMatch())
     {
-        tmpSubString = tmpSub2.cap(0);
+        tmpSubString = match.captured(0);
         tmpSubString = tmpSubString.right(tmpSubString.length() - 2);
         event.subtitle = tmpSubString.left(tmpSubString.length() -1);
-        fullinfo = fullinfo.replace(tmpSub2.cap(0), "");
+        fullinfo = fullinfo.replace(match.captured(0), "");
     }
 
 
@@ -2095,10 +2197,9 @@ void EITFixUp::FixNL(DBEventEIT &event) const
 
 
     // Get the actors
-    QRegExp tmpActors = m_nlActors;
-    if (tmpActors.indexIn(fullinfo) != -1)
+    if ((match = m_nlActors.match(fullinfo)).hasMatch())
     {
-        QString tmpActorsString = tmpActors.cap(0);
+        QString tmpActorsString = match.captured(0);
         tmpActorsString = tmpActorsString.right(tmpActorsString.length() - 6);
         tmpActorsString = tmpActorsString.left(tmpActorsString.length() - 5);
         const QStringList actors =
@@ -2106,14 +2207,13 @@ void EITFixUp::FixNL(DBEventEIT &event) const
         QStringList::const_iterator it = actors.begin();
         for (; it != actors.end(); ++it)
             event.AddPerson(DBPerson::kActor, *it);
-        fullinfo = fullinfo.replace(tmpActors.cap(0), "");
+        fullinfo = fullinfo.replace(match.captured(0), "");
     }
 
     // Try to find presenter
-    QRegExp tmpPres = m_nlPres;
-    if (tmpPres.indexIn(fullinfo) != -1)
+    if ((match = m_nlPres.match(fullinfo)).hasMatch())
     {
-        QString tmpPresString = tmpPres.cap(0);
+        QString tmpPresString = match.captured(0);
         tmpPresString = tmpPresString.right(tmpPresString.length() - 14);
         tmpPresString = tmpPresString.left(tmpPresString.length() -1);
         const QStringList host =
@@ -2121,37 +2221,33 @@ void EITFixUp::FixNL(DBEventEIT &event) const
         QStringList::const_iterator it = host.begin();
         for (; it != host.end(); ++it)
             event.AddPerson(DBPerson::kPresenter, *it);
-        fullinfo = fullinfo.replace(tmpPres.cap(0), "");
+        fullinfo = fullinfo.replace(match.captured(0), "");
     }
 
     // Try to find year
-    QRegExp tmpYear1 = m_nlYear1;
-    QRegExp tmpYear2 = m_nlYear2;
-    if (tmpYear1.indexIn(fullinfo) != -1)
+    if ((match = m_nlYear1.match(fullinfo)).hasMatch())
     {
         bool ok;
-        uint y = tmpYear1.cap(0).toUInt(&ok);
+        uint y = match.captured(0).toUInt(&ok);
         if (ok)
             event.originalairdate = QDate(y, 1, 1);
     }
 
-    if (tmpYear2.indexIn(fullinfo) != -1)
+    if ((match = m_nlYear2.match(fullinfo)).hasMatch())
     {
         bool ok;
-        uint y = tmpYear2.cap(2).toUInt(&ok);
+        uint y = match.captured(2).toUInt(&ok);
         if (ok)
             event.originalairdate = QDate(y, 1, 1);
     }
 
     // Try to find director
-    QRegExp tmpDirector = m_nlDirector;
-    QString tmpDirectorString;
-    if (fullinfo.indexOf(m_nlDirector) != -1)
+    if ((match = m_nlDirector.match(fullinfo)).hasMatch())
     {
-        tmpDirectorString = tmpDirector.cap(0);
-        event.AddPerson(DBPerson::kDirector, tmpDirectorString);
+        event.AddPerson(DBPerson::kDirector, match.captured(0));
     }
 
+
     // Strip leftovers
     if (fullinfo.indexOf(m_nlRub) != -1)
     {
@@ -2223,7 +2319,7 @@ void EITFixUp::FixNO(DBEventEIT &event) const
  */
 void EITFixUp::FixNRK_DVBT(DBEventEIT &event) const
 {
-    QRegExp    tmpExp1;
+    QRegularExpressionMatch match;
     // Check for "title (R)" in the title
     if (event.title.indexOf(m_noRerun) != -1)
     {
@@ -2237,36 +2333,34 @@ void EITFixUp::FixNRK_DVBT(DBEventEIT &event) const
     }
     // Move colon separated category from program-titles into description
     // Have seen "NRK2s historiekveld: Film: bla-bla"
-    tmpExp1 =  m_noNRKCategories;
-    while ((tmpExp1.indexIn(event.title) != -1) &&
-           (tmpExp1.cap(2).length() > 1))
+    while ((match = m_noNRKCategories.match(event.title)).hasMatch() &&
+           (match.captured(2).length() > 1))
     {
-        event.title  = tmpExp1.cap(2);
-        event.description = "(" + tmpExp1.cap(1) + ") " + event.description;
+        event.title  = match.captured(2);
+        event.description = "(" + match.captured(1) + ") " + event.description;
     }
     // Remove season premiere markings
-    tmpExp1 = m_noPremiere;
-    if (tmpExp1.indexIn(event.title) >= 3)
+    match = m_noPremiere.match(event.title);
+    if (match.hasMatch() && match.capturedStart() >= 3)
     {
         event.title.remove(m_noPremiere);
     }
     // Try to find colon-delimited subtitle in title, only tested for NRK channels
-    tmpExp1 = m_noColonSubtitle;
     if (!event.title.startsWith("CSI:") &&
         !event.title.startsWith("CD:") &&
         !event.title.startsWith("Distriktsnyheter: fra"))
     {
-        if (tmpExp1.indexIn(event.title) != -1)
+        if ((match = m_noColonSubtitle.match(event.title)).hasMatch())
         {
 
             if (event.subtitle.length() <= 0)
             {
-                event.title    = tmpExp1.cap(1);
-                event.subtitle = tmpExp1.cap(2);
+                event.title    = match.captured(1);
+                event.subtitle = match.captured(2);
             }
-            else if (event.subtitle == tmpExp1.cap(2))
+            else if (event.subtitle == match.captured(2))
             {
-                event.title    = tmpExp1.cap(1);
+                event.title    = match.captured(1);
             }
         }
     }
@@ -2279,63 +2373,52 @@ void EITFixUp::FixDK(DBEventEIT &event) const
 {
     // Source: YouSee Rules of Operation v1.16
     // url: http://yousee.dk/~/media/pdf/CPE/Rules_Operation.ashx
-    int        position = -1;
     int        episode = -1;
     int        season = -1;
-    QRegExp    tmpRegEx;
+    QRegularExpressionMatch match;
     // Title search
     // episode and part/part total
-    tmpRegEx = m_dkEpisode;
-    position = event.title.indexOf(tmpRegEx);
-    if (position != -1)
+    if ((match = m_dkEpisode.match(event.title)).hasMatch())
     {
-      episode = tmpRegEx.cap(1).toInt();
-      event.partnumber = tmpRegEx.cap(1).toInt();
-      event.title = event.title.replace(tmpRegEx, "");
+      episode = match.captured(1).toInt();
+      event.partnumber = match.captured(1).toInt();
+      event.title = event.title.replace(m_dkEpisode, "");
     }
 
-    tmpRegEx = m_dkPart;
-    position = event.title.indexOf(tmpRegEx);
-    if (position != -1)
+    if ((match = m_dkPart.match(event.title)).hasMatch())
     {
-      episode = tmpRegEx.cap(1).toInt();
-      event.partnumber = tmpRegEx.cap(1).toInt();
-      event.parttotal = tmpRegEx.cap(2).toInt();
-      event.title = event.title.replace(tmpRegEx, "");
+      episode = match.captured(1).toInt();
+      event.partnumber = match.captured(1).toInt();
+      event.parttotal = match.captured(2).toInt();
+      event.title = event.title.replace(m_dkPart, "");
     }
 
     // subtitle delimiters
-    tmpRegEx = m_dkSubtitle1;
-    position = event.title.indexOf(tmpRegEx);
-    if (position != -1)
+    if ((match = m_dkSubtitle1.match(event.title)).hasMatch())
     {
-      event.title = tmpRegEx.cap(1);
-      event.subtitle = tmpRegEx.cap(2);
+      event.title = match.captured(1);
+      event.subtitle = match.captured(2);
     }
     else
     {
-        tmpRegEx = m_dkSubtitle2;
-        if(event.title.indexOf(tmpRegEx) != -1)
+        if ((match = m_dkSubtitle2.match(event.title)).hasMatch())
         {
-            event.title = tmpRegEx.cap(1);
-            event.subtitle = tmpRegEx.cap(2);
+            event.title = match.captured(1);
+            event.subtitle = match.captured(2);
         }
     }
     // Description search
     // Season (Sæson [:digit:]+.) => episode = season episode number
     // or year (- år [:digit:]+(\\)|:) ) => episode = total episode number
-    tmpRegEx = m_dkSeason1;
-    position = event.description.indexOf(tmpRegEx);
-    if (position != -1)
+    if ((match = m_dkSeason1.match(event.description)).hasMatch())
     {
-      season = tmpRegEx.cap(1).toInt();
+      season = match.captured(1).toInt();
     }
     else
     {
-        tmpRegEx = m_dkSeason2;
-        if(event.description.indexOf(tmpRegEx) !=  -1)
+        if ((match = m_dkSeason2.match(event.description)).hasMatch())
         {
-            season = tmpRegEx.cap(1).toInt();
+            season = match.captured(1).toInt();
         }
     }
 
@@ -2346,12 +2429,10 @@ void EITFixUp::FixDK(DBEventEIT &event) const
         event.season = season;
 
     //Feature:
-    tmpRegEx = m_dkFeatures;
-    position = event.description.indexOf(tmpRegEx);
-    if (position != -1)
+    if ((match = m_dkFeatures.match(event.description)).hasMatch())
     {
-        QString features = tmpRegEx.cap(1);
-        event.description = event.description.replace(tmpRegEx, "");
+        QString features = match.captured(1);
+        event.description = event.description.replace(m_dkFeatures, "");
         // 16:9
         if (features.indexOf(m_dkWidescreen) !=  -1)
             event.videoProps |= VID_WIDESCREEN;
@@ -2414,30 +2495,26 @@ void EITFixUp::FixDK(DBEventEIT &event) const
     }
 
     // Find actors and director in description
-    tmpRegEx = m_dkDirector;
     bool directorPresent = false;
-    position = event.description.indexOf(tmpRegEx);
-    if (position != -1)
+    if ((match = m_dkDirector.match(event.description)).hasMatch())
     {
-        QString tmpDirectorsString = tmpRegEx.cap(1);
+        QString tmpDirectorsString = match.captured(1);
         const QStringList directors =
             tmpDirectorsString.split(m_dkPersonsSeparator, QString::SkipEmptyParts);
         QStringList::const_iterator it = directors.begin();
         for (; it != directors.end(); ++it)
         {
             tmpDirectorsString = it->split(":").last().trimmed().
-                    remove(QRegExp("\\.$"));
+                    remove(m_DotEnd);
             if (tmpDirectorsString != "")
                 event.AddPerson(DBPerson::kDirector, tmpDirectorsString);
         }
         directorPresent = true;
     }
 
-    tmpRegEx = m_dkActors;
-    position = event.description.indexOf(tmpRegEx);
-    if (position != -1)
+    if ((match = m_dkActors.match(event.description)).hasMatch())
     {
-        QString tmpActorsString = tmpRegEx.cap(1);
+        QString tmpActorsString = match.captured(1);
         if (directorPresent)
             tmpActorsString = tmpActorsString.replace(m_dkDirector,"");
         const QStringList actors =
@@ -2446,18 +2523,17 @@ void EITFixUp::FixDK(DBEventEIT &event) const
         for (; it != actors.end(); ++it)
         {
             tmpActorsString = it->split(":").last().trimmed().
-                    remove(QRegExp("\\.$"));
+                    remove(m_DotEnd);
             if (tmpActorsString != "")
                 event.AddPerson(DBPerson::kActor, tmpActorsString);
         }
     }
     //find year
-    tmpRegEx = m_dkYear;
-    position = event.description.indexOf(tmpRegEx);
-    if (position != -1)
+    if ((match = m_dkYear.match(event.description)).hasMatch())
     {
         bool ok;
-        uint y = tmpRegEx.cap(1).toUInt(&ok);
+        uint y = match.captured(1).toUInt(&ok);
+
         if (ok)
             event.originalairdate = QDate(y, 1, 1);
     }
@@ -2499,7 +2575,7 @@ void EITFixUp::FixGreekEIT(DBEventEIT &event) const
 {
     //Live show
     int position;
-    QRegExp tmpRegEx;
+    QRegularExpressionMatch match;
     position = event.title.indexOf("(Ζ)");
     if (position != -1)
     {
@@ -2508,33 +2584,29 @@ void EITFixUp::FixGreekEIT(DBEventEIT &event) const
     }
 
     // Greek not previously Shown
-    position = event.title.indexOf(m_grNotPreviouslyShown);
-    if (position != -1)
+    if ((match = m_grNotPreviouslyShown.match(event.title)).hasMatch())
     {
         event.previouslyshown = false;
-        event.title = event.title.replace(m_grNotPreviouslyShown.cap(0), "");
+        event.title = event.title.replace(match.captured(0), "");
     }
 
     // Greek Replay (Ε)
     // it might look redundant compared to previous check but at least it helps
     // remove the (Ε) From the title.
-    tmpRegEx = m_grReplay;
-    if (event.title.indexOf(tmpRegEx) !=  -1)
+    if (event.title.indexOf(m_grReplay) !=  -1)
     {
         event.previouslyshown = true;
-        event.title = event.title.replace(tmpRegEx, "");
+        event.title = event.title.replace(m_grReplay, "");
     }
 
-    tmpRegEx = m_grFixnofullstopActors;
-    position = event.description.indexOf(tmpRegEx);
+    position = event.description.indexOf(m_grFixnofullstopActors);
     if (position != -1)
     {
         event.description.insert(position + 1, ".");
     }
 
     // If they forgot the "." at the end of the sentence before the actors/directors begin, let's insert it.
-    tmpRegEx = m_grFixnofullstopDirectors;
-    position = event.description.indexOf(tmpRegEx);
+    position = event.description.indexOf(m_grFixnofullstopDirectors);
     if (position != -1)
     {
         event.description.insert(position + 1, ".");
@@ -2546,42 +2618,38 @@ void EITFixUp::FixGreekEIT(DBEventEIT &event) const
     // for a director's/presenter's surname (directors/presenters are shown
     // before actors in the description field.). So removing the text after
     // adding the actors AND THEN looking for dir/pres helps to clear things up.
-    tmpRegEx = m_grActors;
-    position = event.description.indexOf(tmpRegEx);
-    if (position != -1)
+    if ((match = m_grActors.match(event.description)).hasMatch())
     {
-        QString tmpActorsString = tmpRegEx.cap(1);
+        QString tmpActorsString = match.captured(1);
         const QStringList actors =
             tmpActorsString.split(m_grPeopleSeparator, QString::SkipEmptyParts);
         QStringList::const_iterator it = actors.begin();
         for (; it != actors.end(); ++it)
         {
             tmpActorsString = it->split(":").last().trimmed().
-                    remove(QRegExp("\\.$"));
+                    remove(m_DotEnd);
             if (tmpActorsString != "")
                 event.AddPerson(DBPerson::kActor, tmpActorsString);
         }
-        event.description.replace(tmpRegEx.cap(0), "");
+        event.description.replace(match.captured(0), "");
     }
     // Director
-    tmpRegEx = m_grDirector;
-    position = event.description.indexOf(tmpRegEx);
-    if (position != -1)
+    if ((match = m_grDirector.match(event.description)).hasMatch())
     {
-        QString tmpDirectorsString = tmpRegEx.cap(1);
+        QString tmpDirectorsString = match.captured(1);
         const QStringList directors =
             tmpDirectorsString.split(m_grPeopleSeparator, QString::SkipEmptyParts);
         QStringList::const_iterator it = directors.begin();
         for (; it != directors.end(); ++it)
         {
             tmpDirectorsString = it->split(":").last().trimmed().
-                    remove(QRegExp("\\.$"));
+                    remove(m_DotEnd);
             if (tmpDirectorsString != "")
             {
                 event.AddPerson(DBPerson::kDirector, tmpDirectorsString);
             }
         }
-        event.description.replace(tmpRegEx.cap(0), "");
+        event.description.replace(match.captured(0), "");
     }
 
 /*
@@ -2616,37 +2684,33 @@ void EITFixUp::FixGreekEIT(DBEventEIT &event) const
     }
 */
     //Try to find presenter
-    tmpRegEx = m_grPres;
-    position = event.description.indexOf(tmpRegEx);
-    if (position != -1)
+    if ((match = m_grPres.match(event.description)).hasMatch())
     {
-        QString tmpPresentersString = tmpRegEx.cap(1);
+        QString tmpPresentersString = match.captured(1);
         const QStringList presenters =
             tmpPresentersString.split(m_grPeopleSeparator, QString::SkipEmptyParts);
         QStringList::const_iterator it = presenters.begin();
         for (; it != presenters.end(); ++it)
         {
             tmpPresentersString = it->split(":").last().trimmed().
-                    remove(QRegExp("\\.$"));
+                    remove(m_DotEnd);
             if (tmpPresentersString != "")
             {
                 event.AddPerson(DBPerson::kPresenter, tmpPresentersString);
             }
         }
-        event.description.replace(tmpRegEx.cap(0), "");
+        event.description.replace(match.captured(0), "");
     }
 
     //find year e.g Παραγωγής 1966 ή ΝΤΟΚΙΜΑΝΤΕΡ - 1998 Κατάλληλο για όλους
     // Used in Private channels (not 'secret', just not owned by Government!)
-    tmpRegEx = m_grYear;
-    position = event.description.indexOf(tmpRegEx);
-    if (position != -1)
+    if ((match = m_grYear.match(event.description)).hasMatch())
     {
         bool ok;
-        uint y = tmpRegEx.cap(1).toUInt(&ok);
+        uint y = match.captured(1).toUInt(&ok);
         if (ok)
             event.originalairdate = QDate(y, 1, 1);
-            event.description.replace(tmpRegEx, "");
+            event.description.replace(m_grYear, "");
     }
     // Remove white spaces
     event.description = event.description.trimmed();
@@ -2654,66 +2718,65 @@ void EITFixUp::FixGreekEIT(DBEventEIT &event) const
     event.subtitle    = event.subtitle.trimmed();
 
     //find country of origin and remove it from description.
-    tmpRegEx = m_grCountry;
-    position = event.description.indexOf(tmpRegEx);
-    if (position != -1)
+    if (event.description.indexOf(m_grCountry) != -1)
     {
-        event.description.replace(tmpRegEx, "");
+        event.description.replace(m_grCountry, "");
     }
 
     // Work out the season and episode numbers (if any)
     // Matching pattern "Επεισ[όο]διο:?|Επ 3 από 14|3/14" etc
     bool    series  = false;
-    QRegExp tmpSeries = m_grSeason;
     // cap(2) is the season for ΑΒΓΔ
     // cap(3) is the season for 1234
-    int position1 = tmpSeries.indexIn(event.title);
-    int position2 = tmpSeries.indexIn(event.description);
-    if ((position1 != -1) || (position2 != -1))
+    QRegularExpressionMatch titlematch = m_grSeason.match(event.title);
+    QRegularExpressionMatch descmatch = m_grSeason.match(event.description);
+    if (titlematch.hasMatch() || descmatch.hasMatch())
     {
-        if (!tmpSeries.cap(2).isEmpty()) // we found a letter representing a number
+        match = descmatch.hasMatch() ? descmatch : titlematch;
+        if (!match.captured(2).isEmpty()) // we found a letter representing a number
         {
             //sometimes Nat. TV writes numbers as letters, i.e Α=1, Β=2, Γ=3, etc
             //must convert them to numbers.
-            int tmpinteger = tmpSeries.cap(2).toUInt();
+            int tmpinteger = match.captured(2).toUInt();
             if (tmpinteger < 1)
             {
-                if (tmpSeries.cap(2) == "ΣΤ") // 6, don't ask!
+                if (match.captured(2) == "ΣΤ") // 6, don't ask!
                     event.season = 6;
                 else
                 {
                     QString LettToNumber = "0ΑΒΓΔΕ6ΖΗΘΙΚΛΜΝ";
-                    tmpinteger = LettToNumber.indexOf(tmpSeries.cap(2));
+                    tmpinteger = LettToNumber.indexOf(match.captured(2));
                     if (tmpinteger != -1)
                         event.season = tmpinteger;
                 }
             }
         }
-        else if (!tmpSeries.cap(3).isEmpty()) //number
+        else if (!match.captured(3).isEmpty()) //number
         {
-            event.season = tmpSeries.cap(3).toUInt();
+            event.season = match.captured(3).toUInt();
         }
         series = true;
-        if (position1 != -1)
-            event.title.replace(tmpSeries.cap(0),"");
-        if (position2 != -1)
-            event.description.replace(tmpSeries.cap(0),"");
+        if (titlematch.hasMatch())
+            event.title.replace(titlematch.captured(0),"");
+        if (descmatch.hasMatch())
+            event.description.replace(descmatch.captured(0),"");
     }
 
-    QRegExp tmpEpisode = m_grlongEp;
-    //tmpEpisode.setMinimal(true);
     // cap(1) is the Episode No.
-    if ((position1 = tmpEpisode.indexIn(event.title)) != -1
-            || (position2 = tmpEpisode.indexIn(event.description)) != -1)
+    titlematch = m_grlongEp.match(event.title);
+    descmatch = titlematch.hasMatch() ? QRegularExpressionMatch() :
+        m_grlongEp.match(event.description);
+    if (titlematch.hasMatch() || descmatch.hasMatch())
     {
-        if (!tmpEpisode.cap(1).isEmpty())
+        match = titlematch.hasMatch() ? titlematch : descmatch;
+        if (!match.captured(1).isEmpty())
         {
-            event.episode = tmpEpisode.cap(1).toUInt();
+            event.episode = match.captured(1).toUInt();
             series = true;
-            if (position1 != -1)
-                event.title.replace(tmpEpisode.cap(0),"");
-            if (position2 != -1)
-                event.description.replace(tmpEpisode.cap(0),"");
+            if (titlematch.hasMatch())
+                event.title.replace(match.captured(0),"");
+            else
+                event.description.replace(match.captured(0),"");
             // Sometimes description omits Season if it's 1. We fix this
             if (0 == event.season)
                 event.season = 1;
@@ -2726,42 +2789,37 @@ void EITFixUp::FixGreekEIT(DBEventEIT &event) const
     // EITFixUp::FixGreekSubtitle, I will search for it only in the description.
     // It will replace the translated one to get better chances of metadata
     // retrieval. The old title will be moved in the description.
-    QRegExp tmptitle = m_grRealTitleinDescription;
-    tmptitle.setMinimal(true);
-    position = event.description.indexOf(tmptitle);
-    if (position != -1)
+    if ((match = m_grRealTitleinDescription.match(event.description))
+        .hasMatch())
     {
-        event.description = event.description.replace(tmptitle, "");
-        if (QString(tmptitle.cap(0)) != event.title.trimmed())
+        event.description = event.description.replace(
+            m_grRealTitleinDescription, "");
+        if (match.captured(0) != event.title.trimmed())
         {
             event.description = "(" + event.title.trimmed() + "). " + event.description;
         }
-        event.title = tmptitle.cap(1);
+        event.title = match.captured(1);
         // Remove the real title from the description
     }
     else // search in title
     {
-        tmptitle = m_grRealTitleinTitle;
-        position = event.title.indexOf(tmptitle);
-        if (position != -1) // found in title instead
+        if ((match = m_grRealTitleinTitle.match(event.title)).hasMatch())
         {
-            event.title.replace(tmptitle.cap(0),"");
+            // found in title instead
+            event.title.replace(match.captured(0),"");
             QString tmpTranslTitle = event.title;
             //QString tmpTranslTitle = event.title.replace(tmptitle.cap(0),"");
-            event.title = tmptitle.cap(1);
+            event.title = match.captured(1);
             event.description = "(" + tmpTranslTitle.trimmed() + "). " + event.description;
         }
     }
 
     // Description field: "^Episode: Lion in the cage. (Description follows)"
-    tmpRegEx = m_grEpisodeAsSubtitle;
-    position = event.description.indexOf(tmpRegEx);
-    if (position != -1)
+    if ((match = m_grEpisodeAsSubtitle.match(event.description)).hasMatch())
     {
-        event.subtitle = tmpRegEx.cap(1).trimmed();
-        event.description.replace(tmpRegEx, "");
+        event.subtitle = match.captured(1).trimmed();
+        event.description.replace(m_grEpisodeAsSubtitle, "");
     }
-    QRegExp m_grMovie("\\bταιν[ιί]α\\b",Qt::CaseInsensitive);
     bool isMovie = (event.description.indexOf(m_grMovie) !=-1) ;
     if (isMovie)
     {
@@ -2938,10 +2996,10 @@ void EITFixUp::FixUnitymedia(DBEventEIT &event) const
     }
 
     // handle star rating in the description
-    QRegExp tmp = m_unitymediaImdbrating;
-    if (event.description.indexOf (tmp) != -1)
+    QRegularExpressionMatch match = m_unitymediaImdbrating.match(event.description);
+    if (match.hasMatch())
     {
-        float stars = tmp.cap(1).toFloat();
+        float stars = match.captured(1).toFloat();
         event.stars = stars / 10.0f;
         event.description.replace (m_unitymediaImdbrating, "");
     }
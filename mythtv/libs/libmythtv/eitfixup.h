@@ -5,7 +5,7 @@
 #ifndef EITFIXUP_H
 #define EITFIXUP_H
 
-#include <QRegExp>
+#include <QRegularExpression>
 
 #include "programdata.h"
 
@@ -119,182 +119,190 @@ class EITFixUp
 
     static QString AddDVBEITAuthority(uint chanid, const QString &id);
 
-    const QRegExp m_bellYear;
-    const QRegExp m_bellActors;
-    const QRegExp m_bellPPVTitleAllDayHD;
-    const QRegExp m_bellPPVTitleAllDay;
-    const QRegExp m_bellPPVTitleHD;
-    const QRegExp m_bellPPVSubtitleAllDay;
-    const QRegExp m_bellPPVDescriptionAllDay;
-    const QRegExp m_bellPPVDescriptionAllDay2;
-    const QRegExp m_bellPPVDescriptionEventId;
-    const QRegExp m_dishPPVTitleHD;
-    const QRegExp m_dishPPVTitleColon;
-    const QRegExp m_dishPPVSpacePerenEnd;
-    const QRegExp m_dishDescriptionNew;
-    const QRegExp m_dishDescriptionFinale;
-    const QRegExp m_dishDescriptionFinale2;
-    const QRegExp m_dishDescriptionPremiere;
-    const QRegExp m_dishDescriptionPremiere2;
-    const QRegExp m_dishPPVCode;
-    const QRegExp m_ukThen;
-    const QRegExp m_ukNew;
-    const QRegExp m_ukNewTitle;
-    const QRegExp m_ukAlsoInHD;
-    const QRegExp m_ukCEPQ;
-    const QRegExp m_ukColonPeriod;
-    const QRegExp m_ukDotSpaceStart;
-    const QRegExp m_ukDotEnd;
-    const QRegExp m_ukSpaceColonStart;
-    const QRegExp m_ukSpaceStart;
-    const QRegExp m_ukPart;
-    const QRegExp m_ukSeries;
-    const QRegExp m_ukCC;
-    const QRegExp m_ukYear;
-    const QRegExp m_uk24ep;
-    const QRegExp m_ukStarring;
-    const QRegExp m_ukBBC7rpt;
-    const QRegExp m_ukDescriptionRemove;
-    const QRegExp m_ukTitleRemove;
-    const QRegExp m_ukDoubleDotEnd;
-    const QRegExp m_ukDoubleDotStart;
-    const QRegExp m_ukTime;
-    const QRegExp m_ukBBC34;
-    const QRegExp m_ukYearColon;
-    const QRegExp m_ukExclusionFromSubtitle;
-    const QRegExp m_ukCompleteDots;
-    const QRegExp m_ukQuotedSubtitle;
-    const QRegExp m_ukAllNew;
-    const QRegExp m_ukLaONoSplit;
-    const QRegExp m_comHemCountry;
-    const QRegExp m_comHemDirector;
-    const QRegExp m_comHemActor;
-    const QRegExp m_comHemHost;
-    const QRegExp m_comHemSub;
-    const QRegExp m_comHemRerun1;
-    const QRegExp m_comHemRerun2;
-    const QRegExp m_comHemTT;
-    const QRegExp m_comHemPersSeparator;
-    const QRegExp m_comHemPersons;
-    const QRegExp m_comHemSubEnd;
-    const QRegExp m_comHemSeries1;
-    const QRegExp m_comHemSeries2;
-    const QRegExp m_comHemTSub;
-    const QRegExp m_mcaIncompleteTitle;
-    const QRegExp m_mcaCompleteTitlea;
-    const QRegExp m_mcaCompleteTitleb;
-    const QRegExp m_mcaSubtitle;
-    const QRegExp m_mcaSeries;
-    const QRegExp m_mcaCredits;
-    const QRegExp m_mcaAvail;
-    const QRegExp m_mcaActors;
-    const QRegExp m_mcaActorsSeparator;
-    const QRegExp m_mcaYear;
-    const QRegExp m_mcaCC;
-    const QRegExp m_mcaDD;
-    const QRegExp m_RTLrepeat;
-    const QRegExp m_RTLSubtitle;
-    const QRegExp m_RTLSubtitle1;
-    const QRegExp m_RTLSubtitle2;
-    const QRegExp m_RTLSubtitle3;
-    const QRegExp m_RTLSubtitle4;
-    const QRegExp m_RTLSubtitle5;
-    const QRegExp m_PRO7Subtitle;
-    const QRegExp m_PRO7Crew;
-    const QRegExp m_PRO7CrewOne;
-    const QRegExp m_PRO7Cast;
-    const QRegExp m_PRO7CastOne;
-    const QRegExp m_RTLEpisodeNo1;
-    const QRegExp m_RTLEpisodeNo2;
-    const QRegExp m_fiRerun;
-    const QRegExp m_fiRerun2;
-    const QRegExp m_dePremiereInfos;
-    const QRegExp m_dePremiereOTitle;
-    const QRegExp m_deSkyDescriptionSeasonEpisode;
-    const QRegExp m_nlTxt;
-    const QRegExp m_nlWide;
-    const QRegExp m_nlRepeat;
-    const QRegExp m_nlHD;
-    const QRegExp m_nlSub;
-    const QRegExp m_nlSub2;
-    const QRegExp m_nlActors;
-    const QRegExp m_nlPres;
-    const QRegExp m_nlPersSeparator;
-    const QRegExp m_nlRub;
-    const QRegExp m_nlYear1;
-    const QRegExp m_nlYear2;
-    const QRegExp m_nlDirector;
-    const QRegExp m_nlCat;
-    const QRegExp m_nlOmroep;
-    const QRegExp m_noRerun;
-    const QRegExp m_noHD;
-    const QRegExp m_noColonSubtitle;
-    const QRegExp m_noNRKCategories;
-    const QRegExp m_noPremiere;
-    const QRegExp m_Stereo;
-    const QRegExp m_dkEpisode;
-    const QRegExp m_dkPart;
-    const QRegExp m_dkSubtitle1;
-    const QRegExp m_dkSubtitle2;
-    const QRegExp m_dkSeason1;
-    const QRegExp m_dkSeason2;
-    const QRegExp m_dkFeatures;
-    const QRegExp m_dkWidescreen;
-    const QRegExp m_dkDolby;
-    const QRegExp m_dkSurround;
-    const QRegExp m_dkStereo;
-    const QRegExp m_dkReplay;
-    const QRegExp m_dkTxt;
-    const QRegExp m_dkHD;
-    const QRegExp m_dkActors;
-    const QRegExp m_dkPersonsSeparator;
-    const QRegExp m_dkDirector;
-    const QRegExp m_dkYear;
-    const QRegExp m_AUFreeviewSY;//subtitle, year
-    const QRegExp m_AUFreeviewY;//year
-    const QRegExp m_AUFreeviewYC;//year, cast
-    const QRegExp m_AUFreeviewSYC;//subtitle, year, cast
-    const QRegExp m_HTML;
-    const QRegExp m_grReplay; //Greek rerun
-    const QRegExp m_grDescriptionFinale; //Greek last m_grEpisode
-    const QRegExp m_grActors; //Greek actors
-    const QRegExp m_grFixnofullstopActors; //bad punctuation makes the "Παίζουν:" and the actors' names part of the directors...
-    const QRegExp m_grFixnofullstopDirectors; //bad punctuation makes the "Σκηνοθ...:" and the previous sentence.
-    const QRegExp m_grPeopleSeparator; // The comma that separates the actors.
-    const QRegExp m_grDirector;
-    const QRegExp m_grPres; // Greek Presenters for shows
-    const QRegExp m_grYear; // Greek release year.
-    const QRegExp m_grCountry; // Greek event country of origin.
-    const QRegExp m_grlongEp; // Greek Episode
-    const QRegExp m_grSeason; // Greek Season
-    const QRegExp m_grSeries;
-    const QRegExp m_grRealTitleinDescription; // The original title is often in the descr in parenthesis.
-    const QRegExp m_grRealTitleinTitle; // The original title is often in the title in parenthesis.
-    const QRegExp m_grNotPreviouslyShown; // Not previously shown on TV
-    const QRegExp m_grEpisodeAsSubtitle; // Description field: "^Episode: Lion in the cage. (Description follows)"
-    const QRegExp m_grCategFood; // Greek category food
-    const QRegExp m_grCategDrama; // Greek category social/drama
-    const QRegExp m_grCategComedy; // Greek category comedy
-    const QRegExp m_grCategChildren; // Greek category for children / cartoons
-    const QRegExp m_grCategMystery; // Greek category for mystery
-    const QRegExp m_grCategFantasy; // Greek category for fantasy
-    const QRegExp m_grCategHistory; //Greek category for historical movie/series
-    const QRegExp m_grCategTeleMag; //Greek category for Telemagazine show
-    const QRegExp m_grCategTeleShop; //Greek category for teleshopping
-    const QRegExp m_grCategGameShow; //Greek category for game show
-    const QRegExp m_grCategDocumentary; // Greek category for Documentaries
-    const QRegExp m_grCategBiography; // Greek category for biography
-    const QRegExp m_grCategNews; // Greek category for News
-    const QRegExp m_grCategSports; // Greek category for Sports
-    const QRegExp m_grCategMusic; // Greek category for Music
-    const QRegExp m_grCategReality; // Greek category for reality shows
-    const QRegExp m_grCategReligion; //Greek category for religion
-    const QRegExp m_grCategCulture; //Greek category for Arts/Culture
-    const QRegExp m_grCategNature; //Greek category for Nature/Science
-    const QRegExp m_grCategSciFi;  // Greek category for Science Fiction
-    const QRegExp m_grCategHealth; //Greek category for Health
-    const QRegExp m_grCategSpecial; //Greek category for specials.
-    const QRegExp m_unitymediaImdbrating; ///< IMDb Rating
+    // Patterns are matched without per-event copies; QRegularExpression
+    // keeps match state out of the pattern so these can be shared.
+    const QRegularExpression m_bellYear;
+    const QRegularExpression m_bellActors;
+    const QRegularExpression m_bellPPVTitleAllDayHD;
+    const QRegularExpression m_bellPPVTitleAllDay;
+    const QRegularExpression m_bellPPVTitleHD;
+    const QRegularExpression m_bellPPVSubtitleAllDay;
+    const QRegularExpression m_bellPPVDescriptionAllDay;
+    const QRegularExpression m_bellPPVDescriptionAllDay2;
+    const QRegularExpression m_bellPPVDescriptionEventId;
+    const QRegularExpression m_dishPPVTitleHD;
+    const QRegularExpression m_dishPPVTitleColon;
+    const QRegularExpression m_dishPPVSpacePerenEnd;
+    const QRegularExpression m_dishDescriptionNew;
+    const QRegularExpression m_dishDescriptionFinale;
+    const QRegularExpression m_dishDescriptionFinale2;
+    const QRegularExpression m_dishDescriptionPremiere;
+    const QRegularExpression m_dishDescriptionPremiere2;
+    const QRegularExpression m_dishPPVCode;
+    const QRegularExpression m_ukThen;
+    const QRegularExpression m_ukNew;
+    const QRegularExpression m_ukNewTitle;
+    const QRegularExpression m_ukAlsoInHD;
+    const QRegularExpression m_ukCEPQ;
+    const QRegularExpression m_ukColonPeriod;
+    const QRegularExpression m_ukDotSpaceStart;
+    const QRegularExpression m_ukDotEnd;
+    const QRegularExpression m_ukSpaceColonStart;
+    const QRegularExpression m_ukSpaceStart;
+    const QRegularExpression m_ukPart;
+    const QRegularExpression m_ukSeries;
+    const QRegularExpression m_ukCC;
+    const QRegularExpression m_ukYear;
+    const QRegularExpression m_uk24ep;
+    const QRegularExpression m_ukStarring;
+    const QRegularExpression m_ukBBC7rpt;
+    const QRegularExpression m_ukDescriptionRemove;
+    const QRegularExpression m_ukTitleRemove;
+    const QRegularExpression m_ukDoubleDotEnd;
+    const QRegularExpression m_ukDoubleDotStart;
+    const QRegularExpression m_ukTime;
+    const QRegularExpression m_ukBBC34;
+    const QRegularExpression m_ukYearColon;
+    const QRegularExpression m_ukExclusionFromSubtitle;
+    const QRegularExpression m_ukCompleteDots;
+    const QRegularExpression m_ukQuotedSubtitle;
+    const QRegularExpression m_ukAllNew;
+    const QRegularExpression m_ukLaONoSplit;
+    const QRegularExpression m_comHemCountry;
+    const QRegularExpression m_comHemDirector;
+    const QRegularExpression m_comHemActor;
+    const QRegularExpression m_comHemHost;
+    const QRegularExpression m_comHemSub;
+    const QRegularExpression m_comHemRerun1;
+    const QRegularExpression m_comHemRerun2;
+    const QRegularExpression m_comHemTT;
+    const QRegularExpression m_comHemPersSeparator;
+    const QRegularExpression m_comHemPersons;
+    const QRegularExpression m_comHemSubEnd;
+    const QRegularExpression m_comHemSeries1;
+    const QRegularExpression m_comHemSeries2;
+    const QRegularExpression m_comHemTSub;
+    const QRegularExpression m_mcaIncompleteTitle;
+    const QRegularExpression m_mcaCompleteTitlea;
+    const QRegularExpression m_mcaCompleteTitleb;
+    const QRegularExpression m_mcaSubtitle;
+    const QRegularExpression m_mcaSeries;
+    const QRegularExpression m_mcaCredits;
+    const QRegularExpression m_mcaAvail;
+    const QRegularExpression m_mcaActors;
+    const QRegularExpression m_mcaActorsSeparator;
+    const QRegularExpression m_mcaYear;
+    const QRegularExpression m_mcaCC;
+    const QRegularExpression m_mcaDD;
+    const QRegularExpression m_RTLrepeat;
+    const QRegularExpression m_RTLSubtitle;
+    const QRegularExpression m_RTLSubtitle1;
+    const QRegularExpression m_RTLSubtitle2;
+    const QRegularExpression m_RTLSubtitle3;
+    const QRegularExpression m_RTLSubtitle4;
+    const QRegularExpression m_RTLSubtitle5;
+    const QRegularExpression m_PRO7Subtitle;
+    const QRegularExpression m_PRO7Crew;
+    const QRegularExpression m_PRO7CrewOne;
+    const QRegularExpression m_PRO7Cast;
+    const QRegularExpression m_PRO7CastOne;
+    const QRegularExpression m_RTLEpisodeNo1;
+    const QRegularExpression m_RTLEpisodeNo2;
+    const QRegularExpression m_fiRerun;
+    const QRegularExpression m_fiRerun2;
+    const QRegularExpression m_dePremiereInfos;
+    const QRegularExpression m_dePremiereOTitle;
+    const QRegularExpression m_deSkyDescriptionSeasonEpisode;
+    const QRegularExpression m_nlTxt;
+    const QRegularExpression m_nlWide;
+    const QRegularExpression m_nlRepeat;
+    const QRegularExpression m_nlHD;
+    const QRegularExpression m_nlSub;
+    const QRegularExpression m_nlSub2;
+    const QRegularExpression m_nlActors;
+    const QRegularExpression m_nlPres;
+    const QRegularExpression m_nlPersSeparator;
+    const QRegularExpression m_nlRub;
+    const QRegularExpression m_nlYear1;
+    const QRegularExpression m_nlYear2;
+    const QRegularExpression m_nlDirector;
+    const QRegularExpression m_nlCat;
+    const QRegularExpression m_nlOmroep;
+    const QRegularExpression m_noRerun;
+    const QRegularExpression m_noHD;
+    const QRegularExpression m_noColonSubtitle;
+    const QRegularExpression m_noNRKCategories;
+    const QRegularExpression m_noPremiere;
+    const QRegularExpression m_Stereo;
+    const QRegularExpression m_DotEnd;
+    const QRegularExpression m_dkEpisode;
+    const QRegularExpression m_dkPart;
+    const QRegularExpression m_dkSubtitle1;
+    const QRegularExpression m_dkSubtitle2;
+    const QRegularExpression m_dkSeason1;
+    const QRegularExpression m_dkSeason2;
+    const QRegularExpression m_dkFeatures;
+    const QRegularExpression m_dkWidescreen;
+    const QRegularExpression m_dkDolby;
+    const QRegularExpression m_dkSurround;
+    const QRegularExpression m_dkStereo;
+    const QRegularExpression m_dkReplay;
+    const QRegularExpression m_dkTxt;
+    const QRegularExpression m_dkHD;
+    const QRegularExpression m_dkActors;
+    const QRegularExpression m_dkPersonsSeparator;
+    const QRegularExpression m_dkDirector;
+    const QRegularExpression m_dkYear;
+    const QRegularExpression m_AUFreeviewSY;//subtitle, year
+    const QRegularExpression m_AUFreeviewY;//year
+    const QRegularExpression m_AUFreeviewYC;//year, cast
+    const QRegularExpression m_AUFreeviewSYC;//subtitle, year, cast
+    const QRegularExpression m_AUNineRating;
+    const QRegularExpression m_AUSevenYear;
+    const QRegularExpression m_AUSevenAdvisories;
+    const QRegularExpression m_AUSevenRating;
+    const QRegularExpression m_HTML;
+    const QRegularExpression m_grReplay; //Greek rerun
+    const QRegularExpression m_grDescriptionFinale; //Greek last m_grEpisode
+    const QRegularExpression m_grActors; //Greek actors
+    const QRegularExpression m_grFixnofullstopActors; //bad punctuation makes the "Παίζουν:" and the actors' names part of the directors...
+    const QRegularExpression m_grFixnofullstopDirectors; //bad punctuation makes the "Σκηνοθ...:" and the previous sentence.
+    const QRegularExpression m_grPeopleSeparator; // The comma that separates the actors.
+    const QRegularExpression m_grDirector;
+    const QRegularExpression m_grPres; // Greek Presenters for shows
+    const QRegularExpression m_grYear; // Greek release year.
+    const QRegularExpression m_grCountry; // Greek event country of origin.
+    const QRegularExpression m_grlongEp; // Greek Episode
+    const QRegularExpression m_grSeason; // Greek Season
+    const QRegularExpression m_grSeries;
+    const QRegularExpression m_grRealTitleinDescription; // The original title is often in the descr in parenthesis.
+    const QRegularExpression m_grRealTitleinTitle; // The original title is often in the title in parenthesis.
+    const QRegularExpression m_grNotPreviouslyShown; // Not previously shown on TV
+    const QRegularExpression m_grEpisodeAsSubtitle; // Description field: "^Episode: Lion in the cage. (Description follows)"
+    const QRegularExpression m_grMovie; // Greek movie
+    const QRegularExpression m_grCategFood; // Greek category food
+    const QRegularExpression m_grCategDrama; // Greek category social/drama
+    const QRegularExpression m_grCategComedy; // Greek category comedy
+    const QRegularExpression m_grCategChildren; // Greek category for children / cartoons
+    const QRegularExpression m_grCategMystery; // Greek category for mystery
+    const QRegularExpression m_grCategFantasy; // Greek category for fantasy
+    const QRegularExpression m_grCategHistory; //Greek category for historical movie/series
+    const QRegularExpression m_grCategTeleMag; //Greek category for Telemagazine show
+    const QRegularExpression m_grCategTeleShop; //Greek category for teleshopping
+    const QRegularExpression m_grCategGameShow; //Greek category for game show
+    const QRegularExpression m_grCategDocumentary; // Greek category for Documentaries
+    const QRegularExpression m_grCategBiography; // Greek category for biography
+    const QRegularExpression m_grCategNews; // Greek category for News
+    const QRegularExpression m_grCategSports; // Greek category for Sports
+    const QRegularExpression m_grCategMusic; // Greek category for Music
+    const QRegularExpression m_grCategReality; // Greek category for reality shows
+    const QRegularExpression m_grCategReligion; //Greek category for religion
+    const QRegularExpression m_grCategCulture; //Greek category for Arts/Culture
+    const QRegularExpression m_grCategNature; //Greek category for Nature/Science
+    const QRegularExpression m_grCategSciFi;  // Greek category for Science Fiction
+    const QRegularExpression m_grCategHealth; //Greek category for Health
+    const QRegularExpression m_grCategSpecial; //Greek category for specials.
+    const QRegularExpression m_unitymediaImdbrating; ///< IMDb Rating
 };
 
 #endif // EITFIXUP_H
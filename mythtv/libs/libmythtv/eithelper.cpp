@@ -16,14 +16,20 @@ using namespace std;
 #include "premieredescriptors.h"
 #include "channelutil.h"        // for ChannelUtil
 #include "mythdate.h"
+#include "mythtimer.h"
 #include "programdata.h"
 #include "programinfo.h" // for subtitle types and audio and video properties
 #include "scheduledrecording.h" // for ScheduledRecording
 #include "compat.h" // for gmtime_r on windows.
 
-const uint EITHelper::kChunkSize = 20;
+const uint EITHelper::kChunkSize = 500;
 EITCache *EITHelper::eitcache = new EITCache();
 
+QMutex            EITHelper::stats_lock;
+QList<EITHelper*> EITHelper::stats_helpers;
+uint              EITHelper::stats_written = 0;
+int64_t           EITHelper::stats_msecs   = 0;
+
 static uint get_chan_id_from_db_atsc(uint sourceid,
                                      uint atscmajor, uint atscminor);
 static uint get_chan_id_from_db_dvb(uint sourceid,  uint serviceid,
@@ -38,13 +44,21 @@ EITHelper::EITHelper() :
     eitfixup(new EITFixUp()),
     gps_offset(-1 * GPS_LEAP_SECONDS),
     sourceid(0), channelid(0),
-    maxStarttime(QDateTime()), seenEITother(false)
+    minStarttime(QDateTime()), maxStarttime(QDateTime()), seenEITother(false)
 {
     init_fixup(fixup);
+
+    QMutexLocker locker(&stats_lock);
+    stats_helpers.push_back(this);
 }
 
 EITHelper::~EITHelper()
 {
+    {
+        QMutexLocker locker(&stats_lock);
+        stats_helpers.removeAll(this);
+    }
+
     QMutexLocker locker(&eitList_lock);
     while (db_events.size())
         delete db_events.dequeue();
@@ -61,6 +75,9 @@ uint EITHelper::GetListSize(void) const
 /** \fn EITHelper::ProcessEvents(void)
  *  \brief Inserts events in EIT list.
  *
+ *  Up to kChunkSize queued events are fixed up, grouped by channel and
+ *  written with one DBEventEIT::UpdateDB() batch per channel.
+ *
  *  \return Returns number of events inserted into DB.
  */
 uint EITHelper::ProcessEvents(void)
@@ -71,41 +88,82 @@ uint EITHelper::ProcessEvents(void)
     if (db_events.empty())
         return 0;
 
-    MSqlQuery query(MSqlQuery::InitCon());
-    for (uint i = 0; (i < kChunkSize) && (db_events.size() > 0); i++)
-    {
-        DBEventEIT *event = db_events.dequeue();
-        eitList_lock.unlock();
+    QList<DBEventEIT*> events;
+    while ((events.size() < (int)kChunkSize) && !db_events.empty())
+        events.push_back(db_events.dequeue());
+    eitList_lock.unlock();
+
+    MythTimer t;
+    t.start();
 
+    // Keep each channel's events in the order they arrived
+    QMap<uint, QList<DBEventEIT*> > channels;
+    for (int i = 0; i < events.size(); ++i)
+    {
+        DBEventEIT *event = events[i];
         eitfixup->Fix(*event);
+        channels[event->chanid].push_back(event);
 
-        insertCount += event->UpdateDB(query, 1000);
+        if (!minStarttime.isValid() || event->starttime < minStarttime)
+            minStarttime = event->starttime;
         maxStarttime = max (maxStarttime, event->starttime);
+    }
 
-        delete event;
-        eitList_lock.lock();
+    MSqlQuery query(MSqlQuery::InitCon());
+    QMap<uint, QList<DBEventEIT*> >::const_iterator it = channels.begin();
+    for (; it != channels.end(); ++it)
+        insertCount += DBEventEIT::UpdateDB(query, *it, 1000);
+
+    for (int i = 0; i < events.size(); ++i)
+        delete events[i];
+
+    int elapsed = t.elapsed();
+    {
+        QMutexLocker stats_locker(&stats_lock);
+        stats_written += events.size();
+        stats_msecs   += elapsed;
     }
 
+    eitList_lock.lock();
+
     if (!insertCount)
         return 0;
 
     if (incomplete_events.size() || unmatched_etts.size())
     {
         LOG(VB_EIT, LOG_INFO,
-            LOC + QString("Added %1 events -- complete(%2) "
-                          "incomplete(%3) unmatched(%4)")
-                .arg(insertCount).arg(db_events.size())
+            LOC + QString("Added %1 events in %2 ms -- complete(%3) "
+                          "incomplete(%4) unmatched(%5)")
+                .arg(insertCount).arg(elapsed).arg(db_events.size())
                 .arg(incomplete_events.size()).arg(unmatched_etts.size()));
     }
     else
     {
         LOG(VB_EIT, LOG_INFO,
-            LOC + QString("Added %1 events").arg(insertCount));
+            LOC + QString("Added %1 events in %2 ms")
+                .arg(insertCount).arg(elapsed));
     }
 
     return insertCount;
 }
 
+/** \fn EITHelper::GetWriteStatistics(uint&, uint&, double&)
+ *  \brief Returns the number of events queued for the database across
+ *         all EITHelpers, the number written so far and the write rate
+ *         in events per second.
+ */
+void EITHelper::GetWriteStatistics(uint &queued, uint &written, double &rate)
+{
+    QMutexLocker locker(&stats_lock);
+
+    queued = 0;
+    for (int i = 0; i < stats_helpers.size(); ++i)
+        queued += stats_helpers[i]->GetListSize();
+
+    written = stats_written;
+    rate    = stats_msecs ? stats_written * 1000.0 / stats_msecs : 0.0;
+}
+
 void EITHelper::SetFixup(uint atsc_major, uint atsc_minor, FixupValue eitfixup)
 {
     QMutexLocker locker(&eitList_lock);
@@ -1427,7 +1485,8 @@ void EITHelper::RescheduleRecordings(void)
 {
     ScheduledRecording::RescheduleMatch(
         0, sourceid, seenEITother ? 0 : ChannelUtil::GetMplexID(channelid),
-        maxStarttime, "EITScanner");
+        minStarttime, maxStarttime, "EITScanner");
     seenEITother = false;
+    minStarttime = QDateTime();
     maxStarttime = QDateTime();
 }
@@ -9,6 +9,7 @@
 
 // Qt includes
 #include <QDateTime>
+#include <QList>
 #include <QMap>
 #include <QMutex>
 #include <QObject>
@@ -16,6 +17,7 @@
 
 // MythTV includes
 #include "mythdeque.h"
+#include "mythtvexp.h"
 
 class MSqlQuery;
 
@@ -124,6 +126,9 @@ class EITHelper
     void PruneEITCache(uint timestamp);
     void WriteEITCache(void);
 
+    static MTV_PUBLIC void GetWriteStatistics(
+        uint &queued, uint &written, double &rate);
+
   private:
     // only ATSC
     uint GetChanID(uint atsc_major, uint atsc_minor);
@@ -148,6 +153,7 @@ class EITHelper
     /* carry some values to optimize channel lookup and reschedules */
     uint                    sourceid;            ///< id of the video source
     uint                    channelid;           ///< id of the channel
+    QDateTime               minStarttime;        ///< earliest starttime of changed events
     QDateTime               maxStarttime;        ///< latest starttime of changed events
     bool                    seenEITother;        ///< if false we only reschedule the active mplex
 
@@ -161,6 +167,12 @@ class EITHelper
 
     /// Maximum number of DB inserts per ProcessEvents call.
     static const uint kChunkSize;
+
+    // Database write statistics over all EITHelpers
+    static QMutex             stats_lock;
+    static QList<EITHelper*>  stats_helpers;
+    static uint               stats_written;  ///< events handed to the db
+    static int64_t            stats_msecs;    ///< time spent writing them
 };
 
 #endif // EIT_HELPER_H
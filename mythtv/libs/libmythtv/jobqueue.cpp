@@ -6,12 +6,14 @@
 #include <cstdlib>
 #include <fcntl.h>
 #include <pthread.h>
+#include <algorithm>
 using namespace std;
 
 #include <QDateTime>
 #include <QFileInfo>
 #include <QRegExp>
 #include <QEvent>
+#include <QThread>
 #include <QCoreApplication>
 
 #include "mythconfig.h"
@@ -51,7 +53,9 @@ JobQueue::JobQueue(bool master) :
     runningJobsLock(new QMutex(QMutex::Recursive)),
     isMaster(master),
     queueThread(new MThread("JobQueue", this)),
-    processQueue(false)
+    processQueue(false),
+    queueChanged(false),
+    lastJobType(JOB_NONE)
 {
     jobQueueCPU = gCoreContext->GetNumSetting("JobQueueCPU", 0);
 
@@ -91,6 +95,16 @@ void JobQueue::customEvent(QEvent *e)
         MythEvent *me = (MythEvent *)e;
         QString message = me->Message();
 
+        // A job was queued or given a command somewhere, or a recording
+        // ended and its jobs (and the tuner's share of the machine) are
+        // now up for grabs.
+        if (message == "JOBQUEUE_CHANGE" ||
+            message.startsWith("DONE_RECORDING"))
+        {
+            WakeQueue();
+            return;
+        }
+
         if (message.startsWith("LOCAL_JOB"))
         {
             // LOCAL_JOB action ID jobID
@@ -179,6 +193,7 @@ void JobQueue::ProcessQueue(void)
     int maxJobs;
     QString message;
     QMap<int, JobQueueEntry> jobs;
+    QMap<int, QList<JobQueueEntry> > readyJobs;
     bool atMax = false;
     bool inTimeWindow = true;
     bool startedJobAlready = false;
@@ -197,6 +212,7 @@ void JobQueue::ProcessQueue(void)
                         .arg(maxJobs));
 
         jobStatus.clear();
+        readyJobs.clear();
 
         runningJobsLock->lock();
         for (rjiter = runningJobs.begin(); rjiter != runningJobs.end();
@@ -431,20 +447,6 @@ void JobQueue::ProcessQueue(void)
                     continue;
                 }
 
-                // never start or claim more than one job in a single run
-                if (startedJobAlready)
-                    continue;
-
-                if ((inTimeWindow) &&
-                    (hostname.isEmpty()) &&
-                    (!ChangeJobHost(jobID, m_hostname)))
-                {
-                    message = QString("Unable to claim '%1' job for %2")
-                                      .arg(JobText(jobs[x].type)).arg(logInfo);
-                    LOG(VB_JOBQUEUE, LOG_ERR, LOC + message);
-                    continue;
-                }
-
                 if (!inTimeWindow)
                 {
                     message = QString("Skipping '%1' job for %2, "
@@ -455,15 +457,72 @@ void JobQueue::ProcessQueue(void)
                     continue;
                 }
 
-                message = QString("Processing '%1' job for %2, "
-                                  "current status is '%3'")
-                                  .arg(JobText(jobs[x].type)).arg(logInfo)
-                                  .arg(StatusText(status));
-                LOG(VB_JOBQUEUE, LOG_INFO, LOC + message);
+                readyJobs[jobs[x].type].append(jobs[x]);
+            }
+
+            // Each job type has its own queue and the types take turns,
+            // so a backlog of transcodes doesn't hold up commflagging.
+            QList<int> types = readyJobs.keys();
+            int first = 0;
+            while (first < types.size() && types[first] <= lastJobType)
+                first++;
 
-                ProcessJob(jobs[x]);
+            for (int t = 0; (t < types.size()) && (jobsRunning < maxJobs) &&
+                     !startedJobAlready; t++)
+            {
+                int type = types[(first + t) % types.size()];
+                QString reason;
+
+                if (!AdmitJobType(type, reason))
+                {
+                    message = QString("Holding back '%1' jobs, %2")
+                                      .arg(JobText(type)).arg(reason);
+                    LOG(VB_JOBQUEUE, LOG_INFO, LOC + message);
+                    continue;
+                }
+
+                const QList<JobQueueEntry> &queue = readyJobs[type];
+                for (int x = 0; x < queue.size(); x++)
+                {
+                    const JobQueueEntry &job = queue[x];
+
+                    if (!job.chanid)
+                        logInfo = QString("jobID #%1").arg(job.id);
+                    else
+                        logInfo = QString("chanid %1 @ %2").arg(job.chanid)
+                                          .arg(job.startts);
+
+                    if (IsHeavyJob(type) && !AdmitJobStorage(job, reason))
+                    {
+                        message = QString("Holding back '%1' job for %2, %3")
+                                          .arg(JobText(type)).arg(logInfo)
+                                          .arg(reason);
+                        LOG(VB_JOBQUEUE, LOG_INFO, LOC + message);
+                        continue;
+                    }
 
-                startedJobAlready = true;
+                    if ((job.hostname.isEmpty()) &&
+                        (!ChangeJobHost(job.id, m_hostname)))
+                    {
+                        message = QString("Unable to claim '%1' job for %2")
+                                          .arg(JobText(type)).arg(logInfo);
+                        LOG(VB_JOBQUEUE, LOG_ERR, LOC + message);
+                        continue;
+                    }
+
+                    message = QString("Processing '%1' job for %2, "
+                                      "current status is '%3'")
+                                      .arg(JobText(type)).arg(logInfo)
+                                      .arg(StatusText(job.status));
+                    LOG(VB_JOBQUEUE, LOG_INFO, LOC + message);
+
+                    ProcessJob(job);
+
+                    // never start or claim more than one job in a single run
+                    startedJobAlready = true;
+                    lastJobType = type;
+                    break;
+                }
             }
         }
 
@@ -490,14 +549,202 @@ void JobQueue::ProcessQueue(void)
         }
 
 
+        // Jobs are started as soon as something changes, the timeout is
+        // only there for changes nobody told us about.
         locker.relock();
-        if (processQueue)
+        if (processQueue && !queueChanged)
         {
             int st = (startedJobAlready) ? (5 * 1000) : (sleepTime * 1000);
             if (st > 0)
                 queueThreadCond.wait(locker.mutex(), st);
         }
+        queueChanged = false;
+    }
+}
+
+/** \brief Has the queue thread take another look at the queue right away.
+ */
+void JobQueue::WakeQueue(void)
+{
+    QMutexLocker locker(&queueThreadCondLock);
+    queueChanged = true;
+    queueThreadCond.wakeAll();
+}
+
+/** \brief Tells every job queue that a job was queued or sent a command.
+ *
+ *  The message goes through the master backend, so job queues on other
+ *  machines and in mythjobqueue hear about it as well.
+ */
+void JobQueue::NotifyQueueChanged(void)
+{
+    gCoreContext->SendMessage("JOBQUEUE_CHANGE");
+}
+
+/// Transcodes and user jobs read and write whole recordings
+bool JobQueue::IsHeavyJob(int jobType)
+{
+    return (jobType == JOB_TRANSCODE) || (jobType & JOB_USERJOB);
+}
+
+/** \brief Checks the limits that apply to every job of one type.
+ *
+ *  Metadata lookups only wait for the job slots. Everything else also
+ *  waits while the one minute load average is above JobQueueMaxCPULoad
+ *  percent of the CPUs, and transcodes and user jobs also wait while
+ *  JobQueueMaxRecorders or more recordings are being made here.
+ *
+ *  \param reason Set to why the jobs can't start.
+ */
+bool JobQueue::AdmitJobType(int jobType, QString &reason)
+{
+    if (jobType == JOB_METADATA)
+        return true;
+
+    int maxLoad = gCoreContext->GetNumSetting("JobQueueMaxCPULoad", 100);
+    double loads[3];
+    if ((maxLoad > 0) && (getloadavg(loads, 3) != -1))
+    {
+        int cpus = max(QThread::idealThreadCount(), 1);
+        int load = (int)(loads[0] * 100.0 / cpus);
+        if (load >= maxLoad)
+        {
+            reason = QString("CPU load is %1%").arg(load);
+            return false;
+        }
     }
+
+    if (!IsHeavyJob(jobType))
+        return true;
+
+    int maxRecorders = gCoreContext->GetNumSetting("JobQueueMaxRecorders", 3);
+    if (maxRecorders > 0)
+    {
+        uint recorders = GetActiveRecorderCount(m_hostname);
+        if (recorders >= (uint)maxRecorders)
+        {
+            reason = QString("%1 recordings in progress").arg(recorders);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/** \brief Checks how busy the storage directory of a job's recording is.
+ *
+ *  Every recorder, player and job using a recording leaves an in-use
+ *  mark with the recording's directory, so the marks tell how many
+ *  streams that directory is already serving. A transcode or user job
+ *  waits while there are JobQueueMaxStorageStreams or more.
+ *
+ *  \param reason Set to why the job can't start.
+ */
+bool JobQueue::AdmitJobStorage(const JobQueueEntry &job, QString &reason)
+{
+    int maxStreams =
+        gCoreContext->GetNumSetting("JobQueueMaxStorageStreams", 4);
+    if ((maxStreams <= 0) || !job.chanid)
+        return true;
+
+    ProgramInfo pginfo(job.chanid, job.recstartts);
+    QString recDir = pginfo.DiscoverRecordingDirectory();
+    if (recDir.isEmpty())
+        return true;
+
+    // mythcommflag and mythtranscode mark the recording themselves on
+    // top of the job queue's mark, only count the job once.
+    MSqlQuery query(MSqlQuery::InitCon());
+    query.prepare("SELECT count(*) FROM inuseprograms "
+                  "WHERE recdir = :RECDIR AND "
+                  "      lastupdatetime >= :ONEHOURAGO AND "
+                  "      recusage NOT IN (:FLAGGER, :TRANSCODER)");
+    query.bindValue(":RECDIR", recDir);
+    query.bindValue(":ONEHOURAGO", MythDate::current().addSecs(-61 * 60));
+    query.bindValue(":FLAGGER", kFlaggerInUseID);
+    query.bindValue(":TRANSCODER", kTranscoderInUseID);
+
+    if (!query.exec() || !query.next())
+    {
+        MythDB::DBError("JobQueue::AdmitJobStorage()", query);
+        return true;
+    }
+
+    uint streams = query.value(0).toUInt();
+    if (streams >= (uint)maxStreams)
+    {
+        reason = QString("%1 streams already use '%2'")
+                         .arg(streams).arg(recDir);
+        return false;
+    }
+
+    return true;
+}
+
+/// Returns the number of recordings being made on the given host
+uint JobQueue::GetActiveRecorderCount(const QString &hostname)
+{
+    MSqlQuery query(MSqlQuery::InitCon());
+    query.prepare("SELECT count(*) FROM inuseprograms "
+                  "WHERE recusage = :RECORDER AND hostname = :HOSTNAME AND "
+                  "      lastupdatetime >= :ONEHOURAGO");
+    query.bindValue(":RECORDER", kRecorderInUseID);
+    query.bindValue(":HOSTNAME", hostname);
+    query.bindValue(":ONEHOURAGO", MythDate::current().addSecs(-61 * 60));
+
+    if (!query.exec() || !query.next())
+    {
+        MythDB::DBError("JobQueue::GetActiveRecorderCount()", query);
+        return 0;
+    }
+
+    return query.value(0).toUInt();
+}
+
+/** \brief Adds a job's queue latency, and its run time once it has
+ *         finished, to the totals for its type and logs them.
+ *  \param finished Invalid while the job is just starting.
+ */
+void JobQueue::UpdateJobStats(int jobType, const QDateTime &queued,
+                              const QDateTime &started,
+                              const QDateTime &finished)
+{
+    QMutexLocker locker(&statsLock);
+
+    if (!jobStats.contains(jobType))
+    {
+        JobStats empty = { 0, 0, 0, 0, 0, 0 };
+        jobStats[jobType] = empty;
+    }
+    JobStats &stats = jobStats[jobType];
+
+    if (!finished.isValid())
+    {
+        int64_t latency = max(queued.secsTo(started), (qint64)0);
+        stats.started++;
+        stats.totalLatency += latency;
+        stats.maxLatency = max(stats.maxLatency, latency);
+
+        LOG(VB_JOBQUEUE, LOG_INFO, LOC +
+            QString("'%1' job waited %2 secs in the queue, "
+                    "average %3 secs, max %4 secs over %5 jobs")
+                .arg(JobText(jobType)).arg(latency)
+                .arg(stats.totalLatency / stats.started)
+                .arg(stats.maxLatency).arg(stats.started));
+        return;
+    }
+
+    int64_t runtime = max(started.secsTo(finished), (qint64)0);
+    stats.finished++;
+    stats.totalRuntime += runtime;
+    stats.maxRuntime = max(stats.maxRuntime, runtime);
+
+    LOG(VB_JOBQUEUE, LOG_INFO, LOC +
+        QString("'%1' job ran for %2 secs, "
+                "average %3 secs, max %4 secs over %5 jobs")
+            .arg(JobText(jobType)).arg(runtime)
+            .arg(stats.totalRuntime / stats.finished)
+            .arg(stats.maxRuntime).arg(stats.finished));
 }
 
 bool JobQueue::QueueRecordingJobs(const RecordingInfo &recinfo, int jobTypes)
@@ -609,6 +856,8 @@ bool JobQueue::QueueJob(int jobType, uint chanid, const QDateTime &recstartts,
         return false;
     }
 
+    NotifyQueueChanged();
+
     return true;
 }
 
@@ -921,6 +1170,10 @@ bool JobQueue::ChangeJobCmds(int jobID, int newCmds)
         return false;
     }
 
+    // The queue thread acts on commands and then resets them to JOB_RUN
+    if (newCmds != JOB_RUN)
+        NotifyQueueChanged();
+
     return true;
 }
 
@@ -943,6 +1196,10 @@ bool JobQueue::ChangeJobCmds(int jobType, uint chanid,
         return false;
     }
 
+    // The queue thread acts on commands and then resets them to JOB_RUN
+    if (newCmds != JOB_RUN)
+        NotifyQueueChanged();
+
     return true;
 }
 
@@ -1696,6 +1953,10 @@ void JobQueue::ProcessJob(JobQueueEntry job)
     jInfo.desc    = GetJobDescription(job.type);
     jInfo.command = GetJobCommand(jobID, job.type, pginfo);
     jInfo.pginfo  = pginfo;
+    jInfo.starttime = MythDate::current();
+
+    UpdateJobStats(job.type, max(job.inserttime, job.schedruntime),
+                   jInfo.starttime, QDateTime());
 
     runningJobs[jobID] = jInfo;
 
@@ -1829,10 +2090,16 @@ void JobQueue::RemoveRunningJob(int id)
             delete pginfo;
         }
 
+        UpdateJobStats(runningJobs[id].type, QDateTime(),
+                       runningJobs[id].starttime, MythDate::current());
+
         runningJobs.remove(id);
     }
 
     runningJobsLock->unlock();
+
+    // A job slot just opened up
+    WakeQueue();
 }
 
 QString JobQueue::PrettyPrint(off_t bytes)
@@ -109,6 +109,7 @@ typedef struct runningjobinfo {
     QString      desc;
     QString      command;
     ProgramInfo *pginfo;
+    QDateTime    starttime;
 } RunningJobInfo;
 
 class JobQueue;
@@ -206,12 +207,31 @@ class MTV_PUBLIC JobQueue : public QObject, public QRunnable
         int jobID;
     } JobThreadStruct;
 
+    /// Queue latency and run time totals for one job type, in seconds
+    typedef struct jobstats
+    {
+        uint    started;
+        int64_t totalLatency;
+        int64_t maxLatency;
+        uint    finished;
+        int64_t totalRuntime;
+        int64_t maxRuntime;
+    } JobStats;
+
     void run(void); // QRunnable
     void ProcessQueue(void);
+    void WakeQueue(void);
+    static void NotifyQueueChanged(void);
 
     void ProcessJob(JobQueueEntry job);
 
     bool AllowedToRun(JobQueueEntry job);
+    bool AdmitJobType(int jobType, QString &reason);
+    bool AdmitJobStorage(const JobQueueEntry &job, QString &reason);
+    static bool IsHeavyJob(int jobType);
+    static uint GetActiveRecorderCount(const QString &hostname);
+    void UpdateJobStats(int jobType, const QDateTime &queued,
+                        const QDateTime &started, const QDateTime &finished);
 
     static bool InJobRunWindow(int orStartingWithinMins = 0);
 
@@ -254,6 +274,13 @@ class MTV_PUBLIC JobQueue : public QObject, public QRunnable
     QWaitCondition queueThreadCond;
     QMutex queueThreadCondLock;
     bool processQueue;
+    /// set when something happened that may let a job start
+    bool queueChanged;
+    /// type of the last job started, job types take turns
+    int lastJobType;
+
+    QMutex statsLock;
+    QMap<int, JobStats> jobStats;
 };
 
 #endif
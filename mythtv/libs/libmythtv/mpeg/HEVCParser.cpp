@@ -0,0 +1,824 @@
+// MythTV headers
+#include "HEVCParser.h"
+#include "mythlogging.h"
+#include "recorders/dtvrecorder.h" // for FrameRate
+
+extern "C" {
+#include "libavcodec/avcodec.h"
+#include "libavcodec/golomb.h"
+}
+
+#include <cmath>
+
+static const float eps = 1E-5;
+
+/*
+  The syntax below follows ITU-T Rec. H.265 (04/2015) as found here:
+  http://www.itu.int/rec/T-REC-H.265
+
+  An access unit is a set of NAL units that are associated with each
+  other, are consecutive in decoding order and contain exactly one coded
+  picture of the base layer. The first of any of the following NAL units
+  after the last VCL NAL unit of a coded picture starts a new access
+  unit (7.4.2.4.4):
+
+  - access unit delimiter, VPS, SPS, PPS or prefix SEI NAL units
+  - NAL units with nal_unit_type in the range of 41..44 or 48..55
+  - the first VCL NAL unit of a coded picture, which is the one with
+    first_slice_segment_in_pic_flag set
+
+  An intra random access point (IRAP) picture is a picture whose VCL NAL
+  units all have a nal_unit_type in the range of 16..23. Decoding can
+  start at an IRAP picture, the RASL pictures associated with a CRA or
+  BLA picture are then skipped.
+*/
+
+/// Largest number of pictures in one list of a short term RPS
+static const uint kMaxDeltaPocs = 16;
+
+/// ITU-T Rec. H.265 A.4.1, sps_max_dec_pic_buffering_minus1 is below 16
+static const uint kMaxShortTermRPS = 64;
+
+struct HEVCParser::ShortTermRPS
+{
+    uint num_negative;
+    uint num_positive;
+    int  delta_poc_s0[kMaxDeltaPocs];
+    int  delta_poc_s1[kMaxDeltaPocs];
+};
+
+HEVCParser::HEVCParser(void)
+{
+    rbsp_buffer_size = 188 * 2;
+    rbsp_buffer = new uint8_t[rbsp_buffer_size];
+
+    Reset();
+}
+
+void HEVCParser::Reset(void)
+{
+    state_changed = false;
+    seen_sps = false;
+    SPS_offset = 0;
+
+    sync_accumulator = 0xffffffff;
+    AU_pending = false;
+
+    nal_unit_type = UNKNOWN;
+    nal_header = 0;
+
+    pic_width = pic_height = 0;
+    aspect_ratio_idc = 0;
+    sar_width = sar_height = 0;
+    unitsInTick = timeScale = 0;
+    vpsUnitsInTick = vpsTimeScale = 0;
+
+    pkt_offset = AU_offset = frame_start_offset = keyframe_start_offset = 0;
+    on_frame = on_key_frame = false;
+
+    resetRBSP();
+}
+
+QString HEVCParser::NAL_type_str(uint8_t type)
+{
+    switch (type)
+    {
+      case TRAIL_N:
+      case TRAIL_R:
+        return "TRAIL";
+      case TSA_N:
+      case TSA_R:
+        return "TSA";
+      case STSA_N:
+      case STSA_R:
+        return "STSA";
+      case RADL_N:
+      case RADL_R:
+        return "RADL";
+      case RASL_N:
+      case RASL_R:
+        return "RASL";
+      case BLA_W_LP:
+      case BLA_W_RADL:
+      case BLA_N_LP:
+        return "BLA";
+      case IDR_W_RADL:
+      case IDR_N_LP:
+        return "IDR";
+      case CRA_NUT:
+        return "CRA";
+      case VPS_NUT:
+        return "VPS";
+      case SPS_NUT:
+        return "SPS";
+      case PPS_NUT:
+        return "PPS";
+      case AUD_NUT:
+        return "AUD";
+      case EOS_NUT:
+        return "EOS";
+      case EOB_NUT:
+        return "EOB";
+      case FD_NUT:
+        return "FD";
+      case PREFIX_SEI_NUT:
+        return "PREFIX_SEI";
+      case SUFFIX_SEI_NUT:
+        return "SUFFIX_SEI";
+    }
+    return "OTHER";
+}
+
+void HEVCParser::resetRBSP(void)
+{
+    rbsp_index = 0;
+    consecutive_zeros = 0;
+    have_unfinished_NAL = false;
+}
+
+bool HEVCParser::fillRBSP(const uint8_t *byteP, uint32_t byte_count,
+                          bool found_start_code)
+{
+    /*
+      bitstream buffer, must be FF_INPUT_BUFFER_PADDING_SIZE
+      bytes larger then the actual data
+    */
+    uint32_t required_size = rbsp_index + byte_count +
+                             FF_INPUT_BUFFER_PADDING_SIZE;
+    if (rbsp_buffer_size < required_size)
+    {
+        // Round up to packet size
+        required_size = ((required_size / 188) + 1) * 188;
+
+        uint8_t *new_buffer = new uint8_t[required_size];
+        memcpy(new_buffer, rbsp_buffer, rbsp_index);
+        delete [] rbsp_buffer;
+        rbsp_buffer = new_buffer;
+        rbsp_buffer_size = required_size;
+    }
+
+    while (byte_count)
+    {
+        /* Copy the byte into the rbsp, unless it
+         * is the 0x03 in a 0x000003 */
+        if (consecutive_zeros < 2 || *byteP != 0x03)
+            rbsp_buffer[rbsp_index++] = *byteP;
+
+        if (*byteP == 0)
+            ++consecutive_zeros;
+        else
+            consecutive_zeros = 0;
+
+        ++byteP;
+        --byte_count;
+    }
+
+    /* The next start code and the first byte of the next NAL unit
+     * header are in the buffer too, drop them along with any trailing
+     * zero bytes.
+     */
+    if (found_start_code)
+    {
+        if (rbsp_index >= 4)
+        {
+            rbsp_index -= 4;
+            while (rbsp_index > 0 && rbsp_buffer[rbsp_index-1] == 0)
+                --rbsp_index;
+        }
+        else
+        {
+            LOG(VB_GENERAL, LOG_ERR,
+                QString("HEVCParser::fillRBSP: Found start code, rbsp_index "
+                        "is %1 but it should be >4")
+                    .arg(rbsp_index));
+        }
+    }
+
+    /* Stick some 0xff on the end for get_bits to run into */
+    memset(&rbsp_buffer[rbsp_index], 0xff, FF_INPUT_BUFFER_PADDING_SIZE);
+    return true;
+}
+
+uint32_t HEVCParser::addBytes(const uint8_t  *bytes,
+                              const uint32_t  byte_count,
+                              const uint64_t  stream_offset)
+{
+    const uint8_t *startP = bytes;
+    const uint8_t *endP;
+    bool           found_start_code;
+
+    state_changed = false;
+    on_frame      = false;
+    on_key_frame  = false;
+
+    while (startP < bytes + byte_count && !on_frame)
+    {
+        endP = avpriv_find_start_code(startP,
+                                      bytes + byte_count, &sync_accumulator);
+
+        found_start_code = ((sync_accumulator & 0xffffff00) == 0x00000100);
+
+        if (have_unfinished_NAL)
+        {
+            if (!fillRBSP(startP, endP - startP, found_start_code))
+            {
+                resetRBSP();
+                return endP - bytes;
+            }
+            processRBSP(found_start_code); /* Call may set have_unfinished_NAL
+                                            * to false */
+        }
+
+        startP = endP;
+
+        if (found_start_code)
+        {
+            if (have_unfinished_NAL)
+            {
+                LOG(VB_GENERAL, LOG_ERR,
+                    "HEVCParser::addBytes: Found new start "
+                    "code, but previous NAL is incomplete!");
+            }
+
+            resetRBSP();
+
+            pkt_offset = stream_offset;
+
+            /*
+              The NAL unit header is two bytes long:
+                forbidden_zero_bit     f(1)
+                nal_unit_type          u(6)
+                nuh_layer_id           u(6)
+                nuh_temporal_id_plus1  u(3)
+              Only the first byte is known here, the second one is the
+              first byte put into the rbsp buffer.
+            */
+            nal_header = sync_accumulator & 0xff;
+            nal_unit_type = (nal_header >> 1) & 0x3f;
+
+            if (nal_header & 0x80)
+            {
+                LOG(VB_GENERAL, LOG_ERR,
+                    "HEVCParser::addBytes: malformed NAL units");
+            }
+            else if (NALisVCL(nal_unit_type) ||
+                     nal_unit_type == VPS_NUT ||
+                     nal_unit_type == SPS_NUT ||
+                     nal_unit_type == PPS_NUT ||
+                     nal_unit_type == AUD_NUT ||
+                     nal_unit_type == PREFIX_SEI_NUT ||
+                     (nal_unit_type >= RSV_NVCL41 &&
+                      nal_unit_type <= RSV_NVCL44) ||
+                     (nal_unit_type >= UNSPEC48 &&
+                      nal_unit_type <= UNSPEC55))
+            {
+                /* Everything that may start an access unit, the layer
+                 * it belongs to isn't known before the next byte */
+                have_unfinished_NAL = true;
+            }
+        }
+    }
+
+    return startP - bytes;
+}
+
+void HEVCParser::processRBSP(bool rbsp_complete)
+{
+    if (rbsp_index < 1)
+    {
+        have_unfinished_NAL = !rbsp_complete;
+        return;
+    }
+
+    // Enhancement layers don't add pictures of their own
+    uint nuh_layer_id = ((nal_header & 0x1) << 5) | (rbsp_buffer[0] >> 3);
+    if (nuh_layer_id != 0)
+    {
+        have_unfinished_NAL = false;
+        return;
+    }
+
+    if (NALisVCL(nal_unit_type))
+    {
+        // first_slice_segment_in_pic_flag is the first bit of the header
+        if (rbsp_index < 2)
+        {
+            have_unfinished_NAL = !rbsp_complete;
+            return;
+        }
+        have_unfinished_NAL = false;
+
+        if (!(rbsp_buffer[1] & 0x80))
+            return;
+
+        set_AU_pending();
+
+        AU_pending = false;
+        state_changed = seen_sps;
+        on_frame = true;
+        frame_start_offset = AU_offset;
+        if (NALisIRAP(nal_unit_type))
+        {
+            on_key_frame = true;
+            keyframe_start_offset = AU_offset;
+        }
+        return;
+    }
+
+    if (nal_unit_type == VPS_NUT || nal_unit_type == SPS_NUT)
+    {
+        /* Best wait until we have the whole thing */
+        if (!rbsp_complete)
+            return;
+
+        set_AU_pending();
+
+        GetBitContext gb;
+        init_get_bits(&gb, rbsp_buffer + 1, 8 * (rbsp_index - 1));
+
+        if (nal_unit_type == VPS_NUT)
+            decode_VPS(&gb);
+        else
+        {
+            if (!seen_sps)
+                SPS_offset = pkt_offset;
+            decode_SPS(&gb);
+        }
+    }
+    else
+    {
+        set_AU_pending();
+    }
+
+    have_unfinished_NAL = false;
+}
+
+/*
+  7.3.3 Profile, tier and level syntax, nothing in it is needed
+*/
+void HEVCParser::profile_tier_level(GetBitContext *gb,
+                                    uint max_sub_layers_minus1)
+{
+    bool sub_layer_profile_present_flag[8];
+    bool sub_layer_level_present_flag[8];
+
+    /*
+      general_profile_space, general_tier_flag, general_profile_idc,
+      the 32 general_profile_compatibility_flags, the four source and
+      constraint flags and 44 reserved or constraint bits
+    */
+    skip_bits_long(gb, 88);
+    skip_bits(gb, 8);   // general_level_idc
+
+    for (uint i = 0; i < max_sub_layers_minus1; ++i)
+    {
+        sub_layer_profile_present_flag[i] = get_bits1(gb);
+        sub_layer_level_present_flag[i]   = get_bits1(gb);
+    }
+
+    if (max_sub_layers_minus1 > 0)
+    {
+        for (uint i = max_sub_layers_minus1; i < 8; ++i)
+            skip_bits(gb, 2); // reserved_zero_2bits
+    }
+
+    for (uint i = 0; i < max_sub_layers_minus1; ++i)
+    {
+        if (sub_layer_profile_present_flag[i])
+            skip_bits_long(gb, 88);
+        if (sub_layer_level_present_flag[i])
+            skip_bits(gb, 8); // sub_layer_level_idc
+    }
+}
+
+/*
+  7.3.1 Video parameter set RBSP syntax, read for the timing information
+  of streams that don't have any in their SPS
+*/
+void HEVCParser::decode_VPS(GetBitContext *gb)
+{
+    skip_bits(gb, 4);   // vps_video_parameter_set_id
+    skip_bits(gb, 2);   // vps_base_layer_internal/available_flag
+    skip_bits(gb, 6);   // vps_max_layers_minus1
+    uint max_sub_layers_minus1 = get_bits(gb, 3);
+    get_bits1(gb);      // vps_temporal_id_nesting_flag
+    skip_bits(gb, 16);  // vps_reserved_0xffff_16bits
+
+    if (max_sub_layers_minus1 > 6)
+        return;
+    profile_tier_level(gb, max_sub_layers_minus1);
+
+    bool ordering_info_present = get_bits1(gb);
+    for (uint i = ordering_info_present ? 0 : max_sub_layers_minus1;
+         i <= max_sub_layers_minus1; ++i)
+    {
+        get_ue_golomb_long(gb); // vps_max_dec_pic_buffering_minus1
+        get_ue_golomb_long(gb); // vps_max_num_reorder_pics
+        get_ue_golomb_long(gb); // vps_max_latency_increase_plus1
+    }
+
+    uint max_layer_id = get_bits(gb, 6);
+    uint num_layer_sets_minus1 = get_ue_golomb_long(gb);
+    if (num_layer_sets_minus1 > 1023)
+        return;
+    for (uint i = 1; i <= num_layer_sets_minus1; ++i)
+        skip_bits_long(gb, max_layer_id + 1); // layer_id_included_flag
+
+    if (get_bits_left(gb) < 65)
+        return;
+
+    if (get_bits1(gb)) // vps_timing_info_present_flag
+    {
+        vpsUnitsInTick = get_bits_long(gb, 32); // vps_num_units_in_tick
+        vpsTimeScale   = get_bits_long(gb, 32); // vps_time_scale
+    }
+}
+
+/*
+  7.3.4 Scaling list data syntax
+*/
+static void scaling_list_data(GetBitContext *gb)
+{
+    for (uint sizeId = 0; sizeId < 4; ++sizeId)
+    {
+        for (uint matrixId = 0; matrixId < 6;
+             matrixId += (sizeId == 3) ? 3 : 1)
+        {
+            if (!get_bits1(gb)) // scaling_list_pred_mode_flag
+            {
+                get_ue_golomb_long(gb); // scaling_list_pred_matrix_id_delta
+                continue;
+            }
+
+            uint coefNum = std::min(64, 1 << (4 + (sizeId << 1)));
+            if (sizeId > 1)
+                get_se_golomb(gb); // scaling_list_dc_coef_minus8
+            for (uint i = 0; i < coefNum; ++i)
+                get_se_golomb(gb); // scaling_list_delta_coef
+        }
+    }
+}
+
+/*
+  7.3.7 Short-term reference picture set syntax, as found in an SPS.
+
+  Sets predicted from the set before them can only be skipped over by
+  working out how many pictures that set refers to, which in turn
+  needs the picture order count differences (7.4.8).
+*/
+bool HEVCParser::short_term_ref_pic_set(GetBitContext *gb, uint idx,
+                                        ShortTermRPS *sets)
+{
+    ShortTermRPS &rps = sets[idx];
+
+    if (idx != 0 && get_bits1(gb)) // inter_ref_pic_set_prediction_flag
+    {
+        const ShortTermRPS &ref = sets[idx - 1];
+        uint num_delta_pocs = ref.num_negative + ref.num_positive;
+        bool use_delta_flag[2 * kMaxDeltaPocs + 1];
+
+        int delta_rps_sign = get_bits1(gb);
+        int delta_rps = (1 - 2 * delta_rps_sign) *
+                        (int)(get_ue_golomb_long(gb) + 1);
+
+        for (uint j = 0; j <= num_delta_pocs; ++j)
+        {
+            bool used_by_curr_pic_flag = get_bits1(gb);
+            use_delta_flag[j] = used_by_curr_pic_flag || get_bits1(gb);
+        }
+
+        uint i = 0;
+        for (int j = (int)ref.num_positive - 1; j >= 0; --j)
+        {
+            int dPoc = ref.delta_poc_s1[j] + delta_rps;
+            if (dPoc < 0 && use_delta_flag[ref.num_negative + j])
+            {
+                if (i >= kMaxDeltaPocs)
+                    return false;
+                rps.delta_poc_s0[i++] = dPoc;
+            }
+        }
+        if (delta_rps < 0 && use_delta_flag[num_delta_pocs])
+        {
+            if (i >= kMaxDeltaPocs)
+                return false;
+            rps.delta_poc_s0[i++] = delta_rps;
+        }
+        for (uint j = 0; j < ref.num_negative; ++j)
+        {
+            int dPoc = ref.delta_poc_s0[j] + delta_rps;
+            if (dPoc < 0 && use_delta_flag[j])
+            {
+                if (i >= kMaxDeltaPocs)
+                    return false;
+                rps.delta_poc_s0[i++] = dPoc;
+            }
+        }
+        rps.num_negative = i;
+
+        i = 0;
+        for (int j = (int)ref.num_negative - 1; j >= 0; --j)
+        {
+            int dPoc = ref.delta_poc_s0[j] + delta_rps;
+            if (dPoc > 0 && use_delta_flag[j])
+            {
+                if (i >= kMaxDeltaPocs)
+                    return false;
+                rps.delta_poc_s1[i++] = dPoc;
+            }
+        }
+        if (delta_rps > 0 && use_delta_flag[num_delta_pocs])
+        {
+            if (i >= kMaxDeltaPocs)
+                return false;
+            rps.delta_poc_s1[i++] = delta_rps;
+        }
+        for (uint j = 0; j < ref.num_positive; ++j)
+        {
+            int dPoc = ref.delta_poc_s1[j] + delta_rps;
+            if (dPoc > 0 && use_delta_flag[ref.num_negative + j])
+            {
+                if (i >= kMaxDeltaPocs)
+                    return false;
+                rps.delta_poc_s1[i++] = dPoc;
+            }
+        }
+        rps.num_positive = i;
+
+        return true;
+    }
+
+    rps.num_negative = get_ue_golomb_long(gb);
+    rps.num_positive = get_ue_golomb_long(gb);
+    if (rps.num_negative > kMaxDeltaPocs || rps.num_positive > kMaxDeltaPocs)
+        return false;
+
+    int poc = 0;
+    for (uint i = 0; i < rps.num_negative; ++i)
+    {
+        poc -= (int)get_ue_golomb_long(gb) + 1; // delta_poc_s0_minus1
+        rps.delta_poc_s0[i] = poc;
+        get_bits1(gb);                     // used_by_curr_pic_s0_flag
+    }
+
+    poc = 0;
+    for (uint i = 0; i < rps.num_positive; ++i)
+    {
+        poc += (int)get_ue_golomb_long(gb) + 1; // delta_poc_s1_minus1
+        rps.delta_poc_s1[i] = poc;
+        get_bits1(gb);                     // used_by_curr_pic_s1_flag
+    }
+
+    return true;
+}
+
+/*
+  7.3.2.2 Sequence parameter set RBSP syntax
+*/
+void HEVCParser::decode_SPS(GetBitContext *gb)
+{
+    seen_sps = true;
+
+    skip_bits(gb, 4);   // sps_video_parameter_set_id
+    uint max_sub_layers_minus1 = get_bits(gb, 3);
+    get_bits1(gb);      // sps_temporal_id_nesting_flag
+
+    if (max_sub_layers_minus1 > 6)
+        return;
+    profile_tier_level(gb, max_sub_layers_minus1);
+
+    get_ue_golomb_long(gb); // sps_seq_parameter_set_id
+
+    uint chroma_format_idc = get_ue_golomb_long(gb);
+    bool separate_colour_plane_flag = false;
+    if (chroma_format_idc == 3)
+        separate_colour_plane_flag = get_bits1(gb);
+
+    uint width  = get_ue_golomb_long(gb); // pic_width_in_luma_samples
+    uint height = get_ue_golomb_long(gb); // pic_height_in_luma_samples
+
+    if (get_bits1(gb)) // conformance_window_flag
+    {
+        // Table 6-1, the offsets are in chroma samples
+        uint ChromaArrayType = separate_colour_plane_flag ?
+            0 : chroma_format_idc;
+        uint SubWidthC  = (ChromaArrayType == 1 ||
+                           ChromaArrayType == 2) ? 2 : 1;
+        uint SubHeightC = (ChromaArrayType == 1) ? 2 : 1;
+
+        uint left   = get_ue_golomb_long(gb); // conf_win_left_offset
+        uint right  = get_ue_golomb_long(gb); // conf_win_right_offset
+        uint top    = get_ue_golomb_long(gb); // conf_win_top_offset
+        uint bottom = get_ue_golomb_long(gb); // conf_win_bottom_offset
+
+        if (SubWidthC * (left + right) < width &&
+            SubHeightC * (top + bottom) < height)
+        {
+            width  -= SubWidthC * (left + right);
+            height -= SubHeightC * (top + bottom);
+        }
+    }
+
+    pic_width  = width;
+    pic_height = height;
+
+    // Whatever follows comes from this SPS or nowhere
+    aspect_ratio_idc = 0;
+    sar_width = sar_height = 0;
+    unitsInTick = timeScale = 0;
+
+    get_ue_golomb_long(gb); // bit_depth_luma_minus8
+    get_ue_golomb_long(gb); // bit_depth_chroma_minus8
+    uint log2_max_pic_order_cnt_lsb = get_ue_golomb_long(gb) + 4;
+    if (log2_max_pic_order_cnt_lsb > 16)
+        return;
+
+    bool ordering_info_present = get_bits1(gb);
+    for (uint i = ordering_info_present ? 0 : max_sub_layers_minus1;
+         i <= max_sub_layers_minus1; ++i)
+    {
+        get_ue_golomb_long(gb); // sps_max_dec_pic_buffering_minus1
+        get_ue_golomb_long(gb); // sps_max_num_reorder_pics
+        get_ue_golomb_long(gb); // sps_max_latency_increase_plus1
+    }
+
+    get_ue_golomb_long(gb); // log2_min_luma_coding_block_size_minus3
+    get_ue_golomb_long(gb); // log2_diff_max_min_luma_coding_block_size
+    get_ue_golomb_long(gb); // log2_min_luma_transform_block_size_minus2
+    get_ue_golomb_long(gb); // log2_diff_max_min_luma_transform_block_size
+    get_ue_golomb_long(gb); // max_transform_hierarchy_depth_inter
+    get_ue_golomb_long(gb); // max_transform_hierarchy_depth_intra
+
+    if (get_bits1(gb)) // scaling_list_enabled_flag
+    {
+        if (get_bits1(gb)) // sps_scaling_list_data_present_flag
+            scaling_list_data(gb);
+    }
+
+    get_bits1(gb); // amp_enabled_flag
+    get_bits1(gb); // sample_adaptive_offset_enabled_flag
+
+    if (get_bits1(gb)) // pcm_enabled_flag
+    {
+        skip_bits(gb, 4);       // pcm_sample_bit_depth_luma_minus1
+        skip_bits(gb, 4);       // pcm_sample_bit_depth_chroma_minus1
+        get_ue_golomb_long(gb); // log2_min_pcm_luma_coding_block_size_minus3
+        get_ue_golomb_long(gb); // log2_diff_max_min_pcm_luma_coding_block_size
+        get_bits1(gb);          // pcm_loop_filter_disabled_flag
+    }
+
+    uint num_short_term_ref_pic_sets = get_ue_golomb_long(gb);
+    if (num_short_term_ref_pic_sets > kMaxShortTermRPS)
+        return;
+
+    ShortTermRPS sets[kMaxShortTermRPS];
+    for (uint i = 0; i < num_short_term_ref_pic_sets; ++i)
+    {
+        if (!short_term_ref_pic_set(gb, i, sets) || get_bits_left(gb) < 0)
+            return;
+    }
+
+    if (get_bits1(gb)) // long_term_ref_pics_present_flag
+    {
+        uint num_long_term_ref_pics_sps = get_ue_golomb_long(gb);
+        if (num_long_term_ref_pics_sps > 32)
+            return;
+        for (uint i = 0; i < num_long_term_ref_pics_sps; ++i)
+        {
+            skip_bits(gb, log2_max_pic_order_cnt_lsb); // lt_ref_pic_poc_lsb_sps
+            get_bits1(gb); // used_by_curr_pic_lt_sps_flag
+        }
+    }
+
+    get_bits1(gb); // sps_temporal_mvp_enabled_flag
+    get_bits1(gb); // strong_intra_smoothing_enabled_flag
+
+    if (get_bits1(gb)) // vui_parameters_present_flag
+        vui_parameters(gb);
+
+    if (get_bits_left(gb) < 0)
+    {
+        LOG(VB_RECORD, LOG_WARNING,
+            "HEVCParser::decode_SPS: SPS is shorter than its contents");
+        aspect_ratio_idc = 0;
+        unitsInTick = timeScale = 0;
+    }
+}
+
+/*
+  E.2.1 VUI parameters syntax, as far as the timing information
+*/
+void HEVCParser::vui_parameters(GetBitContext *gb)
+{
+    if (get_bits1(gb)) // aspect_ratio_info_present_flag
+    {
+        // Table E.1, the same as for H.264
+        aspect_ratio_idc = get_bits(gb, 8);
+        if (aspect_ratio_idc == EXTENDED_SAR)
+        {
+            sar_width  = get_bits(gb, 16);
+            sar_height = get_bits(gb, 16);
+        }
+    }
+
+    if (get_bits1(gb)) // overscan_info_present_flag
+        get_bits1(gb); // overscan_appropriate_flag
+
+    if (get_bits1(gb)) // video_signal_type_present_flag
+    {
+        get_bits(gb, 3);    // video_format
+        get_bits1(gb);      // video_full_range_flag
+        if (get_bits1(gb))  // colour_description_present_flag
+        {
+            get_bits(gb, 8); // colour_primaries
+            get_bits(gb, 8); // transfer_characteristics
+            get_bits(gb, 8); // matrix_coeffs
+        }
+    }
+
+    if (get_bits1(gb)) // chroma_loc_info_present_flag
+    {
+        get_ue_golomb_long(gb); // chroma_sample_loc_type_top_field
+        get_ue_golomb_long(gb); // chroma_sample_loc_type_bottom_field
+    }
+
+    get_bits1(gb); // neutral_chroma_indication_flag
+    get_bits1(gb); // field_seq_flag
+    get_bits1(gb); // frame_field_info_present_flag
+
+    if (get_bits1(gb)) // default_display_window_flag
+    {
+        get_ue_golomb_long(gb); // def_disp_win_left_offset
+        get_ue_golomb_long(gb); // def_disp_win_right_offset
+        get_ue_golomb_long(gb); // def_disp_win_top_offset
+        get_ue_golomb_long(gb); // def_disp_win_bottom_offset
+    }
+
+    if (get_bits1(gb)) // vui_timing_info_present_flag
+    {
+        unitsInTick = get_bits_long(gb, 32); // vui_num_units_in_tick
+        timeScale   = get_bits_long(gb, 32); // vui_time_scale
+    }
+}
+
+double HEVCParser::frameRate(void) const
+{
+    FrameRate result(0);
+    getFrameRate(result);
+    return result.isNonzero() ? result.toDouble() : 0.0;
+}
+
+/** \brief Frame rate from the SPS, or from the VPS if the SPS has none.
+ *
+ *  Unlike H.264, a tick is a whole picture here (E.3.1).
+ */
+void HEVCParser::getFrameRate(FrameRate &result) const
+{
+    if (unitsInTick && timeScale)
+        result = FrameRate(timeScale, unitsInTick);
+    else if (vpsUnitsInTick && vpsTimeScale)
+        result = FrameRate(vpsTimeScale, vpsUnitsInTick);
+    else
+        result = FrameRate(0);
+}
+
+uint HEVCParser::aspectRatio(void) const
+{
+    // Table E.1, sample aspect ratios for aspect_ratio_idc 1 to 16
+    static const uint sar[17][2] =
+    {
+        {  0,  1 }, {  1,  1 }, { 12, 11 }, { 10, 11 }, { 16, 11 },
+        { 40, 33 }, { 24, 11 }, { 20, 11 }, { 32, 11 }, { 80, 33 },
+        { 18, 11 }, { 15, 11 }, { 64, 33 }, {160, 99 }, {  4,  3 },
+        {  3,  2 }, {  2,  1 },
+    };
+
+    double aspect = 0.0;
+
+    if (pic_height)
+        aspect = pic_width / (double)pic_height;
+
+    if (aspect_ratio_idc == EXTENDED_SAR)
+    {
+        if (sar_height)
+            aspect *= sar_width / (double)sar_height;
+        else
+            aspect = 0.0;
+    }
+    else if (aspect_ratio_idc > 0 && aspect_ratio_idc <= 16)
+    {
+        aspect *= sar[aspect_ratio_idc][0] /
+                  (double)sar[aspect_ratio_idc][1];
+    }
+
+    if (aspect == 0.0)
+        return 0;
+    if (fabs(aspect - 1.3333333333333333) < eps)
+        return 2;
+    if (fabs(aspect - 1.7777777777777777) < eps)
+        return 3;
+    if (fabs(aspect - 2.21) < eps)
+        return 4;
+
+    return aspect * 1000000;
+}
@@ -0,0 +1,204 @@
+// -*- Mode: c++ -*-
+/*******************************************************************
+ * HEVCParser
+ *
+ * Distributed as part of MythTV (www.mythtv.org)
+ *
+ *      This program is free software; you can redistribute it and/or modify
+ *      it under the terms of the GNU General Public License as published by
+ *      the Free Software Foundation; either version 2 of the License, or
+ *      (at your option) any later version.
+ *
+ *      This program is distributed in the hope that it will be useful,
+ *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *      GNU General Public License for more details.
+ *
+ *      You should have received a copy of the GNU General Public License
+ *      along with this program; if not, write to the Free Software
+ *      Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ ********************************************************************/
+
+#ifndef HEVCPARSER_H
+#define HEVCPARSER_H
+
+#include <QString>
+#include <stdint.h>
+#include "mythconfig.h"
+#include "compat.h" // for uint on Darwin, MinGW
+
+// copied from libavutil/internal.h
+extern "C" {
+#include "libavutil/common.h" // for AV_GCC_VERSION_AT_LEAST()
+}
+#ifndef av_alias
+#if HAVE_ATTRIBUTE_MAY_ALIAS && (!defined(__ICC) || __ICC > 1110) && AV_GCC_VERSION_AT_LEAST(3,3)
+#   define av_alias __attribute__((may_alias))
+#else
+#   define av_alias
+#endif
+#endif
+
+extern "C" {
+#include "libavcodec/get_bits.h"
+}
+
+class FrameRate;
+
+/** \class HEVCParser
+ *  \brief Finds access units, keyframes and the picture format in an
+ *         ITU-T H.265 (HEVC) Annex B byte stream.
+ *
+ *  This is the H.265 counterpart of H264Parser and is used the same
+ *  way: bytes are fed to addBytes() until stateChanged() reports that
+ *  a new picture starts, at which point onFrameStart() and
+ *  onKeyFrameStart() tell what kind of picture it is and
+ *  frameAUstreamOffset() where its access unit started.
+ *
+ *  Every IRAP picture (IDR, CRA or BLA) is a keyframe. Only the base
+ *  layer is looked at and only the VPS and SPS are decoded, the slice
+ *  headers are only read as far as first_slice_segment_in_pic_flag.
+ */
+class HEVCParser {
+  public:
+
+    // ITU-T Rec. H.265 table 7-1
+    enum NAL_unit_type {
+        TRAIL_N        = 0,
+        TRAIL_R        = 1,
+        TSA_N          = 2,
+        TSA_R          = 3,
+        STSA_N         = 4,
+        STSA_R         = 5,
+        RADL_N         = 6,
+        RADL_R         = 7,
+        RASL_N         = 8,
+        RASL_R         = 9,
+        BLA_W_LP       = 16,
+        BLA_W_RADL     = 17,
+        BLA_N_LP       = 18,
+        IDR_W_RADL     = 19,
+        IDR_N_LP       = 20,
+        CRA_NUT        = 21,
+        RSV_IRAP_23    = 23,
+        RSV_VCL31      = 31,
+        VPS_NUT        = 32,
+        SPS_NUT        = 33,
+        PPS_NUT        = 34,
+        AUD_NUT        = 35,
+        EOS_NUT        = 36,
+        EOB_NUT        = 37,
+        FD_NUT         = 38,
+        PREFIX_SEI_NUT = 39,
+        SUFFIX_SEI_NUT = 40,
+        RSV_NVCL41     = 41,
+        RSV_NVCL44     = 44,
+        UNSPEC48       = 48,
+        UNSPEC55       = 55,
+        UNKNOWN        = 64
+    };
+
+    HEVCParser(void);
+    ~HEVCParser(void) { delete [] rbsp_buffer; }
+
+    uint32_t addBytes(const uint8_t  *bytes,
+                      const uint32_t  byte_count,
+                      const uint64_t  stream_offset);
+    void Reset(void);
+
+    QString NAL_type_str(uint8_t type);
+
+    bool stateChanged(void) const { return state_changed; }
+
+    uint8_t lastNALtype(void) const { return nal_unit_type; }
+
+    bool onFrameStart(void) const { return on_frame; }
+    bool onKeyFrameStart(void) const { return on_key_frame; }
+
+    /// Picture size with the conformance window applied
+    uint pictureWidth(void) const { return pic_width; }
+    uint pictureHeight(void) const { return pic_height; }
+
+    /** \brief Computes aspect ratio from picture size and sample aspect ratio
+     */
+    uint aspectRatio(void) const;
+    double frameRate(void) const;
+    void getFrameRate(FrameRate &result) const;
+
+    uint64_t frameAUstreamOffset(void) const {return frame_start_offset;}
+    uint64_t keyframeAUstreamOffset(void) const {return keyframe_start_offset;}
+    uint64_t SPSstreamOffset(void) const {return SPS_offset;}
+
+    /// IDR, CRA and BLA pictures, decoding can start at any of them
+    static bool NALisIRAP(uint8_t nal_type)
+        {
+            return (nal_type >= BLA_W_LP && nal_type <= RSV_IRAP_23);
+        }
+
+    static bool NALisVCL(uint8_t nal_type)
+        {
+            return (nal_type <= RSV_VCL31);
+        }
+
+    uint32_t GetTimeScale(void) const { return timeScale; }
+
+    uint32_t GetUnitsInTick(void) const { return unitsInTick; }
+
+    void reset_SPS(void) { seen_sps = false; }
+    bool seen_SPS(void) const { return seen_sps; }
+
+    bool found_AU(void) const { return AU_pending; }
+
+  private:
+    Q_DISABLE_COPY(HEVCParser)
+
+    enum constants {EXTENDED_SAR = 255};
+
+    inline void set_AU_pending(void)
+        {
+            if (!AU_pending)
+            {
+                AU_pending = true;
+                AU_offset = pkt_offset;
+            }
+        }
+
+    void resetRBSP(void);
+    bool fillRBSP(const uint8_t *byteP, uint32_t byte_count,
+                  bool found_start_code);
+    void processRBSP(bool rbsp_complete);
+    void decode_VPS(GetBitContext *gb);
+    void decode_SPS(GetBitContext *gb);
+    void profile_tier_level(GetBitContext *gb, uint max_sub_layers_minus1);
+    struct ShortTermRPS;
+    bool short_term_ref_pic_set(GetBitContext *gb, uint idx,
+                                ShortTermRPS *sets);
+    void vui_parameters(GetBitContext *gb);
+
+    bool       AU_pending;
+    bool       state_changed;
+    bool       seen_sps;
+
+    uint32_t   sync_accumulator;
+    uint8_t   *rbsp_buffer;
+    uint32_t   rbsp_buffer_size;
+    uint32_t   rbsp_index;
+    uint32_t   consecutive_zeros;
+    bool       have_unfinished_NAL;
+
+    uint8_t    nal_unit_type;
+    uint8_t    nal_header;
+
+    uint       pic_width, pic_height;
+    uint8_t    aspect_ratio_idc;
+    uint       sar_width, sar_height;
+    uint32_t   unitsInTick, timeScale;
+    uint32_t   vpsUnitsInTick, vpsTimeScale;
+
+    uint64_t   pkt_offset, AU_offset, frame_start_offset, keyframe_start_offset;
+    uint64_t   SPS_offset;
+    bool       on_frame, on_key_frame;
+};
+
+#endif /* HEVCPARSER_H */
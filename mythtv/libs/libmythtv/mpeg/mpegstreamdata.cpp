@@ -22,6 +22,9 @@ using namespace std;
 //#define DEBUG_MPEG_RADIO // uncomment to strip video streams from TS stream
 #define LOC QString("MPEGStream[%1](0x%2): ").arg(_cardid).arg((intptr_t)this, QT_POINTER_SIZE, 16)
 
+/// Number of packets validated at once before being dispatched in spans
+static const uint kTSBlockPackets = 128;
+
 void init_sections(sections_t &sect, uint last_section)
 {
     static const unsigned char init_bits[8] =
@@ -87,6 +90,7 @@ MPEGStreamData::MPEGStreamData(int desiredProgram, int cardnum,
       _invalid_pat_seen(false), _invalid_pat_warning(false)
 {
     memset(_si_time_offsets, 0, sizeof(_si_time_offsets));
+    memset(_pid_roles, kPIDRoleNone, sizeof(_pid_roles));
 
     AddListeningPID(MPEG_PAT_PID);
     AddListeningPID(MPEG_CAT_PID);
@@ -189,10 +193,10 @@ void MPEGStreamData::Reset(int desiredProgram)
         DeletePartialPSIP(it.key());
     _partial_psip_packet_cache.clear();
 
-    _pids_listening.clear();
-    _pids_notlistening.clear();
-    _pids_writing.clear();
-    _pids_audio.clear();
+    ClearPIDs(_pids_listening,    kPIDRoleListening);
+    ClearPIDs(_pids_notlistening, kPIDRoleNotListening);
+    ClearPIDs(_pids_writing,      kPIDRoleWriting);
+    ClearPIDs(_pids_audio,        kPIDRoleAudio);
 
     _pid_video_single_program = _pid_pmt_single_program = 0xffffffff;
 
@@ -643,11 +647,11 @@ bool MPEGStreamData::CreatePMTSingleProgram(const ProgramMapTable &pmt)
             AddListeningPID(cad.PID());
     }
 
-    _pids_audio.clear();
+    ClearPIDs(_pids_audio, kPIDRoleAudio);
     for (uint i = 0; i < audioPIDs.size(); i++)
         AddAudioPID(audioPIDs[i]);
 
-    _pids_writing.clear();
+    ClearPIDs(_pids_writing, kPIDRoleWriting);
     _pid_video_single_program = !videoPIDs.empty() ? videoPIDs[0] : 0xffffffff;
     for (uint i = 1; i < videoPIDs.size(); i++)
         AddWritingPID(videoPIDs[i]);
@@ -1018,8 +1022,26 @@ int MPEGStreamData::ProcessData(const unsigned char *buffer, int len)
         return 0;
     }
 
+    uint slow = 0; // packets to handle one at a time before trying spans
+
     while (pos + int(TSPacket::kSize) <= len)
     { // while we have a whole packet left...
+        if (!slow && !resync)
+        {
+            uint count = min(uint(len - pos) / TSPacket::kSize,
+                             kTSBlockPackets);
+            if (IsCleanTSBlock(&buffer[pos], count))
+            {
+                ProcessTSPacketSpans(
+                    reinterpret_cast<const TSPacket*>(&buffer[pos]), count);
+                pos += count * TSPacket::kSize;
+                continue;
+            }
+            slow = count;
+        }
+        if (slow)
+            slow--;
+
         if (buffer[pos] != SYNC_BYTE || resync)
         {
             int newpos = ResyncStream(buffer, pos+1, len);
@@ -1058,7 +1080,12 @@ bool MPEGStreamData::ProcessTSPacket(const TSPacket& tspacket)
 {
     bool ok = !tspacket.TransportError();
 
-    if (IsEncryptionTestPID(tspacket.PID()))
+    // One table lookup replaces the per packet PID map searches,
+    // PID() is a 13 bit value so it is always within the table.
+    const uint pid   = tspacket.PID();
+    const uint roles = _pid_roles[pid];
+
+    if (roles & kPIDRoleEncTest)
     {
         ProcessEncryptedPacket(tspacket);
     }
@@ -1069,7 +1096,7 @@ bool MPEGStreamData::ProcessTSPacket(const TSPacket& tspacket)
     if (tspacket.Scrambled())
         return true;
 
-    if (IsVideoPID(tspacket.PID()))
+    if (IsVideoPID(pid))
     {
         for (uint j = 0; j < _ts_av_listeners.size(); j++)
             _ts_av_listeners[j]->ProcessVideoTSPacket(tspacket);
@@ -1077,7 +1104,7 @@ bool MPEGStreamData::ProcessTSPacket(const TSPacket& tspacket)
         return true;
     }
 
-    if (IsAudioPID(tspacket.PID()))
+    if (roles & kPIDRoleAudio)
     {
         for (uint j = 0; j < _ts_av_listeners.size(); j++)
             _ts_av_listeners[j]->ProcessAudioTSPacket(tspacket);
@@ -1085,13 +1112,15 @@ bool MPEGStreamData::ProcessTSPacket(const TSPacket& tspacket)
         return true;
     }
 
-    if (IsWritingPID(tspacket.PID()))
+    if (roles & kPIDRoleWriting)
     {
         for (uint j = 0; j < _ts_writing_listeners.size(); j++)
             _ts_writing_listeners[j]->ProcessTSPacket(tspacket);
     }
 
-    if (IsListeningPID(tspacket.PID()) && tspacket.HasPayload())
+    if (!_listening_disabled &&
+        ((roles & (kPIDRoleListening | kPIDRoleNotListening)) ==
+         kPIDRoleListening) && tspacket.HasPayload())
     {
         HandleTSTables(&tspacket);
     }
@@ -1099,6 +1128,81 @@ bool MPEGStreamData::ProcessTSPacket(const TSPacket& tspacket)
     return true;
 }
 
+/** \fn MPEGStreamData::ProcessTSPacketSpans(const TSPacket*,uint)
+ *  \brief Dispatches runs of consecutive packets sharing a PID.
+ *
+ *   The caller must already have verified that every packet is in
+ *   sync and has neither the transport error nor the scrambling bits
+ *   set, see IsCleanTSBlock(). The PID roles are looked up once per run
+ *   and each listener gets the whole run in one ProcessTSPackets(),
+ *   ProcessVideoTSPackets() or ProcessAudioTSPackets() call. Packet order
+ *   is preserved, so listeners that only implement the per packet calls
+ *   see exactly the same stream as with ProcessTSPacket().
+ *
+ *   Handling tables or the encryption test can change the PID roles,
+ *   so those packets still go through ProcessTSPacket() one by one.
+ */
+void MPEGStreamData::ProcessTSPacketSpans(const TSPacket *tspackets,
+                                          uint count)
+{
+    uint i = 0;
+    while (i < count)
+    {
+        const uint pid   = tspackets[i].PID();
+        const uint roles = _pid_roles[pid];
+        const bool video = IsVideoPID(pid);
+
+        if ((roles & kPIDRoleEncTest) ||
+            (!video && !(roles & kPIDRoleAudio) &&
+             (roles & kPIDRoleListening)))
+        {
+            ProcessTSPacket(tspackets[i++]);
+            continue;
+        }
+
+        uint end = i + 1;
+        while (end < count && tspackets[end].PID() == pid)
+            end++;
+
+        const TSPacket *span = &tspackets[i];
+        const uint span_cnt = end - i;
+
+        if (video)
+        {
+            for (uint j = 0; j < _ts_av_listeners.size(); j++)
+                _ts_av_listeners[j]->ProcessVideoTSPackets(span, span_cnt);
+        }
+        else if (roles & kPIDRoleAudio)
+        {
+            for (uint j = 0; j < _ts_av_listeners.size(); j++)
+                _ts_av_listeners[j]->ProcessAudioTSPackets(span, span_cnt);
+        }
+        else if (roles & kPIDRoleWriting)
+        {
+            for (uint j = 0; j < _ts_writing_listeners.size(); j++)
+                _ts_writing_listeners[j]->ProcessTSPackets(span, span_cnt);
+        }
+
+        i = end;
+    }
+}
+
+/** \fn MPEGStreamData::IsCleanTSBlock(const unsigned char*,uint)
+ *  \brief Returns true if every packet in the buffer starts with a sync
+ *         byte and has neither the transport error nor the scrambling
+ *         bit set.
+ *
+ *   The checks are accumulated without branches so that the compiler
+ *   can unroll and vectorize the loop over the whole read.
+ */
+bool MPEGStreamData::IsCleanTSBlock(const unsigned char *buffer, uint count)
+{
+    uint bad = 0;
+    for (uint i = 0; i < count; i++, buffer += TSPacket::kSize)
+        bad |= (buffer[0] ^ SYNC_BYTE) | (buffer[1] & 0x80) | (buffer[3] & 0x80);
+    return !bad;
+}
+
 int MPEGStreamData::ResyncStream(const unsigned char *buffer, int curr_pos,
                                  int len)
 {
@@ -1121,28 +1225,38 @@ int MPEGStreamData::ResyncStream(const unsigned char *buffer, int curr_pos,
 
 bool MPEGStreamData::IsListeningPID(uint pid) const
 {
-    if (_listening_disabled || IsNotListeningPID(pid))
+    if (_listening_disabled)
         return false;
-    pid_map_t::const_iterator it = _pids_listening.find(pid);
-    return it != _pids_listening.end();
+    uint roles = GetPIDRoles(pid);
+    return (roles & (kPIDRoleListening | kPIDRoleNotListening)) ==
+        kPIDRoleListening;
 }
 
 bool MPEGStreamData::IsNotListeningPID(uint pid) const
 {
-    pid_map_t::const_iterator it = _pids_notlistening.find(pid);
-    return it != _pids_notlistening.end();
+    return GetPIDRoles(pid) & kPIDRoleNotListening;
 }
 
 bool MPEGStreamData::IsWritingPID(uint pid) const
 {
-    pid_map_t::const_iterator it = _pids_writing.find(pid);
-    return it != _pids_writing.end();
+    return GetPIDRoles(pid) & kPIDRoleWriting;
 }
 
 bool MPEGStreamData::IsAudioPID(uint pid) const
 {
-    pid_map_t::const_iterator it = _pids_audio.find(pid);
-    return it != _pids_audio.end();
+    return GetPIDRoles(pid) & kPIDRoleAudio;
+}
+
+/** \fn MPEGStreamData::ClearPIDs(pid_map_t&,uint)
+ *  \brief Empties one of the PID maps, clearing the matching role bit
+ *         in the PID classification table as well.
+ */
+void MPEGStreamData::ClearPIDs(pid_map_t &pids, uint role)
+{
+    pid_map_t::const_iterator it = pids.begin();
+    for (; it != pids.end(); ++it)
+        SetPIDRole(it.key(), role, false);
+    pids.clear();
 }
 
 uint MPEGStreamData::GetPIDs(pid_map_t &pids) const
@@ -1864,6 +1978,7 @@ void MPEGStreamData::AddEncryptionTestPID(uint pnum, uint pid, bool isvideo)
     AddListeningPID(pid);
 
     _encryption_pid_to_info[pid] = CryptInfo((isvideo) ? 10000 : 500, 8);
+    SetPIDRole(pid, kPIDRoleEncTest, true);
 
     _encryption_pid_to_pnums[pid].push_back(pnum);
     _encryption_pnum_to_pids[pnum].push_back(pid);
@@ -1907,6 +2022,7 @@ void MPEGStreamData::RemoveEncryptionTestPIDs(uint pnum)
             {
                 _encryption_pid_to_pnums.remove(pid);
                 _encryption_pid_to_info.remove(pid);
+                SetPIDRole(pid, kPIDRoleEncTest, false);
             }
         }
     }
@@ -1916,12 +2032,7 @@ void MPEGStreamData::RemoveEncryptionTestPIDs(uint pnum)
 
 bool MPEGStreamData::IsEncryptionTestPID(uint pid) const
 {
-    QMutexLocker locker(&_encryption_lock);
-
-    QMap<uint, CryptInfo>::const_iterator it =
-        _encryption_pid_to_info.find(pid);
-
-    return it != _encryption_pid_to_info.end();
+    return GetPIDRoles(pid) & kPIDRoleEncTest;
 }
 
 void MPEGStreamData::TestDecryption(const ProgramMapTable *pmt)
@@ -1954,6 +2065,10 @@ void MPEGStreamData::ResetDecryptionMonitoringState(void)
 {
     QMutexLocker locker(&_encryption_lock);
 
+    QMap<uint, CryptInfo>::const_iterator it = _encryption_pid_to_info.begin();
+    for (; it != _encryption_pid_to_info.end(); ++it)
+        SetPIDRole(it.key(), kPIDRoleEncTest, false);
+
     _encryption_pid_to_info.clear();
     _encryption_pid_to_pnums.clear();
     _encryption_pnum_to_pids.clear();
@@ -1989,7 +2104,10 @@ void MPEGStreamData::ProcessEncryptedPacket(const TSPacket& tspacket)
     QMutexLocker locker(&_encryption_lock);
 
     const uint pid = tspacket.PID();
-    CryptInfo &info = _encryption_pid_to_info[pid];
+    QMap<uint, CryptInfo>::iterator iit = _encryption_pid_to_info.find(pid);
+    if (iit == _encryption_pid_to_info.end())
+        return; // test PID was removed after the role table was read
+    CryptInfo &info = *iit;
 
     CryptStatus status = kEncUnknown;
 
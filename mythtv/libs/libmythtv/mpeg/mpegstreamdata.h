@@ -92,6 +92,17 @@ typedef enum
 } PIDPriority;
 typedef QMap<uint, PIDPriority> pid_map_t;
 
+/// Role bits for each entry of the flat PID classification table
+typedef enum
+{
+    kPIDRoleNone         = 0x00,
+    kPIDRoleListening    = 0x01,
+    kPIDRoleNotListening = 0x02,
+    kPIDRoleWriting      = 0x04,
+    kPIDRoleAudio        = 0x08,
+    kPIDRoleEncTest      = 0x10,
+} PIDRole;
+
 class MTV_PUBLIC MPEGStreamData : public EITSource
 {
   public:
@@ -124,26 +135,54 @@ class MTV_PUBLIC MPEGStreamData : public EITSource
     virtual void HandleTSTables(const TSPacket* tspacket);
     virtual bool ProcessTSPacket(const TSPacket& tspacket);
     virtual int  ProcessData(const unsigned char *buffer, int len);
+    void ProcessTSPacketSpans(const TSPacket *tspackets, uint count);
     inline  void HandleAdaptationFieldControl(const TSPacket* tspacket);
 
     // Listening
     virtual void AddListeningPID(
         uint pid, PIDPriority priority = kPIDPriorityNormal)
-        { _pids_listening[pid] = priority; }
+    {
+        _pids_listening[pid] = priority;
+        SetPIDRole(pid, kPIDRoleListening, true);
+    }
     virtual void AddNotListeningPID(uint pid)
-        { _pids_notlistening[pid] = kPIDPriorityNormal; }
+    {
+        _pids_notlistening[pid] = kPIDPriorityNormal;
+        SetPIDRole(pid, kPIDRoleNotListening, true);
+    }
     virtual void AddWritingPID(
         uint pid, PIDPriority priority = kPIDPriorityHigh)
-        { _pids_writing[pid] = priority; }
+    {
+        _pids_writing[pid] = priority;
+        SetPIDRole(pid, kPIDRoleWriting, true);
+    }
     virtual void AddAudioPID(
         uint pid, PIDPriority priority = kPIDPriorityHigh)
-        { _pids_audio[pid] = priority; }
+    {
+        _pids_audio[pid] = priority;
+        SetPIDRole(pid, kPIDRoleAudio, true);
+    }
 
-    virtual void RemoveListeningPID(uint pid) { _pids_listening.remove(pid);  }
+    virtual void RemoveListeningPID(uint pid)
+    {
+        _pids_listening.remove(pid);
+        SetPIDRole(pid, kPIDRoleListening, false);
+    }
     virtual void RemoveNotListeningPID(uint pid)
-        { _pids_notlistening.remove(pid); }
-    virtual void RemoveWritingPID(uint pid) { _pids_writing.remove(pid);    }
-    virtual void RemoveAudioPID(uint pid)   { _pids_audio.remove(pid);      }
+    {
+        _pids_notlistening.remove(pid);
+        SetPIDRole(pid, kPIDRoleNotListening, false);
+    }
+    virtual void RemoveWritingPID(uint pid)
+    {
+        _pids_writing.remove(pid);
+        SetPIDRole(pid, kPIDRoleWriting, false);
+    }
+    virtual void RemoveAudioPID(uint pid)
+    {
+        _pids_audio.remove(pid);
+        SetPIDRole(pid, kPIDRoleAudio, false);
+    }
 
     virtual bool IsListeningPID(uint pid) const;
     virtual bool IsNotListeningPID(uint pid) const;
@@ -161,6 +200,10 @@ class MTV_PUBLIC MPEGStreamData : public EITSource
 
     uint GetPIDs(pid_map_t&) const;
 
+    /// \brief Returns the PIDRole bits set for this PID
+    uint GetPIDRoles(uint pid) const
+        { return (pid < kPIDTableSize) ? _pid_roles[pid] : kPIDRoleNone; }
+
     // PID Priorities
     PIDPriority GetPIDPriority(uint pid) const;
 
@@ -346,7 +389,20 @@ class MTV_PUBLIC MPEGStreamData : public EITSource
     void ProcessPMT(const ProgramMapTable *pmt);
     void ProcessEncryptedPacket(const TSPacket&);
 
+    // PID classification table
+    void SetPIDRole(uint pid, uint role, bool on)
+    {
+        if (pid >= kPIDTableSize)
+            return;
+        if (on)
+            _pid_roles[pid] |= role;
+        else
+            _pid_roles[pid] &= ~role;
+    }
+    void ClearPIDs(pid_map_t &pids, uint role);
+
     static int ResyncStream(const unsigned char *buffer, int curr_pos, int len);
+    static bool IsCleanTSBlock(const unsigned char *buffer, uint count);
 
     void UpdateTimeOffset(uint64_t si_utc_time);
 
@@ -379,6 +435,11 @@ class MTV_PUBLIC MPEGStreamData : public EITSource
     pid_map_t                 _pids_audio;
     bool                      _listening_disabled;
 
+    /// Flat copy of the PID maps above and of the encryption test PIDs,
+    /// so that the per packet code path needs no map lookups or locking.
+    static const uint         kPIDTableSize = 0x2000;
+    unsigned char             _pid_roles[kPIDTableSize];
+
     // Encryption monitoring
     mutable QMutex            _encryption_lock;
     QMap<uint, CryptInfo>     _encryption_pid_to_info;
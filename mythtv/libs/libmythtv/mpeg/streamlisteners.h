@@ -64,6 +64,16 @@ class TSPacketListener
   public:
     virtual bool ProcessTSPacket(const TSPacket& tspacket) = 0;
 
+    /// Called with a run of consecutive packets that share one PID,
+    /// by default they are handed to ProcessTSPacket() one at a time.
+    virtual bool ProcessTSPackets(const TSPacket *tspackets, uint count)
+    {
+        bool ok = true;
+        for (uint i = 0; i < count; i++)
+            ok = ProcessTSPacket(tspackets[i]) && ok;
+        return ok;
+    }
+
   protected:
     virtual ~TSPacketListener() { }
 };
@@ -74,6 +84,24 @@ class TSPacketListenerAV
     virtual bool ProcessVideoTSPacket(const TSPacket& tspacket) = 0;
     virtual bool ProcessAudioTSPacket(const TSPacket& tspacket) = 0;
 
+    /// Called with a run of consecutive video packets that share one PID
+    virtual bool ProcessVideoTSPackets(const TSPacket *tspackets, uint count)
+    {
+        bool ok = true;
+        for (uint i = 0; i < count; i++)
+            ok = ProcessVideoTSPacket(tspackets[i]) && ok;
+        return ok;
+    }
+
+    /// Called with a run of consecutive audio packets that share one PID
+    virtual bool ProcessAudioTSPackets(const TSPacket *tspackets, uint count)
+    {
+        bool ok = true;
+        for (uint i = 0; i < count; i++)
+            ok = ProcessAudioTSPacket(tspackets[i]) && ok;
+        return ok;
+    }
+
   protected:
     virtual ~TSPacketListenerAV() { }
 };
@@ -397,6 +397,143 @@ void framecopy(VideoFrame* dst, const VideoFrame* src, bool useSSE)
     }
 }
 
+static uint8_t c_lumarowstats(const uint8_t *src, int count, int step,
+                              uint8_t *colmax, LumaStats *stats)
+{
+    int lo = stats->min;
+    int64_t sum = 0;
+    uint8_t hi = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        uint8_t pixel = src[i * step];
+
+        sum += pixel;
+        if (pixel < lo)
+            lo = pixel;
+        if (pixel > hi)
+            hi = pixel;
+        if (pixel > colmax[i])
+            colmax[i] = pixel;
+    }
+
+    stats->min    = lo;
+    stats->max    = __MAX(stats->max, (int)hi);
+    stats->sum   += sum;
+    stats->count += count;
+    return hi;
+}
+
+#if ARCH_X86
+/**
+ * \fn SSE_lumarowstats
+ * Packs the samples 16 at a time (strided samples are gathered first)
+ * and folds them into running min/max/sum registers. Column maxima are
+ * updated in place with pmaxub. All of these are order independent so
+ * the result is identical to c_lumarowstats.
+ */
+static uint8_t SSE_lumarowstats(const uint8_t *src, int count, int step,
+                                uint8_t *colmax, LumaStats *stats)
+{
+    const int kChunk = 256;
+    uint8_t packed[kChunk];
+    uint8_t vmin[16], vmax[16];
+    uint64_t vsum[2] = { 0, 0 };
+    int blocks = count / 16;
+
+    memset(vmin, 0xff, sizeof(vmin));
+    memset(vmax, 0, sizeof(vmax));
+
+    for (int done = 0; done < blocks * 16; done += kChunk)
+    {
+        int n = __MIN(kChunk, blocks * 16 - done);
+        const uint8_t *p = src + done * step;
+
+        if (step != 1)
+        {
+            for (int i = 0; i < n; i++)
+                packed[i] = p[i * step];
+            p = packed;
+        }
+
+        uint8_t *c = colmax + done;
+        int nblocks = n / 16;
+
+        // The accumulators are memory operands so only three general
+        // registers are needed, i386 PIC builds can't spare many more.
+        asm volatile (
+            "pxor       %%xmm7, %%xmm7      \n"
+            "movdqu     %[min], %%xmm5      \n"
+            "movdqu     %[max], %%xmm6      \n"
+            "movdqu     %[sum], %%xmm4      \n"
+            "1:                             \n"
+            "movdqu     (%[src]), %%xmm0    \n"
+            "movdqu     (%[col]), %%xmm1    \n"
+            "pminub     %%xmm0, %%xmm5      \n"
+            "pmaxub     %%xmm0, %%xmm6      \n"
+            "pmaxub     %%xmm0, %%xmm1      \n"
+            "movdqu     %%xmm1, (%[col])    \n"
+            "psadbw     %%xmm7, %%xmm0      \n"
+            "paddq      %%xmm0, %%xmm4      \n"
+            "add        $16, %[src]         \n"
+            "add        $16, %[col]         \n"
+            "sub        $1, %[n]            \n"
+            "jnz        1b                  \n"
+            "movdqu     %%xmm5, %[min]      \n"
+            "movdqu     %%xmm6, %[max]      \n"
+            "movdqu     %%xmm4, %[sum]      \n"
+            : [src]"+r"(p), [col]"+r"(c), [n]"+r"(nblocks),
+              [min]"+m"(vmin), [max]"+m"(vmax), [sum]"+m"(vsum)
+            :
+            : "memory", "cc", "xmm0", "xmm1", "xmm4", "xmm5", "xmm6", "xmm7");
+    }
+
+    int lo = stats->min;
+    uint8_t hi = 0;
+    for (int i = 0; i < 16 && blocks; i++)
+    {
+        lo = __MIN(lo, (int)vmin[i]);
+        hi = __MAX(hi, vmax[i]);
+    }
+    stats->min    = lo;
+    stats->max    = __MAX(stats->max, (int)hi);
+    stats->sum   += vsum[0] + vsum[1];
+    stats->count += blocks * 16;
+
+    if (blocks * 16 < count)
+    {
+        uint8_t tail = c_lumarowstats(src + blocks * 16 * step,
+                                      count - blocks * 16, step,
+                                      colmax + blocks * 16, stats);
+        hi = __MAX(hi, tail);
+    }
+
+    return hi;
+}
+#endif
+
+/**
+ * \fn lumarowstats
+ * Accumulates the luma statistics of \p count samples taken every
+ * \p step bytes from \p src into \p stats, and raises \p colmax[i] to
+ * the value of sample i.
+ * \return largest sample of this row, 0 if \p count is 0
+ */
+uint8_t lumarowstats(const uint8_t *src, int count, int step,
+                     uint8_t *colmax, LumaStats *stats, bool useSSE)
+{
+    if (count <= 0)
+        return 0;
+
+#if ARCH_X86
+    if (useSSE && sse2_check())
+        return SSE_lumarowstats(src, count, step, colmax, stats);
+#else
+    Q_UNUSED(useSSE);
+#endif
+    return c_lumarowstats(src, count, step, colmax, stats);
+}
+
 /***************************************
  * USWC Fast Copy
  *
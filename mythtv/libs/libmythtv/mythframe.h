@@ -90,6 +90,29 @@ private:
 void MTV_PUBLIC framecopy(VideoFrame *dst, const VideoFrame *src,
                           bool useSSE = true);
 
+/**
+ * \brief Running luma statistics of sampled pixels, see lumarowstats().
+ */
+typedef struct LumaStats_
+{
+    int     min;   ///< smallest sample seen, 255 if none
+    int     max;   ///< largest sample seen, 0 if none
+    int64_t sum;   ///< sum of all samples
+    int     count; ///< number of samples
+} LumaStats;
+
+static inline void lumastatsinit(LumaStats *stats)
+{
+    stats->min   = 255;
+    stats->max   = 0;
+    stats->sum   = 0;
+    stats->count = 0;
+}
+
+uint8_t MTV_PUBLIC lumarowstats(const uint8_t *src, int count, int step,
+                                uint8_t *colmax, LumaStats *stats,
+                                bool useSSE = true);
+
 static inline void init(VideoFrame *vf, VideoFrameType _codec,
                         unsigned char *_buf, int _width, int _height, int _size,
                         const int *p = 0,
@@ -0,0 +1,239 @@
+// C++ headers
+#include <algorithm>
+using namespace std;
+
+// Qt headers
+#include <QDateTime>
+#include <QFileInfo>
+#include <QRunnable>
+#include <QRegExp>
+#include <QMutex>
+#include <QFile>
+#include <QHash>
+#include <QList>
+#include <QDir>
+
+// MythTV headers
+#include "previewcache.h"
+#include "mthreadpool.h"
+#include "mythlogging.h"
+
+#define LOC QString("PreviewCache: ")
+
+static QMutex                 s_cacheLock;
+/// Least recently used first
+static QList<QString>         s_cacheOrder;
+static QHash<QString, qint64> s_cacheSizes;
+static qint64                 s_cacheTotal = 0;
+static qint64                 s_cacheLimit = 0; ///< 0 keeps every preview
+
+/// Runs PreviewCache::Scan() so the backend doesn't wait on the disks
+class PreviewCacheScanner : public QRunnable
+{
+  public:
+    explicit PreviewCacheScanner(const QStringList &dirs) : m_dirs(dirs) {}
+
+    void run(void)
+    {
+        PreviewCache::Scan(m_dirs);
+    }
+
+  private:
+    QStringList m_dirs;
+};
+
+static bool lessRecentlyUsed(const QFileInfo &a, const QFileInfo &b)
+{
+    return max(a.lastRead(), a.lastModified()) <
+           max(b.lastRead(), b.lastModified());
+}
+
+/// Sets how many bytes of previews are kept before old ones are deleted,
+/// 0 keeps them all
+void PreviewCache::SetMaxSize(qint64 bytes)
+{
+    QStringList expired;
+    {
+        QMutexLocker locker(&s_cacheLock);
+        s_cacheLimit = bytes;
+        expired = Expire();
+    }
+    Remove(expired);
+}
+
+/** \brief Adds the previews in the given directories to the cache.
+ *
+ *   They are taken to be older than anything registered since startup
+ *   and ordered among themselves by when they were last read or written.
+ */
+void PreviewCache::Scan(const QStringList &dirs)
+{
+    QList<QFileInfo> found;
+    foreach (const QString &dirname, dirs)
+    {
+        QDir dir(dirname);
+        QFileInfoList files = dir.entryInfoList(QDir::Files);
+        foreach (const QFileInfo &fi, files)
+        {
+            if (IsPreviewFile(fi.fileName()) &&
+                !IsDefaultPreview(fi.fileName()))
+            {
+                found.push_back(fi);
+            }
+        }
+    }
+    sort(found.begin(), found.end(), lessRecentlyUsed);
+
+    QStringList expired;
+    {
+        QMutexLocker locker(&s_cacheLock);
+
+        // Walk newest first, each one goes in front of the ones after it
+        for (int i = found.size() - 1; i >= 0; --i)
+        {
+            QString filename = found[i].absoluteFilePath();
+            if (s_cacheSizes.contains(filename))
+                continue;
+            s_cacheOrder.push_front(filename);
+            s_cacheSizes[filename] = found[i].size();
+            s_cacheTotal += found[i].size();
+        }
+
+        expired = Expire();
+    }
+    Remove(expired);
+
+    LOG(VB_FILE, LOG_INFO, LOC + QString("Found %1 previews in %2 directories")
+            .arg(found.size()).arg(dirs.size()));
+}
+
+/// Runs Scan() in the background
+void PreviewCache::StartScan(const QStringList &dirs)
+{
+    MThreadPool::globalInstance()->start(
+        new PreviewCacheScanner(dirs), "PreviewCacheScan");
+}
+
+/// Registers a newly written preview, or one that was written again
+void PreviewCache::Insert(const QString &filename)
+{
+    QFileInfo fi(filename);
+    if (!fi.exists() || IsDefaultPreview(fi.fileName()))
+        return;
+
+    QString path = fi.absoluteFilePath();
+    QStringList expired;
+    {
+        QMutexLocker locker(&s_cacheLock);
+
+        if (s_cacheSizes.contains(path))
+        {
+            s_cacheOrder.removeOne(path);
+            s_cacheTotal -= s_cacheSizes[path];
+        }
+
+        s_cacheOrder.push_back(path);
+        s_cacheSizes[path] = fi.size();
+        s_cacheTotal += fi.size();
+
+        expired = Expire();
+    }
+    Remove(expired);
+}
+
+/// Marks a preview as used so it is the last to be expired
+void PreviewCache::Touch(const QString &filename)
+{
+    QString path = QFileInfo(filename).absoluteFilePath();
+
+    QMutexLocker locker(&s_cacheLock);
+
+    if (s_cacheOrder.removeOne(path))
+        s_cacheOrder.push_back(path);
+}
+
+/// Forgets every preview without deleting it
+void PreviewCache::Clear(void)
+{
+    QMutexLocker locker(&s_cacheLock);
+
+    s_cacheOrder.clear();
+    s_cacheSizes.clear();
+    s_cacheTotal = 0;
+}
+
+/// Returns the previews in the cache, least recently used first
+QStringList PreviewCache::GetFiles(void)
+{
+    QMutexLocker locker(&s_cacheLock);
+    return QStringList(s_cacheOrder);
+}
+
+/// Returns the size of the previews in the cache in bytes
+qint64 PreviewCache::GetSize(void)
+{
+    QMutexLocker locker(&s_cacheLock);
+    return s_cacheTotal;
+}
+
+/** \brief Returns true for the names previews are written under, the
+ *         recording's basename followed by an optional time offset and
+ *         size, and then the image format.
+ */
+bool PreviewCache::IsPreviewFile(const QString &filename)
+{
+    static const QRegExp kPreviewName(
+        "^\\d+_\\d{14}\\.\\w+(\\.-?\\d+(\\.-?\\d+x-?\\d+)?)?"
+        "\\.(png|jpg|jpeg|gif|bmp)$", Qt::CaseInsensitive);
+
+    // QRegExp::exactMatch() isn't thread safe on a shared instance
+    QRegExp re(kPreviewName);
+    return re.exactMatch(filename);
+}
+
+/// Returns true for the default preview of a recording, the basename
+/// followed by the image format, these are never expired
+bool PreviewCache::IsDefaultPreview(const QString &filename)
+{
+    static const QRegExp kDefaultName(
+        "^\\d+_\\d{14}\\.\\w+\\.(png|jpg|jpeg|gif|bmp)$",
+        Qt::CaseInsensitive);
+
+    QRegExp re(kDefaultName);
+    return re.exactMatch(filename);
+}
+
+/// Takes the least recently used previews out of the cache until it
+/// fits and returns them, the caller must hold s_cacheLock
+QStringList PreviewCache::Expire(void)
+{
+    QStringList expired;
+
+    if (s_cacheLimit <= 0)
+        return expired;
+
+    // The newest entry stays even if it is bigger than the whole cache
+    while ((s_cacheTotal > s_cacheLimit) && (s_cacheOrder.size() > 1))
+    {
+        QString filename = s_cacheOrder.takeFirst();
+        s_cacheTotal -= s_cacheSizes.take(filename);
+        expired.push_back(filename);
+    }
+
+    return expired;
+}
+
+/// Deletes expired previews, called without s_cacheLock held
+void PreviewCache::Remove(const QStringList &files)
+{
+    foreach (const QString &filename, files)
+    {
+        if (QFile::remove(filename))
+        {
+            LOG(VB_FILE, LOG_INFO, LOC + QString("Expired '%1'")
+                    .arg(filename));
+        }
+    }
+}
+
+/* vim: set expandtab tabstop=4 shiftwidth=4: */
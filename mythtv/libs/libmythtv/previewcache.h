@@ -0,0 +1,48 @@
+// -*- Mode: c++ -*-
+#ifndef PREVIEW_CACHE_H_
+#define PREVIEW_CACHE_H_
+
+#include <QStringList>
+#include <QString>
+
+#include "mythtvexp.h"
+
+/** \class PreviewCache
+ *  \brief Keeps the preview images next to the recordings from taking
+ *         over the recording directories.
+ *
+ *   The time offset and scaled previews written by the
+ *   PreviewGeneratorQueue and the services API are registered here when
+ *   they are written and used. Once they add up to more than SetMaxSize()
+ *   bytes the least recently used ones are deleted, they are made again
+ *   the next time they are asked for. The default limit of 0 keeps them
+ *   all.
+ *
+ *   The default preview of a recording, "<basename>.png", is never
+ *   registered, so it is never expired.
+ *
+ *   Scan() picks up the previews already on disk, so images written
+ *   before a restart are expired too.
+ */
+class MTV_PUBLIC PreviewCache
+{
+  public:
+    static void SetMaxSize(qint64 bytes);
+    static void Scan(const QStringList &dirs);
+    static void StartScan(const QStringList &dirs);
+    static void Insert(const QString &filename);
+    static void Touch(const QString &filename);
+    static void Clear(void);
+
+    static QStringList GetFiles(void);
+    static qint64 GetSize(void);
+
+    static bool IsPreviewFile(const QString &filename);
+    static bool IsDefaultPreview(const QString &filename);
+
+  private:
+    static QStringList Expire(void);
+    static void Remove(const QStringList &files);
+};
+
+#endif // PREVIEW_CACHE_H_
@@ -0,0 +1,327 @@
+// C++ headers
+#include <algorithm>
+#include <cstring>
+using namespace std;
+
+// Qt headers
+#include <QFileInfo>
+#include <QThread>
+
+// MythTV headers
+#include "previewdecoder.h"
+#include "mythcorecontext.h" // for avcodeclock
+#include "programinfo.h"
+#include "seekindex.h"
+#include "mythlogging.h"
+
+extern "C" {
+#include "libswscale/swscale.h"
+}
+
+#define LOC QString("PreviewDecoder: ")
+
+/// Video packets read after the seek before the decoder is drained,
+/// enough to get past one GOP of non-keyframes
+static const int kMaxVideoPackets = 300;
+
+QMutex                 PreviewDecoder::s_poolLock;
+QList<PreviewDecoder*> PreviewDecoder::s_pool;
+
+PreviewDecoder::PreviewDecoder() :
+    m_codecContext(NULL), m_swsContext(NULL), m_frame(av_frame_alloc())
+{
+}
+
+PreviewDecoder::~PreviewDecoder()
+{
+    if (m_codecContext)
+    {
+        QMutexLocker locker(avcodeclock);
+        avcodec_free_context(&m_codecContext);
+    }
+    sws_freeContext(m_swsContext);
+    av_frame_free(&m_frame);
+}
+
+/// Returns the most recently used idle decoder, or a new one
+PreviewDecoder *PreviewDecoder::Acquire(void)
+{
+    QMutexLocker locker(&s_poolLock);
+    if (!s_pool.empty())
+        return s_pool.takeLast();
+    return new PreviewDecoder();
+}
+
+/// Puts a decoder back in the pool, which keeps one per core at most
+void PreviewDecoder::Release(PreviewDecoder *decoder)
+{
+    if (!decoder)
+        return;
+
+    {
+        QMutexLocker locker(&s_poolLock);
+        if (s_pool.size() < max(QThread::idealThreadCount(), 1))
+        {
+            s_pool.push_back(decoder);
+            return;
+        }
+    }
+
+    delete decoder;
+}
+
+/**
+ *  \brief Returns a AV_PIX_FMT_RGB32 buffer containing the keyframe at or
+ *         before the given time, see PreviewGenerator::GetScreenGrab().
+ *
+ *   Only local files can be opened. If the recording has no seek table
+ *   the demuxer seeks by timestamp instead.
+ */
+char *PreviewDecoder::GetScreenGrab(
+    const ProgramInfo &pginfo, const QString &filename,
+    long long seektime, bool time_in_secs,
+    int &bufferlen,
+    int &video_width, int &video_height, float &video_aspect)
+{
+    bufferlen = 0;
+
+    if (!filename.startsWith("/"))
+        return NULL;
+
+    {
+        QMutexLocker locker(avcodeclock);
+        av_register_all();
+    }
+
+    AVFormatContext *ic = NULL;
+    QByteArray fname = filename.toLocal8Bit();
+    if (avformat_open_input(&ic, fname.constData(), NULL, NULL) < 0)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC +
+            QString("Could not open '%1'").arg(filename));
+        return NULL;
+    }
+
+    int stream_index = -1;
+    if (avformat_find_stream_info(ic, NULL) >= 0)
+    {
+        stream_index = av_find_best_stream(ic, AVMEDIA_TYPE_VIDEO,
+                                           -1, -1, NULL, 0);
+    }
+
+    char *retbuf = NULL;
+    if (stream_index >= 0 && OpenCodec(ic->streams[stream_index]))
+    {
+        AVStream *st = ic->streams[stream_index];
+
+        long long keyframe, position;
+        bool seeked = false;
+        if (FindKeyframe(pginfo, filename, seektime, time_in_secs,
+                         keyframe, position))
+        {
+            seeked = av_seek_frame(ic, stream_index, position,
+                                   AVSEEK_FLAG_BYTE) >= 0;
+            LOG(VB_PLAYBACK, LOG_INFO, LOC +
+                QString("Keyframe %1 at %2 for %3%4")
+                    .arg(keyframe).arg(position)
+                    .arg(seektime).arg((time_in_secs) ? "s" : "f"));
+        }
+
+        if (!seeked)
+        {
+            double secs = seektime;
+            if (!time_in_secs)
+            {
+                AVRational rate = av_guess_frame_rate(ic, st, NULL);
+                secs = (rate.num) ? seektime / av_q2d(rate) : 0.0;
+            }
+            int64_t ts = (int64_t)(secs / av_q2d(st->time_base));
+            if (st->start_time != (int64_t)AV_NOPTS_VALUE)
+                ts += st->start_time;
+            seeked = av_seek_frame(ic, stream_index, ts,
+                                   AVSEEK_FLAG_BACKWARD) >= 0;
+        }
+
+        if (seeked && DecodeKeyframe(ic, stream_index))
+        {
+            retbuf = ConvertFrame(bufferlen);
+
+            video_width  = m_frame->width;
+            video_height = m_frame->height;
+            AVRational sar = av_guess_sample_aspect_ratio(ic, st, m_frame);
+            video_aspect = (float) video_width / video_height;
+            if (sar.num && sar.den)
+                video_aspect *= av_q2d(sar);
+        }
+        av_frame_unref(m_frame);
+    }
+
+    avformat_close_input(&ic);
+
+    return retbuf;
+}
+
+/** \brief Looks up the keyframe to grab and its byte offset in the
+ *         recording's seek index, or the database if it has none.
+ *
+ *   A time can only be turned into a keyframe with the durations in a
+ *   seek index, loading them from the database is what we are avoiding.
+ *
+ *  \return true if both keyframe and position were found.
+ */
+bool PreviewDecoder::FindKeyframe(
+    const ProgramInfo &pginfo, const QString &filename,
+    long long seektime, bool time_in_secs,
+    long long &keyframe, long long &position)
+{
+    keyframe = (time_in_secs) ? -1 : seektime;
+    position = -1;
+
+    SeekIndex index;
+    bool use_index = index.Open(filename, QFileInfo(filename).size()) &&
+        (index.GetType() == MARK_GOP_BYFRAME);
+
+    int64_t key, value;
+    if (time_in_secs && use_index)
+    {
+        SeekIndex::Cursor dur = index.GetCursor(SeekIndex::kDurations);
+        while (dur.Next(key, value) && (value <= seektime * 1000))
+            keyframe = key;
+    }
+
+    if (keyframe < 0)
+        return false;
+
+    if (use_index)
+    {
+        long long target = keyframe;
+        SeekIndex::Cursor pos = index.GetCursor(SeekIndex::kPositions);
+        while (pos.Next(key, value) && (key <= target))
+        {
+            keyframe = key;
+            position = value;
+        }
+    }
+    else
+    {
+        uint64_t pos;
+        if (pginfo.QueryKeyFramePosition(&pos, keyframe, true))
+            position = pos;
+    }
+
+    return position >= 0;
+}
+
+/** \brief Sets up the decoder for the stream, reusing the codec context
+ *         of the previous preview if the stream has the same format.
+ */
+bool PreviewDecoder::OpenCodec(AVStream *stream)
+{
+    const AVCodecContext *par = stream->codec;
+
+    if (m_codecContext &&
+        (m_codecContext->codec_id       == par->codec_id) &&
+        (m_codecContext->width          == par->width) &&
+        (m_codecContext->height         == par->height) &&
+        (m_codecContext->extradata_size == par->extradata_size) &&
+        (!par->extradata_size ||
+         !memcmp(m_codecContext->extradata, par->extradata,
+                 par->extradata_size)))
+    {
+        avcodec_flush_buffers(m_codecContext);
+        return true;
+    }
+
+    AVCodec *codec = avcodec_find_decoder(par->codec_id);
+    if (!codec)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + QString("No decoder for %1")
+                .arg(avcodec_get_name(par->codec_id)));
+        return false;
+    }
+
+    QMutexLocker locker(avcodeclock);
+
+    avcodec_free_context(&m_codecContext);
+    m_codecContext = avcodec_alloc_context3(NULL);
+    if (!m_codecContext || avcodec_copy_context(m_codecContext, par) < 0)
+    {
+        avcodec_free_context(&m_codecContext);
+        return false;
+    }
+
+    // Previews are decoded in parallel by the preview queue threads
+    m_codecContext->thread_count      = 1;
+    m_codecContext->skip_frame        = AVDISCARD_NONKEY;
+    m_codecContext->refcounted_frames = 1;
+
+    if (avcodec_open2(m_codecContext, codec, NULL) < 0)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + QString("Could not open %1 decoder")
+                .arg(codec->name));
+        avcodec_free_context(&m_codecContext);
+        return false;
+    }
+
+    return true;
+}
+
+/** \brief Reads from the seek position until a picture comes out.
+ *
+ *   The decoder discards everything but keyframes, so the packets in
+ *   between are only parsed. Pictures the decoder holds back for
+ *   reordering are drained out at the end.
+ */
+bool PreviewDecoder::DecodeKeyframe(AVFormatContext *ic, int stream_index)
+{
+    AVPacket pkt;
+    av_init_packet(&pkt);
+
+    int got_picture = 0;
+    int packets = 0;
+
+    while (!got_picture && (packets < kMaxVideoPackets) &&
+           (av_read_frame(ic, &pkt) >= 0))
+    {
+        if (pkt.stream_index == stream_index)
+        {
+            avcodec_decode_video2(m_codecContext, m_frame, &got_picture, &pkt);
+            packets++;
+        }
+        av_packet_unref(&pkt);
+    }
+
+    if (!got_picture && packets)
+    {
+        pkt.data = NULL;
+        pkt.size = 0;
+        avcodec_decode_video2(m_codecContext, m_frame, &got_picture, &pkt);
+    }
+
+    return got_picture;
+}
+
+char *PreviewDecoder::ConvertFrame(int &bufferlen)
+{
+    int width  = m_frame->width;
+    int height = m_frame->height;
+
+    m_swsContext = sws_getCachedContext(m_swsContext, width, height,
+                                        (AVPixelFormat) m_frame->format,
+                                        width, height, AV_PIX_FMT_RGB32,
+                                        SWS_FAST_BILINEAR, NULL, NULL, NULL);
+    if (!m_swsContext)
+        return NULL;
+
+    bufferlen = width * height * 4;
+    char *buf = new char[bufferlen];
+
+    uint8_t *dst[4]       = { (uint8_t*) buf, NULL, NULL, NULL };
+    int      dstStride[4] = { width * 4, 0, 0, 0 };
+    sws_scale(m_swsContext, m_frame->data, m_frame->linesize, 0, height,
+              dst, dstStride);
+
+    return buf;
+}
+
+/* vim: set expandtab tabstop=4 shiftwidth=4: */
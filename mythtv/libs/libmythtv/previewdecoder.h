@@ -0,0 +1,68 @@
+// -*- Mode: c++ -*-
+#ifndef PREVIEW_DECODER_H_
+#define PREVIEW_DECODER_H_
+
+#include <QString>
+#include <QMutex>
+#include <QList>
+
+extern "C" {
+#include "libavcodec/avcodec.h"
+#include "libavformat/avformat.h"
+}
+
+class ProgramInfo;
+struct SwsContext;
+
+/** \class PreviewDecoder
+ *  \brief Grabs a preview frame from a local file without a MythPlayer.
+ *
+ *   The recording's seek table is used to find the keyframe at or before
+ *   the requested time and the file is opened right at that keyframe's
+ *   byte offset. Only keyframes are decoded, so a preview costs one
+ *   demuxer open and a single picture decode.
+ *
+ *   Decoders are kept in a small pool by Acquire() and Release() so the
+ *   codec and scaler set up by one preview can be used by the next one
+ *   of the same format.
+ */
+class PreviewDecoder
+{
+  public:
+    static PreviewDecoder *Acquire(void);
+    static void Release(PreviewDecoder *decoder);
+
+    char *GetScreenGrab(const ProgramInfo &pginfo,
+                        const QString     &filename,
+                        long long          seektime,
+                        bool               time_in_secs,
+                        int               &bufferlen,
+                        int               &video_width,
+                        int               &video_height,
+                        float             &video_aspect);
+
+  private:
+    PreviewDecoder();
+    ~PreviewDecoder();
+    Q_DISABLE_COPY(PreviewDecoder)
+
+    static bool FindKeyframe(const ProgramInfo &pginfo,
+                             const QString &filename,
+                             long long seektime, bool time_in_secs,
+                             long long &keyframe, long long &position);
+    bool OpenCodec(AVStream *stream);
+    bool DecodeKeyframe(AVFormatContext *ic, int stream_index);
+    char *ConvertFrame(int &bufferlen);
+
+    AVCodecContext *m_codecContext;
+    SwsContext     *m_swsContext;
+    AVFrame        *m_frame;
+
+    static QMutex                 s_poolLock;
+    static QList<PreviewDecoder*> s_pool;
+
+    // for checking that pooled decoders keep their codec
+    friend class TestPreviewDecoder;
+};
+
+#endif // PREVIEW_DECODER_H_
@@ -23,6 +23,7 @@
 #include "ringbuffer.h"
 #include "mythplayer.h"
 #include "previewgenerator.h"
+#include "previewdecoder.h"
 #include "tv_rec.h"
 #include "mythsocket.h"
 #include "remotefile.h"
@@ -207,10 +208,25 @@ bool PreviewGenerator::Run(void)
     QTime tm = QTime::currentTime();
     bool ok = false;
     QString command = GetAppBinDir() + "mythpreviewgen";
-    bool local_ok = ((IsLocal() || !!(m_mode & kForceLocal)) &&
-                     (!!(m_mode & kLocal)) &&
-                     QFileInfo(command).isExecutable());
-    if (!local_ok)
+    bool local = ((IsLocal() || !!(m_mode & kForceLocal)) &&
+                  (!!(m_mode & kLocal)));
+    bool local_ok = local && QFileInfo(command).isExecutable();
+
+    // Try the nearest keyframe in process first, mythpreviewgen is
+    // only started if that can't be decoded
+    bool in_secs = m_timeInSeconds;
+    ok = local && LocalPreviewRun(true);
+    m_timeInSeconds = in_secs;
+
+    if (ok)
+    {
+        msg = QString("Generated in process on %1 in %2 seconds, "
+                      "starting at %3")
+            .arg(gCoreContext->GetHostName())
+            .arg(tm.elapsed()*0.001)
+            .arg(tm.toString(Qt::ISODate));
+    }
+    else if (!local_ok)
     {
         if (!!(m_mode & kRemote))
         {
@@ -615,7 +631,10 @@ bool PreviewGenerator::SavePreview(const QString &filename,
     return false;
 }
 
-bool PreviewGenerator::LocalPreviewRun(void)
+/** \brief Grabs and saves the preview in this process.
+ *  \param keyframe_only Grab the nearest keyframe, see GetScreenGrab().
+ */
+bool PreviewGenerator::LocalPreviewRun(bool keyframe_only)
 {
     m_programInfo.MarkAsInUse(true, kPreviewGeneratorInUseID);
     m_programInfo.SetIgnoreProgStart(true);
@@ -680,7 +699,7 @@ bool PreviewGenerator::LocalPreviewRun(void)
     unsigned char *data = (unsigned char*)
         GetScreenGrab(m_programInfo, m_pathname,
                       captime, m_timeInSeconds,
-                      sz, width, height, aspect);
+                      sz, width, height, aspect, keyframe_only);
 
     QString outname = CreateAccessibleFilename(m_pathname, m_outFileName);
 
@@ -774,6 +793,9 @@ bool PreviewGenerator::IsLocal(void) const
  *  \param video_width  Returns width of frame grabbed.
  *  \param video_height Returns height of frame grabbed.
  *  \param video_aspect Returns aspect ratio of frame grabbed.
+ *  \param keyframe_only If true the keyframe at or before seektime is
+ *                      decoded in process by a PreviewDecoder instead of
+ *                      playing up to seektime with a MythPlayer.
  *  \return Buffer allocated with new containing frame in RGBA32 format if
  *          successful, NULL otherwise.
  */
@@ -781,7 +803,8 @@ char *PreviewGenerator::GetScreenGrab(
     const ProgramInfo &pginfo, const QString &filename,
     long long seektime, bool time_in_secs,
     int &bufferlen,
-    int &video_width, int &video_height, float &video_aspect)
+    int &video_width, int &video_height, float &video_aspect,
+    bool keyframe_only)
 {
     (void) pginfo;
     (void) filename;
@@ -813,30 +836,43 @@ char *PreviewGenerator::GetScreenGrab(
         }
     }
 
-    RingBuffer *rbuf = RingBuffer::Create(filename, false, false, 0);
-    if (!rbuf->IsOpen())
+    if (keyframe_only)
     {
-        LOG(VB_GENERAL, LOG_ERR, LOC + "Previewer could not open file: " +
-                QString("'%1'").arg(filename));
-        delete rbuf;
-        return NULL;
+        PreviewDecoder *decoder = PreviewDecoder::Acquire();
+        retbuf = decoder->GetScreenGrab(pginfo, filename, seektime,
+                                        time_in_secs, bufferlen,
+                                        video_width, video_height,
+                                        video_aspect);
+        PreviewDecoder::Release(decoder);
     }
+    else
+    {
+        RingBuffer *rbuf = RingBuffer::Create(filename, false, false, 0);
+        if (!rbuf->IsOpen())
+        {
+            LOG(VB_GENERAL, LOG_ERR, LOC + "Previewer could not open file: " +
+                    QString("'%1'").arg(filename));
+            delete rbuf;
+            return NULL;
+        }
 
-    PlayerContext *ctx = new PlayerContext(kPreviewGeneratorInUseID);
-    ctx->SetRingBuffer(rbuf);
-    ctx->SetPlayingInfo(&pginfo);
-    ctx->SetPlayer(new MythPlayer((PlayerFlags)(kAudioMuted | kVideoIsNull | kNoITV)));
-    ctx->player->SetPlayerInfo(NULL, NULL, ctx);
+        PlayerContext *ctx = new PlayerContext(kPreviewGeneratorInUseID);
+        ctx->SetRingBuffer(rbuf);
+        ctx->SetPlayingInfo(&pginfo);
+        ctx->SetPlayer(new MythPlayer(
+                           (PlayerFlags)(kAudioMuted | kVideoIsNull | kNoITV)));
+        ctx->player->SetPlayerInfo(NULL, NULL, ctx);
 
-    if (time_in_secs)
-        retbuf = ctx->player->GetScreenGrab(seektime, bufferlen,
+        if (time_in_secs)
+            retbuf = ctx->player->GetScreenGrab(seektime, bufferlen,
                                     video_width, video_height, video_aspect);
-    else
-        retbuf = ctx->player->GetScreenGrabAtFrame(
-            seektime, true, bufferlen,
-            video_width, video_height, video_aspect);
+        else
+            retbuf = ctx->player->GetScreenGrabAtFrame(
+                seektime, true, bufferlen,
+                video_width, video_height, video_aspect);
 
-    delete ctx;
+        delete ctx;
+    }
 
     if (retbuf)
     {
@@ -75,7 +75,7 @@ class MTV_PUBLIC PreviewGenerator : public QObject, public MThread
     void TeardownAll(void);
 
     bool RemotePreviewRun(void);
-    bool LocalPreviewRun(void);
+    bool LocalPreviewRun(bool keyframe_only = false);
     bool IsLocal(void) const;
 
     bool RunReal(void);
@@ -87,7 +87,8 @@ class MTV_PUBLIC PreviewGenerator : public QObject, public MThread
                                int               &bufferlen,
                                int               &video_width,
                                int               &video_height,
-                               float             &video_aspect);
+                               float             &video_aspect,
+                               bool               keyframe_only = false);
 
     static bool SavePreview(const QString &filename,
                             const unsigned char *data,
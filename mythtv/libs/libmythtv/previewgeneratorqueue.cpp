@@ -21,6 +21,7 @@ using std::max;
 
 // libmythtv
 #include "previewgenerator.h"
+#include "previewcache.h"
 
 #define LOC QString("PreviewQueue: ")
 
@@ -51,8 +52,10 @@ PreviewGeneratorQueue::PreviewGeneratorQueue(
 {
     if (PreviewGenerator::kLocal & mode)
     {
+        // Previews are decoded in process, so one per core keeps
+        // them from starving playback and recording
         int idealThreads = QThread::idealThreadCount();
-        m_maxThreads = (idealThreads >= 1) ? idealThreads * 2 : 2;
+        m_maxThreads = (idealThreads >= 1) ? idealThreads : 2;
     }
 
     moveToThread(qthread());
@@ -227,6 +230,14 @@ bool PreviewGeneratorQueue::event(QEvent *e)
             m_running = (m_running > 0) ? m_running - 1 : 0;
         }
 
+        // Only previews written next to local recordings are ours
+        // to expire, remote ones live in the frontend's cache
+        if (me->Message() == "PREVIEW_SUCCESS" &&
+            (PreviewGenerator::kLocal & m_mode))
+        {
+            PreviewCache::Insert(filename);
+        }
+
         UpdatePreviewGeneratorThreads();
 
         return true;
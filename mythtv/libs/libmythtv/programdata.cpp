@@ -4,6 +4,7 @@
 
 // C++ includes
 #include <algorithm>
+#include <map>
 using namespace std;
 
 // Qt includes
@@ -15,6 +16,9 @@ using namespace std;
 #include "mythdb.h"
 #include "mythlogging.h"
 #include "dvbdescriptors.h"
+#include "mythcorecontext.h"
+#include "mythtimer.h"
+#include "mythdate.h"
 
 #define LOC      QString("ProgramData: ")
 
@@ -219,9 +223,191 @@ bool DBEvent::HasTimeConflict(const DBEvent &o) const
             (o.endtime <= endtime     && starttime   < o.endtime));
 }
 
+/** \class DBEventWindow
+ *  \brief In-memory copy of one channel's program table rows for the time
+ *         span of a batch of events.
+ *
+ *  DBEvent::UpdateDB() uses it instead of querying the database for the
+ *  overlapping programs of every event, and keeps it in step with every
+ *  change it writes so later events in the batch see earlier ones.
+ */
+class DBEventWindow
+{
+  public:
+    bool Load(MSqlQuery &query, uint chanid,
+              const QDateTime &start, const QDateTime &end);
+
+    uint GetOverlappingPrograms(
+        const DBEvent &event, vector<DBEvent> &programs) const;
+    bool Exists(const QDateTime &starttime) const
+    {
+        return programs.count(starttime) || manual.contains(starttime);
+    }
+
+    void Remove(const QDateTime &starttime);
+    void Move(const QDateTime &oldstart,
+              const QDateTime &newstart, const QDateTime &newend);
+    void Set(const QDateTime &oldstart, const DBEvent &program);
+
+  private:
+    /// manualid = 0 rows by starttime
+    map<QDateTime, DBEvent> programs;
+    /// starttimes of manual recording rows, which are never overlap
+    /// candidates but do block moving a program
+    QMap<QDateTime, bool>   manual;
+};
+
+bool DBEventWindow::Load(MSqlQuery &query, uint chanid,
+                         const QDateTime &start, const QDateTime &end)
+{
+    // Same conditions as GetOverlappingPrograms() for the whole window,
+    // with closed ends so that rows starting when an event ends are
+    // included for MoveOutOfTheWayDB().
+    query.prepare(
+        "SELECT title,          subtitle,      description, "
+        "       category,       category_type, "
+        "       starttime,      endtime, "
+        "       subtitletypes+0,audioprop+0,   videoprop+0, "
+        "       seriesid,       programid, "
+        "       partnumber,     parttotal, "
+        "       syndicatedepisodenumber, "
+        "       airdate,        originalairdate, "
+        "       previouslyshown,listingsource, "
+        "       stars+0, "
+        "       season,         episode,       totalepisodes, "
+        "       inetref,        manualid "
+        "FROM program "
+        "WHERE chanid   = :CHANID AND "
+        "      ( ( starttime >= :STIME1 AND starttime <= :ETIME1 ) OR "
+        "        ( endtime   >= :STIME2 AND endtime   <= :ETIME2 ) OR "
+        "        ( starttime <  :STIME3 AND endtime   >  :ETIME3 ) )");
+    query.bindValue(":CHANID", chanid);
+    query.bindValue(":STIME1", start);
+    query.bindValue(":ETIME1", end);
+    query.bindValue(":STIME2", start);
+    query.bindValue(":ETIME2", end);
+    query.bindValue(":STIME3", start);
+    query.bindValue(":ETIME3", end);
+
+    if (!query.exec())
+    {
+        MythDB::DBError("DBEventWindow::Load", query);
+        return false;
+    }
+
+    while (query.next())
+    {
+        QDateTime st = MythDate::as_utc(query.value(5).toDateTime());
+        if (query.value(24).toUInt())
+        {
+            manual[st] = true;
+            continue;
+        }
+
+        ProgramInfo::CategoryType category_type =
+            string_to_myth_category_type(query.value(4).toString());
+
+        DBEvent prog(
+            query.value(0).toString(),
+            query.value(1).toString(),
+            query.value(2).toString(),
+            query.value(3).toString(),
+            category_type,
+            st,
+            MythDate::as_utc(query.value(6).toDateTime()),
+            query.value(7).toUInt(),
+            query.value(8).toUInt(),
+            query.value(9).toUInt(),
+            query.value(19).toDouble(),
+            query.value(10).toString(),
+            query.value(11).toString(),
+            query.value(18).toUInt(),
+            query.value(20).toUInt(),  // Season
+            query.value(21).toUInt(),  // Episode
+            query.value(22).toUInt()); // Total Episodes
+
+        prog.inetref    = query.value(23).toString();
+        prog.partnumber = query.value(12).toUInt();
+        prog.parttotal  = query.value(13).toUInt();
+        prog.syndicatedepisodenumber = query.value(14).toString();
+        prog.airdate    = query.value(15).toUInt();
+        prog.originalairdate  = query.value(16).toDate();
+        prog.previouslyshown  = query.value(17).toBool();
+
+        programs.insert(make_pair(st, prog));
+    }
+
+    return true;
+}
+
+// In-memory version of the query in DBEvent::GetOverlappingPrograms()
+uint DBEventWindow::GetOverlappingPrograms(
+    const DBEvent &event, vector<DBEvent> &result) const
+{
+    const QDateTime &st = event.starttime;
+    const QDateTime &et = event.endtime;
+
+    uint count = 0;
+    map<QDateTime, DBEvent>::const_iterator it = programs.begin();
+    for (; it != programs.end(); ++it)
+    {
+        const DBEvent &prog = it->second;
+        if ((prog.starttime >= st && prog.starttime <  et) ||
+            (prog.endtime   >  st && prog.endtime   <= et) ||
+            (prog.starttime <  st && prog.endtime   >  et))
+        {
+            result.push_back(prog);
+            count++;
+        }
+    }
+
+    return count;
+}
+
+void DBEventWindow::Remove(const QDateTime &starttime)
+{
+    programs.erase(starttime);
+    manual.remove(starttime);
+}
+
+void DBEventWindow::Move(const QDateTime &oldstart,
+                         const QDateTime &newstart, const QDateTime &newend)
+{
+    map<QDateTime, DBEvent>::iterator it = programs.find(oldstart);
+    if (it != programs.end())
+    {
+        DBEvent prog = it->second;
+        programs.erase(it);
+        prog.starttime = newstart;
+        prog.endtime   = newend;
+        programs.erase(newstart);
+        programs.insert(make_pair(newstart, prog));
+    }
+
+    if (manual.remove(oldstart))
+        manual[newstart] = true;
+}
+
+void DBEventWindow::Set(const QDateTime &oldstart, const DBEvent &program)
+{
+    if (manual.remove(oldstart))
+        manual[program.starttime] = true;
+    programs.erase(oldstart);
+    programs.erase(program.starttime);
+
+    // Only the program row is tracked, not its credits or ratings
+    DBEvent prog(program.listingsource);
+    prog = program;
+    delete prog.credits;
+    prog.credits = NULL;
+    prog.ratings.clear();
+    programs.insert(make_pair(program.starttime, prog));
+}
+
 // Processing new EIT entry starts here
 uint DBEvent::UpdateDB(
-    MSqlQuery &query, uint chanid, int match_threshold) const
+    MSqlQuery &query, uint chanid, int match_threshold,
+    DBEventWindow *window) const
 {
     // List the program that we are going to add
     LOG(VB_EIT, LOG_DEBUG,
@@ -244,14 +430,20 @@ uint DBEvent::UpdateDB(
     // Get all programs already in the database that overlap
     // with our new program.
     vector<DBEvent> programs;
-    uint count = GetOverlappingPrograms(query, chanid, programs);
+    uint count = window ? window->GetOverlappingPrograms(*this, programs) :
+                          GetOverlappingPrograms(query, chanid, programs);
     int  match = INT_MIN;
     int  i     = -1;
 
     // If there are no programs already in the database that overlap
     // with our new program then we can simply insert it in the database.
     if (!count)
-        return InsertDB(query, chanid);
+    {
+        uint inserted = InsertDB(query, chanid);
+        if (inserted && window)
+            window->Set(starttime, *this);
+        return inserted;
+    }
 
     // List all overlapping programs with start- and endtime.
     for (uint j=0; j<count; j++)
@@ -280,7 +472,7 @@ uint DBEvent::UpdateDB(
             QString("EIT: accept match[%1]: %2 '%3' vs. '%4'")
                 .arg(i).arg(match).arg(title.left(35))
                 .arg(programs[i].title.left(35)));
-        return UpdateDB(query, chanid, programs, i);
+        return UpdateDB(query, chanid, programs, i, window);
     }
     else
     {
@@ -297,7 +489,7 @@ uint DBEvent::UpdateDB(
 
         // Move the overlapping programs out of the way and
         // insert the new program.
-        return UpdateDB(query, chanid, programs, -1);
+        return UpdateDB(query, chanid, programs, -1, window);
     }
 }
 
@@ -536,14 +728,15 @@ int DBEvent::GetMatch(const vector<DBEvent> &programs, int &bestmatch) const
 }
 
 uint DBEvent::UpdateDB(
-    MSqlQuery &q, uint chanid, const vector<DBEvent> &p, int match) const
+    MSqlQuery &q, uint chanid, const vector<DBEvent> &p, int match,
+    DBEventWindow *window) const
 {
     // Adjust/delete overlaps;
     bool ok = true;
     for (uint i = 0; i < p.size(); i++)
     {
         if (i != (uint)match)
-            ok &= MoveOutOfTheWayDB(q, chanid, p[i]);
+            ok &= MoveOutOfTheWayDB(q, chanid, p[i], window);
     }
 
     // If we failed to move programs out of the way, don't insert new ones..
@@ -561,7 +754,10 @@ uint DBEvent::UpdateDB(
         LOG(VB_EIT, LOG_DEBUG,
             QString("EIT: insert '%1'")
                     .arg(title.left(35)));
-        return InsertDB(q, chanid);
+        uint inserted = InsertDB(q, chanid);
+        if (inserted && window)
+            window->Set(starttime, *this);
+        return inserted;
     }
 
     // Changing a starttime of a program that is being recorded can
@@ -585,13 +781,14 @@ uint DBEvent::UpdateDB(
          QString("EIT: update '%1' with '%2'")
                  .arg(p[match].title.left(35))
                  .arg(title.left(35)));
-    return UpdateDB(q, chanid, p[match]);
+    return UpdateDB(q, chanid, p[match], window);
 }
 
 // Update matched item with current data.
 //
 uint DBEvent::UpdateDB(
-    MSqlQuery &query, uint chanid, const DBEvent &match)  const
+    MSqlQuery &query, uint chanid, const DBEvent &match,
+    DBEventWindow *window)  const
 {
     QString  ltitle     = title;
     QString  lsubtitle  = subtitle;
@@ -726,6 +923,22 @@ uint DBEvent::UpdateDB(
         return 0;
     }
 
+    if (window)
+    {
+        DBEvent prog(ltitle, lsubtitle, ldesc, lcategory, tmp,
+                     starttime, endtime, lsubtype, laudio, lvideo,
+                     match.stars, lseriesId, lprogramId, llistingsource,
+                     lseason, lepisode, lepisodeTotal);
+        prog.inetref    = linetref;
+        prog.partnumber = lpartnumber;
+        prog.parttotal  = lparttotal;
+        prog.syndicatedepisodenumber = lsyndicatedepisodenumber;
+        prog.airdate    = lairdate;
+        prog.originalairdate = loriginalairdate;
+        prog.previouslyshown = lpreviouslyshown;
+        window->Set(match.starttime, prog);
+    }
+
     if (credits)
     {
         for (uint i = 0; i < credits->size(); i++)
@@ -846,7 +1059,8 @@ static bool change_program(MSqlQuery &query, uint chanid, const QDateTime &st,
 // Move the program "prog" (3rd parameter) out of the way
 // because it overlaps with our new program.
 bool DBEvent::MoveOutOfTheWayDB(
-    MSqlQuery &query, uint chanid, const DBEvent &prog) const
+    MSqlQuery &query, uint chanid, const DBEvent &prog,
+    DBEventWindow *window) const
 {
     if (prog.starttime >= starttime && prog.endtime <= endtime)
     {
@@ -857,7 +1071,11 @@ bool DBEvent::MoveOutOfTheWayDB(
                     .arg(prog.title.left(35))
                     .arg(prog.starttime.toString(Qt::ISODate))
                     .arg(prog.endtime.toString(Qt::ISODate)));
-        return delete_program(query, chanid, prog.starttime);
+        if (!delete_program(query, chanid, prog.starttime))
+            return false;
+        if (window)
+            window->Remove(prog.starttime);
+        return true;
     }
     else if (prog.starttime < starttime && prog.endtime > starttime)
     {
@@ -870,9 +1088,13 @@ bool DBEvent::MoveOutOfTheWayDB(
             QString("EIT: change '%1' endtime to %2")
                     .arg(prog.title.left(35))
                     .arg(starttime.toString(Qt::ISODate)));
-        return change_program(query, chanid, prog.starttime,
-                              prog.starttime, // Keep the start time
-                              starttime);     // New end time is our start time
+        if (!change_program(query, chanid, prog.starttime,
+                            prog.starttime, // Keep the start time
+                            starttime))     // New end time is our start time
+            return false;
+        if (window)
+            window->Move(prog.starttime, prog.starttime, starttime);
+        return true;
     }
     else if (prog.starttime < endtime && prog.endtime > endtime)
     {
@@ -882,23 +1104,32 @@ bool DBEvent::MoveOutOfTheWayDB(
         // If there is already a program starting just when our
         // new program ends we cannot move the old program
         // so then we have to delete the old program.
-        if (program_exists(query, chanid, endtime))
+        if (window ? window->Exists(endtime) :
+                     program_exists(query, chanid, endtime))
         {
             LOG(VB_EIT, LOG_DEBUG,
                 QString("EIT: delete '%1' %2 - %3")
                         .arg(prog.title.left(35))
                         .arg(prog.starttime.toString(Qt::ISODate))
                         .arg(prog.endtime.toString(Qt::ISODate)));
-            return delete_program(query, chanid, prog.starttime);
+            if (!delete_program(query, chanid, prog.starttime))
+                return false;
+            if (window)
+                window->Remove(prog.starttime);
+            return true;
         }
         LOG(VB_EIT, LOG_DEBUG,
             QString("EIT: change '%1' starttime to %2")
                     .arg(prog.title.left(35))
                     .arg(endtime.toString(Qt::ISODate)));
 
-        return change_program(query, chanid, prog.starttime,
-                              endtime,        // New start time is our endtime
-                              prog.endtime);  // Keep the end time
+        if (!change_program(query, chanid, prog.starttime,
+                            endtime,        // New start time is our endtime
+                            prog.endtime))  // Keep the end time
+            return false;
+        if (window)
+            window->Move(prog.starttime, endtime, prog.endtime);
+        return true;
     }
     // must be non-conflicting...
     return true;
@@ -979,6 +1210,55 @@ uint DBEvent::InsertDB(MSqlQuery &query, uint chanid) const
     return 1;
 }
 
+/** \fn DBEventEIT::UpdateDB(MSqlQuery&, const QList<DBEventEIT*>&, int)
+ *  \brief Updates the database with a batch of events for one channel.
+ *
+ *  The program rows the events can touch are read once into a
+ *  DBEventWindow, the overlaps are resolved against it and all writes
+ *  are committed in a single transaction. If that fails the events are
+ *  written one at a time as before.
+ *
+ *  \return number of events inserted or updated
+ */
+uint DBEventEIT::UpdateDB(MSqlQuery &query, const QList<DBEventEIT*> &events,
+                          int match_threshold)
+{
+    if (events.empty())
+        return 0;
+
+    uint chanid = events[0]->chanid;
+    QDateTime start = events[0]->starttime;
+    QDateTime end   = events[0]->endtime;
+    for (int i = 1; i < events.size(); ++i)
+    {
+        start = min(start, events[i]->starttime);
+        end   = max(end,   events[i]->endtime);
+    }
+
+    uint count = 0;
+    DBEventWindow window;
+    if (query.exec("START TRANSACTION") &&
+        window.Load(query, chanid, start, end))
+    {
+        for (int i = 0; i < events.size(); ++i)
+        {
+            count += events[i]->DBEvent::UpdateDB(
+                query, chanid, match_threshold, &window);
+        }
+
+        if (query.exec("COMMIT"))
+            return count;
+    }
+
+    MythDB::DBError("DBEventEIT::UpdateDB batch", query);
+    query.exec("ROLLBACK");
+
+    count = 0;
+    for (int i = 0; i < events.size(); ++i)
+        count += events[i]->UpdateDB(query, match_threshold);
+    return count;
+}
+
 ProgInfo::ProgInfo(const ProgInfo &other) :
     DBEvent(other.listingsource)
 {
@@ -1026,82 +1306,103 @@ void ProgInfo::Squeeze(void)
     clumpmax.squeeze();
 }
 
-uint ProgInfo::InsertDB(MSqlQuery &query, uint chanid) const
+static const char *program_columns =
+    "  chanid,         title,          subtitle,        description, "
+    "  category,       category_type,  "
+    "  starttime,      endtime, "
+    "  closecaptioned, stereo,         hdtv,            subtitled, "
+    "  subtitletypes,  audioprop,      videoprop, "
+    "  partnumber,     parttotal, "
+    "  syndicatedepisodenumber, "
+    "  airdate,        originalairdate,listingsource, "
+    "  seriesid,       programid,      previouslyshown, "
+    "  stars,          showtype,       title_pronounce, colorcode, "
+    "  season,         episode,        totalepisodes, "
+    "  inetref ";
+
+static const char *program_placeholders[] =
 {
-    LOG(VB_XMLTV, LOG_INFO,
-        QString("Inserting new program    : %1 - %2 %3 %4")
-            .arg(starttime.toString(Qt::ISODate))
-            .arg(endtime.toString(Qt::ISODate))
-            .arg(channel)
-            .arg(title));
-
-    query.prepare(
-        "REPLACE INTO program ("
-        "  chanid,         title,          subtitle,        description, "
-        "  category,       category_type,  "
-        "  starttime,      endtime, "
-        "  closecaptioned, stereo,         hdtv,            subtitled, "
-        "  subtitletypes,  audioprop,      videoprop, "
-        "  partnumber,     parttotal, "
-        "  syndicatedepisodenumber, "
-        "  airdate,        originalairdate,listingsource, "
-        "  seriesid,       programid,      previouslyshown, "
-        "  stars,          showtype,       title_pronounce, colorcode, "
-        "  season,         episode,        totalepisodes, "
-        "  inetref ) "
+    "CHANID",      "TITLE",       "SUBTITLE",    "DESCRIPTION",
+    "CATEGORY",    "CATTYPE",
+    "STARTTIME",   "ENDTIME",
+    "CC",          "STEREO",      "HDTV",        "HASSUBTITLES",
+    "SUBTYPES",    "AUDIOPROP",   "VIDEOPROP",
+    "PARTNUMBER",  "PARTTOTAL",
+    "SYNDICATENO",
+    "AIRDATE",     "ORIGAIRDATE", "LSOURCE",
+    "SERIESID",    "PROGRAMID",   "PREVSHOWN",
+    "STARS",       "SHOWTYPE",    "TITLEPRON",   "COLORCODE",
+    "SEASON",      "EPISODE",     "TOTALEPISODES",
+    "INETREF",
+};
 
-        "VALUES("
-        " :CHANID,        :TITLE,         :SUBTITLE,       :DESCRIPTION, "
-        " :CATEGORY,      :CATTYPE,       "
-        " :STARTTIME,     :ENDTIME, "
-        " :CC,            :STEREO,        :HDTV,           :HASSUBTITLES, "
-        " :SUBTYPES,      :AUDIOPROP,     :VIDEOPROP, "
-        " :PARTNUMBER,    :PARTTOTAL, "
-        " :SYNDICATENO, "
-        " :AIRDATE,       :ORIGAIRDATE,   :LSOURCE, "
-        " :SERIESID,      :PROGRAMID,     :PREVSHOWN, "
-        " :STARS,         :SHOWTYPE,      :TITLEPRON,      :COLORCODE, "
-        " :SEASON,        :EPISODE,       :TOTALEPISODES, "
-        " :INETREF )");
+/// Returns the VALUES tuple for one program row, with every placeholder
+/// name ending in \p suffix so several rows can share one statement.
+QString ProgInfo::GetDBPlaceholders(const QString &suffix)
+{
+    QStringList list;
+    for (uint i = 0; i < sizeof(program_placeholders) / sizeof(char*); ++i)
+        list << QString(":%1%2").arg(program_placeholders[i]).arg(suffix);
+    return QString("(%1)").arg(list.join(", "));
+}
 
+void ProgInfo::BindDB(MSqlQuery &query, uint chanid,
+                      const QString &suffix) const
+{
     QString cattype = myth_category_type_to_string(categoryType);
 
-    query.bindValue(":CHANID",      chanid);
-    query.bindValue(":TITLE",       denullify(title));
-    query.bindValue(":SUBTITLE",    denullify(subtitle));
-    query.bindValue(":DESCRIPTION", denullify(description));
-    query.bindValue(":CATEGORY",    denullify(category));
-    query.bindValue(":CATTYPE",     cattype);
-    query.bindValue(":STARTTIME",   starttime);
-    query.bindValue(":ENDTIME",     denullify(endtime));
-    query.bindValue(":CC",
+    query.bindValue(":CHANID"      + suffix, chanid);
+    query.bindValue(":TITLE"       + suffix, denullify(title));
+    query.bindValue(":SUBTITLE"    + suffix, denullify(subtitle));
+    query.bindValue(":DESCRIPTION" + suffix, denullify(description));
+    query.bindValue(":CATEGORY"    + suffix, denullify(category));
+    query.bindValue(":CATTYPE"     + suffix, cattype);
+    query.bindValue(":STARTTIME"   + suffix, starttime);
+    query.bindValue(":ENDTIME"     + suffix, denullify(endtime));
+    query.bindValue(":CC"          + suffix,
                     (subtitleType & SUB_HARDHEAR) ? true : false);
-    query.bindValue(":STEREO",
+    query.bindValue(":STEREO"      + suffix,
                     (audioProps   & AUD_STEREO)   ? true : false);
-    query.bindValue(":HDTV",
+    query.bindValue(":HDTV"        + suffix,
                     (videoProps   & VID_HDTV)     ? true : false);
-    query.bindValue(":HASSUBTITLES",
+    query.bindValue(":HASSUBTITLES" + suffix,
                     (subtitleType & SUB_NORMAL)   ? true : false);
-    query.bindValue(":SUBTYPES",    subtitleType);
-    query.bindValue(":AUDIOPROP",   audioProps);
-    query.bindValue(":VIDEOPROP",   videoProps);
-    query.bindValue(":PARTNUMBER",  partnumber);
-    query.bindValue(":PARTTOTAL",   parttotal);
-    query.bindValue(":SYNDICATENO", denullify(syndicatedepisodenumber));
-    query.bindValue(":AIRDATE",     airdate ? QString::number(airdate):"0000");
-    query.bindValue(":ORIGAIRDATE", originalairdate);
-    query.bindValue(":LSOURCE",     listingsource);
-    query.bindValue(":SERIESID",    denullify(seriesId));
-    query.bindValue(":PROGRAMID",   denullify(programId));
-    query.bindValue(":PREVSHOWN",   previouslyshown);
-    query.bindValue(":STARS",       stars);
-    query.bindValue(":SHOWTYPE",    showtype);
-    query.bindValue(":TITLEPRON",   title_pronounce);
-    query.bindValue(":COLORCODE",   colorcode);
-    query.bindValue(":SEASON",      season);
-    query.bindValue(":EPISODE",     episode);
-    query.bindValue(":TOTALEPISODES", totalepisodes);
-    query.bindValue(":INETREF",     inetref);
+    query.bindValue(":SUBTYPES"    + suffix, subtitleType);
+    query.bindValue(":AUDIOPROP"   + suffix, audioProps);
+    query.bindValue(":VIDEOPROP"   + suffix, videoProps);
+    query.bindValue(":PARTNUMBER"  + suffix, partnumber);
+    query.bindValue(":PARTTOTAL"   + suffix, parttotal);
+    query.bindValue(":SYNDICATENO" + suffix,
+                    denullify(syndicatedepisodenumber));
+    query.bindValue(":AIRDATE"     + suffix,
+                    airdate ? QString::number(airdate) : "0000");
+    query.bindValue(":ORIGAIRDATE" + suffix, originalairdate);
+    query.bindValue(":LSOURCE"     + suffix, listingsource);
+    query.bindValue(":SERIESID"    + suffix, denullify(seriesId));
+    query.bindValue(":PROGRAMID"   + suffix, denullify(programId));
+    query.bindValue(":PREVSHOWN"   + suffix, previouslyshown);
+    query.bindValue(":STARS"       + suffix, stars);
+    query.bindValue(":SHOWTYPE"    + suffix, showtype);
+    query.bindValue(":TITLEPRON"   + suffix, title_pronounce);
+    query.bindValue(":COLORCODE"   + suffix, colorcode);
+    query.bindValue(":SEASON"      + suffix, season);
+    query.bindValue(":EPISODE"     + suffix, episode);
+    query.bindValue(":TOTALEPISODES" + suffix, totalepisodes);
+    query.bindValue(":INETREF"     + suffix, inetref);
+}
+
+uint ProgInfo::InsertDB(MSqlQuery &query, uint chanid) const
+{
+    LOG(VB_XMLTV, LOG_INFO,
+        QString("Inserting new program    : %1 - %2 %3 %4")
+            .arg(starttime.toString(Qt::ISODate))
+            .arg(endtime.toString(Qt::ISODate))
+            .arg(channel)
+            .arg(title));
+
+    query.prepare(QString("REPLACE INTO program (%1) VALUES %2")
+                  .arg(program_columns).arg(GetDBPlaceholders("")));
+    BindDB(query, chanid, "");
 
     if (!query.exec())
     {
@@ -1274,7 +1575,23 @@ void ProgramData::HandlePrograms(
 {
     uint unchanged = 0, updated = 0;
 
+    HandlePrograms(sourceid, proglist, unchanged, updated);
+
+    LOG(VB_GENERAL, LOG_INFO,
+        QString("Updated programs: %1 Unchanged programs: %2")
+                .arg(updated) .arg(unchanged));
+}
+
+/** \brief Stores the programmes in \p proglist and adds the number of
+ *         programmes that were stored and left alone to \p updated and
+ *         \p unchanged.
+ */
+void ProgramData::HandlePrograms(
+    uint sourceid, QMap<QString, QList<ProgInfo> > &proglist,
+    uint &unchanged, uint &updated)
+{
     MSqlQuery query(MSqlQuery::InitCon());
+    bool bulk = gCoreContext->GetNumSetting("MythFillBulkImport", 1);
 
     QMap<QString, QList<ProgInfo> >::const_iterator mapiter;
     for (mapiter = proglist.begin(); mapiter != proglist.end(); ++mapiter)
@@ -1318,13 +1635,24 @@ void ProgramData::HandlePrograms(
 
         for (uint i = 0; i < chanids.size(); ++i)
         {
+            if (bulk &&
+                HandleProgramsBulk(query, chanids[i], sortlist,
+                                   unchanged, updated))
+            {
+                continue;
+            }
+
+            if (bulk)
+            {
+                LOG(VB_GENERAL, LOG_WARNING, LOC +
+                    QString("Bulk import failed for channel %1, "
+                            "storing programs one by one.")
+                        .arg(chanids[i]));
+            }
+
             HandlePrograms(query, chanids[i], sortlist, unchanged, updated);
         }
     }
-
-    LOG(VB_GENERAL, LOG_INFO,
-        QString("Updated programs: %1 Unchanged programs: %2")
-                .arg(updated) .arg(unchanged));
 }
 
 void ProgramData::HandlePrograms(MSqlQuery             &query,
@@ -1349,6 +1677,453 @@ void ProgramData::HandlePrograms(MSqlQuery             &query,
     }
 }
 
+/// Columns of an existing program row that IsUnchanged() compares.
+class ExistingProgram
+{
+  public:
+    bool Matches(const ProgInfo &pi) const
+    {
+        if (pi.endtime.isNull() || endtime != pi.endtime)
+            return false;
+
+        return
+            title           == denullify(pi.title)                   &&
+            subtitle        == denullify(pi.subtitle)                &&
+            description     == denullify(pi.description)             &&
+            category        == denullify(pi.category)                &&
+            cattype         ==
+                myth_category_type_to_string(pi.categoryType)       &&
+            airdate         == pi.airdate                            &&
+            stars           >= pi.stars - 0.001f                     &&
+            stars           <= pi.stars + 0.001f                     &&
+            previouslyshown == pi.previouslyshown                    &&
+            title_pronounce == denullify(pi.title_pronounce)         &&
+            audioprop       == pi.audioProps                         &&
+            videoprop       == pi.videoProps                         &&
+            subtitletypes   == pi.subtitleType                       &&
+            partnumber      == pi.partnumber                         &&
+            parttotal       == pi.parttotal                          &&
+            seriesid        == denullify(pi.seriesId)                &&
+            showtype        == denullify(pi.showtype)                &&
+            colorcode       == denullify(pi.colorcode)               &&
+            syndicatedepisodenumber ==
+                denullify(pi.syndicatedepisodenumber)               &&
+            programid       == denullify(pi.programId)               &&
+            inetref         == denullify(pi.inetref);
+    }
+
+    QDateTime endtime;
+    QString   title;
+    QString   subtitle;
+    QString   description;
+    QString   category;
+    QString   cattype;
+    uint      airdate;
+    float     stars;
+    bool      previouslyshown;
+    QString   title_pronounce;
+    uint      audioprop;
+    uint      videoprop;
+    uint      subtitletypes;
+    uint      partnumber;
+    uint      parttotal;
+    QString   seriesid;
+    QString   showtype;
+    QString   colorcode;
+    QString   syndicatedepisodenumber;
+    QString   programid;
+    QString   inetref;
+};
+typedef QMultiMap<QDateTime, ExistingProgram> existing_programs_t;
+typedef QPair<QDateTime, QDateTime> time_range_t;
+
+/// Rows per multi-row statement in the bulk import.
+static const int kBulkRows = 100;
+
+static bool bulk_exec(MSqlQuery &query, const QString &what)
+{
+    if (query.exec())
+        return true;
+    MythDB::DBError(what, query);
+    return false;
+}
+
+static bool load_existing_programs(
+    MSqlQuery &query, uint chanid,
+    const QDateTime &from, const QDateTime &to,
+    existing_programs_t &existing)
+{
+    query.prepare(
+        "SELECT starttime,       endtime,        title, "
+        "       subtitle,        description,    category, "
+        "       category_type,   airdate,        stars, "
+        "       previouslyshown, title_pronounce, audioprop+0, "
+        "       videoprop+0,     subtitletypes+0, partnumber, "
+        "       parttotal,       seriesid,       showtype, "
+        "       colorcode,       syndicatedepisodenumber, programid, "
+        "       inetref "
+        "FROM program "
+        "WHERE chanid     = :CHANID AND "
+        "      starttime >= :FROM   AND "
+        "      starttime <  :TO");
+    query.bindValue(":CHANID", chanid);
+    query.bindValue(":FROM",   from);
+    query.bindValue(":TO",     to);
+
+    if (!bulk_exec(query, "load_existing_programs"))
+        return false;
+
+    while (query.next())
+    {
+        ExistingProgram p;
+        p.endtime         = MythDate::as_utc(query.value(1).toDateTime());
+        p.title           = query.value(2).toString();
+        p.subtitle        = query.value(3).toString();
+        p.description     = query.value(4).toString();
+        p.category        = query.value(5).toString();
+        p.cattype         = query.value(6).toString();
+        p.airdate         = query.value(7).toUInt();
+        p.stars           = query.value(8).toFloat();
+        p.previouslyshown = query.value(9).toBool();
+        p.title_pronounce = query.value(10).toString();
+        p.audioprop       = query.value(11).toUInt();
+        p.videoprop       = query.value(12).toUInt();
+        p.subtitletypes   = query.value(13).toUInt();
+        p.partnumber      = query.value(14).toUInt();
+        p.parttotal       = query.value(15).toUInt();
+        p.seriesid        = query.value(16).toString();
+        p.showtype        = query.value(17).toString();
+        p.colorcode       = query.value(18).toString();
+        p.syndicatedepisodenumber = query.value(19).toString();
+        p.programid       = query.value(20).toString();
+        p.inetref         = query.value(21).toString();
+        existing.insert(MythDate::as_utc(query.value(0).toDateTime()), p);
+    }
+
+    return true;
+}
+
+static bool bulk_delete_ranges(
+    MSqlQuery &query, uint chanid, const QList<time_range_t> &ranges)
+{
+    static const char *tables[] =
+        { "program", "programrating", "credits", "programgenres" };
+
+    for (uint t = 0; t < sizeof(tables) / sizeof(char*); ++t)
+    {
+        for (int i = 0; i < ranges.size(); i += kBulkRows)
+        {
+            int n = min(kBulkRows, ranges.size() - i);
+            QStringList clauses;
+            for (int j = 0; j < n; ++j)
+            {
+                clauses << QString("(starttime >= :FROM%1 AND "
+                                   "starttime < :TO%1)").arg(j);
+            }
+
+            query.prepare(QString("DELETE FROM %1 "
+                                  "WHERE chanid = :CHANID AND (%2)")
+                          .arg(tables[t]).arg(clauses.join(" OR ")));
+            query.bindValue(":CHANID", chanid);
+            for (int j = 0; j < n; ++j)
+            {
+                query.bindValue(QString(":FROM%1").arg(j),
+                                ranges[i + j].first);
+                query.bindValue(QString(":TO%1").arg(j),
+                                ranges[i + j].second);
+            }
+
+            if (!bulk_exec(query, QString("bulk %1 delete").arg(tables[t])))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+static bool bulk_insert_programs(
+    MSqlQuery &query, uint chanid, const QList<const ProgInfo*> &inserts)
+{
+    for (int i = 0; i < inserts.size(); i += kBulkRows)
+    {
+        int n = min(kBulkRows, inserts.size() - i);
+        QStringList rows;
+        for (int j = 0; j < n; ++j)
+            rows << ProgInfo::GetDBPlaceholders(QString("_%1").arg(j));
+
+        query.prepare(QString("REPLACE INTO program (%1) VALUES %2")
+                      .arg(program_columns).arg(rows.join(", ")));
+        for (int j = 0; j < n; ++j)
+            inserts[i + j]->BindDB(query, chanid, QString("_%1").arg(j));
+
+        if (!bulk_exec(query, "bulk program insert"))
+            return false;
+    }
+
+    // Collect the rating rows
+    QList<QPair<const ProgInfo*, const EventRating*> > ratings;
+    for (int i = 0; i < inserts.size(); ++i)
+    {
+        QList<EventRating>::const_iterator j = inserts[i]->ratings.begin();
+        for (; j != inserts[i]->ratings.end(); ++j)
+            ratings.push_back(qMakePair(inserts[i], &(*j)));
+    }
+
+    for (int i = 0; i < ratings.size(); i += kBulkRows)
+    {
+        int n = min(kBulkRows, ratings.size() - i);
+        QStringList rows;
+        for (int j = 0; j < n; ++j)
+        {
+            rows << QString("(:CHANID%1, :START%1, :SYS%1, :RATING%1)")
+                .arg(j);
+        }
+
+        // every row gets its own placeholders, MSqlQuery does not
+        // support using one placeholder twice in a statement
+        query.prepare("INSERT INTO programrating "
+                      "       ( chanid, starttime, system, rating) "
+                      "VALUES " + rows.join(", "));
+        for (int j = 0; j < n; ++j)
+        {
+            query.bindValue(QString(":CHANID%1").arg(j), chanid);
+            query.bindValue(QString(":START%1").arg(j),
+                            ratings[i + j].first->starttime);
+            query.bindValue(QString(":SYS%1").arg(j),
+                            ratings[i + j].second->system);
+            query.bindValue(QString(":RATING%1").arg(j),
+                            ratings[i + j].second->rating);
+        }
+
+        if (!bulk_exec(query, "bulk programrating insert"))
+            return false;
+    }
+
+    return true;
+}
+
+/** \brief Inserts the credits of \p inserts, creating missing people with
+ *         one statement per batch of names.
+ *
+ *  Names the people lookup does not return verbatim, e.g. ones that only
+ *  match an existing entry case insensitively, go through
+ *  DBPerson::InsertDB() one at a time.
+ */
+static bool bulk_insert_credits(
+    MSqlQuery &query, uint chanid, const QList<const ProgInfo*> &inserts)
+{
+    QList<QPair<const ProgInfo*, const DBPerson*> > credits;
+    QStringList names;
+    for (int i = 0; i < inserts.size(); ++i)
+    {
+        if (!inserts[i]->credits)
+            continue;
+
+        const DBCredits &c = *inserts[i]->credits;
+        for (uint j = 0; j < c.size(); ++j)
+        {
+            credits.push_back(qMakePair(inserts[i], &c[j]));
+            names << c[j].GetName();
+        }
+    }
+
+    if (credits.empty())
+        return true;
+
+    names.removeDuplicates();
+
+    QMap<QString, uint> personids;
+    for (int i = 0; i < names.size(); i += kBulkRows)
+    {
+        int n = min(kBulkRows, names.size() - i);
+        QStringList rows;
+        for (int j = 0; j < n; ++j)
+            rows << QString(":NAME%1").arg(j);
+
+        query.prepare("INSERT IGNORE INTO people (name) VALUES (" +
+                      rows.join("), (") + ")");
+        for (int j = 0; j < n; ++j)
+            query.bindValue(QString(":NAME%1").arg(j), names[i + j]);
+
+        if (!bulk_exec(query, "bulk insert_person"))
+            return false;
+
+        query.prepare("SELECT person, name FROM people "
+                      "WHERE name IN (" + rows.join(", ") + ")");
+        for (int j = 0; j < n; ++j)
+            query.bindValue(QString(":NAME%1").arg(j), names[i + j]);
+
+        if (!bulk_exec(query, "bulk get_person"))
+            return false;
+
+        while (query.next())
+            personids[query.value(1).toString()] = query.value(0).toUInt();
+    }
+
+    QList<QPair<const ProgInfo*, const DBPerson*> > rows;
+    for (int i = 0; i < credits.size(); ++i)
+    {
+        if (personids.contains(credits[i].second->GetName()))
+            rows.push_back(credits[i]);
+        else
+            credits[i].second->InsertDB(query, chanid,
+                                        credits[i].first->starttime);
+    }
+
+    for (int i = 0; i < rows.size(); i += kBulkRows)
+    {
+        int n = min(kBulkRows, rows.size() - i);
+        QStringList values;
+        for (int j = 0; j < n; ++j)
+        {
+            values << QString("(:PERSON%1, :CHANID%1, :STARTTIME%1, :ROLE%1)")
+                .arg(j);
+        }
+
+        query.prepare("REPLACE INTO credits "
+                      "       ( person,  chanid,  starttime,  role) "
+                      "VALUES " + values.join(", "));
+        for (int j = 0; j < n; ++j)
+        {
+            const DBPerson *person = rows[i + j].second;
+            query.bindValue(QString(":CHANID%1").arg(j), chanid);
+            query.bindValue(QString(":PERSON%1").arg(j),
+                            personids[person->GetName()]);
+            query.bindValue(QString(":STARTTIME%1").arg(j),
+                            rows[i + j].first->starttime);
+            query.bindValue(QString(":ROLE%1").arg(j), person->GetRole());
+        }
+
+        if (!bulk_exec(query, "bulk insert_credits"))
+            return false;
+    }
+
+    return true;
+}
+
+/** \fn ProgramData::HandleProgramsBulk(MSqlQuery&,uint,const QList<ProgInfo*>&,uint&,uint&)
+ *  \brief Stores a channel's programmes with a handful of multi-row
+ *         statements instead of several queries per programme.
+ *
+ *  The channel's existing schedule for the window covered by \p sortlist
+ *  is loaded with one query, and the IsUnchanged() / DeleteOverlaps() /
+ *  InsertDB() sequence of HandlePrograms() is replayed against it in
+ *  memory. The resulting deletes and inserts are then applied in one
+ *  transaction.
+ *
+ *  \return false if the database rejected any of it, in which case the
+ *          transaction is rolled back and nothing has been counted.
+ */
+bool ProgramData::HandleProgramsBulk(MSqlQuery             &query,
+                                     uint                   chanid,
+                                     const QList<ProgInfo*> &sortlist,
+                                     uint &unchanged,
+                                     uint &updated)
+{
+    if (sortlist.empty())
+        return true;
+
+    MythTimer t;
+    t.start();
+
+    QDateTime from = sortlist.front()->starttime;
+    QDateTime to   = from;
+    QList<ProgInfo*>::const_iterator it = sortlist.begin();
+    for (; it != sortlist.end(); ++it)
+    {
+        from = min(from, (*it)->starttime);
+        to   = max(to, (*it)->starttime.addSecs(1));
+        if ((*it)->endtime.isValid())
+            to = max(to, (*it)->endtime);
+    }
+
+    existing_programs_t existing;
+    if (!load_existing_programs(query, chanid, from, to, existing))
+        return false;
+
+    QMap<QDateTime, const ProgInfo*> inserts;
+    QList<time_range_t> ranges;
+    uint nunchanged = 0;
+
+    for (it = sortlist.begin(); it != sortlist.end(); ++it)
+    {
+        const ProgInfo &pi = **it;
+
+        bool same = false;
+        existing_programs_t::const_iterator e = existing.find(pi.starttime);
+        for (; !same && e != existing.end() && e.key() == pi.starttime; ++e)
+            same = e->Matches(pi);
+
+        if (same)
+        {
+            nunchanged++;
+            continue;
+        }
+
+        // ClearDataByChannel(starttime, endtime), done in memory
+        if (pi.endtime.isValid() && pi.starttime < pi.endtime)
+        {
+            if (!ranges.empty() && ranges.back().second >= pi.starttime)
+                ranges.back().second = max(ranges.back().second, pi.endtime);
+            else
+                ranges.push_back(time_range_t(pi.starttime, pi.endtime));
+
+            existing_programs_t::iterator d =
+                existing.lowerBound(pi.starttime);
+            while (d != existing.end() && d.key() < pi.endtime)
+            {
+                LOG(VB_XMLTV, LOG_INFO,
+                    QString("Removing existing program: %1 - %2 %3 %4")
+                    .arg(d.key().toString(Qt::ISODate))
+                    .arg(d->endtime.toString(Qt::ISODate))
+                    .arg(pi.channel).arg(d->title));
+                d = existing.erase(d);
+            }
+
+            QMap<QDateTime, const ProgInfo*>::iterator i =
+                inserts.lowerBound(pi.starttime);
+            while (i != inserts.end() && i.key() < pi.endtime)
+                i = inserts.erase(i);
+        }
+
+        LOG(VB_XMLTV, LOG_INFO,
+            QString("Inserting new program    : %1 - %2 %3 %4")
+                .arg(pi.starttime.toString(Qt::ISODate))
+                .arg(pi.endtime.toString(Qt::ISODate))
+                .arg(pi.channel)
+                .arg(pi.title));
+
+        // REPLACE INTO replaces the row with the same start time
+        existing.remove(pi.starttime);
+        inserts[pi.starttime] = &pi;
+    }
+
+    QList<const ProgInfo*> insertlist = inserts.values();
+
+    bool ok = query.exec("START TRANSACTION") &&
+        bulk_delete_ranges(query, chanid, ranges) &&
+        bulk_insert_programs(query, chanid, insertlist) &&
+        bulk_insert_credits(query, chanid, insertlist) &&
+        query.exec("COMMIT");
+
+    if (!ok)
+    {
+        query.exec("ROLLBACK");
+        return false;
+    }
+
+    unchanged += nunchanged;
+    updated   += insertlist.size();
+
+    LOG(VB_XMLTV, LOG_INFO,
+        QString("Channel %1: %2 programs, %3 updated, %4 unchanged, "
+                "%5 deleted ranges in %6 ms")
+            .arg(chanid).arg(sortlist.size()).arg(insertlist.size())
+            .arg(nunchanged).arg(ranges.size()).arg(t.elapsed()));
+
+    return true;
+}
+
 int ProgramData::fix_end_times(void)
 {
     int count = 0;
@@ -21,6 +21,7 @@ using namespace std;
 #include "eithelper.h" /* for FixupValue */
 
 class MSqlQuery;
+class DBEventWindow;
 
 class MTV_PUBLIC DBPerson
 {
@@ -46,6 +47,7 @@ class MTV_PUBLIC DBPerson
     DBPerson(const QString &_role, const QString &_name);
 
     QString GetRole(void) const;
+    QString GetName(void) const { return name; }
 
     uint InsertDB(MSqlQuery &query, uint chanid,
                   const QDateTime &starttime) const;
@@ -137,7 +139,8 @@ class MTV_PUBLIC DBEvent
     void AddPerson(DBPerson::Role, const QString &name);
     void AddPerson(const QString &role, const QString &name);
 
-    uint UpdateDB(MSqlQuery &query, uint chanid, int match_threshold) const;
+    uint UpdateDB(MSqlQuery &query, uint chanid, int match_threshold,
+                  DBEventWindow *window = NULL) const;
 
     bool HasCredits(void) const { return credits; }
     bool HasTimeConflict(const DBEvent &other) const;
@@ -150,11 +153,14 @@ class MTV_PUBLIC DBEvent
     int  GetMatch(
         const vector<DBEvent> &programs, int &bestmatch) const;
     uint UpdateDB(
-        MSqlQuery&, uint chanid, const vector<DBEvent> &p, int match) const;
+        MSqlQuery&, uint chanid, const vector<DBEvent> &p, int match,
+        DBEventWindow *window) const;
     uint UpdateDB(
-        MSqlQuery&, uint chanid, const DBEvent &match) const;
+        MSqlQuery&, uint chanid, const DBEvent &match,
+        DBEventWindow *window) const;
     bool MoveOutOfTheWayDB(
-        MSqlQuery&, uint chanid, const DBEvent &nonmatch) const;
+        MSqlQuery&, uint chanid, const DBEvent &nonmatch,
+        DBEventWindow *window) const;
     virtual uint InsertDB(MSqlQuery&, uint chanid) const;
     virtual void Squeeze(void);
 
@@ -230,6 +236,9 @@ class MTV_PUBLIC DBEventEIT : public DBEvent
         return DBEvent::UpdateDB(query, chanid, match_threshold);
     }
 
+    static uint UpdateDB(MSqlQuery &query, const QList<DBEventEIT*> &events,
+                         int match_threshold);
+
   public:
     uint32_t      chanid;
     FixupValue    fixup;
@@ -255,6 +264,9 @@ class MTV_PUBLIC ProgInfo : public DBEvent
 
     uint InsertDB(MSqlQuery &query, uint chanid) const;
 
+    static QString GetDBPlaceholders(const QString &suffix);
+    void BindDB(MSqlQuery &query, uint chanid, const QString &suffix) const;
+
     void Squeeze(void);
 
     ProgInfo &operator=(const ProgInfo&);
@@ -276,6 +288,9 @@ class MTV_PUBLIC ProgramData
   public:
     static void HandlePrograms(uint sourceid,
                                QMap<QString, QList<ProgInfo> > &proglist);
+    static void HandlePrograms(uint sourceid,
+                               QMap<QString, QList<ProgInfo> > &proglist,
+                               uint &unchanged, uint &updated);
 
     static int  fix_end_times(void);
     static bool ClearDataByChannel(
@@ -295,6 +310,10 @@ class MTV_PUBLIC ProgramData
         MSqlQuery &query, uint chanid,
         const QList<ProgInfo*> &sortlist,
         uint &unchanged, uint &updated);
+    static bool HandleProgramsBulk(
+        MSqlQuery &query, uint chanid,
+        const QList<ProgInfo*> &sortlist,
+        uint &unchanged, uint &updated);
     static bool IsUnchanged(
         MSqlQuery &query, uint chanid, const ProgInfo &pi);
     static bool DeleteOverlaps(
@@ -23,6 +23,7 @@
 #include "dvbstreamdata.h"
 #include "dtvrecorder.h"
 #include "programinfo.h"
+#include "seekindex.h"
 #include "mythlogging.h"
 #include "mpegtables.h"
 #include "ringbuffer.h"
@@ -174,6 +175,19 @@ void DTVRecorder::FinishRecording(void)
     }
 
     RecorderBase::FinishRecording();
+
+    if (curRecording && ringBuffer)
+    {
+        // The maps are implicitly shared, so copying them is cheap
+        positionMapLock.lock();
+        MarkTypes     type   = positionMapType;
+        frm_pos_map_t posMap = positionMap;
+        frm_pos_map_t durMap = durationMap;
+        positionMapLock.unlock();
+
+        SeekIndex::Write(ringBuffer->GetFilename(),
+                         ringBuffer->GetRealFileSize(), type, posMap, durMap);
+    }
 }
 
 void DTVRecorder::ResetForNewFile(void)
@@ -181,7 +195,7 @@ void DTVRecorder::ResetForNewFile(void)
     LOG(VB_RECORD, LOG_INFO, LOC + "ResetForNewFile(void)");
     QMutexLocker locker(&positionMapLock);
 
-    // _seen_psp and m_h264_parser should
+    // _seen_psp, m_h264_parser and m_hevc_parser should
     // not be reset here. This will only be called just as
     // we're seeing the first packet of a new keyframe for
     // writing to the new file and anything that makes the
@@ -827,6 +841,71 @@ void DTVRecorder::HandleKeyframe(int64_t extra)
     positionMapLock.unlock();
 }
 
+/** \brief Moves past the PES header at the start of a TS packet payload.
+ *  \param tspacket TS packet with the payload unit start indicator set.
+ *  \param i Offset of the PES start code, on success the offset of
+ *           the last byte of the PES header.
+ *  \return Returns false if no PES header could be found.
+ */
+bool DTVRecorder::SyncPES(const TSPacket *tspacket, uint &i)
+{
+    // bounds check
+    if (i + 2 >= TSPacket::kSize)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC +
+            "PES packet start code may overflow to next TS packet, "
+            "aborting keyframe search");
+        return false;
+    }
+
+    // must find the PES start code
+    if (tspacket->data()[i++] != 0x00 ||
+        tspacket->data()[i++] != 0x00 ||
+        tspacket->data()[i++] != 0x01)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC +
+            "PES start code not found in TS packet with PUSI set");
+        return false;
+    }
+
+    // bounds check
+    if (i + 5 >= TSPacket::kSize)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC +
+            "PES packet headers overflow to next TS packet, "
+            "aborting keyframe search");
+        return false;
+    }
+
+    // now we need to compute where the PES payload begins
+    // skip past the stream_id (+1)
+    // the next two bytes are the PES packet length (+2)
+    // after that, one byte of PES packet control bits (+1)
+    // after that, one byte of PES header flags bits (+1)
+    // and finally, one byte for the PES header length
+    const unsigned char pes_header_length = tspacket->data()[i + 5];
+
+    // bounds check
+    if ((i + 6 + pes_header_length) >= TSPacket::kSize)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC +
+            "PES packet headers overflow to next TS packet, "
+            "aborting keyframe search");
+        return false;
+    }
+
+    // we now know where the PES payload is
+    // normally, we should have used 6, but use 5 because the caller's
+    // loop will bump i
+    i += 5 + pes_header_length;
+    _pes_synced = true;
+
+#if 0
+    LOG(VB_RECORD, LOG_DEBUG, LOC + "PES synced");
+#endif
+    return true;
+}
+
 /** \fn DTVRecorder::FindH264Keyframes(const TSPacket*)
  *  \brief This searches the TS packet to identify keyframes.
  *  \param TSPacket Pointer the the TS packet data.
@@ -866,60 +945,8 @@ bool DTVRecorder::FindH264Keyframes(const TSPacket *tspacket)
         // special handling required when a new PES packet begins
         if (payloadStart && !_pes_synced)
         {
-            // bounds check
-            if (i + 2 >= TSPacket::kSize)
-            {
-                LOG(VB_GENERAL, LOG_ERR, LOC +
-                    "PES packet start code may overflow to next TS packet, "
-                    "aborting keyframe search");
-                break;
-            }
-
-            // must find the PES start code
-            if (tspacket->data()[i++] != 0x00 ||
-                tspacket->data()[i++] != 0x00 ||
-                tspacket->data()[i++] != 0x01)
-            {
-                LOG(VB_GENERAL, LOG_ERR, LOC +
-                    "PES start code not found in TS packet with PUSI set");
+            if (!SyncPES(tspacket, i))
                 break;
-            }
-
-            // bounds check
-            if (i + 5 >= TSPacket::kSize)
-            {
-                LOG(VB_GENERAL, LOG_ERR, LOC +
-                    "PES packet headers overflow to next TS packet, "
-                    "aborting keyframe search");
-                break;
-            }
-
-            // now we need to compute where the PES payload begins
-            // skip past the stream_id (+1)
-            // the next two bytes are the PES packet length (+2)
-            // after that, one byte of PES packet control bits (+1)
-            // after that, one byte of PES header flags bits (+1)
-            // and finally, one byte for the PES header length
-            const unsigned char pes_header_length = tspacket->data()[i + 5];
-
-            // bounds check
-            if ((i + 6 + pes_header_length) >= TSPacket::kSize)
-            {
-                LOG(VB_GENERAL, LOG_ERR, LOC +
-                    "PES packet headers overflow to next TS packet, "
-                    "aborting keyframe search");
-                break;
-            }
-
-            // we now know where the PES payload is
-            // normally, we should have used 6, but use 5 because the for
-            // loop will bump i
-            i += 5 + pes_header_length;
-            _pes_synced = true;
-
-#if 0
-            LOG(VB_RECORD, LOG_DEBUG, LOC + "PES synced");
-#endif
             continue;
         }
 
@@ -973,7 +1000,7 @@ bool DTVRecorder::FindH264Keyframes(const TSPacket *tspacket)
             .arg(m_h264_parser.keyframeAUstreamOffset()));
 
         _last_keyframe_seen = _frames_seen_count;
-        HandleH264Keyframe();
+        HandleAUKeyframe(m_h264_parser.keyframeAUstreamOffset());
     }
 
     if (hasFrame)
@@ -1024,11 +1051,146 @@ bool DTVRecorder::FindH264Keyframes(const TSPacket *tspacket)
     return _seen_sps;
 }
 
-/** \fn DTVRecorder::HandleH264Keyframe(void)
+/** \fn DTVRecorder::FindHEVCKeyframes(const TSPacket*)
+ *  \brief This searches the TS packet to identify H.265 keyframes.
+ *
+ *  Works like FindH264Keyframes(), except that HEVC has no field
+ *  pictures to skip over and any IRAP picture counts as a keyframe.
+ *
+ *  \param TSPacket Pointer the the TS packet data.
+ *  \return Returns true if a keyframe has been found.
+ */
+bool DTVRecorder::FindHEVCKeyframes(const TSPacket *tspacket)
+{
+    if (!tspacket->HasPayload()) // no payload to scan
+        return _first_keyframe >= 0;
+
+    if (!ringBuffer)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + "FindHEVCKeyframes: No ringbuffer");
+        return _first_keyframe >= 0;
+    }
+
+    const bool payloadStart = tspacket->PayloadStart();
+    if (payloadStart)
+    {
+        // reset PES sync state
+        _pes_synced = false;
+        _start_code = 0xffffffff;
+    }
+
+    uint aspectRatio = 0;
+    uint height = 0;
+    uint width = 0;
+    FrameRate frameRate(0);
+
+    bool hasFrame = false;
+    bool hasKeyFrame = false;
+
+    // scan for PES packets and H.265 NAL units
+    uint i = tspacket->AFCOffset();
+    for (; i < TSPacket::kSize; ++i)
+    {
+        if (payloadStart && !_pes_synced)
+        {
+            if (!SyncPES(tspacket, i))
+                break;
+            continue;
+        }
+
+        if (!_pes_synced)
+            break;
+
+        uint32_t bytes_used = m_hevc_parser.addBytes
+                              (tspacket->data() + i, TSPacket::kSize - i,
+                               ringBuffer->GetWritePosition());
+        i += (bytes_used - 1);
+
+        if (m_hevc_parser.stateChanged() && m_hevc_parser.onFrameStart())
+        {
+            hasKeyFrame = m_hevc_parser.onKeyFrameStart();
+            hasFrame = true;
+            _seen_sps |= hasKeyFrame;
+
+            width = m_hevc_parser.pictureWidth();
+            height = m_hevc_parser.pictureHeight();
+            aspectRatio = m_hevc_parser.aspectRatio();
+            m_hevc_parser.getFrameRate(frameRate);
+        }
+    } // for (; i < TSPacket::kSize; ++i)
+
+    // If it has been more than 511 frames since the last keyframe,
+    // pretend we have one.
+    if (hasFrame && !hasKeyFrame &&
+        (_frames_seen_count - _last_keyframe_seen) > 511)
+    {
+        hasKeyFrame = true;
+        LOG(VB_RECORD, LOG_WARNING, LOC +
+            QString("FindHEVCKeyframes: %1 frames without a keyframe.")
+            .arg(_frames_seen_count - _last_keyframe_seen));
+    }
+
+    // _buffer_packets will only be true if a payload start has been seen
+    if (hasKeyFrame && (_buffer_packets || _first_keyframe >= 0))
+    {
+        LOG(VB_RECORD, LOG_DEBUG, LOC + QString
+            ("Keyframe @ %1 + %2 = %3 AU %4")
+            .arg(ringBuffer->GetWritePosition())
+            .arg(_payload_buffer.size())
+            .arg(ringBuffer->GetWritePosition() + _payload_buffer.size())
+            .arg(m_hevc_parser.keyframeAUstreamOffset()));
+
+        _last_keyframe_seen = _frames_seen_count;
+        HandleAUKeyframe(m_hevc_parser.keyframeAUstreamOffset());
+    }
+
+    if (hasFrame)
+    {
+        _buffer_packets = false;  // We now know if this is a keyframe
+        _frames_seen_count++;
+        if (!_wait_for_keyframe_option || _first_keyframe >= 0)
+            UpdateFramesWritten();
+        else
+        {
+            /* Found a frame that is not a keyframe, and we want to
+             * start on a keyframe */
+            _payload_buffer.clear();
+        }
+    }
+
+    if ((aspectRatio > 0) && (aspectRatio != m_videoAspect))
+    {
+        m_videoAspect = aspectRatio;
+        AspectChange((AspectRatio)aspectRatio, _frames_written_count);
+    }
+
+    if (height && width && (height != m_videoHeight || m_videoWidth != width))
+    {
+        m_videoHeight = height;
+        m_videoWidth = width;
+        ResolutionChange(width, height, _frames_written_count);
+    }
+
+    if (frameRate.isNonzero() && frameRate != m_frameRate)
+    {
+        LOG(VB_RECORD, LOG_INFO, LOC +
+            QString("FindHEVCKeyframes: timescale: %1, tick: %2, framerate: %3")
+                      .arg( m_hevc_parser.GetTimeScale() )
+                      .arg( m_hevc_parser.GetUnitsInTick() )
+                      .arg( frameRate.toDouble() * 1000 ) );
+        m_frameRate = frameRate;
+        FrameRateChange(frameRate.toDouble() * 1000, _frames_written_count);
+    }
+
+    return _seen_sps;
+}
+
+/** \fn DTVRecorder::HandleAUKeyframe(uint64_t)
  *  \brief This save the current frame to the position maps
  *         and handles ringbuffer switching.
+ *  \param keyframe_offset Stream offset of the keyframe's access unit.
  */
-void DTVRecorder::HandleH264Keyframe(void)
+void DTVRecorder::HandleAUKeyframe(uint64_t keyframe_offset)
 {
     // Perform ringbuffer switch if needed.
     CheckForRingBufferSwitch();
@@ -1043,7 +1205,7 @@ void DTVRecorder::HandleH264Keyframe(void)
         SendMythSystemRecEvent("REC_STARTED_WRITING", curRecording);
     }
     else
-        startpos = m_h264_parser.keyframeAUstreamOffset();
+        startpos = keyframe_offset;
 
     // Add key frame to position map
     positionMapLock.lock();
@@ -1489,6 +1651,66 @@ bool DTVRecorder::ProcessTSPacket(const TSPacket &tspacket)
     return true;
 }
 
+/** \fn DTVRecorder::ProcessTSPackets(const TSPacket*,uint)
+ *  \brief Handles a run of packets that share one PID like
+ *         ProcessTSPacket(), deciding once whether the PID is written.
+ */
+bool DTVRecorder::ProcessTSPackets(const TSPacket *tspackets, uint count)
+{
+    if (!count)
+        return true;
+
+    const uint pid = tspackets[0].PID();
+
+    if (pid != 0x1fff)
+    {
+        _packet_count.fetchAndAddAcquire(count);
+
+        // Check continuity counter
+        for (uint i = 0; i < count; i++)
+        {
+            uint old_cnt = _continuity_counter[pid];
+            if (!CheckCC(pid, tspackets[i].ContinuityCounter()))
+            {
+                int v = _continuity_error_count.fetchAndAddRelaxed(1) + 1;
+                double erate = v * 100.0 / _packet_count.fetchAndAddRelaxed(0);
+                LOG(VB_RECORD, LOG_WARNING, LOC +
+                    QString("PID 0x%1 discontinuity detected "
+                            "((%2+1)%16!=%3) %4%")
+                        .arg(pid,0,16).arg(old_cnt,2)
+                        .arg(tspackets[i].ContinuityCounter(),2)
+                        .arg(erate));
+            }
+        }
+    }
+
+    // Only create fake keyframe[s] if there are no audio/video streams
+    if (_input_pmt && _has_no_av)
+    {
+        for (uint i = 0; i < count; i++)
+        {
+            FindOtherKeyframes(&tspackets[i]);
+            _buffer_packets = false;
+            BufferedWrite(tspackets[i]);
+        }
+        return true;
+    }
+
+    // Ignore these packets if the PID should be stripped
+    if (_stream_id[pid] == 0)
+        return true;
+
+    // There are audio/video streams. Only write the packets
+    // if audio/video key-frames have been found
+    if (_wait_for_keyframe_option && _first_keyframe < 0)
+        return true;
+
+    for (uint i = 0; i < count; i++)
+        BufferedWrite(tspackets[i]);
+
+    return true;
+}
+
 bool DTVRecorder::ProcessVideoTSPacket(const TSPacket &tspacket)
 {
     if (!ringBuffer)
@@ -1513,6 +1735,8 @@ bool DTVRecorder::ProcessVideoTSPacket(const TSPacket &tspacket)
     // Check for keyframes and count frames
     if (streamType == StreamID::H264Video)
         FindH264Keyframes(&tspacket);
+    else if (streamType == StreamID::H265Video)
+        FindHEVCKeyframes(&tspacket);
     else if (streamType != 0)
         FindMPEG2Keyframes(&tspacket);
     else
@@ -1545,6 +1769,87 @@ bool DTVRecorder::ProcessAudioTSPacket(const TSPacket &tspacket)
     return ProcessAVTSPacket(tspacket);
 }
 
+/** \fn DTVRecorder::ProcessVideoTSPackets(const TSPacket*,uint)
+ *  \brief Handles a run of video packets that share one PID, the stream
+ *         type and keyframe finder are picked once for the run.
+ */
+bool DTVRecorder::ProcessVideoTSPackets(const TSPacket *tspackets, uint count)
+{
+    if (!ringBuffer || !count)
+        return true;
+
+    uint streamType = _stream_id[tspackets[0].PID()];
+    if (streamType == 0)
+    {
+        LOG(VB_RECORD, LOG_ERR, LOC +
+            "ProcessVideoTSPackets: unknown stream type!");
+    }
+
+    for (uint i = 0; i < count; i++)
+    {
+        const TSPacket &tspacket = tspackets[i];
+
+        if (tspacket.HasPayload() && tspacket.PayloadStart())
+        {
+            if (_buffer_packets && _first_keyframe >= 0 &&
+                !_payload_buffer.empty())
+            {
+                // Flush the buffer
+                ringBuffer->Write(&_payload_buffer[0], _payload_buffer.size());
+                _payload_buffer.clear();
+            }
+
+            // buffer packets until we know if this is a keyframe
+            _buffer_packets = true;
+        }
+
+        // Check for keyframes and count frames
+        if (streamType == StreamID::H264Video)
+            FindH264Keyframes(&tspacket);
+        else if (streamType == StreamID::H265Video)
+            FindHEVCKeyframes(&tspacket);
+        else if (streamType != 0)
+            FindMPEG2Keyframes(&tspacket);
+
+        ProcessAVTSPacket(tspacket);
+    }
+
+    return true;
+}
+
+/** \fn DTVRecorder::ProcessAudioTSPackets(const TSPacket*,uint)
+ *  \brief Handles a run of audio packets that share one PID.
+ */
+bool DTVRecorder::ProcessAudioTSPackets(const TSPacket *tspackets, uint count)
+{
+    if (!ringBuffer)
+        return true;
+
+    for (uint i = 0; i < count; i++)
+    {
+        const TSPacket &tspacket = tspackets[i];
+
+        if (tspacket.HasPayload() && tspacket.PayloadStart())
+        {
+            if (_buffer_packets && _first_keyframe >= 0 &&
+                !_payload_buffer.empty())
+            {
+                // Flush the buffer
+                ringBuffer->Write(&_payload_buffer[0], _payload_buffer.size());
+                _payload_buffer.clear();
+            }
+
+            // buffer packets until we know if this is a keyframe
+            _buffer_packets = true;
+        }
+
+        FindAudioKeyframes(&tspacket);
+        ProcessAVTSPacket(tspacket);
+    }
+
+    return true;
+}
+
 /// Common code for processing either audio or video packets
 bool DTVRecorder::ProcessAVTSPacket(const TSPacket &tspacket)
 {
@@ -19,6 +19,7 @@ using namespace std;
 #include "streamlisteners.h"
 #include "recorderbase.h"
 #include "H264Parser.h"
+#include "HEVCParser.h"
 
 class MPEGStreamData;
 class TSPacket;
@@ -82,10 +83,13 @@ class DTVRecorder :
 
     // TSPacketListener
     bool ProcessTSPacket(const TSPacket &tspacket);
+    bool ProcessTSPackets(const TSPacket *tspackets, uint count);
 
     // TSPacketListenerAV
     bool ProcessVideoTSPacket(const TSPacket& tspacket);
     bool ProcessAudioTSPacket(const TSPacket& tspacket);
+    bool ProcessVideoTSPackets(const TSPacket *tspackets, uint count);
+    bool ProcessAudioTSPackets(const TSPacket *tspackets, uint count);
 
     // Common audio/visual processing
     bool ProcessAVTSPacket(const TSPacket &tspacket);
@@ -110,7 +114,11 @@ class DTVRecorder :
 
     // MPEG4 AVC / H.264 TS support
     bool FindH264Keyframes(const TSPacket* tspacket);
-    void HandleH264Keyframe(void);
+    void HandleAUKeyframe(uint64_t keyframe_offset);
+    bool SyncPES(const TSPacket *tspacket, uint &i);
+
+    // MPEG-H HEVC / H.265 TS support
+    bool FindHEVCKeyframes(const TSPacket* tspacket);
 
     // MPEG2 PS support (Hauppauge PVR-x50/PVR-500)
     virtual void FindPSKeyFrames(const uint8_t *buffer, uint len);
@@ -144,10 +152,11 @@ class DTVRecorder :
     int _progressive_sequence;
     int _repeat_pict;
 
-    // H.264 support
+    // H.264 and H.265 support
     bool _pes_synced;
     bool _seen_sps;
     H264Parser m_h264_parser;
+    HEVCParser m_hevc_parser;
 
     /// Wait for the a GOP/SEQ-start before sending data
     bool _wait_for_keyframe_option;
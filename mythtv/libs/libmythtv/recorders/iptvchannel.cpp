@@ -156,6 +156,16 @@ bool IPTVChannel::IsOpen(void) const
     return ret;
 }
 
+/// \copydoc IPTVStreamHandler::GetFECCounts
+bool IPTVChannel::GetFECCounts(
+    uint64_t &recovered, uint64_t &unrecoverable) const
+{
+    QMutexLocker locker(&m_stream_lock);
+    recovered = unrecoverable = 0;
+    return m_stream_handler &&
+        m_stream_handler->GetFECCounts(recovered, unrecoverable);
+}
+
 bool IPTVChannel::Tune(const IPTVTuningData &tuning, bool scanning)
 {
     QMutexLocker locker(&m_tune_lock);
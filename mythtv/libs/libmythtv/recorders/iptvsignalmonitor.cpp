@@ -26,7 +26,11 @@ IPTVSignalMonitor::IPTVSignalMonitor(int db_cardnum,
                                      IPTVChannel *_channel,
                                      uint64_t _flags) :
     DTVSignalMonitor(db_cardnum, _channel, _flags),
-    m_streamHandlerStarted(false), m_locked(false)
+    m_streamHandlerStarted(false), m_locked(false), m_hasFEC(false),
+    m_fecRecovered    (tr("FEC Recovered Packets"), "fecrec",
+                       65535, false, 0, 65535, 0),
+    m_fecUnrecoverable(tr("Uncorrected Packets"),   "ucp",
+                       65535, false, 0, 65535, 0)
 {
     LOG(VB_CHANNEL, LOG_INFO, LOC + "ctor");
     signalLock.SetValue(0);
@@ -59,6 +63,19 @@ void IPTVSignalMonitor::Stop(void)
     LOG(VB_CHANNEL, LOG_INFO, LOC + "Stop() -- end");
 }
 
+QStringList IPTVSignalMonitor::GetStatusList(void) const
+{
+    QStringList list = DTVSignalMonitor::GetStatusList();
+    QMutexLocker locker(&statusLock);
+    if (m_hasFEC)
+    {
+        list << m_fecRecovered.GetName() << m_fecRecovered.GetStatus();
+        list << m_fecUnrecoverable.GetName()
+             << m_fecUnrecoverable.GetStatus();
+    }
+    return list;
+}
+
 void IPTVSignalMonitor::SetStreamData(MPEGStreamData *data)
 {
     DTVSignalMonitor::SetStreamData(data);
@@ -91,6 +108,18 @@ void IPTVSignalMonitor::UpdateValues(void)
         m_locked = true;
     }
 
+    // The counts are cumulative, like the DVB uncorrected blocks they
+    // are clamped at 64K rather than normalized to a time period.
+    uint64_t recovered, unrecoverable;
+    bool has_fec = GetIPTVChannel()->GetFECCounts(recovered, unrecoverable);
+    {
+        QMutexLocker locker(&statusLock);
+        m_hasFEC = has_fec;
+        m_fecRecovered.SetValue((int) min(recovered, (uint64_t)65535));
+        m_fecUnrecoverable.SetValue(
+            (int) min(unrecoverable, (uint64_t)65535));
+    }
+
     EmitStatus();
     if (IsAllGood())
         SendMessageAllGood();
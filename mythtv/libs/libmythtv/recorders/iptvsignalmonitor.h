@@ -18,6 +18,8 @@ class IPTVSignalMonitor : public DTVSignalMonitor
 
     void Stop(void);
 
+    virtual QStringList GetStatusList(void) const;
+
     // DTVSignalMonitor
     virtual void SetStreamData(MPEGStreamData *data);
 
@@ -34,6 +36,9 @@ class IPTVSignalMonitor : public DTVSignalMonitor
   protected:
     bool m_streamHandlerStarted;
     bool m_locked;
+    bool m_hasFEC;
+    SignalMonitorValue m_fecRecovered;
+    SignalMonitorValue m_fecUnrecoverable;
 };
 
 #endif // _IPTVSIGNALMONITOR_H_
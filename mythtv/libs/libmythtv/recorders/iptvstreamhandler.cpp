@@ -11,6 +11,7 @@
 #endif
 
 // Qt headers
+#include <QSocketNotifier>
 #include <QUdpSocket>
 #include <QByteArray>
 #include <QHostInfo>
@@ -23,6 +24,7 @@
 #include "rtpdatapacket.h"
 #include "rtpfecpacket.h"
 #include "rtcpdatapacket.h"
+#include "udpbatchreader.h"
 #include "mythlogging.h"
 #include "cetonrtsp.h"
 
@@ -111,7 +113,9 @@ IPTVStreamHandler::IPTVStreamHandler(const IPTVTuningData &tuning) :
     m_buffer(NULL),
     m_rtsp_rtp_port(0),
     m_rtsp_rtcp_port(0),
-    m_rtsp_ssrc(0)
+    m_rtsp_ssrc(0),
+    m_fec_recovered(0),
+    m_fec_unrecoverable(0)
 {
     memset(m_sockets, 0, sizeof(m_sockets));
     memset(m_read_helpers, 0, sizeof(m_read_helpers));
@@ -313,6 +317,13 @@ void IPTVStreamHandler::run(void)
         exec();
     }
 
+    if (m_fec_recovered || m_fec_unrecoverable)
+    {
+        LOG(VB_RECORD, LOG_INFO, LOC +
+            QString("FEC rebuilt %1 packets, %2 packets were lost")
+            .arg(m_fec_recovered).arg(m_fec_unrecoverable));
+    }
+
     // Clean up
     for (uint i = 0; i < IPTV_SOCKET_COUNT; i++)
     {
@@ -339,19 +350,41 @@ void IPTVStreamHandler::run(void)
     RunEpilog();
 }
 
+/** \brief Returns the number of packets rebuilt from the FEC streams and
+ *         the number that could not be, since the stream was opened.
+ *  \return false if the stream doesn't have FEC streams
+ */
+bool IPTVStreamHandler::GetFECCounts(
+    uint64_t &recovered, uint64_t &unrecoverable) const
+{
+    QMutexLocker locker(&m_fec_lock);
+    recovered     = m_fec_recovered;
+    unrecoverable = m_fec_unrecoverable;
+    return m_tuning.GetFECType() != IPTVTuningData::kNone;
+}
+
 IPTVStreamHandlerReadHelper::IPTVStreamHandlerReadHelper(
     IPTVStreamHandler *p, QUdpSocket *s, uint stream) :
     m_parent(p), m_socket(s), m_sender(p->m_sender[stream]),
-    m_stream(stream)
+    m_stream(stream), m_batched(UDPBatchReader::IsSupported()),
+    m_notifier(NULL), m_reader(NULL)
 {
     connect(m_socket, SIGNAL(readyRead()),
             this,     SLOT(ReadPending()));
 }
 
+IPTVStreamHandlerReadHelper::~IPTVStreamHandlerReadHelper()
+{
+    delete m_reader;
+}
+
 #define LOC_WH QString("IPTVSH(%1): ").arg(m_parent->_device)
 
 void IPTVStreamHandlerReadHelper::ReadPending(void)
 {
+    if (m_batched && ReadBatches())
+        return;
+
     QHostAddress sender;
     quint16 senderPort;
     bool sender_null = m_sender.isNull();
@@ -404,6 +437,47 @@ void IPTVStreamHandlerReadHelper::ReadPending(void)
     }
 }
 
+/** \brief Reads the socket with UDPBatchReader.
+ *  \return false if it has to be read with QUdpSocket instead
+ */
+bool IPTVStreamHandlerReadHelper::ReadBatches(void)
+{
+    int fd = m_socket->socketDescriptor();
+
+    if (!m_reader)
+    {
+        m_reader = new UDPBatchReader(m_parent->m_buffer, (int)m_stream - 1);
+        m_reader->SetSender(m_sender);
+
+        // QUdpSocket doesn't emit readyRead() again until a datagram is
+        // read through it, so watch the descriptor from now on
+        m_notifier = new QSocketNotifier(fd, QSocketNotifier::Read, this);
+        connect(m_notifier, SIGNAL(activated(int)),
+                this,       SLOT(ReadPending()));
+    }
+
+    uint rejected = 0;
+    int count = m_reader->Read(fd, rejected);
+
+    if (rejected)
+    {
+        LOG(VB_RECORD, LOG_WARNING, LOC_WH +
+            QString("Received %1 datagrams on socket(%2) from non expected "
+                    "senders (expected:%3) ignoring")
+            .arg(rejected).arg(m_stream).arg(m_sender.toString()));
+    }
+
+    if (count >= 0)
+        return true;
+
+    LOG(VB_RECORD, LOG_INFO, LOC_WH +
+        QString("Batched reads unavailable on socket(%1), "
+                "reading one datagram at a time").arg(m_stream));
+    m_notifier->setEnabled(false);
+    m_batched = false;
+    return false;
+}
+
 IPTVStreamHandlerWriteHelper::IPTVStreamHandlerWriteHelper(IPTVStreamHandler *p)
   : m_parent(p),                m_timer(0),             m_timer_rtcp(0),
     m_last_sequence_number(0),  m_last_timestamp(0),    m_previous_last_sequence_number(0),
@@ -434,6 +508,14 @@ void IPTVStreamHandlerWriteHelper::timerEvent(QTimerEvent* event)
         return;
     }
 
+    {
+        QMutexLocker locker(&m_parent->m_fec_lock);
+        m_parent->m_fec_recovered =
+            m_parent->m_buffer->GetRecoveredPacketCount();
+        m_parent->m_fec_unrecoverable =
+            m_parent->m_buffer->GetUnrecoverablePacketCount();
+    }
+
     if (!m_parent->m_buffer->HasAvailablePacket())
         return;
 
@@ -26,6 +26,8 @@ class DTVSignalMonitor;
 class MPEGStreamData;
 class PacketBuffer;
 class IPTVChannel;
+class UDPBatchReader;
+class QSocketNotifier;
 
 class IPTVStreamHandlerReadHelper : QObject
 {
@@ -34,15 +36,22 @@ class IPTVStreamHandlerReadHelper : QObject
   public:
     IPTVStreamHandlerReadHelper(
         IPTVStreamHandler *p, QUdpSocket *s, uint stream);
+    ~IPTVStreamHandlerReadHelper();
 
   public slots:
     void ReadPending(void);
 
+  private:
+    bool ReadBatches(void);
+
   private:
     IPTVStreamHandler *m_parent;
     QUdpSocket *m_socket;
     QHostAddress m_sender;
     uint m_stream;
+    bool m_batched;
+    QSocketNotifier *m_notifier;
+    UDPBatchReader *m_reader;
 };
 
 class IPTVStreamHandlerWriteHelper : QObject
@@ -90,6 +99,8 @@ class IPTVStreamHandler : public StreamHandler
         StreamHandler::AddListener(data, false, false, output_file);
     } // StreamHandler
 
+    bool GetFECCounts(uint64_t &recovered, uint64_t &unrecoverable) const;
+
   protected:
     IPTVStreamHandler(const IPTVTuningData &tuning);
 
@@ -108,6 +119,10 @@ class IPTVStreamHandler : public StreamHandler
     uint32_t m_rtsp_ssrc;
     QHostAddress m_rtcp_dest;
 
+    mutable QMutex m_fec_lock;
+    uint64_t m_fec_recovered;     // protected by m_fec_lock
+    uint64_t m_fec_unrecoverable; // protected by m_fec_lock
+
     // for implementing Get & Return
     static QMutex                            s_iptvhandlers_lock;
     static QMap<QString, IPTVStreamHandler*> s_iptvhandlers;
@@ -1265,6 +1265,16 @@ bool MpegRecorder::ProcessTSPacket(const TSPacket &tspacket_real)
     return ret;
 }
 
+bool MpegRecorder::ProcessTSPackets(const TSPacket *tspackets, uint count)
+{
+    // The HD-PVR PCR packets get their continuity counters fixed up
+    // one at a time in ProcessTSPacket()
+    if (count && (tspackets[0].PID() == 0x1001) && (driver == "hdpvr"))
+        return TSPacketListener::ProcessTSPackets(tspackets, count);
+
+    return DTVRecorder::ProcessTSPackets(tspackets, count);
+}
+
 void MpegRecorder::Reset(void)
 {
     LOG(VB_RECORD, LOG_INFO, LOC + "Reset(void)");
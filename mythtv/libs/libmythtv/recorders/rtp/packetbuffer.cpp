@@ -13,6 +13,8 @@
 
 PacketBuffer::PacketBuffer(unsigned int bitrate) :
     m_bitrate(bitrate),
+    m_recovered(0ULL),
+    m_unrecoverable(0ULL),
     m_next_empty_packet_key(0ULL)
 {
     while (!m_next_empty_packet_key)
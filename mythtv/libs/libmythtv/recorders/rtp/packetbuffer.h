@@ -40,9 +40,19 @@ class PacketBuffer
      */
     void FreePacket(const UDPPacket &);
 
+    /// Number of missing data packets rebuilt from FEC packets.
+    uint64_t GetRecoveredPacketCount(void) const { return m_recovered; }
+
+    /// Number of data packets that were neither received nor rebuilt.
+    uint64_t GetUnrecoverablePacketCount(void) const
+        { return m_unrecoverable; }
+
   protected:
     uint m_bitrate;
 
+    uint64_t m_recovered;
+    uint64_t m_unrecoverable;
+
     /// Packets key to use for next empty packet
     uint64_t m_next_empty_packet_key;
     
@@ -3,21 +3,72 @@
  * Distributed as part of MythTV under GPL v2 and later.
  */
 
-#include "udppacket.h"
+#include "rtpdatapacket.h"
 
 #ifndef _RTP_FEC_PACKET_H_
 #define _RTP_FEC_PACKET_H_
 
 /** \brief RTP FEC Packet
+ *
+ *  An SMPTE 2022-1 FEC packet is an RTP packet whose payload starts
+ *  with the RFC 2733 FEC header followed by the SMPTE extension. The
+ *  rest of the payload is the XOR of the payloads of the media packets
+ *  it protects, which are the NA packets SNBase, SNBase + Offset, ...
+ *
+ *  Column FEC packets protect one column of the L x D matrix, with
+ *  Offset = L and NA = D. Row FEC packets protect one row, with
+ *  Offset = 1 and NA = L.
  */
-class RTPFECPacket : public UDPPacket
+class RTPFECPacket : public RTPDataPacket
 {
   public:
-    RTPFECPacket(const UDPPacket &o) : UDPPacket(o) { }
-    RTPFECPacket(uint64_t key) : UDPPacket(key) { }
-    RTPFECPacket(void) : UDPPacket(0ULL) { }
+    RTPFECPacket(const RTPFECPacket &o) : RTPDataPacket(o) { }
+    RTPFECPacket(const UDPPacket &o) : RTPDataPacket(o) { }
+    RTPFECPacket(uint64_t key) : RTPDataPacket(key) { }
+    RTPFECPacket(void) : RTPDataPacket(0ULL) { }
 
-    // TODO
+    /// Only SMPTE 2022-1 XOR FEC packets are considered valid
+    bool IsValid(void) const
+    {
+        if (!RTPDataPacket::IsValid())
+            return false;
+        if (m_data.size() < (int)(m_off + kHeaderSize))
+            return false;
+        return HasSMPTEExtension() && GetFECType() == 0 &&
+            GetOffset() > 0 && GetNA() > 0;
+    }
+
+    /// The 16 low bits of the first protected sequence number
+    uint GetSNBase(void) const { return Get16(0); }
+    uint GetLengthRecovery(void) const { return Get16(2); }
+    bool HasSMPTEExtension(void) const { return Get8(4) & 0x80; }
+    uint GetPayloadTypeRecovery(void) const { return Get8(4) & 0x7f; }
+    uint GetTimeStampRecovery(void) const
+    {
+        return (Get16(8) << 16) | Get16(10);
+    }
+    /// True for row FEC, false for column FEC
+    bool IsRow(void) const { return Get8(12) & 0x40; }
+    uint GetFECType(void) const { return (Get8(12) >> 3) & 0x7; }
+    uint GetOffset(void) const { return Get8(13); }
+    uint GetNA(void) const { return Get8(14); }
+
+    const unsigned char *GetFECData(void) const
+    {
+        return reinterpret_cast<const unsigned char*>(m_data.data()) +
+            m_off + kHeaderSize;
+    }
+
+    uint GetFECDataSize(void) const
+    {
+        return m_data.size() - m_off - kHeaderSize;
+    }
+
+    static const uint kHeaderSize = 16;
+
+  private:
+    uint Get8(uint i) const { return (uchar) m_data[m_off + i]; }
+    uint Get16(uint i) const { return (Get8(i) << 8) | Get8(i + 1); }
 };
 
 #endif // _RTP_FEC_PACKET_H_
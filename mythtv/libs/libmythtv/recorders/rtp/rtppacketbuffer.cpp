@@ -4,70 +4,331 @@
  * Distributed as part of MythTV under GPL v2 and later.
  */
 
+#include <cstring>
 #include <algorithm>
 using namespace std;
 
 #include "rtppacketbuffer.h"
 #include "rtpdatapacket.h"
 #include "rtpfecpacket.h"
+#include "mythlogging.h"
+
+#define LOC QString("RTPPacketBuffer: ")
+
+/// Plenty for ordinary reordering when there is no FEC stream
+const uint RTPPacketBuffer::kMinReorderWindow = 100;
+/// SMPTE 2022-1 limits L x D to 100, so this only caps broken senders
+const uint RTPPacketBuffer::kMaxReorderWindow = 1000;
+
+/// A jump this far in the sequence numbers means the sender restarted
+static const uint64_t kResyncDistance = 8192;
+
+/// Size of the RTP header without CSRCs, which is all the FEC leaves out
+static const uint kRTPHeaderSize = 12;
+
+static void xor_bytes(unsigned char *dst, const unsigned char *src, uint size)
+{
+    uint i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+    {
+        uint64_t a, b;
+        memcpy(&a, dst + i, sizeof(a));
+        memcpy(&b, src + i, sizeof(b));
+        a ^= b;
+        memcpy(dst + i, &a, sizeof(a));
+    }
+    for (; i < size; i++)
+        dst[i] ^= src[i];
+}
+
+RTPPacketBuffer::RTPPacketBuffer(unsigned int bitrate) :
+    PacketBuffer(bitrate),
+    m_last_sequence(0ULL),
+    m_next_sequence(0ULL),
+    m_window(kMinReorderWindow)
+{
+}
+
+/// Returns the 64 bit sequence number closest to the last one seen
+uint64_t RTPPacketBuffer::ExtendSequenceNumber(uint sequence) const
+{
+    // Start one wrap in so packets from before the first one stay positive
+    if (!m_last_sequence)
+        return (1ULL<<16) + (sequence & 0xffff);
+
+    int16_t delta = (int16_t)(sequence - (uint)(m_last_sequence & 0xffff));
+    return m_last_sequence + delta;
+}
 
 void RTPPacketBuffer::PushDataPacket(const UDPPacket &udp_packet)
 {
     RTPDataPacket packet(udp_packet);
 
-    uint key = packet.GetSequenceNumber();
+    if (!packet.IsValid())
+    {
+        FreePacket(packet);
+        return;
+    }
 
-    bool large_was_seen_recently = m_large_sequence_number_seen_recently > 0;
-    m_large_sequence_number_seen_recently = 
-        (key > (1U<<15)) ? 500 : m_large_sequence_number_seen_recently - 1;
-    m_large_sequence_number_seen_recently =
-        max(m_large_sequence_number_seen_recently, 0);
+    uint64_t key = ExtendSequenceNumber(packet.GetSequenceNumber());
 
-    if (m_large_sequence_number_seen_recently > 0)
+    if (m_last_sequence &&
+        (key + kResyncDistance < m_next_sequence ||
+         key > m_last_sequence + kResyncDistance))
     {
-        if (key < 500) 
-            key += 1ULL<<16;
+        LOG(VB_RECORD, LOG_INFO, LOC +
+            QString("Sequence number jumped to %1, resynchronizing")
+            .arg(packet.GetSequenceNumber()));
+        Reset();
+        key = ExtendSequenceNumber(packet.GetSequenceNumber());
     }
-    else if (large_was_seen_recently)
+
+    if (!m_next_sequence)
+        m_next_sequence = key;
+
+    // Too late to be used, or a duplicate
+    if (key < m_next_sequence || m_unordered_packets.contains(key))
     {
-        m_current_sequence += 1ULL<<16;
+        FreePacket(packet);
+        return;
     }
 
-    key += m_current_sequence;
+    m_last_sequence = max(m_last_sequence, key);
+    m_unordered_packets[key] = packet;
 
-/*
-    LOG(VB_RECORD, LOG_DEBUG, QString("Pushing %1 as %2 (lr %3)")
-        .arg(packet.GetSequenceNumber()).arg(key)
-        .arg(m_large_sequence_number_seen_recently));
-*/
+    Release();
+}
 
-    m_unordered_packets[key] = packet;
+void RTPPacketBuffer::PushFECPacket(
+    const UDPPacket &packet, uint fec_stream_num)
+{
+    // The direction comes from the FEC header rather than the stream
+    (void) fec_stream_num;
+
+    RTPFECPacket fec(packet);
+
+    if (!m_next_sequence || !fec.IsValid())
+    {
+        FreePacket(fec);
+        return;
+    }
+
+    // Column FEC packets may trail their matrix by a whole matrix
+    uint window = 2 * fec.GetNA() * fec.GetOffset();
+    window = min(max(window, kMinReorderWindow), kMaxReorderWindow);
+    if (window > m_window)
+    {
+        LOG(VB_RECORD, LOG_INFO, LOC +
+            QString("Using a %1 packet reorder window for %2 FEC of %3x%4")
+            .arg(window).arg(fec.IsRow() ? "row" : "column")
+            .arg(fec.GetOffset()).arg(fec.GetNA()));
+        m_window = window;
+    }
+
+    uint64_t base = ExtendSequenceNumber(fec.GetSNBase());
+    uint64_t last = base + (fec.GetNA() - 1) * fec.GetOffset();
+    QMap<uint64_t, RTPFECPacket> &fecs = m_fec_packets[fec.IsRow() ? 1 : 0];
+
+    // Everything it protects has already been made available
+    if (last < m_next_sequence || fecs.contains(base))
+    {
+        FreePacket(fec);
+        return;
+    }
+
+    fecs[base] = fec;
+
+    // A rebuilt packet may complete a FEC packet in the other direction
+    if (Recover(fec, base))
+        RecoverAll();
+
+    Release();
+}
+
+/** \brief Rebuilds the packet protected by fec, if it is the only one
+ *         of its packets that is missing.
+ *  \return true if a packet was rebuilt
+ */
+bool RTPPacketBuffer::Recover(const RTPFECPacket &fec, uint64_t base)
+{
+    uint64_t missing = 0;
+    const RTPDataPacket *reference = NULL;
+
+    for (uint i = 0; i < fec.GetNA(); i++)
+    {
+        uint64_t key = base + i * fec.GetOffset();
+        QMap<uint64_t, RTPDataPacket>::const_iterator it =
+            m_unordered_packets.find(key);
+        if (it != m_unordered_packets.end())
+            reference = &(*it);
+        else if (missing)
+            return false;
+        else
+            missing = key;
+    }
 
-    // TODO pushing packets onto the ordered list should be based on
-    // the bitrate and the M+N of the FEC.. but for now...
-    const int kHighWaterMark = 500;
-    const int kLowWaterMark  = 100;
-    if (m_unordered_packets.size() > kHighWaterMark)
+    if (!missing || missing < m_next_sequence)
+        return false;
+
+    uint length = fec.GetLengthRecovery();
+    uint payload_type = fec.GetPayloadTypeRecovery();
+    uint timestamp = fec.GetTimeStampRecovery();
+    QByteArray payload(reinterpret_cast<const char*>(fec.GetFECData()),
+                       fec.GetFECDataSize());
+
+    for (uint i = 0; i < fec.GetNA(); i++)
+    {
+        uint64_t key = base + i * fec.GetOffset();
+        if (key == missing)
+            continue;
+
+        const RTPDataPacket &packet = m_unordered_packets[key];
+        QByteArray data = packet.GetData();
+        uint size = data.size() - kRTPHeaderSize;
+
+        length       ^= size;
+        payload_type ^= packet.GetPayloadType();
+        timestamp    ^= packet.GetTimeStamp();
+
+        xor_bytes(reinterpret_cast<unsigned char*>(payload.data()),
+                  reinterpret_cast<const unsigned char*>(data.constData()) +
+                  kRTPHeaderSize, min(size, (uint)payload.size()));
+    }
+
+    if (length > (uint)payload.size())
+    {
+        LOG(VB_RECORD, LOG_WARNING, LOC +
+            QString("Can't rebuild %1, recovered length %2 is longer "
+                    "than the FEC payload").arg(missing & 0xffff).arg(length));
+        return false;
+    }
+
+    // The FEC doesn't cover the version, flags, marker or SSRC, so those
+    // are taken from a packet of the same stream
+    RTPDataPacket packet(GetEmptyPacket());
+    QByteArray &data = packet.GetDataReference();
+    data.resize(kRTPHeaderSize + length);
+
+    unsigned char *p = reinterpret_cast<unsigned char*>(data.data());
+    QByteArray ref = (reference) ? reference->GetData() : QByteArray();
+    p[0]  = (reference) ? ref[0] : 0x80;
+    p[1]  = payload_type & 0x7f;
+    p[2]  = (missing >> 8) & 0xff;
+    p[3]  = missing & 0xff;
+    p[4]  = (timestamp >> 24) & 0xff;
+    p[5]  = (timestamp >> 16) & 0xff;
+    p[6]  = (timestamp >> 8) & 0xff;
+    p[7]  = timestamp & 0xff;
+    if (reference)
+        memcpy(p + 8, ref.constData() + 8, 4);
+    else
+        memset(p + 8, 0, 4);
+    memcpy(p + kRTPHeaderSize, payload.constData(), length);
+
+    if (!packet.IsValid())
+    {
+        FreePacket(packet);
+        return false;
+    }
+
+    LOG(VB_RECORD, LOG_DEBUG, LOC + QString("Rebuilt %1 from %2 FEC")
+        .arg(missing & 0xffff).arg(fec.IsRow() ? "row" : "column"));
+
+    m_unordered_packets[missing] = packet;
+    m_recovered++;
+
+    return true;
+}
+
+/// Keeps applying the stored FEC packets until nothing more can be rebuilt
+void RTPPacketBuffer::RecoverAll(void)
+{
+    bool rebuilt = true;
+    while (rebuilt)
     {
-        while (m_unordered_packets.size() > kLowWaterMark)
+        rebuilt = false;
+        for (uint i = 0; i < 2; i++)
         {
-            QMap<uint64_t, RTPDataPacket>::iterator it =
-                m_unordered_packets.begin();
-/*
-            LOG(VB_RECORD, LOG_DEBUG, QString("Popping %1 as %2")
-                .arg((*it).GetSequenceNumber()).arg(it.key()));
-*/
-            m_available_packets.push_back(*it);
-            m_unordered_packets.erase(it);
+            QMap<uint64_t, RTPFECPacket>::const_iterator it =
+                m_fec_packets[i].begin();
+            for (; it != m_fec_packets[i].end(); ++it)
+                rebuilt |= Recover(*it, it.key());
         }
     }
 }
 
-void RTPPacketBuffer::PushFECPacket(
-    const UDPPacket &packet, uint fec_stream_num)
+/// Makes the packets that are in order available and forgets old ones
+void RTPPacketBuffer::Release(void)
 {
-    (void) fec_stream_num;
-    // TODO IMPLEMENT
-    // for now just free the packet for immediate reuse
-    FreePacket(packet);
+    QMap<uint64_t, RTPDataPacket>::iterator it =
+        m_unordered_packets.lowerBound(m_next_sequence);
+
+    while (it != m_unordered_packets.end())
+    {
+        if (it.key() != m_next_sequence)
+        {
+            // Give the missing packet until the window has passed
+            if (m_last_sequence < m_next_sequence + m_window)
+                break;
+
+            RecoverAll();
+
+            it = m_unordered_packets.lowerBound(m_next_sequence);
+            if (it.key() != m_next_sequence)
+            {
+                LOG(VB_RECORD, LOG_DEBUG, LOC +
+                    QString("Lost %1 packets from %2")
+                    .arg(it.key() - m_next_sequence)
+                    .arg(m_next_sequence & 0xffff));
+                m_unrecoverable += it.key() - m_next_sequence;
+                m_next_sequence = it.key();
+            }
+            continue;
+        }
+
+        m_available_packets.push_back(*it);
+        m_next_sequence++;
+        ++it;
+    }
+
+    // Keep one window of packets that have been made available, they
+    // may still be needed to rebuild the packets after them
+    uint64_t oldest = m_next_sequence - min(m_next_sequence, (uint64_t)m_window);
+
+    while (!m_unordered_packets.empty() &&
+           m_unordered_packets.begin().key() < oldest)
+    {
+        m_unordered_packets.erase(m_unordered_packets.begin());
+    }
+
+    for (uint i = 0; i < 2; i++)
+    {
+        while (!m_fec_packets[i].empty() &&
+               m_fec_packets[i].begin().key() < oldest)
+        {
+            FreePacket(*m_fec_packets[i].begin());
+            m_fec_packets[i].erase(m_fec_packets[i].begin());
+        }
+    }
+}
+
+/// Makes everything that is waiting available and starts over
+void RTPPacketBuffer::Reset(void)
+{
+    QMap<uint64_t, RTPDataPacket>::iterator it =
+        m_unordered_packets.lowerBound(m_next_sequence);
+    for (; it != m_unordered_packets.end(); ++it)
+        m_available_packets.push_back(*it);
+    m_unordered_packets.clear();
+
+    for (uint i = 0; i < 2; i++)
+    {
+        QMap<uint64_t, RTPFECPacket>::iterator fit = m_fec_packets[i].begin();
+        for (; fit != m_fec_packets[i].end(); ++fit)
+            FreePacket(*fit);
+        m_fec_packets[i].clear();
+    }
+
+    m_last_sequence = 0ULL;
+    m_next_sequence = 0ULL;
 }
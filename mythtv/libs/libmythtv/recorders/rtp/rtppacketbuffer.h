@@ -10,17 +10,26 @@
 #include <QMap>
 
 #include "rtpdatapacket.h"
+#include "rtpfecpacket.h"
 #include "packetbuffer.h"
 
+/** \brief Reorders RTP data packets and rebuilds lost ones from
+ *         SMPTE 2022-1 FEC packets.
+ *
+ *  Data packets are made available in sequence number order. When a
+ *  packet is missing, the following packets are held back until it
+ *  arrives, is rebuilt from a row or column FEC packet, or the newest
+ *  packet is GetReorderWindow() packets past it, at which point it is
+ *  counted as unrecoverable and skipped.
+ *
+ *  Packets that have been made available are kept for one more window
+ *  so that FEC packets arriving after them can still use them to
+ *  rebuild their neighbours.
+ */
 class RTPPacketBuffer : public PacketBuffer
 {
   public:
-    RTPPacketBuffer(unsigned int bitrate) :
-        PacketBuffer(bitrate),
-        m_large_sequence_number_seen_recently(0),
-        m_current_sequence(0ULL)
-    {
-    }
+    RTPPacketBuffer(unsigned int bitrate);
 
     /// Adds RFC 3550 RTP data packet
     virtual void PushDataPacket(const UDPPacket&);
@@ -28,12 +37,31 @@ class RTPPacketBuffer : public PacketBuffer
     /// Adds SMPTE 2022 Forward Error Correction Stream packet
     virtual void PushFECPacket(const UDPPacket&, unsigned int fec_stream_num);
 
+    /// Number of packets a missing packet is waited for
+    uint GetReorderWindow(void) const { return m_window; }
+
+    static const uint kMinReorderWindow;
+    static const uint kMaxReorderWindow;
+
   private:
-    int m_large_sequence_number_seen_recently;
-    uint64_t m_current_sequence;
+    uint64_t ExtendSequenceNumber(uint sequence) const;
+    bool Recover(const RTPFECPacket &fec, uint64_t base);
+    void RecoverAll(void);
+    void Release(void);
+    void Reset(void);
 
-    /// The key is the RTP sequence number + sequence if applicable
+    /// Highest sequence number seen, 0 before the first data packet
+    uint64_t m_last_sequence;
+    /// Sequence number of the next packet to make available
+    uint64_t m_next_sequence;
+    uint m_window;
+
+    /// The key is the RTP sequence number extended to 64 bits. Packets
+    /// before m_next_sequence have already been made available.
     QMap<uint64_t, RTPDataPacket> m_unordered_packets;
+
+    /// Column [0] and row [1] FEC packets keyed by extended SNBase
+    QMap<uint64_t, RTPFECPacket> m_fec_packets[2];
 };
 
 #endif // _RTP_PACKET_BUFFER_H_
@@ -0,0 +1,180 @@
+/* -*- Mode: c++ -*-
+ * UDPBatchReader
+ * Distributed as part of MythTV under GPL v2 and later.
+ */
+
+#ifdef __linux__
+#define USE_RECVMMSG
+#endif
+
+// POSIX headers
+#ifdef USE_RECVMMSG
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+// MythTV headers
+#include "udpbatchreader.h"
+#include "packetbuffer.h"
+
+const uint UDPBatchReader::kBatchSize       = 64;
+/// Fits jumbo frames, IPTV senders keep to the path MTU
+const uint UDPBatchReader::kMaxDatagramSize = 9216;
+
+#ifdef USE_RECVMMSG
+struct UDPBatch
+{
+    UDPPacket               packets[UDPBatchReader::kBatchSize];
+    struct mmsghdr          msgs[UDPBatchReader::kBatchSize];
+    struct iovec            iovecs[UDPBatchReader::kBatchSize];
+    struct sockaddr_storage addrs[UDPBatchReader::kBatchSize];
+};
+#else
+struct UDPBatch
+{
+};
+#endif
+
+UDPBatchReader::UDPBatchReader(PacketBuffer *buffer, int fec_stream) :
+    m_buffer(buffer), m_fec_stream(fec_stream), m_batch(new UDPBatch)
+{
+}
+
+UDPBatchReader::~UDPBatchReader()
+{
+    delete m_batch;
+}
+
+bool UDPBatchReader::IsSupported(void)
+{
+#ifdef USE_RECVMMSG
+    return true;
+#else
+    return false;
+#endif
+}
+
+void UDPBatchReader::SetSender(const QHostAddress &sender)
+{
+    m_sender = sender;
+}
+
+/** \brief Reads and pushes datagrams until the socket has none left.
+ *  \param fd       non-blocking UDP socket
+ *  \param rejected set to the number of datagrams from other senders
+ *  \return the number of datagrams pushed, or -1 if the caller
+ *          needs to read the socket some other way
+ */
+int UDPBatchReader::Read(int fd, uint &rejected)
+{
+    rejected = 0;
+
+#ifdef USE_RECVMMSG
+    // The sender is compared in the socket's own form once per call
+    int family = AF_UNSPEC;
+    in_addr_t sender4 = 0;
+    Q_IPV6ADDR sender6;
+    memset(&sender6, 0, sizeof(sender6));
+    if (m_sender.protocol() == QAbstractSocket::IPv4Protocol)
+    {
+        family  = AF_INET;
+        sender4 = htonl(m_sender.toIPv4Address());
+    }
+    else if (m_sender.protocol() == QAbstractSocket::IPv6Protocol)
+    {
+        family  = AF_INET6;
+        sender6 = m_sender.toIPv6Address();
+    }
+
+    int total = 0;
+    bool truncated = false;
+    int count = kBatchSize;
+
+    while (count == (int)kBatchSize && !truncated)
+    {
+        for (uint i = 0; i < kBatchSize; i++)
+        {
+            // Slots keep their packet until a datagram has been pushed
+            if (m_batch->packets[i].GetDataReference().size() !=
+                (int)kMaxDatagramSize)
+            {
+                m_batch->packets[i] = m_buffer->GetEmptyPacket();
+                m_batch->packets[i].GetDataReference().resize(kMaxDatagramSize);
+            }
+
+            m_batch->iovecs[i].iov_base =
+                m_batch->packets[i].GetDataReference().data();
+            m_batch->iovecs[i].iov_len  = kMaxDatagramSize;
+
+            struct msghdr &hdr = m_batch->msgs[i].msg_hdr;
+            memset(&hdr, 0, sizeof(hdr));
+            hdr.msg_name    = &m_batch->addrs[i];
+            hdr.msg_namelen = sizeof(m_batch->addrs[i]);
+            hdr.msg_iov     = &m_batch->iovecs[i];
+            hdr.msg_iovlen  = 1;
+        }
+
+        count = recvmmsg(fd, m_batch->msgs, kBatchSize, MSG_DONTWAIT, NULL);
+        if (count < 0)
+        {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+                break;
+            return (total) ? total : -1;
+        }
+
+        for (int i = 0; i < count; i++)
+        {
+            const struct msghdr &hdr = m_batch->msgs[i].msg_hdr;
+
+            if (hdr.msg_flags & MSG_TRUNC)
+            {
+                truncated = true;
+                continue;
+            }
+
+            if (family == AF_INET)
+            {
+                const struct sockaddr_in *addr =
+                    reinterpret_cast<const sockaddr_in*>(&m_batch->addrs[i]);
+                if (addr->sin_family != AF_INET ||
+                    addr->sin_addr.s_addr != sender4)
+                {
+                    rejected++;
+                    continue;
+                }
+            }
+            else if (family == AF_INET6)
+            {
+                const struct sockaddr_in6 *addr =
+                    reinterpret_cast<const sockaddr_in6*>(&m_batch->addrs[i]);
+                if (addr->sin6_family != AF_INET6 ||
+                    memcmp(&addr->sin6_addr, &sender6, sizeof(sender6)) != 0)
+                {
+                    rejected++;
+                    continue;
+                }
+            }
+
+            UDPPacket &packet = m_batch->packets[i];
+            packet.GetDataReference().resize(m_batch->msgs[i].msg_len);
+            if (m_fec_stream < 0)
+                m_buffer->PushDataPacket(packet);
+            else
+                m_buffer->PushFECPacket(packet, m_fec_stream);
+
+            // Let go of it so the buffer doesn't have to copy on reuse
+            packet = UDPPacket();
+            total++;
+        }
+    }
+
+    return (truncated) ? -1 : total;
+#else
+    (void) fd;
+    return -1;
+#endif
+}
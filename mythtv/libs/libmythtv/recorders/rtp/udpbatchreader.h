@@ -0,0 +1,52 @@
+/* -*- Mode: c++ -*-
+ * UDPBatchReader
+ * Distributed as part of MythTV under GPL v2 and later.
+ */
+
+#ifndef _UDP_BATCH_READER_H_
+#define _UDP_BATCH_READER_H_
+
+#include <QHostAddress>
+
+#include "udppacket.h"
+
+class PacketBuffer;
+struct UDPBatch;
+
+/** \brief Receives datagrams from a UDP socket several at a time.
+ *
+ *  On Linux recvmmsg() reads up to kBatchSize datagrams per system call
+ *  straight into UDPPackets taken from the PacketBuffer, which are then
+ *  pushed as data packets or as packets of one FEC stream. Datagrams
+ *  from other senders are dropped while the batch is walked, comparing
+ *  the raw socket addresses rather than building a QHostAddress each.
+ *
+ *  Read() returns -1 where batching isn't available and when a datagram
+ *  didn't fit in a packet, after which the caller should go back to
+ *  reading with QUdpSocket.
+ */
+class UDPBatchReader
+{
+  public:
+    /// \param fec_stream FEC stream to push packets to, or -1 for data
+    UDPBatchReader(PacketBuffer *buffer, int fec_stream);
+    ~UDPBatchReader();
+
+    static bool IsSupported(void);
+
+    /// Only accept datagrams from sender, or from anyone if it is null
+    void SetSender(const QHostAddress &sender);
+
+    int Read(int fd, uint &rejected);
+
+    static const uint kBatchSize;
+    static const uint kMaxDatagramSize;
+
+  private:
+    PacketBuffer *m_buffer;
+    int           m_fec_stream;
+    QHostAddress  m_sender;
+    UDPBatch     *m_batch;
+};
+
+#endif // _UDP_BATCH_READER_H_
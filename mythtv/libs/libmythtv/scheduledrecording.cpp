@@ -40,6 +40,25 @@ QStringList ScheduledRecording::BuildMatchRequest(uint recordid,
                        .arg(why));
 };
 
+/// The time window is sent as "min~max" in place of the single
+/// maxstarttime, which older backends treat as an unbounded match.
+QStringList ScheduledRecording::BuildMatchRequest(uint recordid,
+                uint sourceid, uint mplexid, const QDateTime &minstarttime,
+                const QDateTime &maxstarttime, const QString &why)
+{
+    if (!minstarttime.isValid())
+        return BuildMatchRequest(recordid, sourceid, mplexid,
+                                 maxstarttime, why);
+
+    return QStringList(QString("MATCH %1 %2 %3 %4~%5 %6")
+                       .arg(recordid).arg(sourceid).arg(mplexid)
+                       .arg(minstarttime.toString(Qt::ISODate))
+                       .arg(maxstarttime.isValid() ?
+                            maxstarttime.toString(Qt::ISODate) :
+                            "-")
+                       .arg(why));
+};
+
 QStringList ScheduledRecording::BuildCheckRequest(const RecordingInfo &recinfo,
                                                   const QString &why)
 {
@@ -19,6 +19,17 @@ class MTV_PUBLIC ScheduledRecording
         { SendReschedule(BuildMatchRequest(recordid, sourceid, mplexid,
                                            maxstarttime, why)); };
 
+    // Use when program data changes only for programs starting within
+    // a known time window.  Invalid times leave that end of the window
+    // open.
+    static void RescheduleMatch(uint recordid, uint sourceid, uint mplexid,
+                                const QDateTime &minstarttime,
+                                const QDateTime &maxstarttime,
+                                const QString &why)
+        { SendReschedule(BuildMatchRequest(recordid, sourceid, mplexid,
+                                           minstarttime, maxstarttime,
+                                           why)); };
+
     // Use when previous or current recorded duplicate status changes.
     static void RescheduleCheck(const RecordingInfo &recinfo, 
                                 const QString &why)
@@ -36,6 +47,9 @@ class MTV_PUBLIC ScheduledRecording
     static void SendReschedule(const QStringList &request);
     static QStringList BuildMatchRequest(uint recordid, uint sourceid, 
               uint mplexid, const QDateTime &maxstarttime, const QString &why);
+    static QStringList BuildMatchRequest(uint recordid, uint sourceid,
+              uint mplexid, const QDateTime &minstarttime,
+              const QDateTime &maxstarttime, const QString &why);
     static QStringList BuildCheckRequest(const RecordingInfo &recinfo,
                                          const QString &why);
     static QStringList BuildPlaceRequest(const QString &why);
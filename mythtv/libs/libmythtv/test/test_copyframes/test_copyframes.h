@@ -20,6 +20,8 @@
 
 #include <QtTest/QtTest>
 
+#include <algorithm>
+
 #include "mythcorecontext.h"
 #include "mythframe.h"
 #include "mythavutil.h"
@@ -1267,4 +1269,82 @@ class TestCopyFrames: public QObject
         av_freep(&bufsrc);
         av_freep(&bufdst);
     }
+
+    void YV12lumastats_data(void)
+    {
+        QTest::addColumn<bool>("SSE");
+        QTest::addColumn<int>("step");
+        QTest::newRow("SSE step 1") << true << 1;
+        QTest::newRow("SSE step 4") << true << 4;
+        QTest::newRow("SSE step 6") << true << 6;
+        QTest::newRow("Pure C step 1") << false << 1;
+        QTest::newRow("Pure C step 4") << false << 4;
+        QTest::newRow("Pure C step 6") << false << 6;
+    }
+
+    // Sampled luma statistics as used by the commercial flagger, checked
+    // against a plain loop and benchmarked over a whole Y plane.
+    void YV12lumastats(void)
+    {
+        QFETCH(bool, SSE);
+        QFETCH(int, step);
+        int count = (WIDTH + step - 1) / step;
+        unsigned char *plane = new unsigned char[WIDTH * HEIGHT];
+        unsigned char *colmax = new unsigned char[count];
+        unsigned char *refcolmax = new unsigned char[count];
+
+        // pseudo random, but reproducible, picture content
+        unsigned int seed = 1;
+        for (int i = 0; i < WIDTH * HEIGHT; i++)
+        {
+            seed = seed * 1103515245 + 12345;
+            plane[i] = (seed >> 16) & 0xff;
+        }
+
+        LumaStats ref;
+        lumastatsinit(&ref);
+        memset(refcolmax, 0, count);
+        for (int y = 0; y < HEIGHT; y++)
+        {
+            for (int j = 0; j < count; j++)
+            {
+                unsigned char pixel = plane[y * WIDTH + j * step];
+                ref.sum += pixel;
+                ref.count++;
+                ref.min = std::min(ref.min, (int)pixel);
+                ref.max = std::max(ref.max, (int)pixel);
+                refcolmax[j] = std::max(refcolmax[j], pixel);
+            }
+        }
+
+        LumaStats stats;
+        QBENCHMARK
+        {
+            lumastatsinit(&stats);
+            memset(colmax, 0, count);
+            for (int y = 0; y < HEIGHT; y++)
+                lumarowstats(plane + y * WIDTH, count, step,
+                             colmax, &stats, SSE);
+        }
+
+        QCOMPARE(stats.min, ref.min);
+        QCOMPARE(stats.max, ref.max);
+        QCOMPARE(stats.sum, ref.sum);
+        QCOMPARE(stats.count, ref.count);
+        QVERIFY(memcmp(colmax, refcolmax, count) == 0);
+
+        // row maximum, including a short tail after the last full block
+        unsigned char row[37];
+        for (int i = 0; i < 37; i++)
+            row[i] = i * 3;
+        memset(colmax, 0, count);
+        lumastatsinit(&stats);
+        QCOMPARE((int)lumarowstats(row, 37, 1, colmax, &stats, SSE), 108);
+        QCOMPARE(stats.min, 0);
+        QCOMPARE(stats.sum, (int64_t)(3 * 36 * 37 / 2));
+
+        delete[] plane;
+        delete[] colmax;
+        delete[] refcolmax;
+    }
 };
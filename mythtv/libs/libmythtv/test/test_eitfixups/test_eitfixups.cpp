@@ -675,4 +675,63 @@ void TestEITFixups::testUnitymedia()
     delete event;
 }
 
+void TestEITFixups::benchmarkFixups()
+{
+    // Events taken from the tests above, fixed up the way EITHelper would
+    static const struct
+    {
+        FixupValue  fixup;
+        const char *title;
+        const char *subtitle;
+        const char *description;
+    } corpus[] =
+    {
+        { EITFixUp::kFixUK, "Book of the Week", "",
+          "Girl in the Dark: Anna Lyndsey's account of finding light in the darkness after illness changed her life. 3/5. A Descent into Darkness: The disquieting persistence of the light." },
+        { EITFixUp::kFixUK, "Hoarders", "",
+          "Fascinating series chronicling the lives of serial hoarders. Often facing loss of their children, career, or divorce, can people with this disorder be helped? S3, Ep1" },
+        { EITFixUp::kFixUK, "Yu-Gi-Oh! ZEXAL", "",
+          "It's a duelling disaster for Yuma when Astral, a mysterious visitor from another galaxy, suddenly appears, putting his duel with Shark in serious jeopardy! S01 Ep02 (Part 2 of 2)" },
+        { EITFixUp::kFixUK, "The World at War", "",
+          "12/26. Whirlwind: Acclaimed documentary series about World War II. This episode focuses on the Allied bombing campaign which inflicted grievous damage upon Germany, both day and night. [S]" },
+        { EITFixUp::kFixUK, "A Touch of Frost", "",
+          "The Things We Do for Love: When a beautiful woman is found dead in a car park, the list of suspects leads Jack Frost (David Jason) into the heart of a religious community. [SL] S4 Ep3" },
+        { EITFixUp::kFixUK, "Suffragettes Forever! The Story of...", "",
+          "...Women and Power. 2/3. Documentary series presented by Amanda Vickery. During Victoria's reign extraordinary women gradually changed the lives and opportunities of their sex. [HD] [AD,S]" },
+        { EITFixUp::kFixUK, "Brooklyn's Finest", "",
+          "Three unconnected Brooklyn cops wind up at the same deadly location. Contains very strong language, sexual content and some violence.  Also in HD. [2009] [AD,S]" },
+        { EITFixUp::kFixUK, "Channel 4 News", "",
+          "Includes sport and weather." },
+        { EITFixUp::kFixUK, "Law & Order: Special Victims Unit", "",
+          "Sugar: New. Police drama series about an elite sex crime  ..." },
+        { EITFixUp::kFixUK, "NEW: Marvel's Agents of S.H.I.E.L.D.", "", "" },
+        { EITFixUp::kFixUK, "New: The X-Files", "",
+          "Hit sci-fi drama series returns. Mulder and Scully are reunited after the collapse of their relationship when a TV host contacts them, believing he has uncovered a significant conspiracy. (Ep 1)[AD,S]" },
+        { EITFixUp::kFixHTML | EITFixUp::kFixUK,
+          "<EM>New: Redneck Island</EM>", "",
+          "Twelve rednecks are stranded on a tropical island with 'Stone Cold' Steve Austin, but this is no holiday, they're here to compete for $100,000. S4, Ep4" },
+        { EITFixUp::kFixP7S1, "Titel", "Folgentitel, Mystery, USA 2011",
+          "Beschreibung" },
+        { EITFixUp::kFixUnitymedia, "Titel", "Beschreib",
+          "Beschreibung ... IMDb Rating: 8.9 /10" },
+    };
+    static const int corpusSize = sizeof(corpus) / sizeof(corpus[0]);
+
+    EITFixUp fixup;
+
+    QBENCHMARK
+    {
+        for (int i = 0; i < corpusSize; ++i)
+        {
+            DBEventEIT *event = SimpleDBEventEIT(
+                corpus[i].fixup,
+                QString::fromUtf8(corpus[i].title),
+                QString::fromUtf8(corpus[i].subtitle),
+                QString::fromUtf8(corpus[i].description));
+            fixup.Fix(*event);
+            delete event;
+        }
+    }
+}
+
 QTEST_APPLESS_MAIN(TestEITFixups)
@@ -50,6 +50,7 @@ class TestEITFixups : public QObject
     void testHTMLFixup(void);
     void testSkyEpisodes(void);
     void testUnitymedia(void);
+    void benchmarkFixups(void);
 
   private:
     static DBEventEIT *SimpleDBEventEIT (FixupValue fix, QString title, QString subtitle, QString description);
@@ -0,0 +1,3 @@
+#include "test_hevcparser.h"
+
+QTEST_APPLESS_MAIN(TestHEVCParser)
@@ -0,0 +1,512 @@
+/*
+ *  Class TestHEVCParser
+ *
+ *  Copyright (C) MythTV Developers 2016
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <QtTest/QtTest>
+
+#include "HEVCParser.h"
+#include "recorderbase.h" // for FrameRate
+
+/// Writes the fixed and Exp-Golomb coded fields of an RBSP
+class BitWriter
+{
+  public:
+    BitWriter() : m_bits(0) {}
+
+    void put(uint64_t value, uint count)
+    {
+        for (uint i = count; i > 0; --i)
+        {
+            if (m_bits % 8 == 0)
+                m_data.append((char)0);
+            if ((value >> (i - 1)) & 1)
+                m_data[m_bits / 8] = m_data[m_bits / 8] | (0x80 >> (m_bits % 8));
+            m_bits++;
+        }
+    }
+
+    void ue(uint value)
+    {
+        uint64_t code = (uint64_t)value + 1;
+        uint length = 0;
+        while ((code >> length) > 1)
+            length++;
+        put(0, length);
+        put(code, length + 1);
+    }
+
+    void se(int value)
+    {
+        ue((value > 0) ? 2 * value - 1 : -2 * value);
+    }
+
+    /// rbsp_trailing_bits()
+    QByteArray rbsp(void)
+    {
+        put(1, 1);
+        while (m_bits % 8)
+            put(0, 1);
+        return m_data;
+    }
+
+  private:
+    QByteArray m_data;
+    uint       m_bits;
+};
+
+/// Wraps an RBSP in a start code, a base layer NAL unit header and
+/// emulation prevention bytes
+static QByteArray make_nal(uint type, const QByteArray &rbsp, uint layer = 0)
+{
+    QByteArray nal;
+    nal.append((char)0);
+    nal.append((char)0);
+    nal.append((char)1);
+    nal.append((char)((type << 1) | (layer >> 5)));
+    nal.append((char)(((layer & 0x1f) << 3) | 1));
+
+    uint zeros = 0;
+    for (int i = 0; i < rbsp.size(); ++i)
+    {
+        uchar byte = rbsp[i];
+        if (zeros >= 2 && byte <= 3)
+        {
+            nal.append((char)3);
+            zeros = 0;
+        }
+        nal.append((char)byte);
+        zeros = (byte == 0) ? zeros + 1 : 0;
+    }
+    return nal;
+}
+
+/// profile_tier_level() of a Main profile, level 4 stream
+static void put_profile_tier_level(BitWriter &w)
+{
+    w.put(0, 2);            // general_profile_space
+    w.put(0, 1);            // general_tier_flag
+    w.put(1, 5);            // general_profile_idc
+    w.put(0x60000000, 32);  // general_profile_compatibility_flag
+    w.put(1, 1);            // general_progressive_source_flag
+    w.put(0, 1);            // general_interlaced_source_flag
+    w.put(0, 1);            // general_non_packed_constraint_flag
+    w.put(1, 1);            // general_frame_only_constraint_flag
+    w.put(0, 43);           // general_reserved_zero_43bits
+    w.put(0, 1);            // general_reserved_zero_bit
+    w.put(120, 8);          // general_level_idc
+}
+
+static QByteArray make_vps(uint units_in_tick, uint time_scale)
+{
+    BitWriter w;
+    w.put(0, 4);            // vps_video_parameter_set_id
+    w.put(3, 2);            // vps_base_layer_internal/available_flag
+    w.put(0, 6);            // vps_max_layers_minus1
+    w.put(0, 3);            // vps_max_sub_layers_minus1
+    w.put(1, 1);            // vps_temporal_id_nesting_flag
+    w.put(0xffff, 16);      // vps_reserved_0xffff_16bits
+    put_profile_tier_level(w);
+    w.put(1, 1);            // vps_sub_layer_ordering_info_present_flag
+    w.ue(4);                // vps_max_dec_pic_buffering_minus1
+    w.ue(2);                // vps_max_num_reorder_pics
+    w.ue(0);                // vps_max_latency_increase_plus1
+    w.put(0, 6);            // vps_max_layer_id
+    w.ue(0);                // vps_num_layer_sets_minus1
+    w.put(units_in_tick ? 1 : 0, 1); // vps_timing_info_present_flag
+    if (units_in_tick)
+    {
+        w.put(units_in_tick, 32);
+        w.put(time_scale, 32);
+        w.put(0, 1);        // vps_poc_proportional_to_timing_flag
+        w.ue(0);            // vps_num_hrd_parameters
+    }
+    w.put(0, 1);            // vps_extension_flag
+    return make_nal(HEVCParser::VPS_NUT, w.rbsp());
+}
+
+struct SPSFormat
+{
+    uint width, height;     ///< coded picture size
+    uint crop_right, crop_bottom; ///< in luma samples
+    uint aspect_ratio_idc, sar_width, sar_height;
+    uint units_in_tick, time_scale;
+};
+
+static QByteArray make_sps(const SPSFormat &f)
+{
+    BitWriter w;
+    w.put(0, 4);            // sps_video_parameter_set_id
+    w.put(0, 3);            // sps_max_sub_layers_minus1
+    w.put(1, 1);            // sps_temporal_id_nesting_flag
+    put_profile_tier_level(w);
+    w.ue(0);                // sps_seq_parameter_set_id
+    w.ue(1);                // chroma_format_idc, 4:2:0
+    w.ue(f.width);          // pic_width_in_luma_samples
+    w.ue(f.height);         // pic_height_in_luma_samples
+    w.put(1, 1);            // conformance_window_flag
+    w.ue(0);
+    w.ue(f.crop_right / 2);
+    w.ue(0);
+    w.ue(f.crop_bottom / 2);
+    w.ue(2);                // bit_depth_luma_minus8
+    w.ue(2);                // bit_depth_chroma_minus8
+    w.ue(4);                // log2_max_pic_order_cnt_lsb_minus4
+    w.put(1, 1);            // sps_sub_layer_ordering_info_present_flag
+    w.ue(4);
+    w.ue(2);
+    w.ue(0);
+    w.ue(0);                // log2_min_luma_coding_block_size_minus3
+    w.ue(3);                // log2_diff_max_min_luma_coding_block_size
+    w.ue(0);                // log2_min_luma_transform_block_size_minus2
+    w.ue(3);                // log2_diff_max_min_luma_transform_block_size
+    w.ue(1);                // max_transform_hierarchy_depth_inter
+    w.ue(1);                // max_transform_hierarchy_depth_intra
+
+    w.put(1, 1);            // scaling_list_enabled_flag
+    w.put(1, 1);            // sps_scaling_list_data_present_flag
+    for (uint sizeId = 0; sizeId < 4; ++sizeId)
+    {
+        for (uint matrixId = 0; matrixId < 6;
+             matrixId += (sizeId == 3) ? 3 : 1)
+        {
+            // One explicit list of each size, the others are predicted
+            if (matrixId != 0)
+            {
+                w.put(0, 1); // scaling_list_pred_mode_flag
+                w.ue(1);     // scaling_list_pred_matrix_id_delta
+                continue;
+            }
+            w.put(1, 1);
+            if (sizeId > 1)
+                w.se(8);     // scaling_list_dc_coef_minus8
+            uint coefNum = qMin(64, 1 << (4 + (sizeId << 1)));
+            for (uint i = 0; i < coefNum; ++i)
+                w.se((int)(i % 3) - 1);
+        }
+    }
+
+    w.put(1, 1);            // amp_enabled_flag
+    w.put(1, 1);            // sample_adaptive_offset_enabled_flag
+    w.put(1, 1);            // pcm_enabled_flag
+    w.put(7, 4);            // pcm_sample_bit_depth_luma_minus1
+    w.put(7, 4);            // pcm_sample_bit_depth_chroma_minus1
+    w.ue(0);
+    w.ue(2);
+    w.put(1, 1);            // pcm_loop_filter_disabled_flag
+
+    // Three short term RPS, the last two predicted from the one before,
+    // which only parse if the number of pictures in them is worked out
+    w.ue(3);                // num_short_term_ref_pic_sets
+    w.ue(2);                // num_negative_pics: -1, -3
+    w.ue(1);                // num_positive_pics: +1
+    w.ue(0); w.put(1, 1);
+    w.ue(1); w.put(1, 1);
+    w.ue(0); w.put(1, 1);
+
+    w.put(1, 1);            // inter_ref_pic_set_prediction_flag
+    w.put(1, 1);            // delta_rps_sign
+    w.ue(0);                // abs_delta_rps_minus1, deltaRps = -1
+    w.put(1, 1);            // -2
+    w.put(0, 1); w.put(1, 1); // -4, not used by the current picture
+    w.put(0, 1); w.put(0, 1); // 0, dropped
+    w.put(1, 1);            // -1
+
+    w.put(1, 1);            // inter_ref_pic_set_prediction_flag
+    w.put(0, 1);            // delta_rps_sign
+    w.ue(1);                // abs_delta_rps_minus1, deltaRps = +2
+    for (uint j = 0; j <= 3; ++j)
+        w.put(1, 1);        // used_by_curr_pic_flag
+
+    w.put(1, 1);            // long_term_ref_pics_present_flag
+    w.ue(1);                // num_long_term_ref_pics_sps
+    w.put(5, 8);            // lt_ref_pic_poc_lsb_sps
+    w.put(1, 1);            // used_by_curr_pic_lt_sps_flag
+    w.put(1, 1);            // sps_temporal_mvp_enabled_flag
+    w.put(1, 1);            // strong_intra_smoothing_enabled_flag
+
+    w.put(1, 1);            // vui_parameters_present_flag
+    w.put(f.aspect_ratio_idc ? 1 : 0, 1);
+    if (f.aspect_ratio_idc)
+    {
+        w.put(f.aspect_ratio_idc, 8);
+        if (f.aspect_ratio_idc == 255)
+        {
+            w.put(f.sar_width, 16);
+            w.put(f.sar_height, 16);
+        }
+    }
+    w.put(0, 1);            // overscan_info_present_flag
+    w.put(1, 1);            // video_signal_type_present_flag
+    w.put(5, 3);
+    w.put(0, 1);
+    w.put(1, 1);
+    w.put(9, 8);
+    w.put(16, 8);
+    w.put(9, 8);
+    w.put(0, 1);            // chroma_loc_info_present_flag
+    w.put(0, 3);            // neutral_chroma, field_seq, frame_field_info
+    w.put(1, 1);            // default_display_window_flag
+    w.ue(0); w.ue(0); w.ue(0); w.ue(0);
+    w.put(f.units_in_tick ? 1 : 0, 1); // vui_timing_info_present_flag
+    if (f.units_in_tick)
+    {
+        w.put(f.units_in_tick, 32);
+        w.put(f.time_scale, 32);
+        w.put(0, 1);        // vui_poc_proportional_to_timing_flag
+        w.put(0, 1);        // vui_hrd_parameters_present_flag
+    }
+    w.put(0, 1);            // bitstream_restriction_flag
+    w.put(0, 1);            // sps_extension_present_flag
+    return make_nal(HEVCParser::SPS_NUT, w.rbsp());
+}
+
+static QByteArray make_aud(void)
+{
+    BitWriter w;
+    w.put(2, 3);            // pic_type
+    return make_nal(HEVCParser::AUD_NUT, w.rbsp());
+}
+
+static QByteArray make_pps(void)
+{
+    BitWriter w;
+    w.ue(0);                // pps_pic_parameter_set_id
+    w.ue(0);                // pps_seq_parameter_set_id
+    w.put(0, 7);
+    return make_nal(HEVCParser::PPS_NUT, w.rbsp());
+}
+
+/// A slice segment with some made up slice data after the first bit
+static QByteArray make_slice(uint type, bool first, uint layer = 0)
+{
+    BitWriter w;
+    w.put(first ? 1 : 0, 1); // first_slice_segment_in_pic_flag
+    for (uint i = 0; i < 300; ++i)
+        w.put(0x5a ^ i, 8);
+    return make_nal(type, w.rbsp(), layer);
+}
+
+/// What the parser reported about one picture
+struct Picture
+{
+    bool     keyframe;
+    uint64_t offset;        ///< access unit offset as reported
+};
+
+/// Feeds the stream in transport stream sized pieces, passing the
+/// position of each piece as its stream offset, like DTVRecorder does
+static QList<Picture> parse(HEVCParser &parser, const QByteArray &stream)
+{
+    QList<Picture> pictures;
+    const uint kChunk = 184;
+
+    for (int start = 0; start < stream.size(); start += kChunk)
+    {
+        const uint8_t *data =
+            reinterpret_cast<const uint8_t*>(stream.constData()) + start;
+        uint size = qMin((int)kChunk, stream.size() - start);
+
+        uint i = 0;
+        while (i < size)
+        {
+            i += parser.addBytes(data + i, size - i, start);
+            if (parser.stateChanged() && parser.onFrameStart())
+            {
+                Picture picture;
+                picture.keyframe = parser.onKeyFrameStart();
+                picture.offset   = parser.onKeyFrameStart() ?
+                    parser.keyframeAUstreamOffset() :
+                    parser.frameAUstreamOffset();
+                pictures.append(picture);
+            }
+        }
+    }
+
+    // Flush the last picture
+    const uint8_t end[] = { 0, 0, 1, HEVCParser::AUD_NUT << 1, 1, 0x50 };
+    uint i = 0;
+    while (i < sizeof(end))
+    {
+        i += parser.addBytes(end + i, sizeof(end) - i, stream.size());
+        if (parser.stateChanged() && parser.onFrameStart())
+        {
+            Picture picture;
+            picture.keyframe = parser.onKeyFrameStart();
+            picture.offset   = parser.frameAUstreamOffset();
+            pictures.append(picture);
+        }
+    }
+
+    return pictures;
+}
+
+static const SPSFormat kHD =
+    { 1920, 1088, 0, 8, 1, 0, 0, 1, 50 };
+
+class TestHEVCParser : public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void SPS_test_data(void)
+    {
+        QTest::addColumn<uint>("width");
+        QTest::addColumn<uint>("height");
+        QTest::addColumn<uint>("crop_right");
+        QTest::addColumn<uint>("crop_bottom");
+        QTest::addColumn<uint>("aspect_ratio_idc");
+        QTest::addColumn<uint>("sar_width");
+        QTest::addColumn<uint>("sar_height");
+        QTest::addColumn<uint>("units_in_tick");
+        QTest::addColumn<uint>("time_scale");
+        QTest::addColumn<uint>("cropped_width");
+        QTest::addColumn<uint>("cropped_height");
+        QTest::addColumn<uint>("aspect");
+        QTest::addColumn<double>("fps");
+
+        QTest::newRow("1080p50")
+            << 1920U << 1088U << 0U << 8U << 1U << 0U << 0U
+            << 1U << 50U
+            << 1920U << 1080U << 3U << 50.0;
+        QTest::newRow("2160p59.94")
+            << 3840U << 2160U << 0U << 0U << 1U << 0U << 0U
+            << 1001U << 60000U
+            << 3840U << 2160U << 3U << 60000.0 / 1001;
+        QTest::newRow("576p25 extended SAR")
+            << 720U << 576U << 0U << 0U << 255U << 64U << 45U
+            << 1U << 25U
+            << 720U << 576U << 3U << 25.0;
+        QTest::newRow("576p25 12:11")
+            << 720U << 576U << 0U << 0U << 2U << 0U << 0U
+            << 1U << 25U
+            << 720U << 576U << 1363636U << 25.0;
+        QTest::newRow("1440x1080 cropped 4:3")
+            << 1448U << 1088U << 8U << 8U << 0U << 0U << 0U
+            << 0U << 0U
+            << 1440U << 1080U << 2U << 0.0;
+    }
+
+    void SPS_test(void)
+    {
+        QFETCH(uint, width);
+        QFETCH(uint, height);
+        QFETCH(uint, crop_right);
+        QFETCH(uint, crop_bottom);
+        QFETCH(uint, aspect_ratio_idc);
+        QFETCH(uint, sar_width);
+        QFETCH(uint, sar_height);
+        QFETCH(uint, units_in_tick);
+        QFETCH(uint, time_scale);
+        QFETCH(uint, cropped_width);
+        QFETCH(uint, cropped_height);
+        QFETCH(uint, aspect);
+        QFETCH(double, fps);
+
+        SPSFormat format = { width, height, crop_right, crop_bottom,
+                             aspect_ratio_idc, sar_width, sar_height,
+                             units_in_tick, time_scale };
+
+        HEVCParser parser;
+        QByteArray stream = make_vps(0, 0) + make_sps(format) + make_pps() +
+            make_slice(HEVCParser::IDR_W_RADL, true);
+        parse(parser, stream);
+
+        QVERIFY(parser.seen_SPS());
+        QCOMPARE(parser.pictureWidth(), cropped_width);
+        QCOMPARE(parser.pictureHeight(), cropped_height);
+        QCOMPARE(parser.aspectRatio(), aspect);
+        QCOMPARE(parser.frameRate(), fps);
+    }
+
+    /// Without timing in the SPS, the timing of the VPS is used
+    void VPSTiming_test(void)
+    {
+        SPSFormat format = kHD;
+        format.units_in_tick = 0;
+
+        HEVCParser parser;
+        QByteArray stream = make_vps(1001, 30000) + make_sps(format) +
+            make_pps() + make_slice(HEVCParser::IDR_N_LP, true);
+        parse(parser, stream);
+
+        FrameRate rate(0);
+        parser.getFrameRate(rate);
+        QCOMPARE(rate.getNum(), 30000U);
+        QCOMPARE(rate.getDen(), 1001U);
+    }
+
+    void Keyframe_test(void)
+    {
+        QByteArray parameters = make_vps(1, 50) + make_sps(kHD) + make_pps();
+        QByteArray stream;
+        QList<int> starts;
+
+        // Leading pictures without parameter sets aren't reported
+        stream += make_aud() + make_slice(HEVCParser::TRAIL_R, true);
+
+        // IDR in two slice segments, then two trailing pictures
+        starts.append(stream.size());
+        stream += make_aud() + parameters +
+            make_slice(HEVCParser::IDR_W_RADL, true) +
+            make_slice(HEVCParser::IDR_W_RADL, false);
+        starts.append(stream.size());
+        stream += make_aud() + make_slice(HEVCParser::TRAIL_R, true) +
+            make_slice(HEVCParser::TRAIL_R, false);
+        starts.append(stream.size());
+        stream += make_slice(HEVCParser::TRAIL_N, true);
+
+        // CRA with a leading picture, without an AUD
+        starts.append(stream.size());
+        stream += parameters + make_slice(HEVCParser::CRA_NUT, true);
+        starts.append(stream.size());
+        stream += make_slice(HEVCParser::RASL_N, true);
+
+        // Enhancement layer pictures belong to the base layer AU
+        starts.append(stream.size());
+        stream += make_aud() + make_slice(HEVCParser::BLA_W_RADL, true) +
+            make_slice(HEVCParser::TRAIL_R, true, 1);
+
+        HEVCParser parser;
+        QList<Picture> pictures = parse(parser, stream);
+
+        const bool keyframes[] = { true, false, false, true, false, true };
+        QCOMPARE(pictures.size(), starts.size());
+        for (int i = 0; i < pictures.size(); ++i)
+        {
+            QCOMPARE(pictures[i].keyframe, keyframes[i]);
+            // Offsets are those of the piece the AU's first NAL unit
+            // header is in
+            QCOMPARE(pictures[i].offset,
+                     (uint64_t)((starts[i] + 3) / 184 * 184));
+        }
+    }
+
+    void Reset_test(void)
+    {
+        HEVCParser parser;
+        parse(parser, make_vps(1, 50) + make_sps(kHD) + make_pps() +
+              make_slice(HEVCParser::IDR_W_RADL, true));
+        QVERIFY(parser.seen_SPS());
+
+        parser.Reset();
+        QVERIFY(!parser.seen_SPS());
+        QCOMPARE(parser.pictureWidth(), 0U);
+        QCOMPARE(parser.frameRate(), 0.0);
+    }
+};
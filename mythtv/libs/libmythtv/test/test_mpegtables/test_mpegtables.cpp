@@ -23,6 +23,7 @@
 #include "atsctables.h"
 #include "mpegtables.h"
 #include "dvbtables.h"
+#include "mpegstreamdata.h"
 
 void TestMPEGTables::pat_test(void)
 {
@@ -369,4 +370,208 @@ void TestMPEGTables::OTAChannelName_test (void)
     QCOMPARE (tvct.GetExtendedChannelName(999), QString());
 }
 
+void TestMPEGTables::PIDRoles_test (void)
+{
+    MPEGStreamData sd(-1, -1, false);
+
+    QVERIFY (sd.IsListeningPID(MPEG_PAT_PID));
+    QVERIFY (!sd.IsWritingPID(MPEG_PAT_PID));
+
+    sd.AddWritingPID(0x100);
+    sd.AddAudioPID(0x101);
+    sd.AddListeningPID(0x102);
+    QCOMPARE (sd.GetPIDRoles(0x100), (uint)kPIDRoleWriting);
+    QCOMPARE (sd.GetPIDRoles(0x101), (uint)kPIDRoleAudio);
+    QVERIFY (sd.IsListeningPID(0x102));
+
+    sd.AddNotListeningPID(0x102);
+    QVERIFY (!sd.IsListeningPID(0x102));
+    sd.RemoveNotListeningPID(0x102);
+    QVERIFY (sd.IsListeningPID(0x102));
+
+    sd.SetListeningDisabled(true);
+    QVERIFY (!sd.IsListeningPID(0x102));
+    sd.SetListeningDisabled(false);
+
+    sd.RemoveWritingPID(0x100);
+    QCOMPARE (sd.GetPIDRoles(0x100), (uint)kPIDRoleNone);
+
+    sd.Reset();
+    QVERIFY (!sd.IsAudioPID(0x101));
+    QVERIFY (!sd.IsListeningPID(0x102));
+    QVERIFY (sd.IsListeningPID(MPEG_PAT_PID));
+
+    QCOMPARE (sd.GetPIDRoles(0x2000), (uint)kPIDRoleNone);
+}
+
+class CountingTSListener : public TSPacketListener, public TSPacketListenerAV
+{
+  public:
+    CountingTSListener() : m_packets(0) { }
+
+    bool ProcessTSPacket(const TSPacket&)      { m_packets++; return true; }
+    bool ProcessVideoTSPacket(const TSPacket&) { m_packets++; return true; }
+    bool ProcessAudioTSPacket(const TSPacket&) { m_packets++; return true; }
+
+    uint m_packets;
+};
+
+/// Records the order packets reach the listeners, tagged by call
+class OrderTSListener : public TSPacketListener, public TSPacketListenerAV
+{
+  public:
+    OrderTSListener() : m_spans(0) { }
+
+    static uint Tag(char kind, const TSPacket &tspacket)
+    {
+        const unsigned char *pkt = tspacket.data();
+        return (uint(kind) << 16) | (pkt[4] << 8) | pkt[5];
+    }
+
+    bool ProcessTSPacket(const TSPacket &p)
+        { m_calls.push_back(Tag('w', p)); return true; }
+    bool ProcessVideoTSPacket(const TSPacket &p)
+        { m_calls.push_back(Tag('v', p)); return true; }
+    bool ProcessAudioTSPacket(const TSPacket &p)
+        { m_calls.push_back(Tag('a', p)); return true; }
+
+    bool ProcessTSPackets(const TSPacket *p, uint count)
+    {
+        m_spans++;
+        return TSPacketListener::ProcessTSPackets(p, count);
+    }
+    bool ProcessVideoTSPackets(const TSPacket *p, uint count)
+    {
+        m_spans++;
+        return TSPacketListenerAV::ProcessVideoTSPackets(p, count);
+    }
+    bool ProcessAudioTSPackets(const TSPacket *p, uint count)
+    {
+        m_spans++;
+        return TSPacketListenerAV::ProcessAudioTSPackets(p, count);
+    }
+
+    /// What ProcessTSPacket() delivers one packet at a time when every
+    /// PID but the audio and the ignored one is written
+    void Expect(const QByteArray &mux, uint audio_pid, uint ignored_pid)
+    {
+        m_calls.clear();
+        for (int pos = 0; pos < mux.size(); pos += TSPacket::kSize)
+        {
+            const TSPacket *pkt =
+                reinterpret_cast<const TSPacket*>(mux.constData() + pos);
+            if (pkt->TransportError() || pkt->Scrambled())
+                continue;
+            if (pkt->PID() == audio_pid)
+                ProcessAudioTSPacket(*pkt);
+            else if (pkt->PID() != ignored_pid)
+                ProcessTSPacket(*pkt);
+        }
+    }
+
+    QList<uint> m_calls;
+    uint        m_spans; ///< span calls made by MPEGStreamData
+};
+
+void TestMPEGTables::ProcessData_test (void)
+{
+    // Runs of different lengths crossing the 128 packet blocks, and
+    // a short last block.
+    const uint kPacketCnt = 3 * 128 + 5;
+    const uint kPIDs[4]   = { 0x100, 0x101, 0x102, 0x1fff };
+
+    QByteArray mux(kPacketCnt * TSPacket::kSize, (char)0xff);
+    for (uint i = 0; i < kPacketCnt; i++)
+    {
+        unsigned char *pkt = (unsigned char*) mux.data() + i * TSPacket::kSize;
+        uint pid = kPIDs[(i / 5 + i / 17) % 4];
+        pkt[0] = SYNC_BYTE;
+        pkt[1] = (pid >> 8) & 0x1f;
+        pkt[2] = pid & 0xff;
+        pkt[3] = 0x10 | (i & 0xf);
+        pkt[4] = (i >> 8) & 0xff;
+        pkt[5] = i & 0xff;
+    }
+
+    MPEGStreamData sd(-1, -1, false);
+    OrderTSListener listener;
+    sd.AddWritingListener(&listener);
+    sd.AddAVListener(&listener);
+    sd.AddWritingPID(0x100);
+    sd.AddAudioPID(0x101);
+    sd.AddWritingPID(0x102);
+
+    OrderTSListener expected;
+    expected.Expect(mux, 0x101, 0x1fff);
+
+    QCOMPARE (sd.ProcessData((const unsigned char*) mux.constData(),
+                             mux.size()), 0);
+    QCOMPARE (listener.m_calls, expected.m_calls);
+
+    // each run of one PID within a block arrives in a single span call
+    QVERIFY (listener.m_spans > 0);
+    QVERIFY (listener.m_spans * 3 < (uint) listener.m_calls.size());
+
+    // a damaged packet only drops that packet, the rest stay in order
+    unsigned char *data = (unsigned char*) mux.data();
+    data[10  * TSPacket::kSize + 3] |= 0x80; // scrambled
+    data[130 * TSPacket::kSize + 1] |= 0x80; // transport error
+    expected.Expect(mux, 0x101, 0x1fff);
+    QCOMPARE (expected.m_calls.size() + 2, listener.m_calls.size());
+
+    listener.m_calls.clear();
+    QCOMPARE (sd.ProcessData(data, mux.size()), 0);
+    QCOMPARE (listener.m_calls, expected.m_calls);
+
+    sd.RemoveWritingListener(&listener);
+    sd.RemoveAVListener(&listener);
+}
+
+void TestMPEGTables::ProcessData_benchmark (void)
+{
+    // Roughly what a full DVB mux looks like: a handful of services,
+    // each with a few elementary streams, plus stuffing.
+    const uint kServices   = 8;
+    const uint kPacketCnt  = 16 * 1024;
+    const uint kStreamPIDs = kServices * 4;
+
+    QByteArray mux(kPacketCnt * TSPacket::kSize, (char)0xff);
+    uint expected = 0;
+    for (uint i = 0; i < kPacketCnt; i++)
+    {
+        unsigned char *pkt = (unsigned char*) mux.data() + i * TSPacket::kSize;
+        uint pid = (i % 5 == 4) ? 0x1fff : 0x100 + (i % kStreamPIDs);
+        pkt[0] = SYNC_BYTE;
+        pkt[1] = (pid >> 8) & 0x1f;
+        pkt[2] = pid & 0xff;
+        pkt[3] = 0x10 | (i & 0xf);
+        if (pid != 0x1fff)
+            expected++;
+    }
+
+    MPEGStreamData sd(-1, -1, false);
+    CountingTSListener listener;
+    sd.AddWritingListener(&listener);
+    sd.AddAVListener(&listener);
+    for (uint i = 0; i < kStreamPIDs; i++)
+    {
+        if (i % 4 == 1)
+            sd.AddAudioPID(0x100 + i);
+        else
+            sd.AddWritingPID(0x100 + i);
+    }
+
+    const unsigned char *data = (const unsigned char*) mux.constData();
+    QCOMPARE (sd.ProcessData(data, mux.size()), 0);
+    QCOMPARE (listener.m_packets, expected);
+
+    QBENCHMARK
+    {
+        sd.ProcessData(data, mux.size());
+    }
+
+    sd.RemoveWritingListener(&listener);
+    sd.RemoveAVListener(&listener);
+}
+
 QTEST_APPLESS_MAIN(TestMPEGTables)
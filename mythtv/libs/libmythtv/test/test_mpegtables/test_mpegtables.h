@@ -80,4 +80,17 @@ class TestMPEGTables: public QObject
     /** test US channel names for trailing \0 characters, #12612
       */
     void OTAChannelName_test (void);
+
+    /** test PID classification table against the PID maps
+      */
+    void PIDRoles_test (void);
+
+    /** test that MPEGStreamData::ProcessData hands every packet to
+      * the listeners in stream order
+      */
+    void ProcessData_test (void);
+
+    /** benchmark MPEGStreamData::ProcessData over a synthetic full mux
+      */
+    void ProcessData_benchmark (void);
 };
@@ -0,0 +1,3 @@
+#include "test_previewcache.h"
+
+QTEST_APPLESS_MAIN(TestPreviewCache)
@@ -0,0 +1,200 @@
+/*
+ *  Class TestPreviewCache
+ *
+ *  Copyright (C) MythTV Developers 2016
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <sys/types.h>
+#include <utime.h>
+
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+#include <QFile>
+
+#include "previewcache.h"
+
+class TestPreviewCache: public QObject
+{
+    Q_OBJECT
+
+    static const int kFileSize = 1000;
+
+    QTemporaryDir *m_dir;
+
+    /// Writes a kFileSize preview, last used the given seconds ago
+    QString MakePreview(const QString &name, int age = 0)
+    {
+        QString filename = m_dir->path() + "/" + name;
+        QFile file(filename);
+        if (!file.open(QIODevice::WriteOnly))
+            return QString();
+        file.write(QByteArray(kFileSize, 'p'));
+        file.close();
+
+        if (age > 0)
+        {
+            struct utimbuf times;
+            times.actime = times.modtime = time(NULL) - age;
+            utime(filename.toLocal8Bit().constData(), &times);
+        }
+        return filename;
+    }
+
+  private slots:
+    void init(void)
+    {
+        m_dir = new QTemporaryDir();
+        QVERIFY(m_dir->isValid());
+        PreviewCache::Clear();
+        PreviewCache::SetMaxSize(256 * 1024 * 1024);
+    }
+
+    void cleanup(void)
+    {
+        delete m_dir;
+        m_dir = NULL;
+    }
+
+    void IsPreviewFile_test(void)
+    {
+        QVERIFY(PreviewCache::IsPreviewFile("1001_20160420160000.ts.png"));
+        QVERIFY(PreviewCache::IsPreviewFile("1001_20160420160000.ts.120.png"));
+        QVERIFY(PreviewCache::IsPreviewFile(
+                    "1001_20160420160000.mpg.-1.320x-1.jpg"));
+        QVERIFY(PreviewCache::IsPreviewFile(
+                    "1001_20160420160000.ts.300.160x90.PNG"));
+        QVERIFY(!PreviewCache::IsPreviewFile("1001_20160420160000.ts"));
+        QVERIFY(!PreviewCache::IsPreviewFile("1001_20160420160000.ts.tmp"));
+        QVERIFY(!PreviewCache::IsPreviewFile("folder.png"));
+        QVERIFY(!PreviewCache::IsPreviewFile("1001_2016.ts.png"));
+
+        QVERIFY(PreviewCache::IsDefaultPreview("1001_20160420160000.ts.png"));
+        QVERIFY(PreviewCache::IsDefaultPreview("1001_20160420160000.mpg.JPG"));
+        QVERIFY(!PreviewCache::IsDefaultPreview(
+                    "1001_20160420160000.ts.120.png"));
+        QVERIFY(!PreviewCache::IsDefaultPreview(
+                    "1001_20160420160000.ts.-1.320x-1.png"));
+        QVERIFY(!PreviewCache::IsDefaultPreview("folder.png"));
+    }
+
+    void DefaultPreview_test(void)
+    {
+        QString def = MakePreview("1001_20160420160000.ts.png");
+        QString a   = MakePreview("1001_20160420160000.ts.60.png");
+        PreviewCache::Insert(def);
+        PreviewCache::Insert(a);
+        PreviewCache::Touch(def);
+        QCOMPARE(PreviewCache::GetFiles(), QStringList() << a);
+
+        // a default preview is never expired, even over the limit
+        QString b = MakePreview("1001_20160420160000.ts.120.png");
+        PreviewCache::SetMaxSize(kFileSize / 2);
+        PreviewCache::Insert(b);
+        QCOMPARE(PreviewCache::GetFiles(), QStringList() << b);
+        QVERIFY(QFile::exists(def));
+        QVERIFY(!QFile::exists(a));
+    }
+
+    void Unbounded_test(void)
+    {
+        QString a = MakePreview("1001_20160420160000.ts.60.png");
+        QString b = MakePreview("1001_20160420160000.ts.120.png");
+        PreviewCache::SetMaxSize(0);
+        PreviewCache::Insert(a);
+        PreviewCache::Insert(b);
+        PreviewCache::Scan(QStringList(m_dir->path()));
+        QCOMPARE(PreviewCache::GetFiles(), QStringList() << a << b);
+        QVERIFY(QFile::exists(a));
+        QVERIFY(QFile::exists(b));
+    }
+
+    void LRUOrder_test(void)
+    {
+        QString a = MakePreview("1001_20160420160000.ts.30.png");
+        QString b = MakePreview("1001_20160420160000.ts.60.png");
+        QString c = MakePreview("1001_20160420160000.ts.120.png");
+        PreviewCache::Insert(a);
+        PreviewCache::Insert(b);
+        PreviewCache::Insert(c);
+
+        PreviewCache::Touch(a);
+        QCOMPARE(PreviewCache::GetFiles(), QStringList() << b << c << a);
+        QCOMPARE(PreviewCache::GetSize(), (qint64)3 * kFileSize);
+
+        // writing a preview again makes it the most recently used one
+        PreviewCache::Insert(b);
+        QCOMPARE(PreviewCache::GetFiles(), QStringList() << c << a << b);
+        QCOMPARE(PreviewCache::GetSize(), (qint64)3 * kFileSize);
+
+        // unknown files are ignored
+        PreviewCache::Touch(m_dir->path() + "/missing.png");
+        PreviewCache::Insert(m_dir->path() + "/missing.png");
+        QCOMPARE(PreviewCache::GetFiles().size(), 3);
+    }
+
+    void Expire_test(void)
+    {
+        QString a = MakePreview("1001_20160420160000.ts.30.png");
+        QString b = MakePreview("1001_20160420160000.ts.60.png");
+        QString c = MakePreview("1001_20160420160000.ts.120.png");
+        PreviewCache::Insert(a);
+        PreviewCache::Insert(b);
+        PreviewCache::Insert(c);
+        PreviewCache::Touch(a);
+
+        PreviewCache::SetMaxSize(2 * kFileSize + kFileSize / 2);
+        QCOMPARE(PreviewCache::GetFiles(), QStringList() << c << a);
+        QVERIFY(!QFile::exists(b));
+        QVERIFY(QFile::exists(a));
+        QVERIFY(QFile::exists(c));
+
+        QString d = MakePreview("1001_20160420160000.ts.180.png");
+        PreviewCache::Insert(d);
+        QCOMPARE(PreviewCache::GetFiles(), QStringList() << a << d);
+        QVERIFY(!QFile::exists(c));
+
+        // the newest preview stays even if it doesn't fit on its own
+        PreviewCache::SetMaxSize(kFileSize / 2);
+        QCOMPARE(PreviewCache::GetFiles(), QStringList() << d);
+        QVERIFY(!QFile::exists(a));
+        QVERIFY(QFile::exists(d));
+    }
+
+    void Scan_test(void)
+    {
+        QString newest = MakePreview("1001_20160420160000.ts.30.png");
+        QString oldest = MakePreview("1001_20160420160000.ts.60.png", 3000);
+        QString middle = MakePreview("1002_20160420160000.ts.30.png", 2000);
+        QString other  = MakePreview("cover.png", 5000);
+        QString def    = MakePreview("1002_20160420160000.ts.png", 6000);
+        QString known  = MakePreview("1003_20160420160000.ts.30.png", 4000);
+
+        // registered since startup, so newer than anything found on disk
+        PreviewCache::Insert(known);
+
+        PreviewCache::Scan(QStringList(m_dir->path()));
+        QCOMPARE(PreviewCache::GetFiles(),
+                 QStringList() << oldest << middle << newest << known);
+
+        PreviewCache::SetMaxSize(2 * kFileSize);
+        QCOMPARE(PreviewCache::GetFiles(), QStringList() << newest << known);
+        QVERIFY(!QFile::exists(oldest));
+        QVERIFY(!QFile::exists(middle));
+        QVERIFY(QFile::exists(other));
+        QVERIFY(QFile::exists(def));
+    }
+};
@@ -0,0 +1,3 @@
+#include "test_previewdecoder.h"
+
+QTEST_APPLESS_MAIN(TestPreviewDecoder)
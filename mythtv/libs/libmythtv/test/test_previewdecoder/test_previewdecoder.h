@@ -0,0 +1,280 @@
+/*
+ *  Class TestPreviewDecoder
+ *
+ *  Copyright (C) MythTV Developers 2016
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <cstring>
+
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+#include <QFileInfo>
+
+#include "previewdecoder.h"
+#include "programinfo.h"
+#include "seekindex.h"
+
+/// A short MPEG-2 transport stream, each frame a flat grey that tells
+/// which frame it is
+static const int kWidth     = 160;
+static const int kHeight    = 120;
+static const int kFrameRate = 25;
+static const int kGOP       = 12;
+static const int kFrames    = 50;
+
+class TestPreviewDecoder: public QObject
+{
+    Q_OBJECT
+
+    QTemporaryDir *m_dir;
+    QString        m_filename;
+    frm_pos_map_t  m_keyframes; ///< keyframe to byte offset
+    frm_pos_map_t  m_frames;    ///< every frame to byte offset
+
+    static int LumaOf(int frame) { return 16 + 4 * frame; }
+
+    /// Works out the frame from the grey level of an AV_PIX_FMT_RGB32 grab
+    static int FrameOf(const char *buf)
+    {
+        const uchar *pixel = (const uchar*) buf +
+            ((kHeight / 2) * kWidth + kWidth / 2) * 4;
+        double luma = 16.0 + pixel[1] * 219.0 / 255.0;
+        return qRound((luma - 16.0) / 4.0);
+    }
+
+    void WritePacket(AVFormatContext *oc, AVStream *st, AVPacket &pkt)
+    {
+        long long frame = pkt.pts;
+        long long position = avio_tell(oc->pb);
+        m_frames[frame] = position;
+        if (pkt.flags & AV_PKT_FLAG_KEY)
+            m_keyframes[frame] = position;
+
+        pkt.stream_index = st->index;
+        av_packet_rescale_ts(&pkt, st->codec->time_base, st->time_base);
+        av_write_frame(oc, &pkt);
+        av_packet_unref(&pkt);
+    }
+
+    bool WriteStream(const QString &filename)
+    {
+        QByteArray fname = filename.toLocal8Bit();
+        AVFormatContext *oc = NULL;
+        if (avformat_alloc_output_context2(&oc, NULL, "mpegts",
+                                           fname.constData()) < 0)
+            return false;
+
+        AVCodec *codec = avcodec_find_encoder(AV_CODEC_ID_MPEG2VIDEO);
+        AVStream *st = codec ? avformat_new_stream(oc, codec) : NULL;
+        if (!st)
+        {
+            avformat_free_context(oc);
+            return false;
+        }
+
+        AVCodecContext *c = st->codec;
+        c->width          = kWidth;
+        c->height         = kHeight;
+        c->time_base.num  = 1;
+        c->time_base.den  = kFrameRate;
+        c->gop_size       = kGOP;
+        c->max_b_frames   = 0;
+        c->pix_fmt        = AV_PIX_FMT_YUV420P;
+        c->flags         |= AV_CODEC_FLAG_QSCALE;
+        c->global_quality = FF_QP2LAMBDA * 2;
+        st->time_base     = c->time_base;
+
+        AVFrame *frame = av_frame_alloc();
+        frame->format = c->pix_fmt;
+        frame->width  = kWidth;
+        frame->height = kHeight;
+
+        bool ok = (avcodec_open2(c, codec, NULL) >= 0) &&
+            (av_frame_get_buffer(frame, 32) >= 0) &&
+            (avio_open(&oc->pb, fname.constData(), AVIO_FLAG_WRITE) >= 0) &&
+            (avformat_write_header(oc, NULL) >= 0);
+
+        AVPacket pkt;
+        int got_packet = 0;
+        for (int i = 0; ok && i < kFrames; i++)
+        {
+            av_frame_make_writable(frame);
+            for (int y = 0; y < kHeight; y++)
+                memset(frame->data[0] + y * frame->linesize[0],
+                       LumaOf(i), kWidth);
+            for (int y = 0; y < kHeight / 2; y++)
+            {
+                memset(frame->data[1] + y * frame->linesize[1], 128,
+                       kWidth / 2);
+                memset(frame->data[2] + y * frame->linesize[2], 128,
+                       kWidth / 2);
+            }
+            frame->pts = i;
+
+            av_init_packet(&pkt);
+            pkt.data = NULL;
+            pkt.size = 0;
+            ok = avcodec_encode_video2(c, &pkt, frame, &got_packet) >= 0;
+            if (ok && got_packet)
+                WritePacket(oc, st, pkt);
+        }
+
+        // drain the encoder
+        while (ok)
+        {
+            av_init_packet(&pkt);
+            pkt.data = NULL;
+            pkt.size = 0;
+            if (avcodec_encode_video2(c, &pkt, NULL, &got_packet) < 0 ||
+                !got_packet)
+                break;
+            WritePacket(oc, st, pkt);
+        }
+
+        if (ok)
+            av_write_trailer(oc);
+
+        av_frame_free(&frame);
+        avcodec_close(c);
+        if (oc->pb)
+            avio_closep(&oc->pb);
+        avformat_free_context(oc);
+
+        return ok;
+    }
+
+    bool WriteIndex(const frm_pos_map_t &positions)
+    {
+        frm_pos_map_t durations;
+        frm_pos_map_t::const_iterator it = positions.begin();
+        for (; it != positions.end(); ++it)
+            durations[it.key()] = it.key() * 1000 / kFrameRate;
+
+        return SeekIndex::Write(m_filename, QFileInfo(m_filename).size(),
+                                MARK_GOP_BYFRAME, positions, durations);
+    }
+
+    /// Grabs a preview with a pooled decoder, returns the frame shown
+    int Grab(long long seektime, bool time_in_secs)
+    {
+        ProgramInfo pginfo;
+        int bufferlen = 0, width = 0, height = 0;
+        float aspect = 0.0f;
+
+        PreviewDecoder *decoder = PreviewDecoder::Acquire();
+        char *buf = decoder->GetScreenGrab(pginfo, m_filename, seektime,
+                                           time_in_secs, bufferlen,
+                                           width, height, aspect);
+        PreviewDecoder::Release(decoder);
+
+        if (!buf)
+            return -1;
+
+        int frame = -1;
+        if ((width == kWidth) && (height == kHeight) &&
+            (bufferlen == kWidth * kHeight * 4))
+        {
+            frame = FrameOf(buf);
+        }
+        delete [] buf;
+        return frame;
+    }
+
+  private slots:
+    // called at the beginning of these sets of tests
+    void initTestCase(void)
+    {
+        av_register_all();
+
+        m_dir = new QTemporaryDir();
+        QVERIFY(m_dir->isValid());
+        m_filename = m_dir->path() + "/1001_20160420160000.ts";
+        QVERIFY(WriteStream(m_filename));
+        QCOMPARE(m_frames.size(), kFrames);
+        QCOMPARE(m_keyframes.size(), (kFrames + kGOP - 1) / kGOP);
+    }
+
+    // called at the end of these sets of tests
+    void cleanupTestCase(void)
+    {
+        delete m_dir;
+        m_dir = NULL;
+    }
+
+    // called before each test
+    void init(void)
+    {
+        SeekIndex::Remove(m_filename);
+    }
+
+    /// Without a seek index the demuxer seeks by time
+    void NoIndex_test(void)
+    {
+        int frame = Grab(1, true);
+        QVERIFY(frame >= 0);
+        QCOMPARE(frame % kGOP, 0);
+        QVERIFY(qAbs(frame - kFrameRate) <= kGOP);
+    }
+
+    /// The seek index gives the keyframe at or before the request
+    void KeyframeSeek_test(void)
+    {
+        QVERIFY(WriteIndex(m_keyframes));
+
+        QCOMPARE(Grab(0, false), 0);
+        QCOMPARE(Grab(40, false), 36);
+        QCOMPARE(Grab(kGOP, false), kGOP);
+        QCOMPARE(Grab(1, true), 24);
+        QCOMPARE(Grab(10, true), 48);
+    }
+
+    /// Landing on a P frame only keyframes are decoded, so the next
+    /// keyframe is shown rather than a picture without its references
+    void SkipNonKey_test(void)
+    {
+        QVERIFY(WriteIndex(m_frames));
+
+        QCOMPARE(Grab(30, false), 36);
+        QCOMPARE(Grab(13, false), 24);
+        QCOMPARE(Grab(24, false), 24);
+    }
+
+    /// The next preview of the same format reuses the pooled codec
+    void PooledCodec_test(void)
+    {
+        QVERIFY(WriteIndex(m_keyframes));
+
+        PreviewDecoder *first = PreviewDecoder::Acquire();
+        QVERIFY(first);
+        PreviewDecoder::Release(first);
+        QCOMPARE(Grab(40, false), 36);
+
+        PreviewDecoder *decoder = PreviewDecoder::Acquire();
+        QCOMPARE(decoder, first);
+        AVCodecContext *context = decoder->m_codecContext;
+        QVERIFY(context);
+        QCOMPARE((int) context->skip_frame, (int) AVDISCARD_NONKEY);
+        PreviewDecoder::Release(decoder);
+
+        QCOMPARE(Grab(20, false), 12);
+
+        decoder = PreviewDecoder::Acquire();
+        QCOMPARE(decoder, first);
+        QCOMPARE(decoder->m_codecContext, context);
+        PreviewDecoder::Release(decoder);
+    }
+};
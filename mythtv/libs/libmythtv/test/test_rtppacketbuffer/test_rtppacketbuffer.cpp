@@ -0,0 +1,3 @@
+#include "test_rtppacketbuffer.h"
+
+QTEST_APPLESS_MAIN(TestRTPPacketBuffer)
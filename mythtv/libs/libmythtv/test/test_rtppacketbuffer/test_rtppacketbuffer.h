@@ -0,0 +1,426 @@
+/*
+ *  Class TestRTPPacketBuffer
+ *
+ *  Copyright (C) MythTV Developers 2016
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <QtTest/QtTest>
+#include <QSet>
+
+#include "rtppacketbuffer.h"
+
+/// A datagram as it arrived on one of the sockets of an RTP stream
+struct Datagram
+{
+    Datagram(uint s, uint seq, const QByteArray &d) :
+        stream(s), sequence(seq), data(d) { }
+
+    uint       stream;   ///< 0 for data, 1 for column FEC, 2 for row FEC
+    uint       sequence; ///< RTP sequence number, or SNBase for FEC
+    QByteArray data;
+};
+typedef QList<Datagram> Capture;
+
+static void put16(uchar *p, uint v)
+{
+    p[0] = (v >> 8) & 0xff;
+    p[1] = v & 0xff;
+}
+
+static void put32(uchar *p, uint v)
+{
+    put16(p, v >> 16);
+    put16(p + 2, v);
+}
+
+static uint get32(const uchar *p)
+{
+    return (p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+}
+
+/// An RTP packet of TS packets, shorter every fifth packet like the
+/// last packet of a PES packet would be
+static QByteArray make_data_packet(uint sequence)
+{
+    uint ts_count = (sequence % 5) ? 7 : 1;
+    QByteArray data(12 + ts_count * 188, 0);
+    uchar *p = reinterpret_cast<uchar*>(data.data());
+
+    p[0] = 0x80;
+    p[1] = RTPDataPacket::kPayLoadTypeTS;
+    put16(p + 2, sequence);
+    put32(p + 4, sequence * 300);
+    put32(p + 8, 0x4d595448);
+
+    for (uint i = 0; i < ts_count; i++)
+    {
+        uchar *ts = p + 12 + i * 188;
+        ts[0] = 0x47;
+        for (uint j = 1; j < 188; j++)
+            ts[j] = (sequence * 7 + i * 13 + j) & 0xff;
+    }
+
+    return data;
+}
+
+/// The SMPTE 2022-1 FEC packet protecting the given data packets
+static QByteArray make_fec_packet(const QList<QByteArray> &packets,
+                                  uint fec_sequence, uint snbase,
+                                  bool row, uint offset)
+{
+    uint size = 0, length = 0, payload_type = 0, timestamp = 0;
+    for (int i = 0; i < packets.size(); i++)
+    {
+        const uchar *p = reinterpret_cast<const uchar*>(packets[i].data());
+        size          = qMax(size, (uint)packets[i].size() - 12);
+        length       ^= packets[i].size() - 12;
+        payload_type ^= p[1] & 0x7f;
+        timestamp    ^= get32(p + 4);
+    }
+
+    QByteArray fec(12 + RTPFECPacket::kHeaderSize + size, 0);
+    uchar *p = reinterpret_cast<uchar*>(fec.data());
+    p[0] = 0x80;
+    p[1] = 96;
+    put16(p + 2, fec_sequence);
+
+    uchar *h = p + 12;
+    put16(h, snbase);
+    put16(h + 2, length);
+    h[4] = 0x80 | payload_type;
+    put32(h + 8, timestamp);
+    h[12] = row ? 0x40 : 0x00;
+    h[13] = offset;
+    h[14] = packets.size();
+
+    uchar *payload = h + RTPFECPacket::kHeaderSize;
+    for (int i = 0; i < packets.size(); i++)
+    {
+        const uchar *src = reinterpret_cast<const uchar*>(packets[i].data());
+        for (int j = 12; j < packets[i].size(); j++)
+            payload[j - 12] ^= src[j];
+    }
+
+    return fec;
+}
+
+/** Builds the datagrams an SMPTE 2022-1 sender with an L x D matrix
+ *  produces. Row FEC packets follow their row, the column FEC packets
+ *  of a matrix are spread over the next matrix.
+ */
+static Capture make_capture(uint columns, uint rows, uint first_sequence,
+                            uint matrices)
+{
+    Capture capture;
+    Capture pending_columns;
+    uint fec_sequence[2] = { 0, 0 };
+
+    for (uint m = 0; m < matrices; m++)
+    {
+        uint base = first_sequence + m * columns * rows;
+        QMap<uint, QByteArray> matrix;
+
+        for (uint r = 0; r < rows; r++)
+        {
+            QList<QByteArray> row;
+            for (uint c = 0; c < columns; c++)
+            {
+                uint sequence = (base + r * columns + c) & 0xffff;
+                matrix[r * columns + c] = make_data_packet(sequence);
+                row += matrix[r * columns + c];
+                capture += Datagram(0, sequence, row.back());
+
+                if (!pending_columns.empty() && (r * columns + c) % rows == 0)
+                    capture += pending_columns.takeFirst();
+            }
+
+            uint snbase = (base + r * columns) & 0xffff;
+            capture += Datagram(2, snbase, make_fec_packet(
+                row, fec_sequence[1]++, snbase, true, 1));
+        }
+
+        for (uint c = 0; c < columns; c++)
+        {
+            QList<QByteArray> column;
+            for (uint r = 0; r < rows; r++)
+                column += matrix[r * columns + c];
+
+            uint snbase = (base + c) & 0xffff;
+            pending_columns += Datagram(1, snbase, make_fec_packet(
+                column, fec_sequence[0]++, snbase, false, columns));
+        }
+    }
+
+    capture += pending_columns;
+
+    return capture;
+}
+
+static int find_datagram(const Capture &capture, uint stream, uint sequence)
+{
+    for (int i = 0; i < capture.size(); i++)
+    {
+        if (capture[i].stream == stream && capture[i].sequence == sequence)
+            return i;
+    }
+    return -1;
+}
+
+/// Replays a capture through a buffer like IPTVStreamHandler does,
+/// skipping the datagrams in the loss set
+class Replay
+{
+  public:
+    Replay(const Capture &capture) : m_capture(capture) { }
+
+    void Run(RTPPacketBuffer &buffer, const QSet<int> &lost)
+    {
+        m_output.clear();
+
+        for (int i = 0; i < m_capture.size(); i++)
+        {
+            if (lost.contains(i))
+                continue;
+
+            UDPPacket packet(buffer.GetEmptyPacket());
+            packet.GetDataReference() = m_capture[i].data;
+            if (m_capture[i].stream == 0)
+                buffer.PushDataPacket(packet);
+            else
+                buffer.PushFECPacket(packet, m_capture[i].stream - 1);
+
+            while (buffer.HasAvailablePacket())
+            {
+                UDPPacket out(buffer.PopDataPacket());
+                m_output += out.GetData();
+                buffer.FreePacket(out);
+            }
+        }
+    }
+
+    /// Checks that the output is the data in order, apart from gaps
+    /// adding up to the given number of packets
+    bool Verify(uint lost) const
+    {
+        QMap<uint, QByteArray> sent;
+        for (int i = 0; i < m_capture.size(); i++)
+        {
+            if (m_capture[i].stream == 0)
+                sent[m_capture[i].sequence] = m_capture[i].data;
+        }
+
+        uint gaps = 0, last = 0;
+        for (int i = 0; i < m_output.size(); i++)
+        {
+            RTPDataPacket packet;
+            packet.GetDataReference() = m_output[i];
+            if (!packet.IsValid())
+                return false;
+
+            uint sequence = packet.GetSequenceNumber();
+            if (i > 0)
+                gaps += (sequence - last - 1) & 0xffff;
+            last = sequence;
+
+            if (sent.value(sequence) != m_output[i])
+            {
+                qWarning("packet %u differs from the one sent", sequence);
+                return false;
+            }
+        }
+
+        return gaps == lost && (uint)m_output.size() + lost == (uint)sent.size();
+    }
+
+    QList<QByteArray> m_output;
+
+  private:
+    const Capture &m_capture;
+};
+
+static const uint kColumns  = 10;
+static const uint kRows     = 10;
+static const uint kMatrices = 20;
+static const uint kFirst    = 1000;
+
+class TestRTPPacketBuffer : public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void NoLoss_test(void)
+    {
+        Capture capture = make_capture(kColumns, kRows, kFirst, kMatrices);
+        Replay replay(capture);
+        RTPPacketBuffer buffer(0);
+
+        replay.Run(buffer, QSet<int>());
+
+        QVERIFY(replay.Verify(0));
+        QCOMPARE(buffer.GetRecoveredPacketCount(), (uint64_t)0);
+        QCOMPARE(buffer.GetUnrecoverablePacketCount(), (uint64_t)0);
+        QCOMPARE(buffer.GetReorderWindow(), 2 * kColumns * kRows);
+    }
+
+    void Reorder_test(void)
+    {
+        Capture capture = make_capture(kColumns, kRows, kFirst, kMatrices);
+        for (int i = 100; i + 3 < capture.size(); i += 37)
+            capture.swap(i, i + 3);
+
+        Replay replay(capture);
+        RTPPacketBuffer buffer(0);
+        replay.Run(buffer, QSet<int>());
+
+        // late packets may be rebuilt before they arrive
+        QVERIFY(replay.Verify(0));
+        QCOMPARE(buffer.GetUnrecoverablePacketCount(), (uint64_t)0);
+    }
+
+    void Recovery_test_data(void)
+    {
+        QTest::addColumn<QList<int> >("lost");
+        QTest::addColumn<bool>("lose_row_fec");
+        QTest::addColumn<int>("recovered");
+        QTest::addColumn<int>("unrecoverable");
+
+        QList<int> row_burst, column_burst, two_rows;
+        for (int i = 0; i < (int)kColumns; i++)
+            row_burst << 20 + i;
+        for (int i = 0; i < (int)kRows; i++)
+            column_burst << 5 + i * kColumns;
+        two_rows = row_burst;
+        for (int i = 0; i < (int)kColumns; i++)
+            two_rows << 30 + i;
+
+        QTest::newRow("single packet")
+            << (QList<int>() << 12) << false << 1 << 0;
+        QTest::newRow("row burst") << row_burst << false << 10 << 0;
+        QTest::newRow("column burst") << column_burst << false << 10 << 0;
+        QTest::newRow("L shape")
+            << (QList<int>() << 33 << 34 << 43) << false << 3 << 0;
+        QTest::newRow("square")
+            << (QList<int>() << 33 << 34 << 43 << 44) << false << 0 << 4;
+        QTest::newRow("row FEC lost too")
+            << (QList<int>() << 12) << true << 1 << 0;
+        QTest::newRow("two row burst") << two_rows << false << 0 << 20;
+    }
+
+    void Recovery_test(void)
+    {
+        QFETCH(QList<int>, lost);
+        QFETCH(bool, lose_row_fec);
+        QFETCH(int, recovered);
+        QFETCH(int, unrecoverable);
+
+        // lose packets from the fourth matrix
+        const uint base = kFirst + 3 * kColumns * kRows;
+        Capture capture = make_capture(kColumns, kRows, kFirst, kMatrices);
+
+        QSet<int> drop;
+        for (int i = 0; i < lost.size(); i++)
+        {
+            uint sequence = base + lost[i];
+            drop << find_datagram(capture, 0, sequence);
+            if (lose_row_fec)
+            {
+                uint row = base + (lost[i] / kColumns) * kColumns;
+                drop << find_datagram(capture, 2, row);
+            }
+        }
+        QVERIFY(!drop.contains(-1));
+
+        Replay replay(capture);
+        RTPPacketBuffer buffer(0);
+        replay.Run(buffer, drop);
+
+        QVERIFY(replay.Verify(unrecoverable));
+        QCOMPARE(buffer.GetRecoveredPacketCount(), (uint64_t)recovered);
+        QCOMPARE(buffer.GetUnrecoverablePacketCount(),
+                 (uint64_t)unrecoverable);
+    }
+
+    void Wrap_test(void)
+    {
+        Capture capture = make_capture(kColumns, kRows, 65000, kMatrices);
+
+        QSet<int> drop;
+        drop << find_datagram(capture, 0, 65535);
+        drop << find_datagram(capture, 0, 0);
+        drop << find_datagram(capture, 0, 100);
+        QVERIFY(!drop.contains(-1));
+
+        Replay replay(capture);
+        RTPPacketBuffer buffer(0);
+        replay.Run(buffer, drop);
+
+        QVERIFY(replay.Verify(0));
+        QCOMPARE(buffer.GetRecoveredPacketCount(), (uint64_t)3);
+    }
+
+    void NoFEC_test(void)
+    {
+        Capture capture = make_capture(kColumns, kRows, kFirst, kMatrices);
+
+        QSet<int> drop;
+        for (int i = 0; i < capture.size(); i++)
+        {
+            if (capture[i].stream != 0)
+                drop << i;
+        }
+        drop << find_datagram(capture, 0, kFirst + 512);
+
+        Replay replay(capture);
+        RTPPacketBuffer buffer(0);
+        replay.Run(buffer, drop);
+
+        QVERIFY(replay.Verify(1));
+        QCOMPARE(buffer.GetRecoveredPacketCount(), (uint64_t)0);
+        QCOMPARE(buffer.GetUnrecoverablePacketCount(), (uint64_t)1);
+        QCOMPARE(buffer.GetReorderWindow(), RTPPacketBuffer::kMinReorderWindow);
+    }
+
+    /// Replay with 1% of the datagrams lost at random, apart from the
+    /// end so that every gap is either filled or given up on
+    void Replay_benchmark(void)
+    {
+        Capture capture = make_capture(kColumns, kRows, kFirst, 100);
+
+        QSet<int> drop;
+        uint seed = 12345;
+        for (int i = 0; i < capture.size() * 9 / 10; i++)
+        {
+            seed = seed * 1103515245 + 12345;
+            if ((seed >> 16) % 100 == 0)
+                drop << i;
+        }
+
+        Replay replay(capture);
+        uint64_t recovered = 0, unrecoverable = 0;
+
+        QBENCHMARK
+        {
+            RTPPacketBuffer buffer(0);
+            replay.Run(buffer, drop);
+            recovered = buffer.GetRecoveredPacketCount();
+            unrecoverable = buffer.GetUnrecoverablePacketCount();
+        }
+
+        QVERIFY(recovered > 0);
+        QVERIFY(replay.Verify(unrecoverable));
+    }
+};
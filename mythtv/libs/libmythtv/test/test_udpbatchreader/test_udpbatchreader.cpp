@@ -0,0 +1,3 @@
+#include "test_udpbatchreader.h"
+
+QTEST_APPLESS_MAIN(TestUDPBatchReader)
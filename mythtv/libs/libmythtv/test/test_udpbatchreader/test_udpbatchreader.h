@@ -0,0 +1,270 @@
+/*
+ *  Class TestUDPBatchReader
+ *
+ *  Copyright (C) MythTV Developers 2016
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <QtTest/QtTest>
+#include <QNetworkInterface>
+#include <QUdpSocket>
+
+#include "udpbatchreader.h"
+#include "udppacketbuffer.h"
+
+/// Seven transport stream packets, the usual IPTV datagram
+static const int kPayloadSize = 7 * 188;
+
+static const QHostAddress kGroup("239.255.43.21");
+
+static QByteArray make_datagram(uint index, int size = kPayloadSize)
+{
+    QByteArray data(size, (char)(index & 0xff));
+    data[0] = (index >> 24) & 0xff;
+    data[1] = (index >> 16) & 0xff;
+    data[2] = (index >> 8) & 0xff;
+    data[3] = index & 0xff;
+    return data;
+}
+
+static uint datagram_index(const QByteArray &data)
+{
+    const uchar *p = reinterpret_cast<const uchar*>(data.constData());
+    return (p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+}
+
+/// Returns the loopback interface, which is where the test groups live
+static QNetworkInterface loopback_interface(void)
+{
+    QList<QNetworkInterface> ifaces = QNetworkInterface::allInterfaces();
+    for (int i = 0; i < ifaces.size(); i++)
+    {
+        if (ifaces[i].flags() & QNetworkInterface::IsLoopBack)
+            return ifaces[i];
+    }
+    return QNetworkInterface();
+}
+
+class TestUDPBatchReader : public QObject
+{
+    Q_OBJECT
+
+  private:
+    /// Sends count datagrams numbered from first to the receiver's port
+    static void Send(QUdpSocket &sender, const QHostAddress &to,
+                     quint16 port, uint first, uint count,
+                     int size = kPayloadSize)
+    {
+        for (uint i = first; i < first + count; i++)
+            sender.writeDatagram(make_datagram(i, size), to, port);
+    }
+
+    /// Pops everything from the buffer, checking that it arrived in order
+    static uint Drain(PacketBuffer &buffer, uint first)
+    {
+        uint count = 0;
+        while (buffer.HasAvailablePacket())
+        {
+            UDPPacket packet = buffer.PopDataPacket();
+            QByteArray data = packet.GetData();
+            if (data.size() != kPayloadSize ||
+                datagram_index(data) != first + count)
+            {
+                return count;
+            }
+            buffer.FreePacket(packet);
+            count++;
+        }
+        return count;
+    }
+
+    /// Reads the socket the way IPTVStreamHandler did before batching
+    static uint ReadDatagrams(QUdpSocket &socket, PacketBuffer &buffer,
+                              const QHostAddress &expected)
+    {
+        QHostAddress sender;
+        quint16 senderPort;
+        uint count = 0;
+
+        while (socket.hasPendingDatagrams())
+        {
+            UDPPacket packet(buffer.GetEmptyPacket());
+            QByteArray &data = packet.GetDataReference();
+            data.resize(socket.pendingDatagramSize());
+            socket.readDatagram(data.data(), data.size(),
+                                &sender, &senderPort);
+            if (expected.isNull() || sender == expected)
+            {
+                buffer.PushDataPacket(packet);
+                count++;
+            }
+        }
+        return count;
+    }
+
+  private slots:
+    void initTestCase(void)
+    {
+        if (!UDPBatchReader::IsSupported())
+            QSKIP("Batched reads are only available on Linux");
+    }
+
+    void Read_test(void)
+    {
+        QUdpSocket receiver, sender;
+        QVERIFY(receiver.bind(QHostAddress::LocalHost, 0));
+        QVERIFY(sender.bind(QHostAddress::LocalHost, 0));
+
+        UDPPacketBuffer buffer(0);
+        UDPBatchReader reader(&buffer, -1);
+        uint rejected = 0;
+
+        // More than one batch, but not more than the default receive
+        // buffer holds
+        const uint count = UDPBatchReader::kBatchSize + 5;
+        Send(sender, QHostAddress::LocalHost, receiver.localPort(), 0, count);
+        QCOMPARE(reader.Read(receiver.socketDescriptor(), rejected),
+                 (int)count);
+        QCOMPARE(rejected, 0U);
+        QCOMPARE(Drain(buffer, 0), count);
+
+        // Nothing left to read
+        QCOMPARE(reader.Read(receiver.socketDescriptor(), rejected), 0);
+
+        // The slots that were pushed get fresh packets
+        Send(sender, QHostAddress::LocalHost, receiver.localPort(), count, 3);
+        QCOMPARE(reader.Read(receiver.socketDescriptor(), rejected), 3);
+        QCOMPARE(Drain(buffer, count), 3U);
+    }
+
+    void Sender_test(void)
+    {
+        QUdpSocket receiver, sender;
+        QVERIFY(receiver.bind(QHostAddress::LocalHost, 0));
+        QVERIFY(sender.bind(QHostAddress::LocalHost, 0));
+
+        UDPPacketBuffer buffer(0);
+        UDPBatchReader reader(&buffer, -1);
+        uint rejected = 0;
+
+        reader.SetSender(QHostAddress("127.0.0.2"));
+        Send(sender, QHostAddress::LocalHost, receiver.localPort(), 0, 10);
+        QCOMPARE(reader.Read(receiver.socketDescriptor(), rejected), 0);
+        QCOMPARE(rejected, 10U);
+        QVERIFY(!buffer.HasAvailablePacket());
+
+        reader.SetSender(QHostAddress::LocalHost);
+        Send(sender, QHostAddress::LocalHost, receiver.localPort(), 0, 10);
+        QCOMPARE(reader.Read(receiver.socketDescriptor(), rejected), 10);
+        QCOMPARE(rejected, 0U);
+        QCOMPARE(Drain(buffer, 0), 10U);
+
+        // An IPv6 sender never matches an IPv4 datagram
+        reader.SetSender(QHostAddress::LocalHostIPv6);
+        Send(sender, QHostAddress::LocalHost, receiver.localPort(), 0, 4);
+        QCOMPARE(reader.Read(receiver.socketDescriptor(), rejected), 0);
+        QCOMPARE(rejected, 4U);
+    }
+
+    void FEC_test(void)
+    {
+        QUdpSocket receiver, sender;
+        QVERIFY(receiver.bind(QHostAddress::LocalHost, 0));
+        QVERIFY(sender.bind(QHostAddress::LocalHost, 0));
+
+        // UDPPacketBuffer frees FEC packets, so nothing comes out
+        UDPPacketBuffer buffer(0);
+        UDPBatchReader reader(&buffer, 0);
+        uint rejected = 0;
+
+        Send(sender, QHostAddress::LocalHost, receiver.localPort(), 0, 8);
+        QCOMPARE(reader.Read(receiver.socketDescriptor(), rejected), 8);
+        QVERIFY(!buffer.HasAvailablePacket());
+    }
+
+    void Truncated_test(void)
+    {
+        QUdpSocket receiver, sender;
+        QVERIFY(receiver.bind(QHostAddress::LocalHost, 0));
+        QVERIFY(sender.bind(QHostAddress::LocalHost, 0));
+
+        UDPPacketBuffer buffer(0);
+        UDPBatchReader reader(&buffer, -1);
+        uint rejected = 0;
+
+        Send(sender, QHostAddress::LocalHost, receiver.localPort(), 0, 1,
+             UDPBatchReader::kMaxDatagramSize + 1);
+        QCOMPARE(reader.Read(receiver.socketDescriptor(), rejected), -1);
+    }
+
+    void Multicast_benchmark_data(void)
+    {
+        QTest::addColumn<bool>("batched");
+        QTest::newRow("readDatagram") << false;
+        QTest::newRow("recvmmsg")     << true;
+    }
+
+    /// Sends a batch worth of datagrams to a loopback multicast group
+    /// and reads them back, the way a busy IPTV recorder does
+    void Multicast_benchmark(void)
+    {
+        QFETCH(bool, batched);
+
+        QNetworkInterface lo = loopback_interface();
+        if (!lo.isValid() ||
+            !(lo.flags() & QNetworkInterface::CanMulticast))
+        {
+            QSKIP("The loopback interface doesn't do multicast");
+        }
+
+        QUdpSocket receiver, sender;
+        QVERIFY(receiver.bind(QHostAddress::AnyIPv4, 0,
+                              QUdpSocket::ShareAddress |
+                              QUdpSocket::ReuseAddressHint));
+        if (!receiver.joinMulticastGroup(kGroup, lo))
+            QSKIP("Can't join a multicast group on the loopback interface");
+
+        QVERIFY(sender.bind(QHostAddress::LocalHost, 0));
+        sender.setMulticastInterface(lo);
+        sender.setSocketOption(QAbstractSocket::MulticastLoopbackOption, 1);
+        sender.setSocketOption(QAbstractSocket::MulticastTtlOption, 1);
+
+        UDPPacketBuffer buffer(0);
+        UDPBatchReader reader(&buffer, -1);
+        reader.SetSender(QHostAddress::LocalHost);
+        const uint count = UDPBatchReader::kBatchSize;
+        uint rejected = 0;
+
+        Send(sender, kGroup, receiver.localPort(), 0, 1);
+        if (!receiver.waitForReadyRead(1000))
+            QSKIP("Multicast datagrams aren't looped back");
+        QCOMPARE(ReadDatagrams(receiver, buffer, QHostAddress::LocalHost), 1U);
+        QCOMPARE(Drain(buffer, 0), 1U);
+
+        uint total = 0;
+        QBENCHMARK
+        {
+            Send(sender, kGroup, receiver.localPort(), 0, count);
+            if (batched)
+                reader.Read(receiver.socketDescriptor(), rejected);
+            else
+                ReadDatagrams(receiver, buffer, QHostAddress::LocalHost);
+            total += Drain(buffer, 0);
+        }
+
+        QVERIFY(total > 0);
+    }
+};
@@ -7,14 +7,19 @@
 
 // QT headers
 #include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
 #include <QDomDocument>
 #include <QString>
+#include <QHash>
+#include <QMutex>
 #include <QBrush>
 #include <QLinearGradient>
 #include <QRadialGradient>
 
 // libmyth headers
 #include "mythlogging.h"
+#include "mythtimer.h"
 
 // Mythui headers
 #include "mythmainwindow.h"
@@ -323,6 +328,115 @@ QString XMLParseBase::parseText(QDomElement &element)
 static MythUIType *globalObjectStore = NULL;
 static QStringList loadedBaseFiles;
 
+/// A theme file as parsed by doLoad(), with its windows indexed by name
+class ThemeFile
+{
+  public:
+    QDateTime                   m_modified;
+    qint64                      m_size;
+    QDomDocument                m_doc;
+    QStringList                 m_includes;  ///< base files, in file order
+    QHash<QString, QDomElement> m_windows;
+    /// Number of m_includes that come before each window
+    QHash<QString, int>         m_windowIncludes;
+    /// First window without a name, windows after it can't be loaded
+    QDomElement                 m_unnamed;
+};
+
+// Recursive since loading a window can load the base files it includes
+static QMutex themeCacheLock(QMutex::Recursive);
+static QHash<QString, ThemeFile*> themeCache;
+
+/** \brief Returns the parsed theme file, parsing it only if it isn't in
+ *         the cache or has changed since it was parsed.
+ *
+ *  themeCacheLock must be held while the result is in use.
+ */
+static ThemeFile *GetThemeFile(const QString &filename)
+{
+    QFileInfo info(filename);
+    ThemeFile *theme = themeCache.value(filename);
+
+    if (theme && info.exists() && theme->m_size == info.size() &&
+        theme->m_modified == info.lastModified())
+    {
+        return theme;
+    }
+
+    delete themeCache.take(filename);
+
+    QFile f(filename);
+    if (!f.open(QIODevice::ReadOnly))
+        return NULL;
+
+    MythTimer timer;
+    timer.start();
+
+    theme = new ThemeFile;
+    theme->m_modified = info.lastModified();
+    theme->m_size = info.size();
+
+    QString errorMsg;
+    int errorLine = 0;
+    int errorColumn = 0;
+
+    if (!theme->m_doc.setContent(&f, false, &errorMsg, &errorLine,
+                                 &errorColumn))
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC +
+            QString("Location: '%1' @ %2 column: %3"
+                    "\n\t\t\tError: %4")
+                .arg(qPrintable(filename)).arg(errorLine).arg(errorColumn)
+                .arg(qPrintable(errorMsg)));
+        delete theme;
+        return NULL;
+    }
+
+    f.close();
+
+    QDomElement docElem = theme->m_doc.documentElement();
+    for (QDomNode n = docElem.firstChild(); !n.isNull(); n = n.nextSibling())
+    {
+        QDomElement e = n.toElement();
+        if (e.isNull())
+            continue;
+
+        if (e.tagName() == "include")
+        {
+            QString include = XMLParseBase::getFirstText(e);
+            if (!include.isEmpty())
+                theme->m_includes.push_back(include);
+        }
+        else if (e.tagName() == "window")
+        {
+            QString name = e.attribute("name", "");
+            if (name.isEmpty())
+            {
+                theme->m_unnamed = e;
+                break;
+            }
+
+            QString include = e.attribute("include", "");
+            if (!include.isEmpty())
+                theme->m_includes.push_back(include);
+
+            // The first definition of a window wins
+            if (!theme->m_windows.contains(name))
+            {
+                theme->m_windows[name] = e;
+                theme->m_windowIncludes[name] = theme->m_includes.size();
+            }
+        }
+    }
+
+    themeCache[filename] = theme;
+
+    LOG(VB_GUI, LOG_INFO, LOC + QString("Parsed %1 windows from %2 in %3 ms")
+        .arg(theme->m_windows.size()).arg(filename).arg(timer.elapsed()));
+
+    return theme;
+}
+
 MythUIType *XMLParseBase::GetGlobalObjectStore(void)
 {
     if (!globalObjectStore)
@@ -338,6 +452,10 @@ void XMLParseBase::ClearGlobalObjectStore(void)
 
     // clear any loaded base xml files which will force a reload the next time they are used
     loadedBaseFiles.clear();
+
+    QMutexLocker locker(&themeCacheLock);
+    qDeleteAll(themeCache);
+    themeCache.clear();
 }
 
 void XMLParseBase::ParseChildren(const QString &filename,
@@ -622,50 +740,15 @@ MythUIType *XMLParseBase::ParseUIType(
 bool XMLParseBase::WindowExists(const QString &xmlfile,
                                 const QString &windowname)
 {
+    QMutexLocker locker(&themeCacheLock);
+
     const QStringList searchpath = GetMythUI()->GetThemeSearchPath();
     QStringList::const_iterator it = searchpath.begin();
     for (; it != searchpath.end(); ++it)
     {
-        QString themefile = *it + xmlfile;
-        QFile f(themefile);
-
-        if (!f.open(QIODevice::ReadOnly))
-            continue;
-
-        QDomDocument doc;
-        QString errorMsg;
-        int errorLine = 0;
-        int errorColumn = 0;
-
-        if (!doc.setContent(&f, false, &errorMsg, &errorLine, &errorColumn))
-        {
-            LOG(VB_GENERAL, LOG_ERR, LOC +
-                QString("Location: '%1' @ %2 column: %3"
-                        "\n\t\t\tError: %4")
-                    .arg(qPrintable(themefile)).arg(errorLine).arg(errorColumn)
-                    .arg(qPrintable(errorMsg)));
-            f.close();
-            continue;
-        }
-
-        f.close();
-
-        QDomElement docElem = doc.documentElement();
-        QDomNode n = docElem.firstChild();
-        while (!n.isNull())
-        {
-            QDomElement e = n.toElement();
-            if (!e.isNull())
-            {
-                if (e.tagName() == "window")
-                {
-                    QString name = e.attribute("name", "");
-                    if (name == windowname)
-                        return true;
-                }
-            }
-            n = n.nextSibling();
-        }
+        ThemeFile *theme = GetThemeFile(*it + xmlfile);
+        if (theme && theme->m_windows.contains(windowname))
+            return true;
     }
 
     return false;
@@ -708,29 +791,50 @@ bool XMLParseBase::doLoad(const QString &windowname,
                           bool onlywindows,
                           bool showWarnings)
 {
-    QDomDocument doc;
-    QFile f(filename);
+    QMutexLocker locker(&themeCacheLock);
 
-    if (!f.open(QIODevice::ReadOnly))
+    ThemeFile *theme = GetThemeFile(filename);
+    if (!theme)
         return false;
 
-    QString errorMsg;
-    int errorLine = 0;
-    int errorColumn = 0;
-
-    if (!doc.setContent(&f, false, &errorMsg, &errorLine, &errorColumn))
+    if (onlywindows)
     {
-        LOG(VB_GENERAL, LOG_ERR, LOC +
-            QString("Location: '%1' @ %2 column: %3"
-                    "\n\t\t\tError: %4")
-                .arg(qPrintable(filename)).arg(errorLine).arg(errorColumn)
-                .arg(qPrintable(errorMsg)));
-        f.close();
-        return false;
-    }
+        // Load the base files this window, and those before it, include
+        QHash<QString, int>::const_iterator wit =
+            theme->m_windowIncludes.constFind(windowname);
+        int includes = (wit == theme->m_windowIncludes.constEnd()) ?
+            theme->m_includes.size() : *wit;
+        // Copied since loading an include may replace the cached file
+        QStringList baseFiles = theme->m_includes.mid(0, includes);
+        QDomElement window = theme->m_windows.value(windowname);
+        QDomElement unnamed = theme->m_unnamed;
+
+        for (int i = 0; i < baseFiles.size(); i++)
+            LoadBaseTheme(baseFiles[i]);
+
+        if (window.isNull())
+        {
+            if (!unnamed.isNull())
+            {
+                VERBOSE_XML(VB_GENERAL, LOG_ERR, filename, unnamed,
+                            "Window needs a name");
+            }
+            return false;
+        }
 
-    f.close();
+        MythTimer timer;
+        timer.start();
+
+        ParseChildren(filename, window, parent, showWarnings);
+
+        LOG(VB_GUI, LOG_INFO, LOC + QString("Created window %1 in %2 ms")
+            .arg(windowname).arg(timer.elapsed()));
+
+        return true;
+    }
 
+    // Base files are only loaded once per theme, parse the whole document
+    QDomDocument doc = theme->m_doc;
     QDomElement docElem = doc.documentElement();
     QDomNode n = docElem.firstChild();
     while (!n.isNull())
@@ -746,85 +850,59 @@ bool XMLParseBase::doLoad(const QString &windowname,
                      LoadBaseTheme(include);
             }
 
-            if (onlywindows && e.tagName() == "window")
+            QString type = e.tagName();
+            if (type == "font" || type == "fontdef")
             {
-                QString name = e.attribute("name", "");
-                QString include = e.attribute("include", "");
-                if (name.isEmpty())
-                {
-                    VERBOSE_XML(VB_GENERAL, LOG_ERR, filename, e,
-                                "Window needs a name");
-                    return false;
-                }
-
-                if (!include.isEmpty())
-                    LoadBaseTheme(include);
+                bool global = (GetGlobalObjectStore() == parent);
+                MythFontProperties *font = MythFontProperties::ParseFromXml(
+                    filename, e, parent, global, showWarnings);
 
-                if (name == windowname)
+                if (!global && font)
                 {
-                    ParseChildren(filename, e, parent, showWarnings);
-                    return true;
+                    QString name = e.attribute("name");
+                    parent->AddFont(name, font);
                 }
+                delete font;
             }
-
-            if (!onlywindows)
+            else if (type == "imagetype" ||
+                     type == "textarea" ||
+                     type == "group" ||
+                     type == "textedit" ||
+                     type == "button" ||
+                     type == "buttonlist" ||
+                     type == "buttonlist2" ||
+                     type == "buttontree" ||
+                     type == "spinbox" ||
+                     type == "checkbox" ||
+                     type == "statetype" ||
+                     type == "window" ||
+                     type == "clock" ||
+                     type == "progressbar" ||
+                     type == "scrollbar" ||
+                     type == "webbrowser" ||
+                     type == "guidegrid" ||
+                     type == "shape" ||
+                     type == "editbar" ||
+                     type == "video")
             {
-                QString type = e.tagName();
-                if (type == "font" || type == "fontdef")
-                {
-                    bool global = (GetGlobalObjectStore() == parent);
-                    MythFontProperties *font = MythFontProperties::ParseFromXml(
-                        filename, e, parent, global, showWarnings);
-
-                    if (!global && font)
-                    {
-                        QString name = e.attribute("name");
-                        parent->AddFont(name, font);
-                    }
-                    delete font;
-                }
-                else if (type == "imagetype" ||
-                         type == "textarea" ||
-                         type == "group" ||
-                         type == "textedit" ||
-                         type == "button" ||
-                         type == "buttonlist" ||
-                         type == "buttonlist2" ||
-                         type == "buttontree" ||
-                         type == "spinbox" ||
-                         type == "checkbox" ||
-                         type == "statetype" ||
-                         type == "window" ||
-                         type == "clock" ||
-                         type == "progressbar" ||
-                         type == "scrollbar" ||
-                         type == "webbrowser" ||
-                         type == "guidegrid" ||
-                         type == "shape" ||
-                         type == "editbar" ||
-                         type == "video")
-                {
 
-                    // We don't want widgets in base.xml
-                    // depending on each other so ignore dependsMap
-                    QMap<QString, QString> dependsMap;
-                    MythUIType *uitype = NULL;
-                    uitype = ParseUIType(filename, e, type, parent,
-                                         NULL, showWarnings, dependsMap);
-                    if (uitype)
-                        uitype->ConnectDependants(true);
-                }
-                else
-                {
-                    VERBOSE_XML(VB_GENERAL, LOG_ERR, filename, e,
-                                "Unknown widget type");
-                }
+                // We don't want widgets in base.xml
+                // depending on each other so ignore dependsMap
+                QMap<QString, QString> dependsMap;
+                MythUIType *uitype = NULL;
+                uitype = ParseUIType(filename, e, type, parent,
+                                     NULL, showWarnings, dependsMap);
+                if (uitype)
+                    uitype->ConnectDependants(true);
+            }
+            else
+            {
+                VERBOSE_XML(VB_GENERAL, LOG_ERR, filename, e,
+                            "Unknown widget type");
             }
         }
         n = n.nextSibling();
     }
-    if (onlywindows)
-        return false;
     return true;
 }
 
@@ -24,6 +24,7 @@
 #if !( CONFIG_DARWIN || CONFIG_CYGWIN || defined(__FreeBSD__) || defined(_WIN32))
 #define USE_SETSOCKOPT
 #include <sys/sendfile.h>
+#include <unistd.h>
 #endif
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -169,7 +170,11 @@ HTTPRequest::HTTPRequest() : m_procReqLineExp ( "[ \r\n][ \r\n]*"  ),
                              m_nResponseStatus( 200 ),
                              m_pPostProcess   ( NULL ),
                              m_bKeepAlive     ( true ),
-                             m_nKeepAliveTimeout ( 0 )
+                             m_nKeepAliveTimeout ( 0 ),
+                             m_bDeferFileBody ( false ),
+                             m_nDeferredFile  ( -1 ),
+                             m_llDeferredStart( 0 ),
+                             m_llDeferredBytes( 0 )
 {
     m_response.open( QIODevice::ReadWrite );
 }
@@ -178,6 +183,18 @@ HTTPRequest::HTTPRequest() : m_procReqLineExp ( "[ \r\n][ \r\n]*"  ),
 //
 /////////////////////////////////////////////////////////////////////////////
 
+HTTPRequest::~HTTPRequest()
+{
+#ifdef USE_SETSOCKOPT
+    if (m_nDeferredFile >= 0)
+        close( m_nDeferredFile );
+#endif
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
 RequestType HTTPRequest::SetRequestType( const QString &sType )
 {
     // HTTP
@@ -766,11 +783,73 @@ qint64 HTTPRequest::SendData( QIODevice *pDevice, qint64 llStart, qint64 llBytes
 
 qint64 HTTPRequest::SendFile( QFile &file, qint64 llStart, qint64 llBytes )
 {
+#ifdef USE_SETSOCKOPT
+    // ----------------------------------------------------------------------
+    // Leave the body to the connection's owner, it can sendfile() it
+    // without holding up a worker thread.
+    // ----------------------------------------------------------------------
+
+    if (m_bDeferFileBody && !IsEncrypted() && m_nDeferredFile < 0)
+    {
+        m_nDeferredFile = dup( file.handle() );
+
+        if (m_nDeferredFile >= 0)
+        {
+            m_llDeferredStart = llStart;
+            m_llDeferredBytes = llBytes;
+            return( llBytes );
+        }
+    }
+#endif
+
     qint64 sent = SendData( (QIODevice *)(&file), llStart, llBytes );
 
     return( sent );
 }
 
+/////////////////////////////////////////////////////////////////////////////
+// Returns the file whose body still has to be sent, the caller owns the
+// descriptor. Returns -1 if the whole response has been written.
+/////////////////////////////////////////////////////////////////////////////
+
+int HTTPRequest::TakeDeferredFile( qint64 &llStart, qint64 &llBytes )
+{
+    int nFile = m_nDeferredFile;
+
+    llStart = m_llDeferredStart;
+    llBytes = m_llDeferredBytes;
+
+    m_nDeferredFile = -1;
+
+    return( nFile );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Writes a deferred file body here after all, for when the connection
+// can't be handed on.
+/////////////////////////////////////////////////////////////////////////////
+
+qint64 HTTPRequest::SendDeferredFile( void )
+{
+    qint64 llStart = 0;
+    qint64 llBytes = 0;
+    int    nFile   = TakeDeferredFile( llStart, llBytes );
+
+    if (nFile < 0)
+        return( 0 );
+
+    QFile file;
+    if (!file.open( nFile, QIODevice::ReadOnly, QFileDevice::AutoCloseHandle ))
+    {
+#ifdef USE_SETSOCKOPT
+        close( nFile );
+#endif
+        return( -1 );
+    }
+
+    return( SendData( (QIODevice *)(&file), llStart, llBytes ) );
+}
+
 
 /////////////////////////////////////////////////////////////////////////////
 //
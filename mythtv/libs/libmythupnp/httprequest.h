@@ -161,6 +161,11 @@ class UPNP_PUBLIC HTTPRequest
         bool                m_bKeepAlive;
         uint                m_nKeepAliveTimeout;
 
+        bool                m_bDeferFileBody;
+        int                 m_nDeferredFile;
+        qint64              m_llDeferredStart;
+        qint64              m_llDeferredBytes;
+
     protected:
 
         RequestType     SetRequestType      ( const QString &sType  );
@@ -202,7 +207,7 @@ class UPNP_PUBLIC HTTPRequest
     public:
         
                         HTTPRequest     ();
-        virtual        ~HTTPRequest     () {};
+        virtual        ~HTTPRequest     ();
 
         bool            ParseRequest    ();
 
@@ -249,6 +254,11 @@ class UPNP_PUBLIC HTTPRequest
 
         void            SetKeepAliveTimeout ( int nTimeout ) { m_nKeepAliveTimeout = nTimeout; }
 
+        void            SetDeferFileBody    ( bool bDefer ) { m_bDeferFileBody = bDefer; }
+        bool            HasDeferredFile     () const { return m_nDeferredFile >= 0; }
+        int             TakeDeferredFile    ( qint64 &llStart, qint64 &llBytes );
+        qint64          SendDeferredFile    ( void );
+
         bool            IsUrlProtected      ( const QString &sBaseUrl );
 
         // ------------------------------------------------------------------
@@ -22,6 +22,7 @@
 #include <compat.h>
 #ifndef _WIN32
 #include <sys/utsname.h> 
+#include <unistd.h>
 #endif
 
 // Qt headers
@@ -41,6 +42,9 @@
 #include "htmlserver.h"
 #include "mythversion.h"
 #include "mythcorecontext.h"
+#ifndef _WIN32
+#include "httpsocketpoller.h"
+#endif
 
 #include "serviceHosts/rttiServiceHost.h"
 
@@ -116,7 +120,7 @@ QString  HttpServer::s_platform;
 
 HttpServer::HttpServer() :
     ServerPool(), m_sSharePath(GetShareDir()),
-    m_threadPool("HttpServerPool"), m_running(true),
+    m_threadPool("HttpServerPool"), m_pPoller(NULL), m_running(true),
     m_privateToken(QUuid::createUuid().toString()) // Cryptographically random and sufficiently long enough to act as a secure token
 {
     // Number of connections processed concurrently
@@ -129,6 +133,12 @@ HttpServer::HttpServer() :
     LOG(VB_HTTP, LOG_NOTICE, QString("HttpServer(): Max Thread Count %1")
                                 .arg(m_threadPool.maxThreadCount()));
 
+#ifndef _WIN32
+    // Idle keep-alive connections and file bodies are looked after by
+    // the poller, the workers only handle the requests themselves
+    m_pPoller = new HttpSocketPoller(*this);
+#endif
+
     // ----------------------------------------------------------------------
     // Build Platform String
     // ----------------------------------------------------------------------
@@ -174,8 +184,18 @@ HttpServer::~HttpServer()
     m_running = false;
     m_rwlock.unlock();
 
+#ifndef _WIN32
+    // Workers may still be handing connections over until the pool stops
+    m_pPoller->Stop();
+#endif
+
     m_threadPool.Stop();
 
+#ifndef _WIN32
+    delete m_pPoller;
+    m_pPoller = NULL;
+#endif
+
     while (!m_extensions.empty())
     {
         delete m_extensions.takeFirst();
@@ -319,6 +339,31 @@ void HttpServer::newTcpConnection(qt_socket_fd_t socket)
         QString("HttpServer%1").arg(socket));
 }
 
+/////////////////////////////////////////////////////////////////////////////
+// Called by the poller when a request arrives on an idle connection
+/////////////////////////////////////////////////////////////////////////////
+
+void HttpServer::ResumeConnection(qt_socket_fd_t socket)
+{
+    if (!IsRunning())
+    {
+#ifndef _WIN32
+        close(socket);
+#endif
+        return;
+    }
+
+    // Queued rather than reserved, waking connections must not be able to
+    // start more workers than the pool allows.
+    m_threadPool.start(
+        new HttpWorker(*this, socket, kTCPServer
+#ifndef QT_NO_OPENSSL
+                       , m_sslConfig
+#endif
+                       ),
+        QString("HttpServer%1").arg(socket));
+}
+
 /////////////////////////////////////////////////////////////////////////////
 //
 /////////////////////////////////////////////////////////////////////////////
@@ -482,6 +527,7 @@ void HttpWorker::run(void)
     HTTPRequest            *pRequest   = NULL;
     QTcpSocket             *pSocket;
     bool                    bEncrypted = false;
+    bool                    bHandedOff = false;
 
     if (m_connectionType == kSSLServer)
     {
@@ -556,6 +602,8 @@ void HttpWorker::run(void)
                 if (pRequest != NULL)
                 {
                     pRequest->m_bEncrypted = bEncrypted;
+                    pRequest->SetDeferFileBody(
+                        m_httpServer.GetSocketPoller() != NULL && !bEncrypted);
                     if ( pRequest->ParseRequest() )
                     {
                         bKeepAlive = pRequest->GetKeepAlive();
@@ -604,6 +652,27 @@ void HttpWorker::run(void)
                     if ( pRequest->m_pPostProcess != NULL )
                         pRequest->m_pPostProcess->ExecutePostProcess();
 
+                    // -------------------------------------------------------
+                    // Let the poller send any file body and wait for the
+                    // next request, this worker is then free for others.
+                    // -------------------------------------------------------
+                    if (HandOff(pSocket, pRequest, bKeepAlive))
+                    {
+                        bHandedOff = true;
+                        delete pRequest;
+                        pRequest = NULL;
+                        break;
+                    }
+
+                    if (pRequest->SendDeferredFile() < 0)
+                    {
+                        bKeepAlive = false;
+                        LOG(VB_HTTP, LOG_ERR,
+                            QString("socket(%1) - Error sending file... "
+                                    "Closing connection")
+                                .arg(pSocket->socketDescriptor()));
+                    }
+
                     delete pRequest;
                     pRequest = NULL;
                 }
@@ -628,6 +697,16 @@ void HttpWorker::run(void)
 
     delete pRequest;
 
+    if (bHandedOff)
+    {
+        LOG(VB_HTTP, LOG_INFO, QString("HttpWorker(%1): Connection handed "
+                                       "to poller. %2 requests were handled")
+                                            .arg(m_socket)
+                                            .arg(nRequestsHandled));
+        delete pSocket;
+        return;
+    }
+
     if ((pSocket->error() != QAbstractSocket::UnknownSocketError) &&
         !(bKeepAlive && pSocket->error() == QAbstractSocket::SocketTimeoutError)) // This 'error' isn't an error when keep-alive is active
     {
@@ -693,4 +772,63 @@ void HttpWorker::run(void)
 #endif
 }
 
+/////////////////////////////////////////////////////////////////////////////
+// Passes the connection to the poller if the response has a file body
+// still to send or the client may send another request. Returns false if
+// the connection must stay with this worker.
+/////////////////////////////////////////////////////////////////////////////
+
+bool HttpWorker::HandOff(QTcpSocket *pSocket, HTTPRequest *pRequest,
+                         bool bKeepAlive)
+{
+#ifndef _WIN32
+    HttpSocketPoller *pPoller = m_httpServer.GetSocketPoller();
+
+    if (!pPoller || m_connectionType == kSSLServer ||
+        !m_httpServer.IsRunning() ||
+        (!bKeepAlive && !pRequest->HasDeferredFile()))
+    {
+        return false;
+    }
+
+    // A pipelined request has already been read into this socket
+    if (pSocket->bytesAvailable() > 0)
+        return false;
+
+    // The poller writes to the descriptor directly, so the headers
+    // buffered here must be out first.
+    while (pSocket->bytesToWrite() > 0)
+    {
+        if (!pSocket->waitForBytesWritten(5000))
+            return false;
+    }
+
+    int nSocket = dup(pSocket->socketDescriptor());
+    if (nSocket < 0)
+        return false;
 
+    qint64 llStart = 0;
+    qint64 llBytes = 0;
+    int    nFile   = pRequest->TakeDeferredFile(llStart, llBytes);
+
+    // Only closes this descriptor, the connection stays open on the copy
+    pSocket->abort();
+
+    if (nFile >= 0)
+    {
+        pPoller->AddTransfer(nSocket, nFile, llStart, llBytes,
+                             bKeepAlive, m_socketTimeout);
+    }
+    else
+    {
+        pPoller->AddIdle(nSocket, m_socketTimeout);
+    }
+
+    return true;
+#else
+    (void) pSocket;
+    (void) pRequest;
+    (void) bKeepAlive;
+    return false;
+#endif
+}
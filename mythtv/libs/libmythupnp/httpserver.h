@@ -45,6 +45,7 @@
 typedef struct timeval  TaskTime;
 
 class HttpWorkerThread;
+class HttpSocketPoller;
 class QScriptEngine;
 class HttpServer;
 #ifndef QT_NO_OPENSSL
@@ -138,6 +139,11 @@ class UPNP_PUBLIC HttpServer : public ServerPool
         return tmp;
     }
 
+    /// Returns the poller idle connections and file bodies are handed to,
+    /// NULL on platforms without one
+    HttpSocketPoller *GetSocketPoller(void) const { return m_pPoller; }
+    void ResumeConnection(qt_socket_fd_t socket);
+
     static QString GetPlatform(void);
     static QString GetServerVersion(void);
 
@@ -148,6 +154,7 @@ class UPNP_PUBLIC HttpServer : public ServerPool
     QMultiMap< QString, HttpServerExtension* >  m_basePaths;
     QString                 m_sSharePath;
     MThreadPool             m_threadPool;
+    HttpSocketPoller       *m_pPoller;
     bool                    m_running; // protected by m_rwlock
 
     static QMutex           s_platformLock;
@@ -194,6 +201,8 @@ class HttpWorker : public QRunnable
     virtual void run(void);
 
   protected:
+    bool HandOff(QTcpSocket *pSocket, HTTPRequest *pRequest, bool bKeepAlive);
+
     HttpServer &m_httpServer; 
     qt_socket_fd_t m_socket;
     int         m_socketTimeout;
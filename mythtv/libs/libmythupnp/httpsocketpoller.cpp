@@ -0,0 +1,384 @@
+//////////////////////////////////////////////////////////////////////////////
+// Program Name: httpsocketpoller.cpp
+// Created     : Jun. 14, 2016
+//
+// Purpose     : Waits on idle keep-alive connections and streams file
+//               bodies for the HttpServer without tying up workers
+//
+// Licensed under the GPL v2 or later, see COPYING for details
+//
+//////////////////////////////////////////////////////////////////////////////
+
+// Own headers
+#include "httpsocketpoller.h"
+
+// POSIX headers
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+
+// C++ headers
+#include <algorithm>
+
+#include "mythconfig.h"
+#if !( CONFIG_DARWIN || CONFIG_CYGWIN || defined(__FreeBSD__) )
+#define USE_SENDFILE
+#include <sys/sendfile.h>
+#endif
+
+// Qt headers
+#include <QVector>
+
+// MythTV headers
+#include "httpserver.h"
+#include "mythlogging.h"
+
+#define LOC QString("HttpSocketPoller: ")
+
+const int HttpSocketPoller::kStallTimeout = 30 * 1000;
+
+// Largest chunk sent before looking at the other connections again
+#define SENDFILE_CHUNK_SIZE (4 * 1024 * 1024)
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
+HttpSocketPoller::HttpSocketPoller( HttpServer &httpServer )
+    : MThread("HttpSocketPoller"),
+      m_httpServer( httpServer ),
+      m_bStop     ( false ),
+      m_nCount    ( 0 )
+{
+    m_wakeFds[0] = m_wakeFds[1] = -1;
+
+    if (pipe( m_wakeFds ) < 0)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + "Unable to create wake pipe " + ENO);
+        m_wakeFds[0] = m_wakeFds[1] = -1;
+    }
+    else
+    {
+        fcntl( m_wakeFds[0], F_SETFL, O_NONBLOCK );
+        fcntl( m_wakeFds[1], F_SETFL, O_NONBLOCK );
+    }
+
+    start();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
+HttpSocketPoller::~HttpSocketPoller()
+{
+    Stop();
+    wait();
+
+    QList<Connection>::iterator it = m_connections.begin();
+    for (; it != m_connections.end(); ++it)
+        Close( *it );
+    m_connections.clear();
+
+    for (it = m_pending.begin(); it != m_pending.end(); ++it)
+        Close( *it );
+    m_pending.clear();
+
+    if (m_wakeFds[0] >= 0)
+        close( m_wakeFds[0] );
+    if (m_wakeFds[1] >= 0)
+        close( m_wakeFds[1] );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
+void HttpSocketPoller::Stop( void )
+{
+    m_lock.lock();
+    m_bStop = true;
+    m_lock.unlock();
+
+    Wake();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Waits for the next request on a connection
+/////////////////////////////////////////////////////////////////////////////
+
+void HttpSocketPoller::AddIdle( int nSocket, int nTimeout )
+{
+    Connection conn;
+    conn.m_nSocket     = nSocket;
+    conn.m_nFile       = -1;
+    conn.m_llOffset    = 0;
+    conn.m_llRemaining = 0;
+    conn.m_bKeepAlive  = true;
+    conn.m_nTimeout    = nTimeout;
+
+    Add( conn );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Sends llBytes of nFile from llStart, then waits for the next request
+// if bKeepAlive is set or closes the connection.
+/////////////////////////////////////////////////////////////////////////////
+
+void HttpSocketPoller::AddTransfer( int nSocket, int nFile,
+                                    qint64 llStart, qint64 llBytes,
+                                    bool bKeepAlive, int nTimeout )
+{
+    Connection conn;
+    conn.m_nSocket     = nSocket;
+    conn.m_nFile       = nFile;
+    conn.m_llOffset    = llStart;
+    conn.m_llRemaining = llBytes;
+    conn.m_bKeepAlive  = bKeepAlive;
+    conn.m_nTimeout    = nTimeout;
+
+    Add( conn );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
+int HttpSocketPoller::GetConnectionCount( void ) const
+{
+    QMutexLocker locker(&m_lock);
+    return m_nCount;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
+void HttpSocketPoller::Add( const Connection &conn )
+{
+    m_lock.lock();
+    m_pending.push_back( conn );
+    m_pending.back().m_idle.start();
+    m_nCount++;
+    m_lock.unlock();
+
+    Wake();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
+void HttpSocketPoller::Wake( void )
+{
+    if (m_wakeFds[1] >= 0)
+    {
+        char c = 0;
+        if (write( m_wakeFds[1], &c, 1 ) < 0 && errno != EAGAIN)
+            LOG(VB_HTTP, LOG_ERR, LOC + "Unable to wake poller " + ENO);
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Sends as much of the body as the socket takes without blocking,
+// returns false if the connection failed.
+/////////////////////////////////////////////////////////////////////////////
+
+bool HttpSocketPoller::Send( Connection &conn )
+{
+#ifdef USE_SENDFILE
+    qint64 llChunk = SENDFILE_CHUNK_SIZE;
+
+    while (conn.m_llRemaining > 0 && llChunk > 0)
+    {
+        off_t   offset  = conn.m_llOffset;
+        size_t  nCount  = std::min( conn.m_llRemaining, llChunk );
+        ssize_t nSent   = sendfile( conn.m_nSocket, conn.m_nFile,
+                                    &offset, nCount );
+        if (nSent < 0)
+        {
+            if (errno == EAGAIN || errno == EINTR)
+                return true;
+
+            LOG(VB_HTTP, LOG_INFO, LOC + QString("socket(%1) - sendfile ")
+                .arg(conn.m_nSocket) + ENO);
+            return false;
+        }
+
+        // The file is shorter than the Content-Length we sent
+        if (nSent == 0)
+            return false;
+
+        conn.m_llOffset    += nSent;
+        conn.m_llRemaining -= nSent;
+        llChunk            -= nSent;
+        conn.m_idle.start();
+    }
+
+    return true;
+#else
+    (void) conn;
+    return false;
+#endif
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
+void HttpSocketPoller::Close( Connection &conn )
+{
+    if (conn.m_nFile >= 0)
+        close( conn.m_nFile );
+    if (conn.m_nSocket >= 0)
+        close( conn.m_nSocket );
+
+    conn.m_nFile   = -1;
+    conn.m_nSocket = -1;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
+void HttpSocketPoller::run( void )
+{
+    RunProlog();
+
+    QVector<struct pollfd> fds;
+
+    while (true)
+    {
+        // ------------------------------------------------------------------
+        // Pick up new connections
+        // ------------------------------------------------------------------
+
+        m_lock.lock();
+        if (m_bStop)
+        {
+            m_lock.unlock();
+            break;
+        }
+        m_connections += m_pending;
+        m_pending.clear();
+        m_lock.unlock();
+
+        // ------------------------------------------------------------------
+        // Wait until a connection is ready or the next one times out
+        // ------------------------------------------------------------------
+
+        fds.resize( m_connections.size() + 1 );
+
+        fds[0].fd      = m_wakeFds[0];
+        fds[0].events  = POLLIN;
+        fds[0].revents = 0;
+
+        int nWait = 1000;
+
+        for (int i = 0; i < m_connections.size(); i++)
+        {
+            const Connection &conn = m_connections[i];
+            bool bSending = (conn.m_nFile >= 0);
+            int  nTimeout = bSending ? kStallTimeout : conn.m_nTimeout;
+
+            fds[i + 1].fd      = conn.m_nSocket;
+            fds[i + 1].events  = bSending ? POLLOUT : POLLIN;
+            fds[i + 1].revents = 0;
+
+            nWait = std::min( nWait, std::max(
+                nTimeout - (int)conn.m_idle.elapsed(), 0 ) );
+        }
+
+        if (poll( fds.data(), fds.size(), nWait ) < 0 && errno != EINTR)
+        {
+            LOG(VB_GENERAL, LOG_ERR, LOC + "poll() failed " + ENO);
+            usleep(100 * 1000);
+            continue;
+        }
+
+        if (fds[0].revents & POLLIN)
+        {
+            char buf[128];
+            while (read( m_wakeFds[0], buf, sizeof(buf) ) > 0)
+                ;
+        }
+
+        // ------------------------------------------------------------------
+        // Service the connections, backwards so removals keep fds[] in step
+        // ------------------------------------------------------------------
+
+        int nClosed = 0;
+
+        for (int i = m_connections.size() - 1; i >= 0; i--)
+        {
+            Connection &conn    = m_connections[i];
+            short       revents = fds[i + 1].revents;
+            bool        bRemove = false;
+
+            if (conn.m_nFile >= 0)
+            {
+                if (revents & (POLLOUT | POLLERR | POLLHUP | POLLNVAL))
+                {
+                    if ((revents & (POLLERR | POLLNVAL)) || !Send( conn ))
+                    {
+                        Close( conn );
+                        bRemove = true;
+                    }
+                    else if (conn.m_llRemaining <= 0)
+                    {
+                        close( conn.m_nFile );
+                        conn.m_nFile = -1;
+                        conn.m_idle.start();
+
+                        if (!conn.m_bKeepAlive)
+                        {
+                            Close( conn );
+                            bRemove = true;
+                        }
+                    }
+                }
+                else if (conn.m_idle.elapsed() > kStallTimeout)
+                {
+                    LOG(VB_HTTP, LOG_WARNING, LOC +
+                        QString("socket(%1) - Client stopped reading, "
+                                "%2 bytes not sent")
+                            .arg(conn.m_nSocket).arg(conn.m_llRemaining));
+                    Close( conn );
+                    bRemove = true;
+                }
+            }
+            else if (revents & (POLLERR | POLLNVAL))
+            {
+                Close( conn );
+                bRemove = true;
+            }
+            else if (revents & (POLLIN | POLLHUP))
+            {
+                // The worker sees a closed connection itself
+                m_httpServer.ResumeConnection( conn.m_nSocket );
+                conn.m_nSocket = -1;
+                bRemove = true;
+            }
+            else if (conn.m_idle.elapsed() > conn.m_nTimeout)
+            {
+                Close( conn );
+                bRemove = true;
+            }
+
+            if (bRemove)
+            {
+                m_connections.removeAt( i );
+                nClosed++;
+            }
+        }
+
+        if (nClosed)
+        {
+            QMutexLocker locker(&m_lock);
+            m_nCount -= nClosed;
+        }
+    }
+
+    RunEpilog();
+}
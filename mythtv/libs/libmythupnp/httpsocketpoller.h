@@ -0,0 +1,91 @@
+//////////////////////////////////////////////////////////////////////////////
+// Program Name: httpsocketpoller.h
+// Created     : Jun. 14, 2016
+//
+// Purpose     : Waits on idle keep-alive connections and streams file
+//               bodies for the HttpServer without tying up workers
+//
+// Licensed under the GPL v2 or later, see COPYING for details
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef __HTTPSOCKETPOLLER_H__
+#define __HTTPSOCKETPOLLER_H__
+
+// Qt headers
+#include <QMutex>
+#include <QList>
+
+// MythTV headers
+#include "mythtimer.h"
+#include "mthread.h"
+
+class HttpServer;
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// HttpSocketPoller watches any number of connections from a single thread.
+//
+// A worker hands a plain TCP connection over once it has written the
+// response headers. If the response has a file body the poller streams it
+// with sendfile() as the socket becomes writable. Afterwards, or straight
+// away if there is no body, it waits for the next request on the
+// connection and passes the connection back to the HttpServer when one
+// arrives. Connections that stay idle longer than their keep-alive
+// timeout, or stop reading a body for kStallTimeout ms, are closed.
+//
+/////////////////////////////////////////////////////////////////////////////
+
+class HttpSocketPoller : public MThread
+{
+    public:
+
+        explicit HttpSocketPoller( HttpServer &httpServer );
+        virtual ~HttpSocketPoller();
+
+        void    Stop        ( void );
+
+        // Both take ownership of the descriptors
+        void    AddIdle     ( int nSocket, int nTimeout );
+        void    AddTransfer ( int nSocket, int nFile,
+                              qint64 llStart, qint64 llBytes,
+                              bool bKeepAlive, int nTimeout );
+
+        int     GetConnectionCount( void ) const;
+
+        static const int kStallTimeout;
+
+    protected:
+
+        virtual void run    ( void );
+
+    private:
+
+        struct Connection
+        {
+            int         m_nSocket;
+            int         m_nFile;        // -1 while waiting for a request
+            qint64      m_llOffset;
+            qint64      m_llRemaining;
+            bool        m_bKeepAlive;
+            int         m_nTimeout;     // keep-alive timeout, ms
+            MythTimer   m_idle;
+        };
+
+        void    Add         ( const Connection &conn );
+        void    Wake        ( void );
+        bool    Send        ( Connection &conn );
+        void    Close       ( Connection &conn );
+
+        HttpServer         &m_httpServer;
+
+        mutable QMutex      m_lock;
+        QList<Connection>   m_pending;      // protected by m_lock
+        bool                m_bStop;        // protected by m_lock
+        int                 m_nCount;       // protected by m_lock
+
+        QList<Connection>   m_connections;  // poller thread only
+        int                 m_wakeFds[2];
+};
+
+#endif
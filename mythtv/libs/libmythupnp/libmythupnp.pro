@@ -27,7 +27,7 @@ HEADERS += configuration.h
 HEADERS += soapclient.h mythxmlclient.h mmembuf.h upnpexp.h
 HEADERS += upnpserviceimpl.h
 HEADERS += servicehost.h wsdl.h htmlserver.h serverSideScripting.h xsd.h
-HEADERS += upnphelpers.h websocket.h
+HEADERS += upnphelpers.h websocket.h httpsocketpoller.h
 
 HEADERS += services/rtti.h
 HEADERS += serviceHosts/rttiServiceHost.h
@@ -40,7 +40,7 @@ HEADERS += websocket_extensions/*.h
 
 SOURCES += mmulticastsocketdevice.cpp
 SOURCES += msocketdevice.cpp
-unix:SOURCES += msocketdevice_unix.cpp
+unix:SOURCES += msocketdevice_unix.cpp httpsocketpoller.cpp
 mingw | win32-msvc*:SOURCES += msocketdevice_win.cpp
 SOURCES += httprequest.cpp upnp.cpp ssdp.cpp taskqueue.cpp upnputil.cpp
 SOURCES += upnpdevice.cpp upnptasknotify.cpp upnptasksearch.cpp
@@ -0,0 +1,3 @@
+#include "test_httpserver.h"
+
+QTEST_GUILESS_MAIN(TestHttpServer)
@@ -0,0 +1,379 @@
+/*
+ *  Class TestHttpServer
+ *
+ *  Copyright (C) MythTV Developers 2016
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+#include <QTcpSocket>
+#include <QEventLoop>
+#include <QHostAddress>
+#include <QTimer>
+#include <QHash>
+#include <QFile>
+
+#include "httpserver.h"
+#include "httpsocketpoller.h"
+#include "mythcorecontext.h"
+#include "mythdb.h"
+
+static const qint64 kFileSize = 1024 * 1024;
+
+/// Byte at offset in the test file
+static inline char file_byte(qint64 offset)
+{
+    return (char)(offset % 251);
+}
+
+/// Serves the files in a directory as /files/<name>
+class FileServerExtension : public HttpServerExtension
+{
+  public:
+    explicit FileServerExtension(const QString &sDir)
+        : HttpServerExtension("TestFiles", sDir) { }
+
+    virtual QStringList GetBasePaths() { return QStringList("/files"); }
+
+    virtual bool ProcessRequest(HTTPRequest *pRequest)
+    {
+        if (pRequest->m_sBaseUrl != "/files")
+            return false;
+        pRequest->FormatFileResponse(m_sSharePath + "/" + pRequest->m_sMethod);
+        return true;
+    }
+};
+
+/** \brief HTTP load generator.
+ *
+ *  Opens a number of keep-alive connections and sends requests on each,
+ *  alternating between the whole file and a 64 KiB range of it, from a
+ *  single thread using the event loop.
+ */
+class HttpLoad : public QObject
+{
+    Q_OBJECT
+
+  public:
+    HttpLoad(quint16 port, qint64 fileSize, int connections, int requests,
+             bool keepOpen = false) :
+        m_responses(0), m_errors(0), m_bytes(0),
+        m_port(port), m_fileSize(fileSize), m_connections(connections),
+        m_requests(requests), m_keepOpen(keepOpen), m_done(0) { }
+
+    ~HttpLoad()
+    {
+        QHash<QTcpSocket*, Client>::iterator it = m_clients.begin();
+        for (; it != m_clients.end(); ++it)
+        {
+            it.key()->abort();
+            delete it.key();
+        }
+    }
+
+    /// Returns true if every request was answered correctly
+    bool Run(int timeout)
+    {
+        for (int i = 0; i < m_connections; i++)
+        {
+            QTcpSocket *socket = new QTcpSocket();
+            Client client = { i, 0, false, QByteArray(), -1, 0, 0, 0 };
+            m_clients[socket] = client;
+            connect(socket, SIGNAL(connected()), this, SLOT(Connected()));
+            connect(socket, SIGNAL(readyRead()), this, SLOT(ReadyRead()));
+            socket->connectToHost(QHostAddress(QHostAddress::LocalHost),
+                                  m_port);
+        }
+
+        QEventLoop loop;
+        connect(this, SIGNAL(Finished()), &loop, SLOT(quit()));
+        QTimer::singleShot(timeout, &loop, SLOT(quit()));
+        if (m_done < m_connections)
+            loop.exec();
+
+        return m_done == m_connections && m_errors == 0 &&
+            m_responses == m_connections * m_requests;
+    }
+
+    int     m_responses;
+    int     m_errors;
+    qint64  m_bytes;
+
+  signals:
+    void Finished(void);
+
+  private slots:
+    void Connected(void)
+    {
+        QTcpSocket *socket = qobject_cast<QTcpSocket*>(sender());
+        SendRequest(socket, m_clients[socket]);
+    }
+
+    void ReadyRead(void)
+    {
+        QTcpSocket *socket = qobject_cast<QTcpSocket*>(sender());
+        Client &client = m_clients[socket];
+
+        while (socket->bytesAvailable() > 0)
+        {
+            if (client.length < 0)
+            {
+                client.header += socket->readAll();
+                int end = client.header.indexOf("\r\n\r\n");
+                if (end < 0)
+                    return;
+
+                QByteArray body = client.header.mid(end + 4);
+                ParseHeader(client, client.header.left(end));
+                client.header.clear();
+                Received(socket, client, body);
+            }
+            else
+            {
+                QByteArray body =
+                    socket->read(client.length - client.received);
+                if (body.isEmpty())
+                    break;
+                Received(socket, client, body);
+            }
+        }
+    }
+
+  private:
+    struct Client
+    {
+        int         id;
+        int         sent;
+        bool        range;
+        QByteArray  header;
+        qint64      length;     // -1 while reading the header
+        qint64      received;
+        qint64      start;      // offset of the first byte expected
+        int         status;
+    };
+
+    void SendRequest(QTcpSocket *socket, Client &client)
+    {
+        QByteArray request = "GET /files/test.bin HTTP/1.1\r\n"
+                             "Host: localhost\r\n";
+        client.start = 0;
+        client.range = (client.sent % 2);
+        if (client.range)
+        {
+            client.start = ((qint64)(client.id + 1) * 7919 * client.sent) %
+                (m_fileSize - 65536);
+            request += QString("Range: bytes=%1-%2\r\n")
+                .arg(client.start).arg(client.start + 65535).toLatin1();
+        }
+        request += "\r\n";
+
+        client.sent++;
+        client.length = -1;
+        client.received = 0;
+        socket->write(request);
+    }
+
+    void ParseHeader(Client &client, const QByteArray &header)
+    {
+        QList<QByteArray> lines = header.split('\n');
+        QList<QByteArray> status = lines[0].split(' ');
+        client.status = (status.size() > 1) ? status[1].toInt() : 0;
+        client.length = 0;
+        for (int i = 1; i < lines.size(); i++)
+        {
+            if (lines[i].toLower().startsWith("content-length:"))
+                client.length = lines[i].mid(15).trimmed().toLongLong();
+        }
+
+        if ((client.range &&
+             (client.status != 206 || client.length != 65536)) ||
+            (!client.range &&
+             (client.status != 200 || client.length != m_fileSize)))
+        {
+            m_errors++;
+        }
+    }
+
+    void Received(QTcpSocket *socket, Client &client, const QByteArray &data)
+    {
+        if (client.received == 0 && !data.isEmpty() &&
+            data[0] != file_byte(client.start))
+        {
+            m_errors++;
+        }
+
+        client.received += data.size();
+        m_bytes += data.size();
+
+        if (client.received < client.length)
+            return;
+
+        m_responses++;
+
+        if (client.sent < m_requests)
+        {
+            SendRequest(socket, client);
+        }
+        else
+        {
+            if (!m_keepOpen)
+                socket->disconnectFromHost();
+            if (++m_done == m_connections)
+                emit Finished();
+        }
+    }
+
+    quint16     m_port;
+    qint64      m_fileSize;
+    int         m_connections;
+    int         m_requests;
+    bool        m_keepOpen;
+    int         m_done;
+    QHash<QTcpSocket*, Client> m_clients;
+};
+
+class TestHttpServer : public QObject
+{
+    Q_OBJECT
+
+    QTemporaryDir   m_dir;
+    HttpServer     *m_server;
+    quint16         m_port;
+
+    /// Sends one request and returns the whole response
+    QByteArray Get(const QByteArray &request)
+    {
+        QTcpSocket socket;
+        socket.connectToHost(QHostAddress(QHostAddress::LocalHost), m_port);
+        if (!socket.waitForConnected(5000))
+            return QByteArray();
+
+        socket.write(request);
+        socket.waitForBytesWritten(5000);
+
+        QByteArray response;
+        while (socket.waitForReadyRead(2000))
+            response += socket.readAll();
+        return response;
+    }
+
+  private slots:
+    // called at the beginning of these sets of tests
+    void initTestCase(void)
+    {
+        gCoreContext = new MythCoreContext("bin_version_unknown", NULL);
+        GetMythDB()->IgnoreDatabase(true);
+
+        QVERIFY(m_dir.isValid());
+        QFile file(m_dir.path() + "/test.bin");
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        QByteArray data(kFileSize, 0);
+        for (qint64 i = 0; i < kFileSize; i++)
+            data[(int)i] = file_byte(i);
+        QCOMPARE(file.write(data), kFileSize);
+        file.close();
+
+        m_server = new HttpServer();
+        m_server->RegisterExtension(new FileServerExtension(m_dir.path()));
+
+        QList<QHostAddress> addrs;
+        addrs << QHostAddress(QHostAddress::LocalHost);
+        for (m_port = 16550; m_port < 16650; m_port++)
+        {
+            if (m_server->listen(addrs, m_port))
+                break;
+        }
+        QVERIFY(m_server->isListening());
+    }
+
+    // called at the end of these sets of tests
+    void cleanupTestCase(void)
+    {
+        delete m_server;
+        m_server = NULL;
+        delete gCoreContext;
+        gCoreContext = NULL;
+    }
+
+    void Range_test(void)
+    {
+        QByteArray response = Get("GET /files/test.bin HTTP/1.1\r\n"
+                                  "Host: localhost\r\n"
+                                  "Range: bytes=1000-1999\r\n"
+                                  "Connection: close\r\n\r\n");
+        QVERIFY(response.startsWith("HTTP/1.1 206"));
+        QVERIFY(response.contains("Content-Range: bytes 1000-1999/1048576"));
+        QByteArray body = response.mid(response.indexOf("\r\n\r\n") + 4);
+        QCOMPARE(body.size(), 1000);
+        for (int i = 0; i < body.size(); i++)
+            QCOMPARE(body[i], file_byte(1000 + i));
+
+        response = Get("GET /files/test.bin HTTP/1.1\r\n"
+                       "Host: localhost\r\n"
+                       "Connection: close\r\n\r\n");
+        QVERIFY(response.startsWith("HTTP/1.1 200"));
+        body = response.mid(response.indexOf("\r\n\r\n") + 4);
+        QCOMPARE((qint64)body.size(), kFileSize);
+        QCOMPARE(body[(int)kFileSize - 1], file_byte(kFileSize - 1));
+
+        response = Get("GET /files/test.bin HTTP/1.1\r\n"
+                       "Host: localhost\r\n"
+                       "Range: bytes=2000000-2000010\r\n"
+                       "Connection: close\r\n\r\n");
+        QVERIFY(response.startsWith("HTTP/1.1 416"));
+    }
+
+    /// Idle keep-alive connections must not hold on to worker threads
+    void IdleConnections_test(void)
+    {
+        int connections = QThread::idealThreadCount() * 2 + 32;
+        HttpLoad load(m_port, kFileSize, connections, 2, true);
+        QVERIFY(load.Run(30000));
+
+        HttpSocketPoller *poller = m_server->GetSocketPoller();
+        if (!poller)
+            QSKIP("No socket poller on this platform");
+        QTRY_COMPARE(poller->GetConnectionCount(), connections);
+
+        // Every worker is still free for new requests
+        QByteArray response = Get("GET /files/test.bin HTTP/1.1\r\n"
+                                  "Host: localhost\r\n"
+                                  "Range: bytes=0-99\r\n"
+                                  "Connection: close\r\n\r\n");
+        QVERIFY(response.startsWith("HTTP/1.1 206"));
+    }
+
+    void Concurrency_benchmark_data(void)
+    {
+        QTest::addColumn<int>("connections");
+        QTest::newRow("8 connections")   << 8;
+        QTest::newRow("64 connections")  << 64;
+        QTest::newRow("256 connections") << 256;
+    }
+
+    /// Time for many clients to each fetch the file and ranges of it
+    void Concurrency_benchmark(void)
+    {
+        QFETCH(int, connections);
+
+        QBENCHMARK
+        {
+            HttpLoad load(m_port, kFileSize, connections, 4);
+            QVERIFY(load.Run(120000));
+        }
+    }
+};
@@ -52,13 +52,19 @@ libmythtv-test.target = buildtestmythtv
 libmythtv-test.commands = cd libmythtv/test && $(QMAKE) && $(MAKE)
 unix:QMAKE_EXTRA_TARGETS += libmythtv-test
 
+# unit tests libmythupnp
+libmythupnp-test.depends = sub-libmythupnp
+libmythupnp-test.target = buildtestmythupnp
+libmythupnp-test.commands = cd libmythupnp/test && $(QMAKE) && $(MAKE)
+unix:QMAKE_EXTRA_TARGETS += libmythupnp-test
+
 # unit tests libmythmetadata
 libmythmetadata-test.depends = sub-libmythmetadata
 libmythmetadata-test.target = buildtestmythmetadata
 libmythmetadata-test.commands = cd libmythmetadata/test && $(QMAKE) && $(MAKE)
 unix:QMAKE_EXTRA_TARGETS += libmythmetadata-test
 
-unittest.depends = libmyth-test libmythbase-test libmythtv-test libmythmetadata-test
+unittest.depends = libmyth-test libmythbase-test libmythtv-test libmythupnp-test libmythmetadata-test
 unittest.target = test
 unittest.commands = ../programs/scripts/unittests.sh
 unix:QMAKE_EXTRA_TARGETS += unittest
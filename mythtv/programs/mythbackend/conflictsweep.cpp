@@ -0,0 +1,52 @@
+// C++ headers
+#include <algorithm>
+using namespace std;
+
+// MythTV headers
+#include "conflictsweep.h"
+#include "recordinginfo.h"
+
+void ConflictSweep::Build(const RecList &list)
+{
+    Clear();
+    m_entries.reserve(list.size());
+    for (uint i = 0; i < list.size(); ++i)
+    {
+        Entry e;
+        e.start = list[i]->GetRecordingStartTime().toMSecsSinceEpoch();
+        e.end   = list[i]->GetRecordingEndTime().toMSecsSinceEpoch();
+        e.pos   = i;
+        m_entries.push_back(e);
+    }
+    stable_sort(m_entries.begin(), m_entries.end());
+
+    m_maxEnd.resize(m_entries.size());
+    qint64 maxend = 0;
+    for (uint i = 0; i < m_entries.size(); ++i)
+    {
+        maxend = (i == 0) ? m_entries[i].end : max(maxend, m_entries[i].end);
+        m_maxEnd[i] = maxend;
+    }
+}
+
+void ConflictSweep::FindOverlaps(const RecordingInfo *p,
+                                 vector<uint> &positions) const
+{
+    positions.clear();
+
+    qint64 start = p->GetRecordingStartTime().toMSecsSinceEpoch();
+    qint64 end   = p->GetRecordingEndTime().toMSecsSinceEpoch();
+
+    // m_maxEnd never decreases, so everything before the first entry
+    // reaching start has ended before p begins.
+    uint i = lower_bound(m_maxEnd.begin(), m_maxEnd.end(), start) -
+        m_maxEnd.begin();
+    for ( ; i < m_entries.size() && m_entries[i].start <= end; ++i)
+    {
+        if (m_entries[i].end >= start)
+            positions.push_back(m_entries[i].pos);
+    }
+
+    // Callers rely on conflicts being found in list order
+    sort(positions.begin(), positions.end());
+}
@@ -0,0 +1,40 @@
+#ifndef CONFLICTSWEEP_H_
+#define CONFLICTSWEEP_H_
+
+// C++ headers
+#include <vector>
+using namespace std;
+
+// MythTV headers
+#include "mythscheduler.h"
+
+class RecordingInfo;
+
+/** \brief Start time ordered view of one conflict list.
+ *
+ *  Lets the scheduler find the entries whose recording times overlap
+ *  or touch a given recording with a binary search, rather than by
+ *  walking every entry of the list for every candidate recording.
+ */
+class ConflictSweep
+{
+  public:
+    void Build(const RecList &list);
+    void Clear(void) { m_entries.clear(); m_maxEnd.clear(); }
+    void FindOverlaps(const RecordingInfo *p, vector<uint> &positions) const;
+
+  private:
+    class Entry
+    {
+      public:
+        qint64 start;
+        qint64 end;
+        uint   pos;
+        bool operator<(const Entry &other) const
+            { return start < other.start; }
+    };
+    vector<Entry>  m_entries; // sorted by start time
+    vector<qint64> m_maxEnd;  // latest end time of m_entries[0..i]
+};
+
+#endif // CONFLICTSWEEP_H_
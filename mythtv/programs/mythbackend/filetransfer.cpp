@@ -1,24 +1,41 @@
+// POSIX headers
+#include <fcntl.h>
+#include <unistd.h>
+
 #include <QCoreApplication>
 #include <QDateTime>
 #include <QFileInfo>
 
 #include "filetransfer.h"
 #include "ringbuffer.h"
+#include "mythcorecontext.h"
 #include "mythdate.h"
 #include "mythsocket.h"
 #include "programinfo.h"
 #include "mythlogging.h"
 
+/// Files not modified for this long are assumed to be complete
+static const int kZeroCopyMinAge = 60; // seconds
+
 FileTransfer::FileTransfer(QString &filename, MythSocket *remote,
                            bool usereadahead, int timeout_ms) :
     ReferenceCounter(QString("FileTransfer:%1").arg(filename)),
     readthreadlive(true), readsLocked(false),
-    rbuffer(RingBuffer::Create(filename, false, usereadahead, timeout_ms, true)),
-    sock(remote), ateof(false), lock(QMutex::NonRecursive),
+    rbuffer(NULL),
+    sock(remote), ateof(false),
+    zerocopyfd(-1), zerocopypos(0),
+    lock(QMutex::NonRecursive),
     writemode(false)
 {
     pginfo = new ProgramInfo(filename);
     pginfo->MarkAsInUse(true, kFileTransferInUseID);
+
+    zerocopyfd = OpenZeroCopy(filename, pginfo);
+
+    // The read ahead thread would only duplicate the sendfile() reads
+    rbuffer = RingBuffer::Create(filename, false,
+                                 usereadahead && zerocopyfd < 0,
+                                 timeout_ms, true);
     rbuffer->Start();
 }
 
@@ -26,7 +43,9 @@ FileTransfer::FileTransfer(QString &filename, MythSocket *remote, bool write) :
     ReferenceCounter(QString("FileTransfer:%1").arg(filename)),
     readthreadlive(true), readsLocked(false),
     rbuffer(RingBuffer::Create(filename, write)),
-    sock(remote), ateof(false), lock(QMutex::NonRecursive),
+    sock(remote), ateof(false),
+    zerocopyfd(-1), zerocopypos(0),
+    lock(QMutex::NonRecursive),
     writemode(write)
 {
     pginfo = new ProgramInfo(filename);
@@ -50,6 +69,9 @@ FileTransfer::~FileTransfer()
         rbuffer = NULL;
     }
 
+    if (zerocopyfd >= 0)
+        close(zerocopyfd);
+
     if (pginfo)
     {
         pginfo->MarkAsInUse(false, kFileTransferInUseID);
@@ -57,6 +79,57 @@ FileTransfer::~FileTransfer()
     }
 }
 
+/** \brief Opens filename for zero-copy transfers if it is a finished
+ *         recording, or other static file, on local storage.
+ *
+ *  LiveTV and files that are still being written must be read through
+ *  the RingBuffer, which knows how to wait for data at the end of a
+ *  growing file.
+ *
+ *  \return file descriptor, or -1 if the file is not eligible.
+ */
+int FileTransfer::OpenZeroCopy(const QString &filename,
+                               const ProgramInfo *pginfo)
+{
+#ifdef __linux__
+    if (gCoreContext->GetNumSetting("BackendZeroCopyTransfers", 1) == 0)
+        return -1;
+
+    QFileInfo finfo(filename);
+    if (!finfo.isFile() || !finfo.isReadable())
+        return -1;
+
+    QDateTime cutoff = MythDate::current().addSecs(-kZeroCopyMinAge);
+    if (finfo.lastModified().toUTC() > cutoff)
+        return -1;
+
+    if (pginfo->GetRecordingGroup() == "LiveTV" ||
+        pginfo->GetRecordingEndTime() > MythDate::current())
+        return -1;
+
+    int fd = open(filename.toLocal8Bit().constData(), O_RDONLY);
+    if (fd < 0)
+        return -1;
+
+    LOG(VB_FILE, LOG_INFO, QString("FileTransfer: using sendfile() for %1")
+        .arg(filename));
+    return fd;
+#else
+    (void) filename; (void) pginfo;
+    return -1;
+#endif
+}
+
+/// Falls back to reading through the RingBuffer at the current position
+void FileTransfer::DisableZeroCopy(void)
+{
+    LOG(VB_FILE, LOG_INFO, "FileTransfer: sendfile() failed, "
+        "falling back to buffered transfers");
+    close(zerocopyfd);
+    zerocopyfd = -1;
+    rbuffer->Seek(zerocopypos, SEEK_SET);
+}
+
 bool FileTransfer::isOpen(void)
 {
     if (rbuffer && rbuffer->IsOpen())
@@ -130,6 +203,21 @@ int FileTransfer::RequestBlock(int size)
     while (readsLocked)
         readsUnlockedCond.wait(&lock, 100 /*ms*/);
 
+    if (zerocopyfd >= 0 && readthreadlive)
+    {
+        ret = sock->SendFile(zerocopyfd, zerocopypos, max(size, 0));
+        if (ret >= 0)
+        {
+            zerocopypos += ret;
+
+            if (pginfo)
+                pginfo->UpdateInUseMark();
+
+            return ret;
+        }
+        DisableZeroCopy();
+    }
+
     requestBuffer.resize(max((size_t)max(size,0) + 128, requestBuffer.size()));
     char *buf = &requestBuffer[0];
     while (tot < size && !rbuffer->GetStopReads() && readthreadlive)
@@ -233,6 +321,23 @@ long long FileTransfer::Seek(long long curpos, long long pos, int whence)
 
     ateof = false;
 
+    if (zerocopyfd >= 0)
+    {
+        QMutexLocker locker(&lock);
+
+        long long desired = pos;
+        if (whence == SEEK_CUR)
+            desired = curpos + pos;
+        else if (whence == SEEK_END)
+            desired = rbuffer->GetRealFileSize() + pos;
+
+        if (desired < 0)
+            return -1;
+
+        zerocopypos = desired;
+        return zerocopypos;
+    }
+
     Pause();
 
     if (whence == SEEK_CUR)
@@ -51,6 +51,9 @@ class FileTransfer : public ReferenceCounter
   private:
    ~FileTransfer();
 
+    static int OpenZeroCopy(const QString &filename, const ProgramInfo *pginfo);
+    void DisableZeroCopy(void);
+
     volatile bool  readthreadlive;
     bool           readsLocked;
     QWaitCondition readsUnlockedCond;
@@ -62,6 +65,11 @@ class FileTransfer : public ReferenceCounter
 
     vector<char> requestBuffer;
 
+    /// File descriptor used to sendfile() finished recordings straight
+    /// to the socket, -1 when blocks go through the RingBuffer instead.
+    int zerocopyfd;
+    long long zerocopypos;
+
     QMutex lock;
 
     bool writemode;
@@ -38,6 +38,7 @@
 #include "mythsystemlegacy.h"
 #include "exitcodes.h"
 #include "jobqueue.h"
+#include "eithelper.h"
 #include "upnp.h"
 #include "mythdate.h"
 
@@ -570,6 +571,19 @@ void HttpStatus::FillStatusXML( QDomDocument *pDoc )
         pDoc->createTextNode(gCoreContext->GetSetting("DataDirectMessage"));
     guide.appendChild(dataDirectMessage);
 
+    uint   eitQueued  = 0;
+    uint   eitWritten = 0;
+    double eitRate    = 0.0;
+    EITHelper::GetWriteStatistics(eitQueued, eitWritten, eitRate);
+    if (eitQueued || eitWritten)
+    {
+        QDomElement eit = pDoc->createElement("EIT");
+        eit.setAttribute("queued",  eitQueued);
+        eit.setAttribute("written", eitWritten);
+        eit.setAttribute("rate",    QString::number(eitRate, 'f', 1));
+        guide.appendChild(eit);
+    }
+
     // Add Miscellaneous information
 
     QString info_script = gCoreContext->GetSetting("MiscStatusScript");
@@ -1447,6 +1461,15 @@ int HttpStatus::PrintMachineInfo( QTextStream &os, QDomElement info )
 
             if (!sMsg.isEmpty())
                 os << "<br />\r\n    DataDirect Status: " << sMsg;
+
+            QDomElement eit = e.namedItem( "EIT" ).toElement();
+            if (!eit.isNull())
+            {
+                os << "<br />\r\n    EIT: "
+                   << eit.attribute( "queued", "0" ) << " events queued, "
+                   << eit.attribute( "written", "0" ) << " written at "
+                   << eit.attribute( "rate", "0" ) << " events/sec.";
+            }
         }
     }
     os << "\r\n  </div>\r\n";
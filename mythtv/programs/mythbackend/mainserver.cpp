@@ -41,6 +41,7 @@ using namespace std;
 #include <QHostAddress>
 
 #include "previewgeneratorqueue.h"
+#include "previewcache.h"
 #include "mythmiscutil.h"
 #include "mythsystemlegacy.h"
 #include "exitcodes.h"
@@ -251,6 +252,22 @@ MainServer::MainServer(bool master, int port,
         PreviewGenerator::kLocalAndRemote, ~0, 0);
     PreviewGeneratorQueue::AddListener(this);
 
+    qint64 previewCacheSize =
+        (qint64)gCoreContext->GetNumSetting("PreviewCacheSize", 0) *
+        1024 * 1024;
+    if (previewCacheSize > 0)
+    {
+        PreviewCache::SetMaxSize(previewCacheSize);
+        QStringList previewDirs;
+        foreach (const QString &group, StorageGroup::getRecordingsGroups())
+        {
+            StorageGroup sgroup(group, gCoreContext->GetHostName());
+            previewDirs += sgroup.GetDirList();
+        }
+        previewDirs.removeDuplicates();
+        PreviewCache::StartScan(previewDirs);
+    }
+
     threadPool.setMaxThreadCount(PRT_STARTUP_THREAD_COUNT);
 
     masterBackendOverride =
@@ -1118,6 +1135,8 @@ void MainServer::customEvent(QEvent *e)
     {
         MythEvent *me = (MythEvent *)e;
 
+        m_recordedListCache.HandleEvent(*me);
+
         QString message = me->Message();
         QString error;
         if ((message == "PREVIEW_SUCCESS" || message == "PREVIEW_QUEUED") &&
@@ -1610,7 +1629,14 @@ void MainServer::HandleVersion(MythSocket *socket, const QStringList &slist)
     }
 
     retlist << "ACCEPT" << MYTH_PROTO_VERSION;
-    socket->WriteStringList(retlist);
+
+    // Switch to binary string lists only if the client asked for them,
+    // and only after the reply, which the client reads in the old encoding
+    bool binary = slist.size() > 3 &&
+        slist[3] == MythSocket::kBinaryStringListsToken;
+    if (binary)
+        retlist << MythSocket::kBinaryStringListsToken;
+    socket->WriteStringList(retlist, binary);
 }
 
 /**
@@ -2073,7 +2099,7 @@ void MainServer::HandleQueryRecordings(QString type, PlaybackSock *pbs)
         sort = -1;
 
     ProgramList destination;
-    LoadFromRecorded(
+    m_recordedListCache.Get(
         destination, (type == "Recording"),
         inUseMap, isJobRunning, recMap, sort);
 
@@ -2386,6 +2412,7 @@ void MainServer::DoDeleteThread(DeleteStruct *ds)
     nameFilters.push_back(fInfo.fileName() + ".old");
     nameFilters.push_back(fInfo.fileName() + ".map");
     nameFilters.push_back(fInfo.fileName() + ".tmp.map");
+    nameFilters.push_back(fInfo.fileName() + ".seek");
     nameFilters.push_back(fInfo.baseName() + ".srt");  // e.g. 1234_20150213165800.srt
 
     QDir dir (fInfo.path());
@@ -23,6 +23,7 @@ using namespace std;
 #include "mythsocket.h"
 #include "mythdeque.h"
 #include "mythdownloadmanager.h"
+#include "recordedlistcache.h"
 
 #ifdef DeleteFile
 #undef DeleteFile
@@ -350,6 +351,8 @@ class MainServer : public QObject, public MythSocketCBs
     QMutex                     m_downloadURLsLock;
     QMap<QString, QString>     m_downloadURLs;
 
+    RecordedListCache          m_recordedListCache;
+
     int m_exitCode;
 
     typedef QHash<QString,QString> RequestedBy;
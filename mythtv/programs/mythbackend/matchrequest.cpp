@@ -0,0 +1,51 @@
+// C++ headers
+#include <algorithm>
+using namespace std;
+
+// MythTV headers
+#include "matchrequest.h"
+
+/** \brief Merges a MATCH request into the pending ones.
+ *
+ *  Busy EIT scanners can queue many requests for the same source or
+ *  multiplex before the scheduler gets to them. Requests for the same
+ *  rule, source and multiplex are folded into one covering the union
+ *  of their time windows, and a request to rematch everything replaces
+ *  all others, so each guide change is only rematched once.
+ */
+void MatchRequest::Coalesce(QList<MatchRequest> &pending,
+                            const MatchRequest &request)
+{
+    if (!pending.empty() && pending[0].IsFullMatch())
+        return;
+
+    if (request.IsFullMatch())
+    {
+        pending.clear();
+        pending.push_back(request);
+        return;
+    }
+
+    for (int i = 0; i < pending.size(); ++i)
+    {
+        MatchRequest &match = pending[i];
+        if (match.recordid != request.recordid ||
+            match.sourceid != request.sourceid ||
+            match.mplexid  != request.mplexid)
+            continue;
+
+        if (!match.minstarttime.isValid() || !request.minstarttime.isValid())
+            match.minstarttime = QDateTime();
+        else
+            match.minstarttime = min(match.minstarttime, request.minstarttime);
+
+        if (!match.maxstarttime.isValid() || !request.maxstarttime.isValid())
+            match.maxstarttime = QDateTime();
+        else
+            match.maxstarttime = max(match.maxstarttime, request.maxstarttime);
+
+        return;
+    }
+
+    pending.push_back(request);
+}
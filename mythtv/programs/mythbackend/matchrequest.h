@@ -0,0 +1,33 @@
+#ifndef MATCHREQUEST_H_
+#define MATCHREQUEST_H_
+
+// Qt headers
+#include <QDateTime>
+#include <QList>
+
+/** \brief A MATCH request waiting to be run by the scheduler.
+ *
+ *  Zero ids and invalid times leave that part of the match unbounded.
+ */
+class MatchRequest
+{
+  public:
+    MatchRequest() : recordid(0), sourceid(0), mplexid(0) {}
+
+    uint      recordid;
+    uint      sourceid;
+    uint      mplexid;
+    QDateTime minstarttime;
+    QDateTime maxstarttime;
+
+    bool IsFullMatch(void) const
+    {
+        return !recordid && !sourceid && !mplexid &&
+            !minstarttime.isValid() && !maxstarttime.isValid();
+    }
+
+    static void Coalesce(QList<MatchRequest> &pending,
+                         const MatchRequest &request);
+};
+
+#endif // MATCHREQUEST_H_
@@ -1018,6 +1018,9 @@ void Scheduler::BuildListMaps(void)
         }
     }
 
+    for (uint j = 0; j < conflictlists.size(); ++j)
+        conflictsweeps[conflictlists[j]].Build(*conflictlists[j]);
+
     QMap<uint, uint>::iterator it;
     for (it = badinputs.begin(); it != badinputs.end(); ++it)
     {
@@ -1031,6 +1034,7 @@ void Scheduler::ClearListMaps(void)
 {
     for (uint i = 0; i < conflictlists.size(); ++i)
         conflictlists[i]->clear();
+    conflictsweeps.clear();
     titlelistmap.clear();
     recordidlistmap.clear();
     cache_is_same_program.clear();
@@ -1052,96 +1056,142 @@ bool Scheduler::IsSameProgram(
     return cache_is_same_program[X] = a->IsDuplicateProgram(*b);
 }
 
-bool Scheduler::FindNextConflict(
-    const RecList     &cardlist,
+/// Returns true if q conflicts with p, affinity is incremented for
+/// each non-conflicting recording on the same multiplex or channel
+bool Scheduler::IsConflict(
     const RecordingInfo *p,
-    RecConstIter      &j,
-    OpenEndType        openEnd,
-    uint              *paffinity) const
+    const RecordingInfo *q,
+    OpenEndType          openEnd,
+    uint                &affinity) const
 {
-    uint affinity = 0;
-    for ( ; j != cardlist.end(); ++j)
-    {
-        const RecordingInfo *q = *j;
-        QString msg;
+    QString msg;
 
-        if (p == q)
-            continue;
+    if (p == q)
+        return false;
 
-        if (!Recording(q))
-            continue;
+    if (!Recording(q))
+        return false;
 
+    if (debugConflicts)
+        msg = QString("comparing with '%1' ").arg(q->GetTitle());
+
+    if (p->GetInputID() != q->GetInputID() &&
+        !igrp.GetSharedInputGroup(p->GetInputID(), q->GetInputID()))
+    {
         if (debugConflicts)
-            msg = QString("comparing with '%1' ").arg(q->GetTitle());
+            msg += "  cardid== ";
+        return false;
+    }
 
-        if (p->GetInputID() != q->GetInputID() &&
-            !igrp.GetSharedInputGroup(p->GetInputID(), q->GetInputID()))
-        {
-            if (debugConflicts)
-                msg += "  cardid== ";
-            continue;
-        }
+    if (p->GetRecordingEndTime() < q->GetRecordingStartTime() ||
+        p->GetRecordingStartTime() > q->GetRecordingEndTime())
+    {
+        if (debugConflicts)
+            msg += "  no-overlap ";
+        return false;
+    }
 
-        if (p->GetRecordingEndTime() < q->GetRecordingStartTime() ||
-            p->GetRecordingStartTime() > q->GetRecordingEndTime())
+    if (p->GetRecordingEndTime() == q->GetRecordingStartTime() ||
+        p->GetRecordingStartTime() == q->GetRecordingEndTime())
+    {
+        if (openEnd == openEndNever ||
+            (openEnd == openEndDiffChannel &&
+             p->GetChanID() == q->GetChanID()) ||
+            (openEnd == openEndAlways &&
+             p->GetInputID() != q->GetInputID() &&
+             ((p->mplexid && p->mplexid == q->mplexid) ||
+              (!p->mplexid && p->GetChanID() == q->GetChanID()))))
         {
             if (debugConflicts)
                 msg += "  no-overlap ";
-            continue;
-        }
-
-        if (p->GetRecordingEndTime() == q->GetRecordingStartTime() ||
-            p->GetRecordingStartTime() == q->GetRecordingEndTime())
-        {
-            if (openEnd == openEndNever ||
-                (openEnd == openEndDiffChannel &&
+            if ((m_openEnd == openEndDiffChannel &&
                  p->GetChanID() == q->GetChanID()) ||
-                (openEnd == openEndAlways &&
+                (m_openEnd == openEndAlways &&
                  p->GetInputID() != q->GetInputID() &&
                  ((p->mplexid && p->mplexid == q->mplexid) ||
                   (!p->mplexid && p->GetChanID() == q->GetChanID()))))
-            {
-                if (debugConflicts)
-                    msg += "  no-overlap ";
-                if ((m_openEnd == openEndDiffChannel &&
-                     p->GetChanID() == q->GetChanID()) ||
-                    (m_openEnd == openEndAlways &&
-                     p->GetInputID() != q->GetInputID() &&
-                     ((p->mplexid && p->mplexid == q->mplexid) ||
-                      (!p->mplexid && p->GetChanID() == q->GetChanID()))))
-                      ++affinity;
-                continue;
-            }
+                  ++affinity;
+            return false;
         }
+    }
 
-        if (debugConflicts)
-        {
-            LOG(VB_SCHEDULE, LOG_INFO, msg);
-            LOG(VB_SCHEDULE, LOG_INFO,
-                QString("  cardid's: %1, %2 Shared input group: %3 "
-                        "mplexid's: %4, %5")
-                     .arg(p->GetInputID()).arg(q->GetInputID())
-                     .arg(igrp.GetSharedInputGroup(
-                              p->GetInputID(), q->GetInputID()))
-                     .arg(p->mplexid).arg(q->mplexid));
-        }
+    if (debugConflicts)
+    {
+        LOG(VB_SCHEDULE, LOG_INFO, msg);
+        LOG(VB_SCHEDULE, LOG_INFO,
+            QString("  cardid's: %1, %2 Shared input group: %3 "
+                    "mplexid's: %4, %5")
+                 .arg(p->GetInputID()).arg(q->GetInputID())
+                 .arg(igrp.GetSharedInputGroup(
+                          p->GetInputID(), q->GetInputID()))
+                 .arg(p->mplexid).arg(q->mplexid));
+    }
 
-        // if two inputs are in the same input group we have a conflict
-        // unless the programs are on the same multiplex.
-        if (p->GetInputID() != q->GetInputID() &&
-            ((p->mplexid && p->mplexid == q->mplexid) ||
-             (!p->mplexid && p->GetChanID() == q->GetChanID())))
+    // if two inputs are in the same input group we have a conflict
+    // unless the programs are on the same multiplex.
+    if (p->GetInputID() != q->GetInputID() &&
+        ((p->mplexid && p->mplexid == q->mplexid) ||
+         (!p->mplexid && p->GetChanID() == q->GetChanID())))
+    {
+        ++affinity;
+        return false;
+    }
+
+    if (debugConflicts)
+        LOG(VB_SCHEDULE, LOG_INFO, "Found conflict");
+
+    return true;
+}
+
+bool Scheduler::FindNextConflict(
+    const RecList     &cardlist,
+    const RecordingInfo *p,
+    RecConstIter      &j,
+    OpenEndType        openEnd,
+    uint              *paffinity) const
+{
+    uint affinity = 0;
+    for ( ; j != cardlist.end(); ++j)
+    {
+        if (IsConflict(p, *j, openEnd, affinity))
         {
-            ++affinity;
-            continue;
+            if (paffinity)
+                *paffinity += affinity;
+            return true;
         }
+    }
 
-        if (debugConflicts)
-            LOG(VB_SCHEDULE, LOG_INFO, "Found conflict");
+    if (debugConflicts)
+        LOG(VB_SCHEDULE, LOG_INFO, "No conflict");
 
-        if (paffinity)
-            *paffinity += affinity;
-        return true;
+    if (paffinity)
+        *paffinity += affinity;
+    return false;
+}
+
+/** \brief Like FindNextConflict() above, but only looks at the
+ *         positions in cardlist found by FindConflictCandidates().
+ *
+ *  k indexes candidates, on success cardlist[candidates[k]] is the
+ *  conflicting recording.
+ */
+bool Scheduler::FindNextConflict(
+    const RecList        &cardlist,
+    const RecordingInfo  *p,
+    const vector<uint>   &candidates,
+    uint                 &k,
+    OpenEndType           openEnd,
+    uint                 *paffinity) const
+{
+    uint affinity = 0;
+    for ( ; k < candidates.size(); ++k)
+    {
+        if (IsConflict(p, cardlist[candidates[k]], openEnd, affinity))
+        {
+            if (paffinity)
+                *paffinity += affinity;
+            return true;
+        }
     }
 
     if (debugConflicts)
@@ -1152,6 +1202,30 @@ bool Scheduler::FindNextConflict(
     return false;
 }
 
+/** \brief Returns the positions in cardlist, in list order, of the
+ *         entries whose recording times overlap or touch those of p.
+ *
+ *  Entries outside that range can never conflict with p, so skipping
+ *  them does not change the result of the conflict checks.
+ */
+void Scheduler::FindConflictCandidates(
+    const RecList       &cardlist,
+    const RecordingInfo *p,
+    vector<uint>        &candidates) const
+{
+    QMap<const RecList *, ConflictSweep>::const_iterator it =
+        conflictsweeps.constFind(&cardlist);
+    if (it != conflictsweeps.constEnd())
+    {
+        (*it).FindOverlaps(p, candidates);
+        return;
+    }
+
+    candidates.clear();
+    for (uint i = 0; i < cardlist.size(); ++i)
+        candidates.push_back(i);
+}
+
 const RecordingInfo *Scheduler::FindConflict(
     const RecordingInfo        *p,
     OpenEndType openend,
@@ -1159,12 +1233,15 @@ const RecordingInfo *Scheduler::FindConflict(
     bool checkAll) const
 {
     RecList &conflictlist = *conflictlistmap[p->GetInputID()];
-    RecConstIter k = conflictlist.begin();
-    if (FindNextConflict(conflictlist, p, k, openend, affinity))
+    vector<uint> candidates;
+    FindConflictCandidates(conflictlist, p, candidates);
+    uint k = 0;
+    if (FindNextConflict(conflictlist, p, candidates, k, openend, affinity))
     {
-        RecordingInfo *firstConflict = *k;
+        RecordingInfo *firstConflict = conflictlist[candidates[k]];
         while (checkAll &&
-               FindNextConflict(conflictlist, p, ++k, openend, affinity))
+               FindNextConflict(conflictlist, p, candidates, ++k,
+                                openend, affinity))
             ;
         return firstConflict;
     }
@@ -1527,10 +1604,13 @@ void Scheduler::SchedNewRetryPass(RecIter i, RecIter end,
         // Try to move each conflict.  Restore the old status if we
         // can't.
         RecList &conflictlist = *conflictlistmap[p->GetInputID()];
-        RecConstIter k = conflictlist.begin();
-        for ( ; FindNextConflict(conflictlist, p, k); ++k)
+        vector<uint> candidates;
+        FindConflictCandidates(conflictlist, p, candidates);
+        uint k = 0;
+        for ( ; FindNextConflict(conflictlist, p, candidates, k); ++k)
         {
-            if (!TryAnotherShowing(*k, samePriority, livetv))
+            if (!TryAnotherShowing(conflictlist[candidates[k]],
+                                   samePriority, livetv))
             {
                 RestoreRecStatus();
                 break;
@@ -2250,6 +2330,7 @@ bool Scheduler::HandleReschedule(void)
     QString msg;
     bool deleteFuture = false;
     bool runCheck = false;
+    QList<MatchRequest> matches;
 
     while (HaveQueuedRequests())
     {
@@ -2277,17 +2358,21 @@ bool Scheduler::HandleReschedule(void)
                 continue;
             }
 
-            uint recordid = tokens[1].toUInt();
-            uint sourceid = tokens[2].toUInt();
-            uint mplexid = tokens[3].toUInt();
-            QDateTime maxstarttime = MythDate::fromString(tokens[4]);
+            MatchRequest match;
+            match.recordid = tokens[1].toUInt();
+            match.sourceid = tokens[2].toUInt();
+            match.mplexid = tokens[3].toUInt();
+            QStringList window = tokens[4].split('~');
+            if (window.size() > 1)
+            {
+                match.minstarttime = MythDate::fromString(window[0]);
+                match.maxstarttime = MythDate::fromString(window[1]);
+            }
+            else
+                match.maxstarttime = MythDate::fromString(tokens[4]);
             deleteFuture = true;
             runCheck = true;
-            schedLock.unlock();
-            recordmatchLock.lock();
-            UpdateMatches(recordid, sourceid, mplexid, maxstarttime);
-            recordmatchLock.unlock();
-            schedLock.lock();
+            MatchRequest::Coalesce(matches, match);
         }
         else if (tokens[0] == "CHECK")
         {
@@ -2306,6 +2391,7 @@ bool Scheduler::HandleReschedule(void)
             QString descrip = request[3];
             QString programid = request[4];
             runCheck = true;
+            RunMatchRequests(matches); // keep the original request order
             schedLock.unlock();
             recordmatchLock.lock();
             ResetDuplicates(recordid, findid, title, subtitle, descrip,
@@ -2321,6 +2407,8 @@ bool Scheduler::HandleReschedule(void)
         }
     }
 
+    RunMatchRequests(matches);
+
     // Delete future oldrecorded entries that no longer
     // match any potential recordings.
     if (deleteFuture)
@@ -2411,6 +2499,26 @@ bool Scheduler::HandleReschedule(void)
     return true;
 }
 
+/// Runs and clears the pending MATCH requests, schedLock must be held
+void Scheduler::RunMatchRequests(QList<MatchRequest> &pending)
+{
+    if (pending.empty())
+        return;
+
+    schedLock.unlock();
+    recordmatchLock.lock();
+    for (int i = 0; i < pending.size(); ++i)
+    {
+        const MatchRequest &match = pending[i];
+        UpdateMatches(match.recordid, match.sourceid, match.mplexid,
+                      match.maxstarttime, match.minstarttime);
+    }
+    recordmatchLock.unlock();
+    schedLock.lock();
+
+    pending.clear();
+}
+
 bool Scheduler::HandleRunSchedulerStartup(
     int prerollseconds, int idleWaitForRecordingTime)
 {
@@ -3687,7 +3795,8 @@ static QString progfindid = QString(
         .arg(kOverrideRecord);
 
 void Scheduler::UpdateMatches(uint recordid, uint sourceid, uint mplexid,
-                              const QDateTime &maxstarttime)
+                              const QDateTime &maxstarttime,
+                              const QDateTime &minstarttime)
 {
     struct timeval dbstart, dbend;
 
@@ -3720,6 +3829,12 @@ void Scheduler::UpdateMatches(uint recordid, uint sourceid, uint mplexid,
         filterClause += " AND program.starttime <= :MAXSTARTTIME";
         bindings[":MAXSTARTTIME"] = maxstarttime;
     }
+    if (minstarttime.isValid())
+    {
+        deleteClause += " AND recordmatch.starttime >= :MINSTARTTIME";
+        filterClause += " AND program.starttime >= :MINSTARTTIME";
+        bindings[":MINSTARTTIME"] = minstarttime;
+    }
 
     query.prepare(QString("DELETE recordmatch FROM recordmatch, channel "
                           "WHERE recordmatch.chanid = channel.chanid")
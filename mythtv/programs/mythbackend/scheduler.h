@@ -23,6 +23,8 @@ using namespace std;
 #include "mythscheduler.h"
 #include "mthread.h"
 #include "scheduledrecording.h"
+#include "conflictsweep.h"
+#include "matchrequest.h"
 
 class EncoderLink;
 class MainServer;
@@ -120,7 +122,10 @@ class Scheduler : public MThread, public MythScheduler
     void UpdateDuplicates(void);
     bool FillRecordList(void);
     void UpdateMatches(uint recordid, uint sourceid, uint mplexid,
-                       const QDateTime &maxstarttime);
+                       const QDateTime &maxstarttime,
+                       const QDateTime &minstarttime = QDateTime());
+
+    void RunMatchRequests(QList<MatchRequest> &pending);
     void UpdateManuals(uint recordid);
     void BuildWorkList(void);
     bool ClearWorkList(void);
@@ -136,10 +141,20 @@ class Scheduler : public MThread, public MythScheduler
 
     bool IsSameProgram(const RecordingInfo *a, const RecordingInfo *b) const;
 
+    bool IsConflict(const RecordingInfo *p, const RecordingInfo *q,
+                    OpenEndType openEnd, uint &affinity) const;
     bool FindNextConflict(const RecList &cardlist,
                           const RecordingInfo *p, RecConstIter &iter,
                           OpenEndType openEnd = openEndNever,
                           uint *paffinity = NULL) const;
+    bool FindNextConflict(const RecList &cardlist,
+                          const RecordingInfo *p,
+                          const vector<uint> &candidates, uint &k,
+                          OpenEndType openEnd = openEndNever,
+                          uint *paffinity = NULL) const;
+    void FindConflictCandidates(const RecList &cardlist,
+                                const RecordingInfo *p,
+                                vector<uint> &candidates) const;
     const RecordingInfo *FindConflict(const RecordingInfo *p,
                                       OpenEndType openEnd = openEndNever,
                                       uint *affinity = NULL,
@@ -223,6 +238,7 @@ class Scheduler : public MThread, public MythScheduler
     RecList livetvlist;
     vector<RecList *> conflictlists;
     QMap<uint, RecList *> conflictlistmap;
+    QMap<const RecList *, ConflictSweep> conflictsweeps;
     QMap<uint, RecList> recordidlistmap;
     QMap<QString, RecList> titlelistmap;
     InputGroupMap igrp;
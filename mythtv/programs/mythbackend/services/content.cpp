@@ -36,6 +36,7 @@
 #include "storagegroup.h"
 #include "programinfo.h"
 #include "previewgenerator.h"
+#include "previewcache.h"
 #include "backendutil.h"
 #include "httprequest.h"
 #include "serviceUtil.h"
@@ -582,7 +583,11 @@ QFileInfo Content::GetPreviewImage(        int        nRecordedId,
 
         if (!ok)
             return QFileInfo();
+
+        PreviewCache::Insert( sPreviewFileName );
     }
+    else
+        PreviewCache::Touch( sPreviewFileName );
 
     bool bDefaultPixmap = (nWidth == 0) && (nHeight == 0);
 
@@ -607,7 +612,10 @@ QFileInfo Content::GetPreviewImage(        int        nRecordedId,
         {
             if (QFileInfo(sPreviewFileName).lastModified() <=
                 QFileInfo(sNewFileName).lastModified())
+            {
+                PreviewCache::Touch( sNewFileName );
                 return QFileInfo( sNewFileName );
+            }
         }
 
         QImage image = QImage(sPreviewFileName);
@@ -625,7 +633,8 @@ QFileInfo Content::GetPreviewImage(        int        nRecordedId,
             image = image.scaled(nWidth, nHeight, Qt::IgnoreAspectRatio,
                                         Qt::SmoothTransformation);
 
-        image.save(sNewFileName, sImageFormat.toUpper().toLocal8Bit());
+        if (image.save(sNewFileName, sImageFormat.toUpper().toLocal8Bit()))
+            PreviewCache::Insert( sNewFileName );
 
         // Let anybody update it
         bool ret = makeFileAccessible(sNewFileName.toLocal8Bit().constData());
@@ -0,0 +1,3 @@
+#include "test_conflictsweep.h"
+
+QTEST_APPLESS_MAIN(TestConflictSweep)
@@ -0,0 +1,189 @@
+/*
+ *  Class TestConflictSweep
+ *
+ *  Copyright (C) MythTV Developers 2016
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <vector>
+using std::vector;
+
+#include <QtTest/QtTest>
+#include <QDateTime>
+
+#include "conflictsweep.h"
+#include "recordinginfo.h"
+
+/// Two weeks of guide data on 16 inputs, the size of a busy schedule
+static const int kInputs   = 16;
+static const int kShowings = 4000;
+
+class TestConflictSweep: public QObject
+{
+    Q_OBJECT
+
+    RecList m_list;
+
+    static RecordingInfo *MakeShowing(const QDateTime &start, int minutes)
+    {
+        RecordingInfo *p = new RecordingInfo();
+        p->SetRecordingStartTime(start);
+        p->SetRecordingEndTime(start.addSecs(minutes * 60));
+        return p;
+    }
+
+    /// Back to back showings of 30 to 120 minutes on every input, with
+    /// some recordings starting early or ending late so they overlap
+    static void MakeSchedule(RecList &list, int count)
+    {
+        QDateTime base(QDate(2016, 4, 20), QTime(0, 0), Qt::UTC);
+        vector<QDateTime> next(kInputs, base);
+        qsrand(4321);
+        for (int i = 0; i < count; ++i)
+        {
+            int input = i % kInputs;
+            int minutes = 30 * (1 + qrand() % 4);
+            QDateTime start = next[input];
+            next[input] = start.addSecs(minutes * 60);
+            if (qrand() % 8 == 0)
+            {
+                start = start.addSecs(-120);
+                minutes += 5;
+            }
+            list.push_back(MakeShowing(start, minutes));
+        }
+    }
+
+    static void Clear(RecList &list)
+    {
+        while (!list.empty())
+        {
+            delete list.back();
+            list.pop_back();
+        }
+    }
+
+    /// What FindNextConflict() used to do, walk every entry of the list
+    static void FindOverlapsLinear(const RecList &list, const RecordingInfo *p,
+                                   vector<uint> &positions)
+    {
+        positions.clear();
+        QDateTime start = p->GetRecordingStartTime();
+        QDateTime end   = p->GetRecordingEndTime();
+        for (uint i = 0; i < list.size(); ++i)
+        {
+            if (list[i]->GetRecordingStartTime() <= end &&
+                list[i]->GetRecordingEndTime() >= start)
+            {
+                positions.push_back(i);
+            }
+        }
+    }
+
+  private slots:
+    // called at the beginning of these sets of tests
+    void initTestCase(void)
+    {
+        MakeSchedule(m_list, kShowings);
+    }
+
+    // called at the end of these sets of tests
+    void cleanupTestCase(void)
+    {
+        Clear(m_list);
+    }
+
+    void Empty_test(void)
+    {
+        RecList list;
+        ConflictSweep sweep;
+        sweep.Build(list);
+
+        RecordingInfo *p = MakeShowing(QDateTime::currentDateTimeUtc(), 60);
+        vector<uint> positions(1, 0);
+        sweep.FindOverlaps(p, positions);
+        QVERIFY(positions.empty());
+        delete p;
+    }
+
+    void Touching_test(void)
+    {
+        QDateTime base(QDate(2016, 4, 20), QTime(20, 0), Qt::UTC);
+        RecList list;
+        list.push_back(MakeShowing(base.addSecs(3600), 60));   // 21:00-22:00
+        list.push_back(MakeShowing(base, 60));                 // 20:00-21:00
+        list.push_back(MakeShowing(base.addSecs(-3600), 30));  // 19:00-19:30
+        list.push_back(MakeShowing(base.addSecs(-7200), 300)); // 18:00-23:00
+
+        ConflictSweep sweep;
+        sweep.Build(list);
+
+        // 20:00-21:00 touches both neighbours, found in list order
+        vector<uint> positions;
+        sweep.FindOverlaps(list[1], positions);
+        QCOMPARE(positions.size(), (size_t)3);
+        QCOMPARE(positions[0], 0U);
+        QCOMPARE(positions[1], 1U);
+        QCOMPARE(positions[2], 3U);
+
+        // the long showing keeps the running maximum end time up
+        RecordingInfo *late = MakeShowing(base.addSecs(2 * 3600 + 60), 10);
+        sweep.FindOverlaps(late, positions);
+        QCOMPARE(positions.size(), (size_t)1);
+        QCOMPARE(positions[0], 3U);
+        delete late;
+
+        Clear(list);
+    }
+
+    void MatchesLinear_test(void)
+    {
+        ConflictSweep sweep;
+        sweep.Build(m_list);
+
+        vector<uint> expected;
+        vector<uint> positions;
+        for (uint i = 0; i < m_list.size(); ++i)
+        {
+            FindOverlapsLinear(m_list, m_list[i], expected);
+            sweep.FindOverlaps(m_list[i], positions);
+            QCOMPARE(positions, expected);
+        }
+    }
+
+    /// One placement pass, every showing is checked against the list
+    void Linear_benchmark(void)
+    {
+        vector<uint> positions;
+        QBENCHMARK
+        {
+            for (uint i = 0; i < m_list.size(); ++i)
+                FindOverlapsLinear(m_list, m_list[i], positions);
+        }
+    }
+
+    void Sweep_benchmark(void)
+    {
+        vector<uint> positions;
+        QBENCHMARK
+        {
+            ConflictSweep sweep;
+            sweep.Build(m_list);
+            for (uint i = 0; i < m_list.size(); ++i)
+                sweep.FindOverlaps(m_list[i], positions);
+        }
+    }
+};
@@ -0,0 +1,3 @@
+#include "test_matchrequest.h"
+
+QTEST_APPLESS_MAIN(TestMatchRequest)
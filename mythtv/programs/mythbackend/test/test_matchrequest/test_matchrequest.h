@@ -0,0 +1,296 @@
+/*
+ *  Class TestMatchRequest
+ *
+ *  Copyright (C) MythTV Developers 2016
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <algorithm>
+#include <vector>
+using std::vector;
+
+#include <QtTest/QtTest>
+#include <QDateTime>
+#include <QList>
+
+#include "matchrequest.h"
+
+/// Two weeks of half hour slots on 6 multiplexes of 2 sources
+static const int kRules    = 8;
+static const int kMplexes  = 6;
+static const int kSlots    = 14 * 48;
+static const int kSlotSecs = 30 * 60;
+
+/// One recordmatch row
+class MatchRow
+{
+  public:
+    uint   recordid;
+    uint   sourceid;
+    uint   mplexid;
+    qint64 start;
+
+    bool operator<(const MatchRow &o) const
+    {
+        if (start != o.start)
+            return start < o.start;
+        if (mplexid != o.mplexid)
+            return mplexid < o.mplexid;
+        return recordid < o.recordid;
+    }
+    bool operator==(const MatchRow &o) const
+    {
+        return start == o.start && mplexid == o.mplexid &&
+            sourceid == o.sourceid && recordid == o.recordid;
+    }
+};
+typedef vector<MatchRow> MatchTable;
+
+class TestMatchRequest: public QObject
+{
+    Q_OBJECT
+
+    MatchTable          m_truth; // recordmatch for the current guide
+    MatchTable          m_stale; // recordmatch before the guide changed
+    QList<MatchRequest> m_burst;
+
+    static QDateTime Base(void)
+    {
+        return QDateTime(QDate(2016, 4, 20), QTime(0, 0), Qt::UTC);
+    }
+
+    static uint SourceOf(uint mplexid) { return 1 + mplexid % 2; }
+
+    static MatchRow MakeRow(uint recordid, uint mplexid, int slot)
+    {
+        MatchRow row;
+        row.recordid = recordid;
+        row.sourceid = SourceOf(mplexid);
+        row.mplexid  = mplexid;
+        row.start    = Base().addSecs(slot * kSlotSecs).toMSecsSinceEpoch();
+        return row;
+    }
+
+    /// The rows UpdateMatches() deletes and refills for a request
+    static bool InRequest(const MatchRow &row, const MatchRequest &match)
+    {
+        if (match.recordid && row.recordid != match.recordid)
+            return false;
+        if (match.sourceid && row.sourceid != match.sourceid)
+            return false;
+        if (match.mplexid && row.mplexid != match.mplexid)
+            return false;
+        if (match.minstarttime.isValid() &&
+            row.start < match.minstarttime.toMSecsSinceEpoch())
+            return false;
+        if (match.maxstarttime.isValid() &&
+            row.start > match.maxstarttime.toMSecsSinceEpoch())
+            return false;
+        return true;
+    }
+
+    /// What UpdateMatches() does to recordmatch, with m_truth as the
+    /// result of matching the rules against the current guide
+    void UpdateMatches(MatchTable &table, const MatchRequest &match) const
+    {
+        MatchTable kept;
+        kept.reserve(table.size());
+        for (uint i = 0; i < table.size(); ++i)
+        {
+            if (!InRequest(table[i], match))
+                kept.push_back(table[i]);
+        }
+        for (uint i = 0; i < m_truth.size(); ++i)
+        {
+            if (InRequest(m_truth[i], match))
+                kept.push_back(m_truth[i]);
+        }
+        std::sort(kept.begin(), kept.end());
+        table.swap(kept);
+    }
+
+    /// A burst of EIT updates with the odd rule edit mixed in, the guide
+    /// only changes inside the requested windows
+    void MakeBurst(int count, bool fullmatch)
+    {
+        m_burst.clear();
+        m_stale = m_truth;
+        for (int i = 0; i < count; ++i)
+        {
+            MatchRequest match;
+            int slot = qrand() % kSlots;
+            if (qrand() % 8 == 0)
+            {
+                match.recordid = 1 + qrand() % kRules;
+            }
+            else
+            {
+                match.mplexid  = qrand() % kMplexes;
+                match.sourceid = SourceOf(match.mplexid);
+                match.minstarttime = Base().addSecs(slot * kSlotSecs);
+                match.maxstarttime = match.minstarttime.addSecs(
+                    (1 + qrand() % 12) * kSlotSecs);
+            }
+            if (fullmatch && i == count / 2)
+                match = MatchRequest();
+            m_burst.push_back(match);
+
+            // drop and add a few matches inside the window
+            MatchTable stale;
+            for (uint j = 0; j < m_stale.size(); ++j)
+            {
+                if (!InRequest(m_stale[j], match) || qrand() % 4)
+                    stale.push_back(m_stale[j]);
+            }
+            for (int j = 0; j < 4; ++j)
+            {
+                MatchRow row = MakeRow(1 + qrand() % kRules,
+                                       qrand() % kMplexes,
+                                       slot + qrand() % 12);
+                if (InRequest(row, match))
+                    stale.push_back(row);
+            }
+            std::sort(stale.begin(), stale.end());
+            m_stale.swap(stale);
+        }
+    }
+
+    MatchTable RunSequential(void) const
+    {
+        MatchTable table = m_stale;
+        for (int i = 0; i < m_burst.size(); ++i)
+            UpdateMatches(table, m_burst[i]);
+        return table;
+    }
+
+    MatchTable RunCoalesced(QList<MatchRequest> &pending) const
+    {
+        pending.clear();
+        for (int i = 0; i < m_burst.size(); ++i)
+            MatchRequest::Coalesce(pending, m_burst[i]);
+
+        MatchTable table = m_stale;
+        for (int i = 0; i < pending.size(); ++i)
+            UpdateMatches(table, pending[i]);
+        return table;
+    }
+
+  private slots:
+    // called at the beginning of these sets of tests
+    void initTestCase(void)
+    {
+        qsrand(1234);
+        for (int slot = 0; slot < kSlots; ++slot)
+        {
+            for (int mplexid = 0; mplexid < kMplexes; ++mplexid)
+            {
+                if (qrand() % 3 == 0)
+                    m_truth.push_back(
+                        MakeRow(1 + qrand() % kRules, mplexid, slot));
+            }
+        }
+        std::sort(m_truth.begin(), m_truth.end());
+    }
+
+    void Merge_test(void)
+    {
+        QList<MatchRequest> pending;
+        MatchRequest match;
+        match.sourceid = 1;
+        match.mplexid  = 3;
+        match.minstarttime = Base().addSecs(3600);
+        match.maxstarttime = Base().addSecs(7200);
+        MatchRequest::Coalesce(pending, match);
+
+        match.minstarttime = Base();
+        match.maxstarttime = Base().addSecs(5400);
+        MatchRequest::Coalesce(pending, match);
+        QCOMPARE(pending.size(), 1);
+        QCOMPARE(pending[0].minstarttime, Base());
+        QCOMPARE(pending[0].maxstarttime, Base().addSecs(7200));
+
+        // an open window stays open
+        match.minstarttime = QDateTime();
+        MatchRequest::Coalesce(pending, match);
+        QCOMPARE(pending.size(), 1);
+        QVERIFY(!pending[0].minstarttime.isValid());
+
+        // another multiplex is kept apart
+        match.mplexid = 5;
+        MatchRequest::Coalesce(pending, match);
+        QCOMPARE(pending.size(), 2);
+
+        // a full match replaces everything and absorbs later requests
+        MatchRequest::Coalesce(pending, MatchRequest());
+        MatchRequest::Coalesce(pending, match);
+        QCOMPARE(pending.size(), 1);
+        QVERIFY(pending[0].IsFullMatch());
+    }
+
+    void SameMatches_test_data(void)
+    {
+        QTest::addColumn<int>("count");
+        QTest::addColumn<bool>("fullmatch");
+        QTest::newRow("single")    << 1   << false;
+        QTest::newRow("burst")     << 200 << false;
+        QTest::newRow("fullmatch") << 200 << true;
+    }
+
+    /// Coalescing a burst must leave recordmatch as running the
+    /// requests one by one does
+    void SameMatches_test(void)
+    {
+        QFETCH(int, count);
+        QFETCH(bool, fullmatch);
+
+        qsrand(count);
+        MakeBurst(count, fullmatch);
+        QVERIFY(m_stale != m_truth || count == 1);
+
+        QList<MatchRequest> pending;
+        MatchTable coalesced = RunCoalesced(pending);
+        MatchTable sequential = RunSequential();
+        QCOMPARE(coalesced.size(), sequential.size());
+        QVERIFY(coalesced == sequential);
+        QVERIFY(sequential == m_truth);
+
+        QVERIFY(pending.size() <= m_burst.size());
+        if (count > kMplexes + kRules)
+            QVERIFY(pending.size() <= kMplexes + kRules);
+    }
+
+    /// A burst of 500 requests run one by one, as before coalescing
+    void Sequential_benchmark(void)
+    {
+        qsrand(500);
+        MakeBurst(500, false);
+        QBENCHMARK
+        {
+            RunSequential();
+        }
+    }
+
+    void Coalesced_benchmark(void)
+    {
+        qsrand(500);
+        MakeBurst(500, false);
+        QList<MatchRequest> pending;
+        QBENCHMARK
+        {
+            RunCoalesced(pending);
+        }
+    }
+};
@@ -130,7 +130,8 @@ ClassicCommDetector::ClassicCommDetector(SkipType commDetectMethod_in,
                                          const QDateTime& startedAt_in,
                                          const QDateTime& stopsAt_in,
                                          const QDateTime& recordingStartedAt_in,
-                                         const QDateTime& recordingStopsAt_in) :
+                                         const QDateTime& recordingStopsAt_in,
+                                         int threads_in) :
 
 
     commDetectMethod(commDetectMethod_in),
@@ -149,6 +150,9 @@ ClassicCommDetector::ClassicCommDetector(SkipType commDetectMethod_in,
     sceneHasChanged(false),                    stationLogoPresent(false),
     lastFrameWasBlank(false),                  lastFrameWasSceneChange(false),
     decoderFoundAspectChanges(false),          sceneChangeDetector(0),
+    analysisThreads(max(1, threads_in)),       analysisQueue(NULL),
+    sampleRows(0),                             sampleCols(0),
+    videoAspect(0.0f),
     player(player_in),
     startedAt(startedAt_in),                   stopsAt(stopsAt_in),
     recordingStartedAt(recordingStartedAt_in),
@@ -181,12 +185,26 @@ ClassicCommDetector::ClassicCommDetector(SkipType commDetectMethod_in,
         !!gCoreContext->GetNumSetting("CommDetectBlankCanHaveLogo", 1);
 }
 
+ClassicCommDetector::~ClassicCommDetector()
+{
+    delete analysisQueue;
+}
+
 void ClassicCommDetector::Init()
 {
     QSize video_disp_dim = player->GetVideoSize();
-    width  = video_disp_dim.width();
-    height = video_disp_dim.height();
-    fps = player->GetFrameRate();
+    Init(video_disp_dim.width(), video_disp_dim.height(),
+         player->GetFrameRate());
+}
+
+/** \fn ClassicCommDetector::Init(int,int,double)
+ *  \brief Sets up the detector for frames of the given size and rate.
+ */
+void ClassicCommDetector::Init(int width_in, int height_in, double fps_in)
+{
+    width  = width_in;
+    height = height_in;
+    fps    = fps_in;
 
     preRoll  = (long long)(
         max(int64_t(0), int64_t(recordingStartedAt.secsTo(startedAt))) * fps);
@@ -221,7 +239,7 @@ void ClassicCommDetector::Init()
         QString("Commercial Detection initialized: "
                 "width = %1, height = %2, fps = %3, method = %4")
             .arg(width).arg(height)
-            .arg(player->GetFrameRate()).arg(commDetectMethod));
+            .arg(fps).arg(commDetectMethod));
 
     if ((width * height) > 1000000)
     {
@@ -253,6 +271,8 @@ void ClassicCommDetector::Init()
         QString("Using Sample Spacing of %1 horizontal & %2 vertical pixels.")
             .arg(horizSpacing).arg(vertSpacing));
 
+    InitSampling();
+
     framesProcessed = 0;
     totalMinBrightness = 0;
     blankFrameCount = 0;
@@ -283,6 +303,16 @@ void ClassicCommDetector::Init()
 
     ClearAllMaps();
 
+    // The flagging thread decodes and merges, the others analyze.
+    delete analysisQueue;
+    analysisQueue = NULL;
+    if (analysisThreads > 1)
+    {
+        analysisQueue = new FrameAnalysisQueue(
+            this, FrameAnalysisQueue::kAnyLane, analysisThreads - 1,
+            4 * analysisThreads);
+    }
+
     if (verboseDebugging)
     {
         LOG(VB_COMMFLAG, LOG_DEBUG,
@@ -390,6 +420,7 @@ bool ClassicCommDetector::go()
         LOG(VB_GENERAL, LOG_INFO, "Finding Logo");
 
         logoInfoAvailable = logoDetector->searchForLogo(player);
+        InitLogoMask();
 
         if (showProgress)
         {
@@ -424,11 +455,9 @@ bool ClassicCommDetector::go()
 
     float flagFPS;
     long long  currentFrameNumber = 0LL;
-    float aspect = player->GetVideoAspect();
-    float newAspect = aspect;
     int prevpercent = -1;
 
-    SetVideoParams(aspect);
+    SetVideoAspect(player->GetVideoAspect());
 
     emit breathe();
 
@@ -443,17 +472,6 @@ bool ClassicCommDetector::go()
         VideoFrame* currentFrame = player->GetRawVideoFrame();
         currentFrameNumber = currentFrame->frameNumber;
 
-        //Lucas: maybe we should make the nuppelvideoplayer send out a signal
-        //when the aspect ratio changes.
-        //In order to not change too many things at a time, I"m using basic
-        //polling for now.
-        newAspect = currentFrame->aspect;
-        if (newAspect != aspect)
-        {
-            SetVideoParams(aspect);
-            aspect = newAspect;
-        }
-
         if (((currentFrameNumber % 500) == 0) ||
             (((currentFrameNumber % 100) == 0) &&
              (stillRecording)))
@@ -466,46 +484,6 @@ bool ClassicCommDetector::go()
             }
         }
 
-        if ((sendCommBreakMapUpdates) &&
-            ((commBreakMapUpdateRequested) ||
-             ((currentFrameNumber % 500) == 0)))
-        {
-            frm_dir_map_t commBreakMap;
-            frm_dir_map_t::iterator it;
-            frm_dir_map_t::iterator lastIt;
-            bool mapsAreIdentical = false;
-
-            GetCommercialBreakList(commBreakMap);
-
-            if ((commBreakMap.size() == 0) &&
-                (lastSentCommBreakMap.size() == 0))
-            {
-                mapsAreIdentical = true;
-            }
-            else if (commBreakMap.size() == lastSentCommBreakMap.size())
-            {
-                // assume true for now and set false if we find a difference
-                mapsAreIdentical = true;
-                for (it = commBreakMap.begin();
-                     it != commBreakMap.end() && mapsAreIdentical; ++it)
-                {
-                    lastIt = lastSentCommBreakMap.find(it.key());
-                    if ((lastIt == lastSentCommBreakMap.end()) ||
-                        (*lastIt != *it))
-                        mapsAreIdentical = false;
-                }
-            }
-
-            if (commBreakMapUpdateRequested || !mapsAreIdentical)
-            {
-                emit gotNewCommercialBreakList();
-                lastSentCommBreakMap = commBreakMap;
-            }
-
-            if (commBreakMapUpdateRequested)
-                commBreakMapUpdateRequested = false;
-        }
-
         while (m_bPaused)
         {
             emit breathe();
@@ -569,7 +547,7 @@ bool ClassicCommDetector::go()
             }
         }
 
-        ProcessFrame(currentFrame, currentFrameNumber);
+        QueueFrame(currentFrame);
 
         if (stillRecording)
         {
@@ -604,6 +582,8 @@ bool ClassicCommDetector::go()
         player->DiscardVideoFrame(currentFrame);
     }
 
+    FlushFrames();
+
     if (showProgress)
     {
         float elapsed = flagTime.elapsed() / 1000.0;
@@ -764,32 +744,234 @@ void ClassicCommDetector::SetVideoParams(float aspect)
     }
 }
 
-void ClassicCommDetector::ProcessFrame(VideoFrame *frame,
-                                       long long frame_number)
+/** \fn ClassicCommDetector::SetVideoAspect(float)
+ *  \brief Sets the aspect ratio the first merged frame is compared with.
+ */
+void ClassicCommDetector::SetVideoAspect(float aspect)
+{
+    videoAspect = aspect;
+    SetVideoParams(aspect);
+}
+
+/** \fn ClassicCommDetector::QueueFrame(const VideoFrame*)
+ *  \brief Analyzes a decoded frame and merges every frame whose analysis
+ *         is done, in decode order.
+ *
+ *  With more than one analysis thread the frame is copied onto the
+ *  analysis queue and this only blocks when the queue is full, so the
+ *  caller can keep decoding while earlier frames are analyzed.
+ */
+void ClassicCommDetector::QueueFrame(const VideoFrame *frame)
+{
+    if (!analysisQueue)
+    {
+        AnalyzeFrame(frame, serialStats);
+        MergeFrameStats(serialStats);
+
+#ifdef SHOW_DEBUG_WIN
+        if (frame && frame->buf)
+        {
+            comm_debug_show(frame->buf);
+            getchar();
+        }
+#endif
+        return;
+    }
+
+    FrameAnalysisJob *job;
+    if (analysisQueue->IsFull() && (job = analysisQueue->Dequeue(true)))
+    {
+        MergeFrameStats(*static_cast<ClassicFrameStats*>(job));
+        analysisQueue->Release(job);
+    }
+
+    analysisQueue->Enqueue(frame);
+
+    while ((job = analysisQueue->Dequeue(false)))
+    {
+        MergeFrameStats(*static_cast<ClassicFrameStats*>(job));
+        analysisQueue->Release(job);
+    }
+}
+
+/// Waits for the analysis of every queued frame and merges it
+void ClassicCommDetector::FlushFrames(void)
+{
+    if (!analysisQueue)
+        return;
+
+    FrameAnalysisJob *job;
+    while ((job = analysisQueue->Dequeue(true)))
+    {
+        MergeFrameStats(*static_cast<ClassicFrameStats*>(job));
+        analysisQueue->Release(job);
+    }
+}
+
+FrameAnalysisJob *ClassicCommDetector::CreateFrameJob(void)
+{
+    return new ClassicFrameStats();
+}
+
+void ClassicCommDetector::AnalyzeFrameJob(FrameAnalysisJob *job, uint)
+{
+    ClassicFrameStats *stats = static_cast<ClassicFrameStats*>(job);
+    AnalyzeFrame(&stats->frame, *stats);
+}
+
+/** \fn ClassicCommDetector::AnalyzeFrame(const VideoFrame*,ClassicFrameStats&)
+ *  \brief Takes the measurements of one frame that do not depend on any
+ *         other frame.
+ *
+ *  Only \p stats is written, everything read here is fixed before the
+ *  first frame is queued, so this may run on several frames at once.
+ *  Rows that cross the logo are fed to lumarowstats() as runs of unmasked
+ *  samples.
+ */
+void ClassicCommDetector::AnalyzeFrame(const VideoFrame *frame,
+                                       ClassicFrameStats &stats)
+{
+    stats.frameNumber = frame ? frame->frameNumber : -1;
+    stats.aspect      = frame ? frame->aspect : videoAspect;
+    stats.valid       = frame && frame->buf && stats.frameNumber != -1 &&
+                        frame->codec == FMT_YV12;
+    stats.logoPresent = false;
+
+    if (!stats.valid || !width || !height)
+        return;
+
+    if (commDetectMethod & COMM_DETECT_BLANKS)
+    {
+        const unsigned char *framePtr = frame->buf;
+        int bytesPerLine = frame->pitches[0];
+
+        lumastatsinit(&stats.luma);
+        stats.rowMax.assign(max(sampleRows, 1), 0);
+        stats.colMax.assign(max(sampleCols, 1), 0);
+        unsigned char *colMax = &stats.colMax[0];
+
+        for (int r = 0; r < sampleRows; r++)
+        {
+            const unsigned char *row = framePtr +
+                (commDetectBorder + r * vertSpacing) * bytesPerLine +
+                commDetectBorder;
+
+            if (logoMask.empty())
+            {
+                stats.rowMax[r] = lumarowstats(row, sampleCols, horizSpacing,
+                                               colMax, &stats.luma);
+                continue;
+            }
+
+            const unsigned char *mask = &logoMask[r * sampleCols];
+            unsigned char rmax = 0;
+            int j = 0;
+            while (j < sampleCols)
+            {
+                while (j < sampleCols && mask[j])
+                    j++;
+
+                int start = j;
+                while (j < sampleCols && !mask[j])
+                    j++;
+
+                if (j > start)
+                {
+                    rmax = max(rmax, lumarowstats(
+                                   row + start * horizSpacing, j - start,
+                                   horizSpacing, colMax + start, &stats.luma));
+                }
+            }
+            stats.rowMax[r] = rmax;
+        }
+    }
+
+    if (commDetectMethod & COMM_DETECT_SCENE)
+        sceneChangeDetector->generateHistogram(frame, stats.histogram);
+
+    if ((logoInfoAvailable) && (commDetectMethod & COMM_DETECT_LOGO))
+    {
+        stats.logoPresent =
+            logoDetector->doesThisFrameContainTheFoundLogo(frame);
+    }
+}
+
+/** \fn ClassicCommDetector::MergeFrameStats(const ClassicFrameStats&)
+ *  \brief Merges the measurements of one frame into the frame info,
+ *         frames must be merged in decode order.
+ */
+void ClassicCommDetector::MergeFrameStats(const ClassicFrameStats &stats)
+{
+    //Lucas: maybe we should make the nuppelvideoplayer send out a signal
+    //when the aspect ratio changes.
+    //In order to not change too many things at a time, I"m using basic
+    //polling for now.
+    if (stats.aspect != videoAspect)
+    {
+        SetVideoParams(videoAspect);
+        videoAspect = stats.aspect;
+    }
+
+    if ((sendCommBreakMapUpdates) &&
+        ((commBreakMapUpdateRequested) ||
+         ((stats.frameNumber % 500) == 0)))
+    {
+        frm_dir_map_t commBreakMap;
+        frm_dir_map_t::iterator it;
+        frm_dir_map_t::iterator lastIt;
+        bool mapsAreIdentical = false;
+
+        GetCommercialBreakList(commBreakMap);
+
+        if ((commBreakMap.size() == 0) &&
+            (lastSentCommBreakMap.size() == 0))
+        {
+            mapsAreIdentical = true;
+        }
+        else if (commBreakMap.size() == lastSentCommBreakMap.size())
+        {
+            // assume true for now and set false if we find a difference
+            mapsAreIdentical = true;
+            for (it = commBreakMap.begin();
+                 it != commBreakMap.end() && mapsAreIdentical; ++it)
+            {
+                lastIt = lastSentCommBreakMap.find(it.key());
+                if ((lastIt == lastSentCommBreakMap.end()) ||
+                    (*lastIt != *it))
+                    mapsAreIdentical = false;
+            }
+        }
+
+        if (commBreakMapUpdateRequested || !mapsAreIdentical)
+        {
+            emit gotNewCommercialBreakList();
+            lastSentCommBreakMap = commBreakMap;
+        }
+
+        if (commBreakMapUpdateRequested)
+            commBreakMapUpdateRequested = false;
+    }
+
+    ApplyFrameStats(stats);
+}
+
+void ClassicCommDetector::ApplyFrameStats(const ClassicFrameStats &stats)
 {
     int max = 0;
     int min = 255;
     int avg = 0;
-    unsigned char pixel;
     int blankPixelsChecked = 0;
     long long totBrightness = 0;
-    unsigned char *rowMax = new unsigned char[height];
-    unsigned char *colMax = new unsigned char[width];
-    memset(rowMax, 0, sizeof(*rowMax)*height);
-    memset(colMax, 0, sizeof(*colMax)*width);
     int topDarkRow = commDetectBorder;
     int bottomDarkRow = height - commDetectBorder - 1;
     int leftDarkCol = commDetectBorder;
     int rightDarkCol = width - commDetectBorder - 1;
     FrameInfoEntry fInfo;
 
-    if (!frame || !(frame->buf) || frame_number == -1 ||
-        frame->codec != FMT_YV12)
+    if (!stats.valid)
     {
         LOG(VB_COMMFLAG, LOG_ERR, "CommDetect: Invalid video frame or codec, "
                                   "unable to process frame.");
-        delete[] rowMax;
-        delete[] colMax;
         return;
     }
 
@@ -797,14 +979,10 @@ void ClassicCommDetector::ProcessFrame(VideoFrame *frame,
     {
         LOG(VB_COMMFLAG, LOG_ERR, "CommDetect: Width or Height is 0, "
                                   "unable to process frame.");
-        delete[] rowMax;
-        delete[] colMax;
         return;
     }
 
-    curFrameNumber = frame_number;
-    unsigned char* framePtr = frame->buf;
-    int bytesPerLine = frame->pitches[0];
+    curFrameNumber = stats.frameNumber;
 
     fInfo.minBrightness = -1;
     fInfo.maxBrightness = -1;
@@ -836,91 +1014,50 @@ void ClassicCommDetector::ProcessFrame(VideoFrame *frame,
 
     frameInfo[curFrameNumber] = fInfo;
 
-    if (commDetectMethod & COMM_DETECT_BLANKS)
+    bool scanBlanks = (commDetectMethod & COMM_DETECT_BLANKS);
+    if (scanBlanks)
         frameIsBlank = false;
 
     if (commDetectMethod & COMM_DETECT_SCENE)
     {
-        sceneChangeDetector->processFrame(frame);
+        sceneChangeDetector->processHistogram(stats.histogram);
     }
 
-    stationLogoPresent = false;
+    stationLogoPresent = stats.logoPresent;
 
-    for(int y = commDetectBorder; y < (height - commDetectBorder);
-            y += vertSpacing)
+    if (scanBlanks)
     {
-        for(int x = commDetectBorder; x < (width - commDetectBorder);
-                x += horizSpacing)
-        {
-            pixel = framePtr[y * bytesPerLine + x];
-
-            if (commDetectMethod & COMM_DETECT_BLANKS)
-            {
-                 bool checkPixel = false;
-                 if (!commDetectBlankCanHaveLogo)
-                     checkPixel = true;
-
-                 if (!logoInfoAvailable)
-                     checkPixel = true;
-                 else if (!logoDetector->pixelInsideLogo(x,y))
-                     checkPixel=true;
-
-                 if (checkPixel)
-                 {
-                     blankPixelsChecked++;
-                     totBrightness += pixel;
-
-                     if (pixel < min)
-                          min = pixel;
-
-                     if (pixel > max)
-                          max = pixel;
-
-                     if (pixel > rowMax[y])
-                         rowMax[y] = pixel;
-
-                     if (pixel > colMax[x])
-                         colMax[x] = pixel;
-                 }
-            }
-        }
+        blankPixelsChecked = stats.luma.count;
+        totBrightness = stats.luma.sum;
+        min = stats.luma.min;
+        max = stats.luma.max;
     }
 
-    if ((commDetectMethod & COMM_DETECT_BLANKS) && blankPixelsChecked)
+    if (scanBlanks && blankPixelsChecked)
     {
-        for(int y = commDetectBorder; y < (height - commDetectBorder);
-                y += vertSpacing)
+        for (int r = 0; r < sampleRows; r++)
         {
-            if (rowMax[y] > commDetectBoxBrightness)
+            if (stats.rowMax[r] > commDetectBoxBrightness)
                 break;
             else
-                topDarkRow = y;
+                topDarkRow = commDetectBorder + r * vertSpacing;
         }
 
-        for(int y = commDetectBorder; y < (height - commDetectBorder);
-                y += vertSpacing)
-            if (rowMax[y] >= commDetectBoxBrightness)
-                bottomDarkRow = y;
+        for (int r = 0; r < sampleRows; r++)
+            if (stats.rowMax[r] >= commDetectBoxBrightness)
+                bottomDarkRow = commDetectBorder + r * vertSpacing;
 
-        delete[] rowMax;
-        rowMax = 0;
-
-        for(int x = commDetectBorder; x < (width - commDetectBorder);
-                x += horizSpacing)
+        for (int j = 0; j < sampleCols; j++)
         {
-            if (colMax[x] > commDetectBoxBrightness)
+            if (stats.colMax[j] > commDetectBoxBrightness)
                 break;
             else
-                leftDarkCol = x;
+                leftDarkCol = commDetectBorder + j * horizSpacing;
         }
 
-        for(int x = commDetectBorder; x < (width - commDetectBorder);
-                x += horizSpacing)
-            if (colMax[x] >= commDetectBoxBrightness)
-                rightDarkCol = x;
-
-        delete[] colMax;
-        colMax = 0;
+        for (int j = 0; j < sampleCols; j++)
+            if (stats.colMax[j] >= commDetectBoxBrightness)
+                rightDarkCol = commDetectBorder + j * horizSpacing;
 
         frameInfo[curFrameNumber].format = COMM_FORMAT_NORMAL;
         if ((topDarkRow > commDetectBorder) &&
@@ -965,12 +1102,6 @@ void ClassicCommDetector::ProcessFrame(VideoFrame *frame,
             frameIsBlank = true;
     }
 
-    if ((logoInfoAvailable) && (commDetectMethod & COMM_DETECT_LOGO))
-    {
-        stationLogoPresent =
-            logoDetector->doesThisFrameContainTheFoundLogo(frame);
-    }
-
 #if 0
     if ((commDetectMethod == COMM_DETECT_ALL) &&
         (CheckRatingSymbol()))
@@ -1009,14 +1140,49 @@ void ClassicCommDetector::ProcessFrame(VideoFrame *frame,
                 frameInfo[curFrameNumber].aspect,
                 frameInfo[curFrameNumber].flagMask ));
 
-#ifdef SHOW_DEBUG_WIN
-    comm_debug_show(frame->buf);
-    getchar();
-#endif
-
     framesProcessed++;
-    delete[] rowMax;
-    delete[] colMax;
+}
+
+/** \fn ClassicCommDetector::InitSampling(void)
+ *  \brief Counts the rows and columns sampled by the blank frame scan.
+ */
+void ClassicCommDetector::InitSampling(void)
+{
+    sampleRows = 0;
+    if (height > 2 * commDetectBorder)
+        sampleRows =
+            (height - 2 * commDetectBorder + vertSpacing - 1) / vertSpacing;
+
+    sampleCols = 0;
+    if (width > 2 * commDetectBorder)
+        sampleCols =
+            (width - 2 * commDetectBorder + horizSpacing - 1) / horizSpacing;
+
+    logoMask.clear();
+}
+
+/** \fn ClassicCommDetector::InitLogoMask(void)
+ *  \brief Marks the sampled pixels that the blank frame scan must skip
+ *         because they are inside the station logo.
+ */
+void ClassicCommDetector::InitLogoMask(void)
+{
+    logoMask.clear();
+
+    if (!commDetectBlankCanHaveLogo || !logoInfoAvailable)
+        return;
+
+    logoMask.assign(sampleRows * sampleCols, 0);
+    for (int r = 0; r < sampleRows; r++)
+    {
+        int y = commDetectBorder + r * vertSpacing;
+        for (int j = 0; j < sampleCols; j++)
+        {
+            int x = commDetectBorder + j * horizSpacing;
+            if (logoDetector->pixelInsideLogo(x, y))
+                logoMask[r * sampleCols + j] = 1;
+        }
+    }
 }
 
 void ClassicCommDetector::ClearAllMaps(void)
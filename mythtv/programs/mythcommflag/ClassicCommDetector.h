@@ -4,6 +4,10 @@
 // POSIX headers
 #include <stdint.h>
 
+// C++ headers
+#include <vector>
+using namespace std;
+
 // Qt headers
 #include <QObject>
 #include <QMap>
@@ -15,10 +19,12 @@
 
 // Commercial Flagging headers
 #include "CommDetectorBase.h"
+#include "FrameAnalysisQueue.h"
+#include "Histogram.h"
 
 class MythPlayer;
 class LogoDetectorBase;
-class SceneChangeDetectorBase;
+class ClassicSceneChangeDetector;
 
 enum frameMaskValues {
     COMM_FRAME_SKIPPED       = 0x0001,
@@ -43,7 +49,32 @@ class FrameInfoEntry
     QString toString(uint64_t frame, bool verbose) const;
 };
 
-class ClassicCommDetector : public CommDetectorBase
+/** \brief What ClassicCommDetector measures in one frame.
+ *
+ *  AnalyzeFrame() only reads the frame and state that is fixed once
+ *  flagging starts, so frames can be measured on any thread. The results
+ *  are then merged into the detector in frame order by MergeFrameStats().
+ */
+class ClassicFrameStats : public FrameAnalysisJob
+{
+  public:
+    ClassicFrameStats() :
+        frameNumber(-1), aspect(0.0f), valid(false), logoPresent(false)
+    {
+        lumastatsinit(&luma);
+    }
+
+    long long frameNumber;
+    float aspect;
+    bool valid;
+    LumaStats luma;
+    vector<unsigned char> rowMax; ///< indexed by sampled row
+    vector<unsigned char> colMax; ///< indexed by sampled column
+    Histogram histogram;
+    bool logoPresent;
+};
+
+class ClassicCommDetector : public CommDetectorBase, public FrameJobAnalyzer
 {
     Q_OBJECT
 
@@ -53,7 +84,8 @@ class ClassicCommDetector : public CommDetectorBase
                             const QDateTime& startedAt_in,
                             const QDateTime& stopsAt_in,
                             const QDateTime& recordingStartedAt_in,
-                            const QDateTime& recordingStopsAt_in);
+                            const QDateTime& recordingStopsAt_in,
+                            int threads = 1);
         virtual void deleteLater(void);
 
         bool go();
@@ -70,7 +102,7 @@ class ClassicCommDetector : public CommDetectorBase
         friend class ClassicLogoDetector;
 
     protected:
-        virtual ~ClassicCommDetector() {}
+        virtual ~ClassicCommDetector();
 
     private:
         typedef struct frameblock
@@ -111,6 +143,15 @@ class ClassicCommDetector : public CommDetectorBase
             frm_dir_map_t &out, const show_map_t &in);
         void CleanupFrameInfo(void);
         void GetLogoCommBreakMap(show_map_t &map);
+        void InitSampling(void);
+        void InitLogoMask(void);
+        void AnalyzeFrame(const VideoFrame *frame, ClassicFrameStats &stats);
+        void MergeFrameStats(const ClassicFrameStats &stats);
+        void ApplyFrameStats(const ClassicFrameStats &stats);
+
+        // FrameJobAnalyzer
+        FrameAnalysisJob *CreateFrameJob(void);
+        void AnalyzeFrameJob(FrameAnalysisJob *job, uint lane);
 
         enum SkipTypes commDetectMethod;
         frm_dir_map_t lastSentCommBreakMap;
@@ -169,7 +210,16 @@ class ClassicCommDetector : public CommDetectorBase
         bool lastFrameWasSceneChange;
         bool decoderFoundAspectChanges;
 
-        SceneChangeDetectorBase* sceneChangeDetector;
+        ClassicSceneChangeDetector* sceneChangeDetector;
+
+        // Parallel frame analysis
+        int analysisThreads;
+        FrameAnalysisQueue *analysisQueue;
+        ClassicFrameStats serialStats;
+        vector<unsigned char> logoMask;
+        int sampleRows;
+        int sampleCols;
+        float videoAspect;
 
 protected:
         MythPlayer *player;
@@ -186,8 +236,11 @@ protected:
 
 
         void Init();
+        void Init(int width_in, int height_in, double fps_in);
         void SetVideoParams(float aspect);
-        void ProcessFrame(VideoFrame *frame, long long frame_number);
+        void SetVideoAspect(float aspect);
+        void QueueFrame(const VideoFrame *frame);
+        void FlushFrames(void);
         QMap<long long, FrameInfoEntry> frameInfo;
 
 public slots:
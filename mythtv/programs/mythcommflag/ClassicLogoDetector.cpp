@@ -30,7 +30,7 @@ ClassicLogoDetector::ClassicLogoDetector(ClassicCommDetector* commdetector,
                                          unsigned int xspacing_in,
                                          unsigned int yspacing_in)
     : LogoDetectorBase(w,h),
-      commDetector(commdetector),                       frameNumber(0),
+      commDetector(commdetector),
       previousFrameWasSceneChange(false),
       xspacing(xspacing_in),                            yspacing(yspacing_in),
       commDetectBorder(commdetectborder_in),            edgeMask(new EdgeMaskEntry[width * height]),
@@ -378,7 +378,7 @@ void ClassicLogoDetector::DumpLogo(bool fromCurrentFrame,
  * which are partially mods based on Myth's original commercial skip
  * code written by Chris Pinkham. */
 bool ClassicLogoDetector::doesThisFrameContainTheFoundLogo(
-    VideoFrame* frame)
+    const VideoFrame* frame)
 {
     int radius = 2;
     unsigned int x, y;
@@ -390,7 +390,7 @@ bool ClassicLogoDetector::doesThisFrameContainTheFoundLogo(
     int testEdges = 0;
     int testNotEdges = 0;
 
-    unsigned char* framePtr = frame->buf;
+    const unsigned char* framePtr = frame->buf;
     int bytesPerLine = frame->pitches[0];
 
     for (y = logoMinY; y <= logoMaxY; y++ )
@@ -436,7 +436,6 @@ bool ClassicLogoDetector::doesThisFrameContainTheFoundLogo(
         }
     }
 
-    frameNumber++;
     double goodEdgeRatio = (testEdges) ?
         (double)goodEdges / (double)testEdges : 0.0;
     double badEdgeRatio = (testNotEdges) ?
@@ -27,17 +27,30 @@ void ClassicSceneChangeDetector::deleteLater(void)
 
 void ClassicSceneChangeDetector::processFrame(VideoFrame* frame)
 {
-    histogram->generateFromImage(frame, width, height, commdetectborder,
-                                 width-commdetectborder, commdetectborder,
-                                 height-commdetectborder, xspacing, yspacing);
-    float similar = histogram->calculateSimilarityWith(*previousHistogram);
+    generateHistogram(frame, *histogram);
+    processHistogram(*histogram);
+}
+
+/// Only reads the frame, so this may run for several frames at once
+void ClassicSceneChangeDetector::generateHistogram(const VideoFrame* frame,
+                                                   Histogram &hist) const
+{
+    hist.generateFromImage(frame, width, height, commdetectborder,
+                           width-commdetectborder, commdetectborder,
+                           height-commdetectborder, xspacing, yspacing);
+}
+
+/// Compares the histogram with the previous frame's, in frame order
+void ClassicSceneChangeDetector::processHistogram(const Histogram &hist)
+{
+    float similar = hist.calculateSimilarityWith(*previousHistogram);
 
     bool isSceneChange = (similar < .85 && !previousFrameWasSceneChange);
 
     emit(haveNewInformation(frameNumber,isSceneChange,similar));
     previousFrameWasSceneChange = isSceneChange;
 
-    std::swap(histogram,previousHistogram);
+    *previousHistogram = hist;
     frameNumber++;
 }
 
@@ -14,6 +14,8 @@ class ClassicSceneChangeDetector : public SceneChangeDetectorBase
     virtual void deleteLater(void);
 
     void processFrame(VideoFrame* frame);
+    void generateHistogram(const VideoFrame* frame, Histogram &hist) const;
+    void processHistogram(const Histogram &hist);
 
   private:
     ~ClassicSceneChangeDetector() {}
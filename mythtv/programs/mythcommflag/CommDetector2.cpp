@@ -313,7 +313,8 @@ CommDetector2::CommDetector2(
     const QDateTime   &endts_in,
     const QDateTime   &recstartts_in,
     const QDateTime   &recendts_in,
-    bool               useDB) :
+    bool               useDB,
+    int                threads) :
     commDetectMethod((enum SkipTypes)(commDetectMethod_in & ~COMM_DETECT_2)),
     showProgress(showProgress_in),  fullSpeed(fullSpeed_in),
     player(player_in),
@@ -324,6 +325,7 @@ CommDetector2::CommDetector2(
     finished(false),                currentFrameNumber(0),
     logoFinder(NULL),               logoMatcher(NULL),
     blankFrameDetector(NULL),       sceneChangeDetector(NULL),
+    laneActive(0),                  analysisQueue(NULL),
     debugdir("")
 {
     FrameAnalyzerItem        pass0, pass1;
@@ -415,8 +417,16 @@ CommDetector2::CommDetector2(
 
         if (!logoMatcher)
         {
-            logoMatcher = new TemplateMatcher(pgmConverter, cannyEdgeDetector,
-                    logoFinder, debugdir);
+            /*
+             * PGMConverter caches the last converted frame, so the matcher
+             * needs its own when it runs beside the histogram analyzers.
+             */
+            PGMConverter *matcherConverter = pgmConverter;
+            if (threads > 1 && histogramAnalyzer)
+                matcherConverter = new PGMConverter();
+
+            logoMatcher = new TemplateMatcher(matcherConverter,
+                    cannyEdgeDetector, logoFinder, debugdir);
             pass1.push_back(logoMatcher);
         }
     }
@@ -427,6 +437,23 @@ CommDetector2::CommDetector2(
     /* Aggregate them all together. */
     frameAnalyzers.push_back(pass0);
     frameAnalyzers.push_back(pass1);
+
+    if (threads > 1)
+    {
+        FrameAnalyzerItem histogramLane, logoLane;
+
+        if (blankFrameDetector)
+            histogramLane.push_back(blankFrameDetector);
+        if (sceneChangeDetector)
+            histogramLane.push_back(sceneChangeDetector);
+        if (logoMatcher)
+            logoLane.push_back(logoMatcher);
+
+        if (!histogramLane.empty())
+            analysisLanes.push_back(histogramLane);
+        if (!logoLane.empty())
+            analysisLanes.push_back(logoLane);
+    }
 }
 
 void CommDetector2::reportState(int elapsedms, long long frameno,
@@ -521,6 +548,130 @@ int CommDetector2::computeBreaks(long long nframes)
     return 0;
 }
 
+/*
+ * Runs the analyzers of the pass on one thread per lane if the pass is made
+ * up of the analysis lanes, the caller keeps decoding meanwhile.
+ */
+bool CommDetector2::startLanes(const FrameAnalyzerItem &pass)
+{
+    laneAnalyzers.clear();
+
+    FrameAnalyzerItem::size_type nanalyzers = 0;
+    for (FrameAnalyzerList::const_iterator lane = analysisLanes.begin();
+            lane != analysisLanes.end(); ++lane)
+    {
+        FrameAnalyzerItem item;
+        for (FrameAnalyzerItem::const_iterator it = lane->begin();
+                it != lane->end(); ++it)
+        {
+            if (std::find(pass.begin(), pass.end(), *it) != pass.end())
+                item.push_back(*it);
+        }
+
+        if (!item.empty())
+        {
+            nanalyzers += item.size();
+            laneAnalyzers.push_back(item);
+        }
+    }
+
+    if (laneAnalyzers.size() < 2 || nanalyzers != pass.size())
+    {
+        laneAnalyzers.clear();
+        return false;
+    }
+
+    laneFinished.assign(laneAnalyzers.size(), FrameAnalyzerItem());
+    laneDead.assign(laneAnalyzers.size(), FrameAnalyzerItem());
+    laneActive.fetchAndStoreOrdered(nanalyzers);
+
+    analysisQueue = new FrameAnalysisQueue(
+        this, FrameAnalysisQueue::kEveryLane, laneAnalyzers.size(),
+        4 * laneAnalyzers.size());
+
+    return true;
+}
+
+void CommDetector2::queueFrame(const VideoFrame *frame)
+{
+    FrameAnalysisJob *job;
+
+    if (analysisQueue->IsFull() && (job = analysisQueue->Dequeue(true)))
+        analysisQueue->Release(job);
+
+    analysisQueue->Enqueue(frame);
+
+    while ((job = analysisQueue->Dequeue(false)))
+        analysisQueue->Release(job);
+}
+
+/*
+ * Waits until the lanes have analyzed every queued frame, then moves the
+ * analyzers that finished or died in a lane out of the pass, in pass order.
+ */
+void CommDetector2::syncLanes(FrameAnalyzerItem &pass,
+                              FrameAnalyzerItem &deadAnalyzers)
+{
+    FrameAnalysisJob *job;
+    while ((job = analysisQueue->Dequeue(true)))
+        analysisQueue->Release(job);
+
+    FrameAnalyzerItem finished, dead;
+    for (uint lane = 0; lane < laneAnalyzers.size(); lane++)
+    {
+        finished.insert(finished.end(), laneFinished[lane].begin(),
+                        laneFinished[lane].end());
+        dead.insert(dead.end(), laneDead[lane].begin(), laneDead[lane].end());
+        laneFinished[lane].clear();
+        laneDead[lane].clear();
+    }
+
+    FrameAnalyzerItem::iterator it = pass.begin();
+    while (it != pass.end())
+    {
+        if (std::find(finished.begin(), finished.end(), *it) != finished.end())
+        {
+            finishedAnalyzers.push_back(*it);
+            it = pass.erase(it);
+        }
+        else if (std::find(dead.begin(), dead.end(), *it) != dead.end())
+        {
+            deadAnalyzers.push_back(*it);
+            it = pass.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void CommDetector2::stopLanes(void)
+{
+    delete analysisQueue;
+    analysisQueue = NULL;
+    laneAnalyzers.clear();
+}
+
+FrameAnalysisJob *CommDetector2::CreateFrameJob(void)
+{
+    return new FrameAnalysisJob();
+}
+
+/* Each lane only touches its own analyzers and lists. */
+void CommDetector2::AnalyzeFrameJob(FrameAnalysisJob *job, uint lane)
+{
+    FrameAnalyzerItem &item = laneAnalyzers[lane];
+    if (item.empty())
+        return;
+
+    int nanalyzers = item.size();
+    (void)processFrame(item, laneFinished[lane], laneDead[lane],
+                       &job->frame, job->frame.frameNumber + 1);
+    if ((int)item.size() != nanalyzers)
+        laneActive.fetchAndAddOrdered(item.size() - nanalyzers);
+}
+
 bool CommDetector2::go(void)
 {
     int minlag = 7; // seconds
@@ -589,11 +740,15 @@ bool CommDetector2::go(void)
         if (searchingForLogo(logoFinder, *currentPass))
             emit statusUpdate(QCoreApplication::translate("(mythcommflag)",
                 "Performing Logo Identification"));
+        else
+            startLanes(*currentPass);
 
         clock.start();
         passTime.start();
         memset(&getframetime, 0, sizeof(getframetime));
-        while (!(*currentPass).empty() && player->GetEof() == kEofStateNone)
+        while (!(*currentPass).empty() &&
+               (!analysisQueue || laneActive.fetchAndAddOrdered(0) > 0) &&
+               player->GetEof() == kEofStateNone)
         {
             struct timeval start, end, elapsedtv;
 
@@ -625,6 +780,7 @@ bool CommDetector2::go(void)
                 if (m_bStop)
                 {
                     player->DiscardVideoFrame(currentFrame);
+                    stopLanes();
                     return false;
                 }
             }
@@ -643,9 +799,18 @@ bool CommDetector2::go(void)
                         nframes, passno, npasses);
             }
 
-            nextFrame = processFrame(
-                *currentPass, finishedAnalyzers,
-                deadAnalyzers, currentFrame, currentFrameNumber);
+            if (analysisQueue)
+            {
+                /* The lanes only hold analyzers that want every frame. */
+                queueFrame(currentFrame);
+                nextFrame = currentFrameNumber + 1;
+            }
+            else
+            {
+                nextFrame = processFrame(
+                    *currentPass, finishedAnalyzers,
+                    deadAnalyzers, currentFrame, currentFrameNumber);
+            }
 
             if (((currentFrameNumber >= 1) && (nframes > 0) &&
                  (((nextFrame * 10) / nframes) !=
@@ -682,6 +847,9 @@ bool CommDetector2::go(void)
             {
                 frm_dir_map_t breakMap;
 
+                if (analysisQueue)
+                    syncLanes(*currentPass, deadAnalyzers);
+
                 GetCommercialBreakList(breakMap);
 
                 frm_dir_map_t::const_iterator ii, jj;
@@ -708,6 +876,12 @@ bool CommDetector2::go(void)
             player->DiscardVideoFrame(currentFrame);
         }
 
+        if (analysisQueue)
+        {
+            syncLanes(*currentPass, deadAnalyzers);
+            stopLanes();
+        }
+
         // Save total duration only on the last pass, which hopefully does
         // no skipping.
         if (passno + 1 == npasses)
@@ -7,6 +7,7 @@ using namespace std;
 
 // Qt headers
 #include <QDateTime>
+#include <QAtomicInt>
 
 // MythTV headers
 #include "programinfo.h"
@@ -14,6 +15,7 @@ using namespace std;
 // Commercial Flagging headers
 #include "CommDetectorBase.h"
 #include "FrameAnalyzer.h"
+#include "FrameAnalysisQueue.h"
 
 class MythPlayer;
 class TemplateFinder;
@@ -34,14 +36,15 @@ QString strftimeval(const struct timeval *tv);
 typedef vector<FrameAnalyzer*>    FrameAnalyzerItem;
 typedef vector<FrameAnalyzerItem> FrameAnalyzerList;
 
-class CommDetector2 : public CommDetectorBase
+class CommDetector2 : public CommDetectorBase, public FrameJobAnalyzer
 {
   public:
     CommDetector2(
         SkipType commDetectMethod,
         bool showProgress, bool fullSpeed, MythPlayer* player,
         int chanid, const QDateTime& startts, const QDateTime& endts,
-        const QDateTime& recstartts, const QDateTime& recendts, bool useDB);
+        const QDateTime& recstartts, const QDateTime& recendts, bool useDB,
+        int threads = 1);
     virtual bool go(void);
     virtual void GetCommercialBreakList(frm_dir_map_t &comms);
     virtual void recordingFinished(long long totalFileSize);
@@ -50,12 +53,21 @@ class CommDetector2 : public CommDetectorBase
         ostream &out, const frm_dir_map_t *comm_breaks, bool verbose) const;
 
   private:
-    virtual ~CommDetector2() {}
+    virtual ~CommDetector2() { delete analysisQueue; }
 
     void reportState(int elapsed_sec, long long frameno, long long nframes,
             unsigned int passno, unsigned int npasses);
     int computeBreaks(long long nframes);
 
+    bool startLanes(const FrameAnalyzerItem &pass);
+    void queueFrame(const VideoFrame *frame);
+    void syncLanes(FrameAnalyzerItem &pass, FrameAnalyzerItem &deadAnalyzers);
+    void stopLanes(void);
+
+    // FrameJobAnalyzer
+    FrameAnalysisJob *CreateFrameJob(void);
+    void AnalyzeFrameJob(FrameAnalysisJob *job, uint lane);
+
   private:
     enum SkipTypes          commDetectMethod;
     bool                    showProgress;
@@ -80,6 +92,17 @@ class CommDetector2 : public CommDetectorBase
     BlankFrameDetector      *blankFrameDetector;
     SceneChangeDetector     *sceneChangeDetector;
 
+    /*
+     * Groups of last pass analyzers that share no state, so that each group
+     * can analyze every frame on its own thread.
+     */
+    FrameAnalyzerList       analysisLanes;
+    FrameAnalyzerList       laneAnalyzers;      /* current pass, by lane */
+    FrameAnalyzerList       laneFinished;
+    FrameAnalyzerList       laneDead;
+    QAtomicInt              laneActive;         /* analyzers left in lanes */
+    FrameAnalysisQueue     *analysisQueue;
+
     QString                 debugdir;
 };
 
@@ -0,0 +1,235 @@
+// C++ headers
+#include <algorithm>
+#include <cstring>
+using namespace std;
+
+// Qt headers
+#include <QString>
+
+// MythTV headers
+#include "mythlogging.h"
+#include "mthread.h"
+
+// Commercial Flagging headers
+#include "FrameAnalysisQueue.h"
+
+/// Runs one lane of a FrameAnalysisQueue
+class FrameAnalysisThread : public MThread
+{
+  public:
+    FrameAnalysisThread(FrameAnalysisQueue *queue, uint lane) :
+        MThread(QString("CommFlagAnalysis%1").arg(lane)),
+        m_queue(queue), m_lane(lane) {}
+
+    virtual void run(void)
+    {
+        RunProlog();
+        m_queue->RunWorker(m_lane);
+        RunEpilog();
+    }
+
+  private:
+    FrameAnalysisQueue *m_queue;
+    uint                m_lane;
+};
+
+FrameAnalysisJob::FrameAnalysisJob() : m_started(0), m_finished(0)
+{
+    memset(&frame, 0, sizeof(frame));
+}
+
+/** \fn FrameAnalysisJob::CopyFrame(const VideoFrame*)
+ *  \brief Copies the whole frame buffer, so the analyzers see the same
+ *         planes, pitches and offsets as in the decoder's frame.
+ */
+void FrameAnalysisJob::CopyFrame(const VideoFrame *src)
+{
+    if (!src)
+    {
+        memset(&frame, 0, sizeof(frame));
+        frame.frameNumber = -1;
+        return;
+    }
+
+    frame = *src;
+    memset(frame.priv, 0, sizeof(frame.priv));
+    frame.qscale_table = NULL;
+    frame.qstride = 0;
+    frame.directrendering = 0;
+
+    if (!src->buf)
+        return;
+
+    int size = src->size;
+    if (size <= 0)
+        size = src->pitches[0] * src->height;
+    if (size <= 0)
+    {
+        frame.buf = NULL;
+        return;
+    }
+
+    if ((int)m_buffer.size() < size)
+        m_buffer.resize(size);
+    memcpy(&m_buffer[0], src->buf, size);
+    frame.buf  = &m_buffer[0];
+    frame.size = size;
+}
+
+FrameAnalysisQueue::FrameAnalysisQueue(FrameJobAnalyzer *analyzer,
+                                       LaneMode mode, uint threads,
+                                       uint depth) :
+    m_analyzer(analyzer), m_mode(mode),
+    m_depth(max(depth, 1U)), m_allLanes(1), m_stopping(false)
+{
+    threads = min(max(threads, 1U), 32U);
+    if (m_mode == kEveryLane)
+        m_allLanes = (threads == 32) ? ~0U : ((1U << threads) - 1);
+
+    for (uint i = 0; i < threads; i++)
+    {
+        m_threads.push_back(new FrameAnalysisThread(this, i));
+        m_threads.back()->start();
+    }
+
+    LOG(VB_COMMFLAG, LOG_INFO,
+        QString("Analyzing frames on %1 thread(s), %2 frames queued at most")
+            .arg(threads).arg(m_depth));
+}
+
+FrameAnalysisQueue::~FrameAnalysisQueue()
+{
+    m_lock.lock();
+    m_stopping = true;
+    m_jobQueued.wakeAll();
+    m_lock.unlock();
+
+    for (uint i = 0; i < m_threads.size(); i++)
+    {
+        m_threads[i]->wait();
+        delete m_threads[i];
+    }
+
+    while (!m_jobs.empty())
+    {
+        delete m_jobs.front();
+        m_jobs.pop_front();
+    }
+    for (uint i = 0; i < m_free.size(); i++)
+        delete m_free[i];
+}
+
+/// Returns true if the flagging thread must Dequeue() before it may
+/// Enqueue() another frame
+bool FrameAnalysisQueue::IsFull(void)
+{
+    QMutexLocker locker(&m_lock);
+    return m_jobs.size() >= m_depth;
+}
+
+bool FrameAnalysisQueue::IsEmpty(void)
+{
+    QMutexLocker locker(&m_lock);
+    return m_jobs.empty();
+}
+
+/// Copies a decoded frame onto the queue, the caller keeps the frame
+void FrameAnalysisQueue::Enqueue(const VideoFrame *frame)
+{
+    FrameAnalysisJob *job = NULL;
+    {
+        QMutexLocker locker(&m_lock);
+        if (!m_free.empty())
+        {
+            job = m_free.back();
+            m_free.pop_back();
+        }
+    }
+
+    if (!job)
+        job = m_analyzer->CreateFrameJob();
+
+    job->CopyFrame(frame);
+    job->m_started = 0;
+    job->m_finished = 0;
+
+    QMutexLocker locker(&m_lock);
+    m_jobs.push_back(job);
+    m_jobQueued.wakeAll();
+}
+
+/** \fn FrameAnalysisQueue::Dequeue(bool)
+ *  \brief Takes the oldest frame off the queue once every lane is done
+ *         with it.
+ *
+ *   Returns NULL if the queue is empty, or if the oldest frame is still
+ *   being analyzed and \p wait is not set. The job must be handed back
+ *   with Release().
+ */
+FrameAnalysisJob *FrameAnalysisQueue::Dequeue(bool wait)
+{
+    QMutexLocker locker(&m_lock);
+
+    while (wait && !m_jobs.empty() &&
+           m_jobs.front()->m_finished != m_allLanes)
+    {
+        m_jobFinished.wait(&m_lock);
+    }
+
+    if (m_jobs.empty() || m_jobs.front()->m_finished != m_allLanes)
+        return NULL;
+
+    FrameAnalysisJob *job = m_jobs.front();
+    m_jobs.pop_front();
+    return job;
+}
+
+void FrameAnalysisQueue::Release(FrameAnalysisJob *job)
+{
+    QMutexLocker locker(&m_lock);
+    m_free.push_back(job);
+}
+
+/// Returns the oldest frame the lane has not taken yet, m_lock must be held
+FrameAnalysisJob *FrameAnalysisQueue::NextJob(uint lane)
+{
+    uint bit = (m_mode == kEveryLane) ? (1U << lane) : 1U;
+
+    deque<FrameAnalysisJob*>::iterator it = m_jobs.begin();
+    for (; it != m_jobs.end(); ++it)
+    {
+        if (!((*it)->m_started & bit))
+        {
+            (*it)->m_started |= bit;
+            return *it;
+        }
+    }
+
+    return NULL;
+}
+
+void FrameAnalysisQueue::RunWorker(uint lane)
+{
+    uint bit = (m_mode == kEveryLane) ? (1U << lane) : 1U;
+
+    QMutexLocker locker(&m_lock);
+    while (!m_stopping)
+    {
+        FrameAnalysisJob *job = NextJob(lane);
+        if (!job)
+        {
+            m_jobQueued.wait(&m_lock);
+            continue;
+        }
+
+        locker.unlock();
+        m_analyzer->AnalyzeFrameJob(job, lane);
+        locker.relock();
+
+        job->m_finished |= bit;
+        if (job->m_finished == m_allLanes)
+            m_jobFinished.wakeAll();
+    }
+}
+
+/* vim: set expandtab tabstop=4 shiftwidth=4: */
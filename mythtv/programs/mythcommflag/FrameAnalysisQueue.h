@@ -0,0 +1,115 @@
+/*
+ * FrameAnalysisQueue
+ *
+ * Bounded queue of decoded frames that are analyzed on worker threads and
+ * handed back to the flagging thread in decode order.
+ */
+
+#ifndef _FRAMEANALYSISQUEUE_H_
+#define _FRAMEANALYSISQUEUE_H_
+
+// C++ headers
+#include <deque>
+#include <vector>
+using namespace std;
+
+// Qt headers
+#include <QMutex>
+#include <QWaitCondition>
+
+// MythTV headers
+#include "mythframe.h"
+
+class MThread;
+
+/** \brief A copy of one decoded frame waiting in a FrameAnalysisQueue.
+ *
+ *  Subclasses add whatever the analysis produces for the frame.
+ */
+class FrameAnalysisJob
+{
+  public:
+    FrameAnalysisJob();
+    virtual ~FrameAnalysisJob() {}
+
+    /// The copied frame, or a frame with a NULL buf if the decoder
+    /// returned a frame without a buffer.
+    VideoFrame frame;
+
+  private:
+    void CopyFrame(const VideoFrame *src);
+
+    vector<unsigned char> m_buffer;
+    uint m_started;  ///< lanes that took this frame
+    uint m_finished; ///< lanes done with this frame
+
+    friend class FrameAnalysisQueue;
+};
+
+/// Implemented by the detector that analyzes the queued frames
+class FrameJobAnalyzer
+{
+  public:
+    virtual ~FrameJobAnalyzer() {}
+
+    /// Creates an empty job, jobs are reused for later frames
+    virtual FrameAnalysisJob *CreateFrameJob(void) = 0;
+
+    /// Analyzes one frame, called from the worker thread of the lane
+    virtual void AnalyzeFrameJob(FrameAnalysisJob *job, uint lane) = 0;
+};
+
+/** \brief Runs frame analysis on worker threads while the flagging thread
+ *         keeps decoding.
+ *
+ *  Frames are copied into a bounded queue and taken off it with Dequeue()
+ *  strictly in the order they were added, once their analysis is done.
+ *
+ *  With kAnyLane every frame is analyzed once, by whichever worker is
+ *  free, so frames are analyzed out of order and the analysis must not
+ *  depend on earlier frames. With kEveryLane each worker thread is a lane
+ *  that analyzes every frame, in order, so stateful analyzers can run on
+ *  separate lanes as long as the lanes share no state.
+ */
+class FrameAnalysisQueue
+{
+  public:
+    enum LaneMode
+    {
+        kAnyLane,
+        kEveryLane,
+    };
+
+    FrameAnalysisQueue(FrameJobAnalyzer *analyzer, LaneMode mode,
+                       uint threads, uint depth);
+    ~FrameAnalysisQueue();
+
+    bool IsFull(void);
+    bool IsEmpty(void);
+    void Enqueue(const VideoFrame *frame);
+    FrameAnalysisJob *Dequeue(bool wait);
+    void Release(FrameAnalysisJob *job);
+
+  private:
+    void RunWorker(uint lane);
+    FrameAnalysisJob *NextJob(uint lane);
+
+    FrameJobAnalyzer          *m_analyzer;
+    LaneMode                   m_mode;
+    uint                       m_depth;
+    uint                       m_allLanes;
+
+    QMutex                     m_lock;
+    QWaitCondition             m_jobQueued;
+    QWaitCondition             m_jobFinished;
+    bool                       m_stopping;
+    deque<FrameAnalysisJob*>   m_jobs;    ///< queued, in decode order
+    vector<FrameAnalysisJob*>  m_free;
+    vector<MThread*>           m_threads;
+
+    friend class FrameAnalysisThread;
+};
+
+#endif  /* !_FRAMEANALYSISQUEUE_H_ */
+
+/* vim: set expandtab tabstop=4 shiftwidth=4: */
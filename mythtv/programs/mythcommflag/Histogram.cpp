@@ -17,7 +17,7 @@ Histogram::~Histogram()
 {
 }
 
-void Histogram::generateFromImage(VideoFrame* frame, unsigned int frameWidth,
+void Histogram::generateFromImage(const VideoFrame* frame, unsigned int frameWidth,
          unsigned int frameHeight, unsigned int minScanX, unsigned int maxScanX,
          unsigned int minScanY, unsigned int maxScanY, unsigned int XSpacing,
          unsigned int YSpacing)
@@ -31,7 +31,7 @@ void Histogram::generateFromImage(VideoFrame* frame, unsigned int frameWidth,
     if (maxScanY > frameHeight-1)
         maxScanY = frameHeight-1;
 
-    unsigned char* framePtr = frame->buf;
+    const unsigned char* framePtr = frame->buf;
     int bytesPerLine = frame->pitches[0];
     for(unsigned int y = minScanY; y < maxScanY; y += YSpacing)
         for(unsigned int x = minScanX; x < maxScanX; x += XSpacing)
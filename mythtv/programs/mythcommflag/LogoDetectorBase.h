@@ -15,7 +15,7 @@ class LogoDetectorBase : public QObject
         foundLogo(false), width(w),height(h) {};
 
     virtual bool searchForLogo(MythPlayer* player) = 0;
-    virtual bool doesThisFrameContainTheFoundLogo(VideoFrame* frame) = 0;
+    virtual bool doesThisFrameContainTheFoundLogo(const VideoFrame* frame) = 0;
     virtual bool pixelInsideLogo(unsigned int x, unsigned int y) = 0;
     virtual unsigned int getRequiredAvailableBufferForSearch() = 0;
 
@@ -64,6 +64,10 @@ void MythCommFlagCommandLineParser::LoadArguments(void)
     add("--outputmethod", "outputmethod", "",
         "Format of output written to outputfile, essentials, full.", "")
             ->SetGroup("Commflagging");
+    add("--threads", "threads", 1,
+        "Number of threads used to decode and analyze frames, "
+        "0 uses one per CPU core. Overrides the CommFlagThreads setting.", "")
+            ->SetGroup("Commflagging");
     add("--queue", "queue", false,
         "Insert flagging job into the JobQueue, rather than "
         "running flagging in the foreground.", "");
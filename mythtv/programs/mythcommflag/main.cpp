@@ -20,6 +20,7 @@ using namespace std;
 #include <QRegExp>
 #include <QDir>
 #include <QEvent>
+#include <QThread>
 
 // MythTV headers
 #include "mythmiscutil.h"
@@ -78,6 +79,10 @@ int recorderNum = -1;
 int jobID = -1;
 int lastCmd = -1;
 
+/// Threads used to decode and analyze frames, 1 keeps everything on the
+/// flagging thread and decodes with a single FFmpeg thread.
+int analysisThreads = 1;
+
 static QMap<QString,SkipTypes> *init_skip_types();
 QMap<QString,SkipTypes> *skipTypes = init_skip_types();
 
@@ -536,7 +541,7 @@ static int DoFlagCommercials(
         program_info->GetScheduledStartTime(),
         program_info->GetScheduledEndTime(),
         program_info->GetRecordingStartTime(),
-        program_info->GetRecordingEndTime(), useDB);
+        program_info->GetRecordingEndTime(), useDB, analysisThreads);
 
     if (jobid > 0)
         LOG(VB_COMMFLAG, LOG_INFO,
@@ -868,12 +873,21 @@ static int FlagCommercials(ProgramInfo *program_info, int jobid,
         }
     }
 
+    analysisThreads = gCoreContext->GetNumSetting("CommFlagThreads", 1);
+    if (cmdline.toBool("threads"))
+        analysisThreads = cmdline.toInt("threads");
+    if (analysisThreads <= 0)
+        analysisThreads = QThread::idealThreadCount();
+    analysisThreads = max(analysisThreads, 1);
+
     PlayerFlags flags = (PlayerFlags)(kAudioMuted   |
                                       kVideoIsNull  |
                                       kDecodeLowRes |
-                                      kDecodeSingleThreaded |
                                       kDecodeNoLoopFilter |
                                       kNoITV);
+    /* frame threaded decoding returns the same frames, just later */
+    if (analysisThreads == 1)
+        flags = (PlayerFlags) (flags | kDecodeSingleThreaded);
     /* blank detector needs to be only sample center for this optimization. */
     if ((COMM_DETECT_BLANKS  == commDetectMethod) ||
         (COMM_DETECT_2_BLANK == commDetectMethod))
@@ -18,6 +18,7 @@ HEADERS += CommDetectorFactory.h CommDetectorBase.h
 HEADERS += ClassicLogoDetector.h
 HEADERS += ClassicSceneChangeDetector.h
 HEADERS += ClassicCommDetector.h
+HEADERS += FrameAnalysisQueue.h
 HEADERS += Histogram.h
 HEADERS += quickselect.h
 HEADERS += CommDetector2.h
@@ -39,6 +40,7 @@ SOURCES += CommDetectorFactory.cpp CommDetectorBase.cpp
 SOURCES += ClassicLogoDetector.cpp
 SOURCES += ClassicSceneChangeDetector.cpp
 SOURCES += ClassicCommDetector.cpp
+SOURCES += FrameAnalysisQueue.cpp
 SOURCES += Histogram.cpp
 SOURCES += quickselect.c
 SOURCES += CommDetector2.cpp
@@ -0,0 +1,3 @@
+#include "test_classiccommdetector.h"
+
+QTEST_GUILESS_MAIN(TestClassicCommDetector)
@@ -0,0 +1,168 @@
+/*
+ *  Class TestClassicCommDetector
+ *
+ *  Copyright (C) MythTV Developers 2016
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <QtTest/QtTest>
+
+#include <vector>
+using namespace std;
+
+#include "ClassicCommDetector.h"
+#include "mythcorecontext.h"
+#include "mythframe.h"
+
+/// Feeds frames to the detector without a player
+class SyntheticCommDetector : public ClassicCommDetector
+{
+  public:
+    SyntheticCommDetector(SkipType method, int threads) :
+        ClassicCommDetector(method, false, true, NULL,
+                            QDateTime(), QDateTime(), QDateTime(), QDateTime(),
+                            threads) {}
+    ~SyntheticCommDetector() {}
+
+    using ClassicCommDetector::Init;
+    using ClassicCommDetector::SetVideoAspect;
+    using ClassicCommDetector::QueueFrame;
+    using ClassicCommDetector::FlushFrames;
+
+    QStringList FrameInfo(void) const
+    {
+        QStringList list;
+        QMap<long long, FrameInfoEntry>::const_iterator it = frameInfo.begin();
+        for (; it != frameInfo.end(); ++it)
+            list << it->toString(it.key(), true);
+        return list;
+    }
+};
+
+class TestClassicCommDetector : public QObject
+{
+    Q_OBJECT
+
+    static const int kWidth  = 160;
+    static const int kHeight = 120;
+    static const int kFPS    = 10;
+
+    /** A minute of show, a break of three 30 second spots in 16:9 with
+     *  blank frames between them, and another minute of show. Scenes change
+     *  every 4 seconds.
+     */
+    static void Render(VideoFrame &frame, vector<unsigned char> &buf,
+                       long long number)
+    {
+        const long long show   = 60 * kFPS;
+        const long long spot   = 30 * kFPS;
+        const long long breakEnd = show + 3 * spot;
+
+        bool inBreak = number >= show && number < breakEnd;
+        bool blank   = (number >= show && number <= breakEnd &&
+                        ((number - show) % spot) < 3);
+        int  scene   = number / (4 * kFPS);
+
+        int pitches[3] = { kWidth, kWidth / 2, kWidth / 2 };
+        int offsets[3] = { 0, kWidth * kHeight, kWidth * kHeight * 5 / 4 };
+        init(&frame, FMT_YV12, &buf[0], kWidth, kHeight, buf.size(),
+             pitches, offsets, inBreak ? 16.0f / 9 : 4.0f / 3, kFPS);
+        frame.frameNumber = number;
+
+        for (int y = 0; y < kHeight; y++)
+        {
+            unsigned char *row = &buf[y * kWidth];
+            for (int x = 0; x < kWidth; x++)
+            {
+                row[x] = blank ? 16 :
+                    30 + (x * (scene % 5 + 1) + y * 3 + scene * 37) % 200;
+            }
+        }
+        memset(&buf[kWidth * kHeight], 128, kWidth * kHeight / 2);
+    }
+
+    static void Flag(SkipType method, int threads, frm_dir_map_t &breaks,
+                     QStringList &frames)
+    {
+        SyntheticCommDetector *detector =
+            new SyntheticCommDetector(method, threads);
+        detector->Init(kWidth, kHeight, kFPS);
+        detector->SetVideoAspect(4.0f / 3);
+
+        VideoFrame frame;
+        vector<unsigned char> buf(kWidth * kHeight * 3 / 2);
+        for (long long number = 0; number < (60 + 90 + 60) * kFPS; number++)
+        {
+            Render(frame, buf, number);
+            detector->QueueFrame(&frame);
+        }
+        detector->FlushFrames();
+
+        detector->GetCommercialBreakList(breaks);
+        frames = detector->FrameInfo();
+        delete detector;
+    }
+
+  private slots:
+    // called at the beginning of these sets of tests
+    void initTestCase(void)
+    {
+        gCoreContext = new MythCoreContext("bin_version", NULL);
+    }
+
+    void cleanupTestCase(void)
+    {
+        delete gCoreContext;
+        gCoreContext = NULL;
+    }
+
+    void ThreadsGiveSameBreaks_data(void)
+    {
+        QTest::addColumn<int>("method");
+        QTest::addColumn<bool>("needBreak");
+
+        QTest::newRow("blank") << (int)COMM_DETECT_BLANK << true;
+        QTest::newRow("blank+scene")
+            << (int)(COMM_DETECT_BLANK | COMM_DETECT_SCENE) << false;
+        QTest::newRow("scene") << (int)COMM_DETECT_SCENE << false;
+    }
+
+    /// The analysis queue must not change a single frame's flags, nor the
+    /// break list built from them.
+    void ThreadsGiveSameBreaks(void)
+    {
+        QFETCH(int, method);
+        QFETCH(bool, needBreak);
+
+        frm_dir_map_t serialBreaks;
+        QStringList serialFrames;
+        Flag((SkipType)method, 1, serialBreaks, serialFrames);
+
+        QCOMPARE(serialFrames.size(), (60 + 90 + 60) * kFPS);
+        if (needBreak)
+            QVERIFY(!serialBreaks.isEmpty());
+
+        for (int threads = 2; threads <= 4; threads += 2)
+        {
+            frm_dir_map_t breaks;
+            QStringList frames;
+            Flag((SkipType)method, threads, breaks, frames);
+
+            QCOMPARE(frames, serialFrames);
+            QCOMPARE(breaks, serialBreaks);
+        }
+    }
+};
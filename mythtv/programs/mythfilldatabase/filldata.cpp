@@ -306,23 +306,51 @@ bool FillData::GrabDDData(Source source, int poffset,
 }
 
 // XMLTV stuff
+
+/// Stores channels and programmes as the XMLTV parser hands them on.
+class FillDataXMLTVListener : public XMLTVListener
+{
+  public:
+    FillDataXMLTVListener(FillData &filldata, int sourceid) :
+        m_filldata(filldata), m_sourceid(sourceid),
+        m_channels(0), m_unchanged(0), m_updated(0) {}
+
+    void HandleChannels(ChannelInfoList &chanlist)
+    {
+        m_filldata.chan_data.handleChannels(m_sourceid, &chanlist);
+    }
+
+    void HandlePrograms(QMap<QString, QList<ProgInfo> > &proglist)
+    {
+        m_channels += proglist.count();
+        m_filldata.prog_data.HandlePrograms(
+            m_sourceid, proglist, m_unchanged, m_updated);
+    }
+
+    FillData &m_filldata;
+    int       m_sourceid;
+    uint      m_channels;  ///< channels that had programmes
+    uint      m_unchanged;
+    uint      m_updated;
+};
+
 bool FillData::GrabDataFromFile(int id, QString &filename)
 {
-    ChannelInfoList chanlist;
-    QMap<QString, QList<ProgInfo> > proglist;
+    FillDataXMLTVListener listener(*this, id);
 
-    if (!xmltv_parser.parseFile(filename, &chanlist, &proglist))
+    if (!xmltv_parser.parseFile(filename, &listener))
         return false;
 
-    chan_data.handleChannels(id, &chanlist);
-    if (proglist.count() == 0)
+    if (listener.m_channels == 0)
     {
         LOG(VB_GENERAL, LOG_INFO, "No programs found in data.");
         endofdata = true;
     }
     else
     {
-        prog_data.HandlePrograms(id, proglist);
+        LOG(VB_GENERAL, LOG_INFO,
+            QString("Updated programs: %1 Unchanged programs: %2")
+                    .arg(listener.m_updated) .arg(listener.m_unchanged));
     }
     return true;
 }
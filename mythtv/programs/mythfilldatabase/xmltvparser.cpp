@@ -2,9 +2,12 @@
 
 // Qt headers
 #include <QFile>
+#include <QSet>
 #include <QStringList>
 #include <QDateTime>
 #include <QDomDocument>
+#include <QXmlStreamReader>
+#include <QElapsedTimer>
 #include <QUrl>
 
 // C++ headers
@@ -607,11 +610,64 @@ ProgInfo *XMLTVParser::parseProgram(QDomElement &element)
     return pginfo;
 }
 
-bool XMLTVParser::parseFile(
-    QString filename, ChannelInfoList *chanlist,
-    QMap<QString, QList<ProgInfo> > *proglist)
+/** \brief Builds a DOM subtree for the element the reader is positioned on
+ *         and leaves the reader on its end tag.
+ *
+ *  Adjacent character data is merged and whitespace only text is dropped,
+ *  as QDomDocument::setContent() does, so parseChannel() and parseProgram()
+ *  see the same tree they would see in a fully loaded document.
+ */
+static QDomElement readElement(QXmlStreamReader &reader, QDomDocument &doc)
+{
+    QDomElement element = doc.createElement(reader.name().toString());
+
+    QXmlStreamAttributes attrs = reader.attributes();
+    for (int i = 0; i < attrs.size(); ++i)
+    {
+        element.setAttribute(attrs[i].name().toString(),
+                             attrs[i].value().toString());
+    }
+
+    QString text;
+    while (!reader.atEnd())
+    {
+        reader.readNext();
+
+        if (reader.isCharacters())
+        {
+            text += reader.text();
+            continue;
+        }
+
+        if (!text.trimmed().isEmpty())
+            element.appendChild(doc.createTextNode(text));
+        text.clear();
+
+        if (reader.isEndElement())
+            break;
+
+        if (reader.isStartElement())
+            element.appendChild(readElement(reader, doc));
+    }
+
+    return element;
+}
+
+/** \brief Parses an XMLTV file and passes its contents to \p listener.
+ *
+ *  The file is read with QXmlStreamReader, and only the current
+ *  element is turned into a DOM tree. Most grabbers group programmes
+ *  by channel. While that holds, each channel's programmes go to the
+ *  listener as soon as the next channel starts, so memory use is
+ *  bounded by the largest channel rather than by the file.
+ *
+ *  If a channel turns up again after it was handed on, the rest of the
+ *  file is buffered and handed on at the end. The earlier part of that
+ *  channel is already in the database by then, and ProgramData resolves
+ *  any overlaps against it.
+ */
+bool XMLTVParser::parseFile(QString filename, XMLTVListener *listener)
 {
-    QDomDocument doc;
     QFile f;
 
     if (!dash_open(f, filename, QIODevice::ReadOnly))
@@ -621,94 +677,162 @@ bool XMLTVParser::parseFile(
         return false;
     }
 
-    QString errorMsg = "unknown";
-    int errorLine = 0;
-    int errorColumn = 0;
-
-    if (!doc.setContent(&f, &errorMsg, &errorLine, &errorColumn))
-    {
-        LOG(VB_GENERAL, LOG_ERR, QString("Error in %1:%2: %3")
-            .arg(errorLine).arg(errorColumn).arg(errorMsg));
-
-        f.close();
-        return true;
-    }
+    QElapsedTimer timer, handlerTimer;
+    qint64 handlerTime = 0;
+    timer.start();
 
-    f.close();
+    QXmlStreamReader reader(&f);
+    QDomDocument doc;
+    QUrl baseUrl;
 
-    QDomElement docElem = doc.documentElement();
+    ChannelInfoList chanlist;
+    bool channelsHandled = false;
 
-    QUrl baseUrl(docElem.attribute("source-data-url", ""));
-    //QUrl sourceUrl(docElem.attribute("source-info-url", ""));
+    QMap<QString, QList<ProgInfo> > proglist;
+    QSet<QString> handedOn;
+    QString lastChannel;
+    bool grouped = true;
+    uint channelCount = 0;
+    uint programCount = 0;
 
     QString aggregatedTitle;
     QString aggregatedDesc;
 
-    QDomNode n = docElem.firstChild();
-    while (!n.isNull())
+    while (!reader.atEnd())
     {
-        QDomElement e = n.toElement();
-        if (!e.isNull())
+        if (reader.readNext() != QXmlStreamReader::StartElement)
+            continue;
+
+        // the root element, channels and programmes are its children
+        if (reader.name() == "tv")
+        {
+            baseUrl = QUrl(reader.attributes().value("source-data-url")
+                           .toString());
+            continue;
+        }
+
+        QDomElement e = readElement(reader, doc);
+        if (reader.hasError())
+            break;
+
+        if (e.tagName() == "channel")
         {
-            if (e.tagName() == "channel")
+            ChannelInfo *chinfo = parseChannel(e, baseUrl);
+            if (!chinfo->xmltvid.isEmpty())
+                chanlist.push_back(*chinfo);
+            delete chinfo;
+            channelCount++;
+            continue;
+        }
+
+        if (e.tagName() != "programme")
+            continue;
+
+        if (!channelsHandled)
+        {
+            handlerTimer.start();
+            listener->HandleChannels(chanlist);
+            handlerTime += handlerTimer.elapsed();
+            channelsHandled = true;
+        }
+
+        ProgInfo *pginfo = parseProgram(e);
+        programCount++;
+
+        if (pginfo->startts == pginfo->endts)
+        {
+            LOG(VB_GENERAL, LOG_WARNING, QString("Invalid programme (%1), "
+                                                "identical start and end "
+                                                "times, skipping")
+                                                .arg(pginfo->title));
+            delete pginfo;
+            continue;
+        }
+
+        if (!pginfo->clumpidx.isEmpty())
+        {
+            /* append all titles/descriptions from one clump */
+            if (pginfo->clumpidx.toInt() == 0)
             {
-                ChannelInfo *chinfo = parseChannel(e, baseUrl);
-                if (!chinfo->xmltvid.isEmpty())
-                    chanlist->push_back(*chinfo);
-                delete chinfo;
+                aggregatedTitle.clear();
+                aggregatedDesc.clear();
             }
-            else if (e.tagName() == "programme")
-            {
-                ProgInfo *pginfo = parseProgram(e);
 
-                if (pginfo->startts == pginfo->endts)
-                {
-                    LOG(VB_GENERAL, LOG_WARNING, QString("Invalid programme (%1), "
-                                                        "identical start and end "
-                                                        "times, skipping")
-                                                        .arg(pginfo->title));
-                }
-                else
-                {
-                    if (pginfo->clumpidx.isEmpty())
-                        (*proglist)[pginfo->channel].push_back(*pginfo);
-                    else
-                    {
-                        /* append all titles/descriptions from one clump */
-                        if (pginfo->clumpidx.toInt() == 0)
-                        {
-                            aggregatedTitle.clear();
-                            aggregatedDesc.clear();
-                        }
+            if (!pginfo->title.isEmpty())
+            {
+                if (!aggregatedTitle.isEmpty())
+                    aggregatedTitle.append(" | ");
+                aggregatedTitle.append(pginfo->title);
+            }
 
-                        if (!pginfo->title.isEmpty())
-                        {
-                            if (!aggregatedTitle.isEmpty())
-                                aggregatedTitle.append(" | ");
-                            aggregatedTitle.append(pginfo->title);
-                        }
+            if (!pginfo->description.isEmpty())
+            {
+                if (!aggregatedDesc.isEmpty())
+                    aggregatedDesc.append(" | ");
+                aggregatedDesc.append(pginfo->description);
+            }
 
-                        if (!pginfo->description.isEmpty())
-                        {
-                            if (!aggregatedDesc.isEmpty())
-                                aggregatedDesc.append(" | ");
-                            aggregatedDesc.append(pginfo->description);
-                        }
-                        if (pginfo->clumpidx.toInt() ==
-                            pginfo->clumpmax.toInt() - 1)
-                        {
-                            pginfo->title = aggregatedTitle;
-                            pginfo->description = aggregatedDesc;
-                            (*proglist)[pginfo->channel].push_back(*pginfo);
-                        }
-                    }
-                }
+            if (pginfo->clumpidx.toInt() != pginfo->clumpmax.toInt() - 1)
+            {
                 delete pginfo;
+                continue;
+            }
+
+            pginfo->title = aggregatedTitle;
+            pginfo->description = aggregatedDesc;
+        }
+
+        if (grouped && pginfo->channel != lastChannel)
+        {
+            if (handedOn.contains(pginfo->channel))
+            {
+                LOG(VB_GENERAL, LOG_INFO,
+                    QString("Programmes for %1 are not grouped by channel, "
+                            "buffering the rest of the file.")
+                        .arg(pginfo->channel));
+                grouped = false;
             }
+            else if (!lastChannel.isEmpty())
+            {
+                handlerTimer.start();
+                listener->HandlePrograms(proglist);
+                handlerTime += handlerTimer.elapsed();
+                proglist.clear();
+                handedOn.insert(lastChannel);
+            }
+            lastChannel = pginfo->channel;
         }
-        n = n.nextSibling();
+
+        proglist[pginfo->channel].push_back(*pginfo);
+        delete pginfo;
     }
 
+    qint64 parseTime = timer.elapsed() - handlerTime;
+    qint64 bytes = f.pos();
+    f.close();
+
+    if (reader.hasError())
+    {
+        LOG(VB_GENERAL, LOG_ERR, QString("Error in %1:%2: %3")
+            .arg(reader.lineNumber()).arg(reader.columnNumber())
+            .arg(reader.errorString()));
+        return true;
+    }
+
+    handlerTimer.start();
+    if (!channelsHandled)
+        listener->HandleChannels(chanlist);
+    if (!proglist.isEmpty())
+        listener->HandlePrograms(proglist);
+    handlerTime += handlerTimer.elapsed();
+
+    LOG(VB_GENERAL, LOG_INFO,
+        QString("Parsed %1 channels and %2 programmes (%3 kB) in %4 s, "
+                "%5 programmes/s, %6 s spent storing them")
+            .arg(channelCount).arg(programCount).arg(bytes / 1024)
+            .arg(parseTime / 1000.0, 0, 'f', 1)
+            .arg(parseTime ? programCount * 1000 / parseTime : programCount)
+            .arg(handlerTime / 1000.0, 0, 'f', 1));
+
     return true;
 }
-
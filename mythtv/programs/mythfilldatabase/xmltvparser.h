@@ -13,6 +13,21 @@ class ProgInfo;
 class QUrl;
 class QDomElement;
 
+/** \brief Receives the contents of an XMLTV file while it is being parsed.
+ *
+ *  HandleChannels() is called once, before the first programme is handed
+ *  on. HandlePrograms() is called with the programmes of one or more
+ *  channels each time the parser is done with them.
+ */
+class XMLTVListener
+{
+  public:
+    virtual ~XMLTVListener() {}
+
+    virtual void HandleChannels(ChannelInfoList &chanlist) = 0;
+    virtual void HandlePrograms(QMap<QString, QList<ProgInfo> > &proglist) = 0;
+};
+
 class XMLTVParser
 {
   public:
@@ -20,8 +35,7 @@ class XMLTVParser
 
     ChannelInfo *parseChannel(QDomElement &element, QUrl &baseUrl);
     ProgInfo *parseProgram(QDomElement &element);
-    bool parseFile(QString filename, ChannelInfoList *chanlist,
-                   QMap<QString, QList<ProgInfo> > *proglist);
+    bool parseFile(QString filename, XMLTVListener *listener);
 
   private:
     unsigned int current_year;
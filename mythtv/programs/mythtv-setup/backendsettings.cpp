@@ -227,6 +227,20 @@ static GlobalSpinBox *HDRingbufferSize()
     return bs;
 }
 
+static HostSpinBox *PreviewCacheSize()
+{
+    HostSpinBox *bs = new HostSpinBox("PreviewCacheSize", 0, 100000, 64);
+    bs->setLabel(QObject::tr("Preview image cache size (MB)"));
+    bs->setHelpText(QObject::tr("Preview images of other times and sizes "
+                    "than the default preview are kept next to the "
+                    "recordings. Once they take up more than this many "
+                    "megabytes, the least recently used ones are deleted. "
+                    "The default preview of a recording is never deleted. "
+                    "Set to 0 to keep all previews."));
+    bs->setValue(0);
+    return bs;
+}
+
 static GlobalComboBox *StorageScheduler()
 {
     GlobalComboBox *gc = new GlobalComboBox("StorageScheduler");
@@ -507,12 +521,60 @@ static HostSpinBox *JobQueueCheckFrequency()
 {
     HostSpinBox *gc = new HostSpinBox("JobQueueCheckFrequency", 5, 300, 5);
     gc->setLabel(QObject::tr("Job Queue check frequency (secs)"));
-    gc->setHelpText(QObject::tr("When looking for new jobs to process, the "
-                    "Job Queue will wait this many seconds between checks."));
+    gc->setHelpText(QObject::tr("The Job Queue starts jobs as soon as they "
+                    "are queued or a running job finishes. It also looks "
+                    "through the queue this often in case it missed a "
+                    "change."));
     gc->setValue(60);
     return gc;
 };
 
+static HostSpinBox *JobQueueMaxCPULoad()
+{
+    HostSpinBox *gc = new HostSpinBox("JobQueueMaxCPULoad", 0, 400, 10);
+    gc->setLabel(QObject::tr("Maximum CPU load for new jobs (%)"));
+    gc->setHelpText(QObject::tr("Jobs other than metadata lookups will not "
+                    "be started while the one minute load average is at "
+                    "least this percentage of the CPUs in this backend. "
+                    "Set to 0 to ignore the load."));
+    gc->setValue(100);
+    return gc;
+};
+
+static HostSpinBox *JobQueueMaxRecorders()
+{
+    HostSpinBox *gc = new HostSpinBox("JobQueueMaxRecorders", 0, 32, 1);
+    gc->setLabel(QObject::tr("Maximum recordings for transcodes"));
+    gc->setHelpText(QObject::tr("Transcodes and user jobs will not be "
+                    "started while this many recordings or more are being "
+                    "made on this backend. Set to 0 to ignore recordings."));
+    gc->setValue(3);
+    return gc;
+};
+
+static HostSpinBox *JobQueueMaxStorageStreams()
+{
+    HostSpinBox *gc = new HostSpinBox("JobQueueMaxStorageStreams", 0, 32, 1);
+    gc->setLabel(QObject::tr("Maximum streams per storage directory"));
+    gc->setHelpText(QObject::tr("Transcodes and user jobs will not be "
+                    "started while this many recordings, playbacks and "
+                    "jobs or more are using the directory the recording "
+                    "is in. Set to 0 to ignore storage use."));
+    gc->setValue(4);
+    return gc;
+};
+
+static HostSpinBox *CommFlagThreads()
+{
+    HostSpinBox *gc = new HostSpinBox("CommFlagThreads", 0, 16, 1);
+    gc->setLabel(QObject::tr("Commercial detection threads"));
+    gc->setHelpText(QObject::tr("Number of threads each commercial "
+                    "detection job uses to decode and analyze frames. "
+                    "Set to 0 to use one thread per CPU core."));
+    gc->setValue(1);
+    return gc;
+};
+
 static HostComboBox *JobQueueCPU()
 {
     HostComboBox *gc = new HostComboBox("JobQueueCPU");
@@ -857,6 +919,7 @@ BackendSettings::BackendSettings() {
     fm->addChild(fmh1);
     fm->addChild(HDRingbufferSize());
     fm->addChild(StorageScheduler());
+    fm->addChild(PreviewCacheSize());
     group2->addChild(fm);
     VerticalConfigurationGroup* upnp = new VerticalConfigurationGroup();
     upnp->setLabel(QObject::tr("UPnP Server Settings"));
@@ -914,6 +977,10 @@ BackendSettings::BackendSettings() {
     group5->setLabel(QObject::tr("Job Queue (Backend-Specific)"));
     group5->addChild(JobQueueMaxSimultaneousJobs());
     group5->addChild(JobQueueCheckFrequency());
+    group5->addChild(JobQueueMaxCPULoad());
+    group5->addChild(JobQueueMaxRecorders());
+    group5->addChild(JobQueueMaxStorageStreams());
+    group5->addChild(CommFlagThreads());
 
     HorizontalConfigurationGroup* group5a =
               new HorizontalConfigurationGroup(false, false);
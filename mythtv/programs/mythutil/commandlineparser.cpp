@@ -176,6 +176,10 @@ void MythUtilCommandLineParser::LoadArguments(void)
         << add("--checkrecordings", "checkrecordings", false,
                 "Check all recording exist and have a seektable etc.", "")
                 ->SetGroup("Recording Utils")
+        << add("--writeseekindex", "writeseekindex", false,
+                "Write seek index files for recordings on this host "
+                "that don't have a current one.", "")
+                ->SetGroup("Recording Utils")
 
         // eitutils.cpp
         << add("--cleareit", "cleareit", false,
@@ -16,6 +16,7 @@ using namespace std;
 #include "remotefile.h"
 #include "mythsystem.h"
 #include "mythdirs.h"
+#include "seekindex.h"
 
 // Local includes
 #include "recordingutils.h"
@@ -232,9 +233,92 @@ static int CheckRecordings(const MythUtilCommandLineParser &cmdline)
     return GENERIC_EXIT_OK;
 }
 
+static int WriteSeekIndexes(const MythUtilCommandLineParser &cmdline)
+{
+    cout << "Writing seek indexes" << endl;
+
+    std::vector<ProgramInfo *> *recordingList = RemoteGetRecordedList(-1);
+
+    if (!recordingList)
+    {
+        cout << "ERROR - failed to get recording list from backend" << endl;
+        return GENERIC_EXIT_NOT_OK;
+    }
+
+    uint written = 0, current = 0, skipped = 0, failed = 0;
+
+    vector<ProgramInfo *>::iterator i = recordingList->begin();
+    for ( ; i != recordingList->end(); ++i)
+    {
+        ProgramInfo *p = *i;
+        // ignore live tv and deleted recordings
+        if (p->GetRecordingGroup() == "LiveTV" ||
+            p->GetRecordingGroup() == "Deleted")
+        {
+            continue;
+        }
+
+        // The index can only be written next to recordings on this host
+        QString path = p->GetPlaybackURL(false, true);
+        QFileInfo fi(path);
+        if (!path.startsWith('/') || !fi.exists() || fi.size() == 0)
+        {
+            skipped++;
+            continue;
+        }
+
+        SeekIndex index;
+        if (index.Open(path, fi.size()))
+        {
+            current++;
+            continue;
+        }
+
+        cout << "Indexing: " << qPrintable(CreateProgramInfoString(*p)) << endl;
+
+        MarkTypes type = MARK_GOP_BYFRAME;
+        frm_pos_map_t posMap, durMap;
+        p->QueryPositionMap(posMap, type);
+        if (posMap.isEmpty())
+            p->QueryPositionMap(posMap, type = MARK_GOP_START);
+        if (posMap.isEmpty())
+            p->QueryPositionMap(posMap, type = MARK_KEYFRAME);
+
+        if (posMap.isEmpty())
+        {
+            cout << "No seektable found" << endl;
+            skipped++;
+            continue;
+        }
+
+        p->QueryPositionMap(durMap, MARK_DURATION_MS);
+
+        if (SeekIndex::Write(path, fi.size(), type, posMap, durMap))
+        {
+            written++;
+        }
+        else
+        {
+            cout << "ERROR - unable to write " <<
+                qPrintable(SeekIndex::GetIndexName(path)) << endl;
+            failed++;
+        }
+    }
+
+    cout << endl << "SUMMARY" << endl;
+    cout << "Recordings           : " << recordingList->size() << endl;
+    cout << "Indexes written      : " << written << endl;
+    cout << "Already up to date   : " << current << endl;
+    cout << "Skipped              : " << skipped << endl;
+    cout << "Failed               : " << failed << endl;
+
+    return (failed) ? GENERIC_EXIT_NOT_OK : GENERIC_EXIT_OK;
+}
+
 void registerRecordingUtils(UtilMap &utilMap)
 {
     utilMap["checkrecordings"]         = &CheckRecordings;
+    utilMap["writeseekindex"]          = &WriteSeekIndexes;
 }
 
 /* vim: set expandtab tabstop=4 shiftwidth=4: */
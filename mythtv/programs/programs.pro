@@ -23,4 +23,30 @@ using_backend {
     !mingw:!win32-msvc*: SUBDIRS += mythfilerecorder
 }
 
+# unit tests mythbackend
+using_backend {
+    mythbackend-test.depends = sub-mythbackend
+    mythbackend-test.target = buildtestmythbackend
+    mythbackend-test.commands = cd mythbackend/test && $(QMAKE) && $(MAKE)
+    unix:QMAKE_EXTRA_TARGETS += mythbackend-test
+
+    unittest.depends += mythbackend-test
+}
+
+# unit tests mythcommflag
+using_frontend {
+    mythcommflag-test.depends = sub-mythcommflag
+    mythcommflag-test.target = buildtestmythcommflag
+    mythcommflag-test.commands = cd mythcommflag/test && $(QMAKE) && $(MAKE)
+    unix:QMAKE_EXTRA_TARGETS += mythcommflag-test
+
+    unittest.depends += mythcommflag-test
+}
+
+using_backend|using_frontend {
+    unittest.target = test
+    unittest.commands = scripts/unittests.sh
+    unix:QMAKE_EXTRA_TARGETS += unittest
+}
+
 using_mythtranscode: SUBDIRS += mythtranscode